@@ -0,0 +1,140 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Insertion and lookup time vs. memory usage of boost::unordered_flat_map
+// with the default power-of-two growth and with compact growth
+// (hash_prefers_compact_growth), at several table sizes.
+
+#define _SILENCE_CXX17_OLD_ALLOCATOR_MEMBERS_DEPRECATION_WARNING
+#define _SILENCE_CXX20_CISO646_REMOVED_WARNING
+
+#include <boost/unordered/unordered_flat_map.hpp>
+#include <boost/core/detail/splitmix64.hpp>
+#include <boost/config.hpp>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <utility>
+
+using namespace std::chrono_literals;
+
+constexpr std::size_t N = 8'000'000;
+
+constexpr int K = 4;
+
+static std::vector<std::uint64_t> indices1, indices2;
+
+static void init_indices()
+{
+    boost::detail::splitmix64 rng;
+
+    for( std::size_t i = 0; i < N; ++i )
+    {
+        indices1.push_back( rng() );
+        indices2.push_back( rng() );
+    }
+}
+
+static std::size_t memory_used = 0, peak_memory_used = 0;
+
+template<class T> struct counting_allocator
+{
+    using value_type = T;
+
+    counting_allocator() = default;
+    template<class U> counting_allocator( counting_allocator<U> const& ) {}
+
+    T* allocate( std::size_t n )
+    {
+        memory_used += n * sizeof( T );
+        if( memory_used > peak_memory_used ) peak_memory_used = memory_used;
+        return std::allocator<T>().allocate( n );
+    }
+
+    void deallocate( T* p, std::size_t n )
+    {
+        memory_used -= n * sizeof( T );
+        std::allocator<T>().deallocate( p, n );
+    }
+
+    bool operator==( counting_allocator const& ) const { return true; }
+    bool operator!=( counting_allocator const& ) const { return false; }
+};
+
+struct compact_hash: boost::hash<std::uint64_t>
+{
+    using prefers_compact_growth = void;
+};
+
+template<class Hash> using map_type = boost::unordered_flat_map<
+    std::uint64_t, std::uint64_t, Hash, std::equal_to<std::uint64_t>,
+    counting_allocator<std::pair<std::uint64_t const, std::uint64_t>>>;
+
+template<class Map> BOOST_NOINLINE void test( char const* label, std::size_t n )
+{
+    memory_used = peak_memory_used = 0;
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    Map map;
+    for( std::size_t i = 0; i < n; ++i ) map.emplace( indices1[ i ], i );
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::uint64_t s = 0;
+
+    for( int k = 0; k < K; ++k )
+    {
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            auto it = map.find( indices1[ i ] );
+            if( it != map.end() ) s += it->second;
+        }
+    }
+
+    auto t3 = std::chrono::steady_clock::now();
+
+    for( int k = 0; k < K; ++k )
+    {
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            auto it = map.find( indices2[ i ] );
+            if( it != map.end() ) s += it->second;
+        }
+    }
+
+    auto t4 = std::chrono::steady_clock::now();
+
+    std::cout
+        << std::setw( 10 ) << label
+        << std::setw( 10 ) << n
+        << std::setw( 11 ) << ( t2 - t1 ) / 1ms
+        << std::setw( 11 ) << ( t3 - t2 ) / 1ms
+        << std::setw( 11 ) << ( t4 - t3 ) / 1ms
+        << std::setw( 9 ) << std::fixed << std::setprecision( 3 ) << map.load_factor()
+        << std::setw( 10 ) << memory_used / 1024 / 1024
+        << std::setw( 10 ) << peak_memory_used / 1024 / 1024
+        << " (s=" << s << ")\n";
+}
+
+int main()
+{
+    init_indices();
+
+    std::cout
+        << "    growth         n  insert ms   found ms unfound ms     load    mem MB   peak MB\n";
+
+    // sizes right after (load ~0.5 vs. ~0.8) and right before (same load)
+    // a power-of-two rehash
+
+    for( std::size_t n: { N / 16, N * 3 / 32, N / 4, N * 3 / 8, N / 2, N * 3 / 4 } )
+    {
+        test<map_type<boost::hash<std::uint64_t>>>( "pow2", n );
+        test<map_type<compact_hash>>( "compact", n );
+    }
+}
@@ -0,0 +1,218 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Lookup throughput of boost::concurrent_flat_cache against a
+// boost::concurrent_flat_map with an external LRU list protected by a mutex,
+// which every hit has to lock to move the element to the front. Keys follow
+// a skewed distribution so that most lookups are hits; misses insert the
+// key, evicting another one if the cache is full.
+
+#define _SILENCE_CXX17_OLD_ALLOCATOR_MEMBERS_DEPRECATION_WARNING
+#define _SILENCE_CXX20_CISO646_REMOVED_WARNING
+
+#include <boost/unordered/concurrent_flat_cache.hpp>
+#include <boost/unordered/concurrent_flat_map.hpp>
+#include <boost/core/detail/splitmix64.hpp>
+#include <boost/config.hpp>
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+
+using namespace std::chrono_literals;
+
+constexpr std::size_t L = 1'000'000; // cache size limit
+constexpr std::uint64_t K = 4'000'000; // key space
+constexpr unsigned M = 4'000'000; // lookups per thread
+
+class lru_map
+{
+    using list_type = std::list<std::uint64_t>;
+    using map_type = boost::concurrent_flat_map<std::uint64_t, std::pair<std::uint64_t, list_type::iterator>>;
+
+    map_type map_;
+    list_type list_;
+    std::mutex mutex_;
+    std::size_t limit_;
+
+public:
+
+    explicit lru_map( std::size_t limit ): limit_( limit )
+    {
+        map_.reserve( limit );
+    }
+
+    bool lookup( std::uint64_t k, std::uint64_t& v )
+    {
+        return map_.visit( k, [&]( map_type::value_type& x ){
+
+            v = x.second.first;
+
+            std::lock_guard<std::mutex> lock( mutex_ );
+            list_.splice( list_.begin(), list_, x.second.second );
+        });
+    }
+
+    void insert( std::uint64_t k, std::uint64_t v )
+    {
+        list_type::iterator it;
+
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
+
+            list_.push_front( k );
+            it = list_.begin();
+        }
+
+        if( !map_.emplace( k, std::make_pair( v, it ) ) )
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            list_.erase( it );
+            return;
+        }
+
+        while( map_.size() > limit_ )
+        {
+            std::uint64_t k2;
+
+            {
+                std::lock_guard<std::mutex> lock( mutex_ );
+                k2 = list_.back();
+            }
+
+            // the mutex is locked within the element's group lock, as in
+            // lookup, and the element may have been used in the meantime
+
+            auto n = map_.erase_if( k2, [&]( map_type::value_type& x ){
+
+                std::lock_guard<std::mutex> lock( mutex_ );
+
+                if( x.second.second != std::prev( list_.end() ) ) return false;
+
+                list_.erase( x.second.second );
+                return true;
+            });
+
+            if( n == 0 ) break;
+        }
+    }
+
+    std::size_t size() const
+    {
+        return map_.size();
+    }
+};
+
+class clock_cache
+{
+    boost::concurrent_flat_cache<std::uint64_t, std::uint64_t> cache_;
+
+public:
+
+    explicit clock_cache( std::size_t limit ): cache_( limit )
+    {
+    }
+
+    bool lookup( std::uint64_t k, std::uint64_t& v )
+    {
+        return cache_.cvisit( k, [&]( std::pair<std::uint64_t const, std::uint64_t> const& x ){ v = x.second; } );
+    }
+
+    void insert( std::uint64_t k, std::uint64_t v )
+    {
+        cache_.emplace( k, v );
+    }
+
+    std::size_t size() const
+    {
+        return cache_.size();
+    }
+};
+
+// approximately Zipf-distributed keys with exponent 1, scrambled
+
+static std::uint64_t skewed_key( boost::detail::splitmix64& rng )
+{
+    double u = static_cast<double>( rng() >> 11 ) * 0x1.0p-53;
+    auto r = static_cast<std::uint64_t>( std::pow( static_cast<double>( K ), u ) ) - 1;
+
+    return ( r * 0x9E3779B97F4A7C15ull ) ^ ( r >> 7 );
+}
+
+template<class Cache> void test( char const* label, unsigned T )
+{
+    Cache cache( L );
+
+    {
+        boost::detail::splitmix64 rng( 0 );
+
+        for( std::size_t i = 0; i < 2 * L; ++i )
+        {
+            auto k = skewed_key( rng );
+            cache.insert( k, k );
+        }
+    }
+
+    std::atomic<std::uint64_t> hits{ 0 };
+    std::vector<std::thread> threads;
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    for( unsigned t = 0; t < T; ++t )
+    {
+        threads.emplace_back( [&, t]{
+
+            boost::detail::splitmix64 rng( t + 1 );
+            std::uint64_t h = 0, v = 0;
+
+            for( unsigned i = 0; i < M; ++i )
+            {
+                auto k = skewed_key( rng );
+
+                if( cache.lookup( k, v ) )
+                {
+                    ++h;
+                }
+                else
+                {
+                    cache.insert( k, k );
+                }
+            }
+
+            hits += h;
+        });
+    }
+
+    for( auto& th: threads ) th.join();
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    auto n = static_cast<double>( T ) * M;
+    auto s = std::chrono::duration<double>( t2 - t1 ).count();
+
+    std::cout << label << ", " << T << " threads: " << n / s / 1e6 << " Mlookups/s, "
+        << 100.0 * static_cast<double>( hits ) / n << "% hits, size " << cache.size() << std::endl;
+}
+
+int main()
+{
+    unsigned threads[] = { 1, 2, 4, 8, 16 };
+
+    for( unsigned T: threads )
+    {
+        if( T > 1 && T > 2 * std::thread::hardware_concurrency() ) break;
+
+        test<lru_map>( "concurrent_flat_map + mutex LRU list", T );
+        test<clock_cache>( "concurrent_flat_cache (CLOCK)", T );
+
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,179 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Lookup latency of boost::concurrent_flat_map while writer threads make it
+// grow from empty. Build twice, with and without
+// -DBOOST_UNORDERED_ENABLE_INCREMENTAL_REHASH, and compare the tails.
+
+#define _SILENCE_CXX17_OLD_ALLOCATOR_MEMBERS_DEPRECATION_WARNING
+#define _SILENCE_CXX20_CISO646_REMOVED_WARNING
+
+#include <boost/unordered/concurrent_flat_map.hpp>
+#include <boost/core/detail/splitmix64.hpp>
+#include <boost/config.hpp>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+constexpr unsigned N = 8'000'000; // final size
+constexpr unsigned W = 4; // writer threads
+constexpr unsigned R = 4; // reader threads
+constexpr unsigned B = 40; // histogram buckets, bucket i covers [2^i, 2^(i+1)) ns
+
+using map_type = boost::concurrent_flat_map<std::uint64_t, std::uint64_t>;
+
+struct histogram
+{
+    std::uint64_t count[ B ] = {};
+    std::uint64_t max = 0;
+
+    void add( std::uint64_t ns )
+    {
+        unsigned i = 0;
+        while( i < B - 1 && ( ns >> ( i + 1 ) ) ) ++i;
+
+        ++count[ i ];
+        max = (std::max)( max, ns );
+    }
+
+    void merge( histogram const& h )
+    {
+        for( unsigned i = 0; i < B; ++i ) count[ i ] += h.count[ i ];
+        max = (std::max)( max, h.max );
+    }
+
+    std::uint64_t total() const
+    {
+        std::uint64_t s = 0;
+        for( unsigned i = 0; i < B; ++i ) s += count[ i ];
+        return s;
+    }
+
+    // upper bound of the bucket holding the given quantile
+    std::uint64_t percentile( double q ) const
+    {
+        auto target = static_cast<std::uint64_t>( q * static_cast<double>( total() ) );
+        std::uint64_t s = 0;
+
+        for( unsigned i = 0; i < B; ++i )
+        {
+            s += count[ i ];
+            if( s > target ) return std::uint64_t( 1 ) << ( i + 1 );
+        }
+
+        return max;
+    }
+};
+
+static void print( char const* label, histogram const& h )
+{
+    std::cout << label << ": " << h.total() << " lookups\n";
+
+    std::cout << "  p50 < " << h.percentile( 0.5 ) << " ns, p99 < " << h.percentile( 0.99 )
+        << " ns, p99.9 < " << h.percentile( 0.999 ) << " ns, p99.99 < " << h.percentile( 0.9999 )
+        << " ns, max = " << h.max << " ns\n";
+
+    for( unsigned i = 0; i < B; ++i )
+    {
+        if( h.count[ i ] == 0 ) continue;
+
+        std::cout << "  [" << std::setw( 11 ) << ( std::uint64_t( 1 ) << i ) << ", "
+            << std::setw( 11 ) << ( std::uint64_t( 1 ) << ( i + 1 ) ) << ") ns: "
+            << std::setw( 11 ) << h.count[ i ] << "\n";
+    }
+}
+
+int main()
+{
+    std::vector< std::uint64_t > keys( N );
+
+    {
+        boost::detail::splitmix64 rng;
+        for( auto& k: keys ) k = rng();
+    }
+
+    map_type map;
+
+    // readers only look for keys already inserted by the writers, slowest
+    // writer determines how far that is
+
+    std::atomic< unsigned > progress[ W ];
+    for( auto& p: progress ) p = 0;
+
+    std::atomic< bool > done{ false };
+    std::vector< histogram > hs( R );
+    std::vector< std::thread > threads;
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    for( unsigned w = 0; w < W; ++w )
+    {
+        threads.emplace_back( [&, w]{
+
+            for( unsigned i = w; i < N; i += W )
+            {
+                map.emplace( keys[ i ], i );
+                if( i % 1024 < W ) progress[ w ].store( i / W, std::memory_order_release );
+            }
+
+            progress[ w ].store( N / W, std::memory_order_release );
+        });
+    }
+
+    for( unsigned r = 0; r < R; ++r )
+    {
+        threads.emplace_back( [&, r]{
+
+            boost::detail::splitmix64 rng( r );
+            histogram& h = hs[ r ];
+            std::uint64_t s = 0;
+
+            while( !done.load( std::memory_order_relaxed ) )
+            {
+                unsigned m = N / W;
+                for( auto& p: progress ) m = (std::min)( m, p.load( std::memory_order_acquire ) );
+
+                if( m == 0 ) continue;
+
+                auto i = static_cast<unsigned>( rng() % m ) * W + static_cast<unsigned>( rng() % W );
+
+                auto t2 = std::chrono::steady_clock::now();
+                map.cvisit( keys[ i ], [&]( map_type::value_type const& x ){ s += x.second; } );
+                auto t3 = std::chrono::steady_clock::now();
+
+                h.add( static_cast<std::uint64_t>( ( t3 - t2 ) / 1ns ) );
+            }
+
+            if( s == 0 ) std::cout << "";
+        });
+    }
+
+    for( unsigned w = 0; w < W; ++w ) threads[ w ].join();
+
+    auto t4 = std::chrono::steady_clock::now();
+
+    done = true;
+    for( unsigned r = 0; r < R; ++r ) threads[ W + r ].join();
+
+#if defined(BOOST_UNORDERED_ENABLE_INCREMENTAL_REHASH)
+    char const* label = "incremental rehash";
+#else
+    char const* label = "stop-the-world rehash";
+#endif
+
+    std::cout << label << ", " << W << " writers, " << R << " readers: "
+        << map.size() << " elements inserted in " << ( t4 - t1 ) / 1ms << " ms\n\n";
+
+    histogram h;
+    for( auto const& x: hs ) h.merge( x );
+
+    print( "cvisit", h );
+}
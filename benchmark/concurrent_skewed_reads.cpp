@@ -0,0 +1,103 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Lookup throughput of boost::concurrent_flat_map under a read-mostly,
+// skewed workload (most lookups hit a few hot keys) for 1 to 64 threads.
+// Build twice, with and without -DBOOST_UNORDERED_ENABLE_OPTIMISTIC_READS,
+// and compare.
+
+#define _SILENCE_CXX17_OLD_ALLOCATOR_MEMBERS_DEPRECATION_WARNING
+#define _SILENCE_CXX20_CISO646_REMOVED_WARNING
+
+#include <boost/unordered/concurrent_flat_map.hpp>
+#include <boost/core/detail/splitmix64.hpp>
+#include <boost/config.hpp>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+constexpr unsigned N = 1'000'000; // map size
+constexpr unsigned H = 64; // hot keys
+constexpr unsigned K = 20'000'000; // total operations, split among threads
+constexpr unsigned U = 1000; // one update every U operations
+
+using map_type = boost::concurrent_flat_map<std::uint64_t, std::uint64_t>;
+
+static void test( map_type& map, std::vector< std::uint64_t > const& keys, unsigned T )
+{
+    std::vector< std::thread > threads;
+    std::vector< std::uint64_t > sums( T );
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    for( unsigned t = 0; t < T; ++t )
+    {
+        threads.emplace_back( [&, t]{
+
+            boost::detail::splitmix64 rng( t );
+            std::uint64_t s = 0;
+
+            for( unsigned i = 0; i < K / T; ++i )
+            {
+                auto r = rng();
+
+                // 90% of lookups go to the hot keys
+                auto j = r % 10 != 0? ( r >> 8 ) % H: ( r >> 8 ) % N;
+
+                if( i % U == 0 )
+                {
+                    map.visit( keys[ j ], []( map_type::value_type& x ){ ++x.second; } );
+                }
+                else
+                {
+                    map.cvisit( keys[ j ], [&]( map_type::value_type const& x ){ s += x.second; } );
+                }
+            }
+
+            sums[ t ] = s;
+        });
+    }
+
+    for( auto& th: threads ) th.join();
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::uint64_t s = 0;
+    for( auto x: sums ) s += x;
+
+    std::cout << std::setw( 2 ) << T << " threads: " << std::setw( 6 ) << ( t2 - t1 ) / 1ms << " ms (" << s << ")\n";
+}
+
+int main()
+{
+    std::vector< std::uint64_t > keys( N );
+
+    {
+        boost::detail::splitmix64 rng;
+        for( auto& k: keys ) k = rng();
+    }
+
+    map_type map;
+    map.reserve( N );
+
+    for( unsigned i = 0; i < N; ++i ) map.emplace( keys[ i ], i );
+
+#if defined(BOOST_UNORDERED_ENABLE_OPTIMISTIC_READS)
+    std::cout << "optimistic reads, ";
+#else
+    std::cout << "locked reads, ";
+#endif
+
+    std::cout << K << " operations, " << 100.0 / U << "% updates\n\n";
+
+    for( unsigned T = 1; T <= 64; T *= 2 )
+    {
+        test( map, keys, T );
+    }
+}
@@ -0,0 +1,188 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Writer latency of boost::concurrent_flat_map while another thread copies
+// it, either with the copy constructor (which blocks the container for the
+// whole copy) or with snapshot().
+
+#define _SILENCE_CXX17_OLD_ALLOCATOR_MEMBERS_DEPRECATION_WARNING
+#define _SILENCE_CXX20_CISO646_REMOVED_WARNING
+
+#include <boost/unordered/concurrent_flat_map.hpp>
+#include <boost/core/detail/splitmix64.hpp>
+#include <boost/config.hpp>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+constexpr unsigned N = 8'000'000; // initial size
+constexpr unsigned W = 4; // writer threads
+constexpr unsigned S = 5; // copies
+constexpr unsigned B = 40; // histogram buckets, bucket i covers [2^i, 2^(i+1)) ns
+
+using map_type = boost::concurrent_flat_map<std::uint64_t, std::uint64_t>;
+
+struct histogram
+{
+    std::uint64_t count[ B ] = {};
+    std::uint64_t max = 0;
+
+    void add( std::uint64_t ns )
+    {
+        unsigned i = 0;
+        while( i < B - 1 && ( ns >> ( i + 1 ) ) ) ++i;
+
+        ++count[ i ];
+        max = (std::max)( max, ns );
+    }
+
+    void merge( histogram const& h )
+    {
+        for( unsigned i = 0; i < B; ++i ) count[ i ] += h.count[ i ];
+        max = (std::max)( max, h.max );
+    }
+
+    std::uint64_t total() const
+    {
+        std::uint64_t s = 0;
+        for( unsigned i = 0; i < B; ++i ) s += count[ i ];
+        return s;
+    }
+
+    // upper bound of the bucket holding the given quantile
+    std::uint64_t percentile( double q ) const
+    {
+        auto target = static_cast<std::uint64_t>( q * static_cast<double>( total() ) );
+        std::uint64_t s = 0;
+
+        for( unsigned i = 0; i < B; ++i )
+        {
+            s += count[ i ];
+            if( s > target ) return std::uint64_t( 1 ) << ( i + 1 );
+        }
+
+        return max;
+    }
+};
+
+static void print( char const* label, histogram const& h )
+{
+    std::cout << label << ": " << h.total() << " writes\n";
+
+    std::cout << "  p50 < " << h.percentile( 0.5 ) << " ns, p99 < " << h.percentile( 0.99 )
+        << " ns, p99.9 < " << h.percentile( 0.999 ) << " ns, p99.99 < " << h.percentile( 0.9999 )
+        << " ns, max = " << h.max << " ns\n";
+
+    for( unsigned i = 0; i < B; ++i )
+    {
+        if( h.count[ i ] == 0 ) continue;
+
+        std::cout << "  [" << std::setw( 11 ) << ( std::uint64_t( 1 ) << i ) << ", "
+            << std::setw( 11 ) << ( std::uint64_t( 1 ) << ( i + 1 ) ) << ") ns: "
+            << std::setw( 11 ) << h.count[ i ] << "\n";
+    }
+}
+
+template<class F> void test( char const* label, std::vector< std::uint64_t > const& keys, F copy )
+{
+    map_type map;
+
+    // the table does not grow during the test, so that writers only wait on
+    // copies
+
+    map.reserve( 2 * N );
+    for( unsigned i = 0; i < N; ++i ) map.emplace( keys[ i ], i );
+
+    std::atomic< bool > done{ false };
+    std::vector< histogram > hs( W );
+    std::vector< std::thread > threads;
+
+    for( unsigned w = 0; w < W; ++w )
+    {
+        threads.emplace_back( [&, w]{
+
+            boost::detail::splitmix64 rng( w );
+            histogram& h = hs[ w ];
+
+            while( !done.load( std::memory_order_relaxed ) )
+            {
+                auto r = rng();
+                auto i = static_cast<unsigned>( r % N );
+
+                auto t2 = std::chrono::steady_clock::now();
+
+                if( r & 0x100000000 )
+                {
+                    map.visit( keys[ i ], []( map_type::value_type& x ){ ++x.second; } );
+                }
+                else if( r & 0x200000000 )
+                {
+                    map.emplace( keys[ N + i % ( N / 2 ) ], i ); // fresh key, the first time
+                }
+                else
+                {
+                    map.erase( keys[ N + i % ( N / 2 ) ] );
+                }
+
+                auto t3 = std::chrono::steady_clock::now();
+
+                h.add( static_cast<std::uint64_t>( ( t3 - t2 ) / 1ns ) );
+            }
+        });
+    }
+
+    std::this_thread::sleep_for( 200ms );
+
+    std::size_t s = 0;
+    auto t1 = std::chrono::steady_clock::now();
+
+    for( unsigned j = 0; j < S; ++j )
+    {
+        s += copy( map );
+        std::this_thread::sleep_for( 100ms );
+    }
+
+    auto t4 = std::chrono::steady_clock::now();
+
+    done = true;
+    for( auto& t: threads ) t.join();
+
+    std::cout << label << ": " << S << " copies of " << s / S << " elements in "
+        << ( t4 - t1 - S * 100ms ) / 1ms << " ms\n";
+
+    histogram h;
+    for( auto const& x: hs ) h.merge( x );
+
+    print( label, h );
+    std::cout << std::endl;
+}
+
+int main()
+{
+    std::vector< std::uint64_t > keys( N + N / 2 );
+
+    {
+        boost::detail::splitmix64 rng;
+        for( auto& k: keys ) k = rng();
+    }
+
+    test( "copy constructor", keys, []( map_type const& map ){
+
+        map_type copy( map );
+        return copy.size();
+    });
+
+    test( "snapshot", keys, []( map_type const& map ){
+
+        auto copy = map.snapshot();
+        return copy.size();
+    });
+}
@@ -0,0 +1,108 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Key comparisons and lookup throughput of boost::unordered_flat_map and
+// boost::unordered_node_map with long string keys sharing a common prefix.
+// Build twice, with and without -DBOOST_UNORDERED_ENABLE_16BIT_FINGERPRINTS,
+// and compare.
+
+#define _SILENCE_CXX17_OLD_ALLOCATOR_MEMBERS_DEPRECATION_WARNING
+#define _SILENCE_CXX20_CISO646_REMOVED_WARNING
+
+#include <boost/unordered/unordered_flat_map.hpp>
+#include <boost/unordered/unordered_node_map.hpp>
+#include <boost/core/detail/splitmix64.hpp>
+#include <boost/config.hpp>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+constexpr unsigned N = 1'000'000;
+constexpr int K = 10;
+
+static std::vector<std::string> indices1, indices2;
+
+static std::string make_index( std::uint64_t x )
+{
+    char buffer[ 128 ];
+    std::snprintf( buffer, sizeof(buffer), "/usr/local/share/application/resources/%016llx.dat", static_cast<unsigned long long>( x ) );
+
+    return buffer;
+}
+
+static void init_indices()
+{
+    boost::detail::splitmix64 rng;
+
+    indices1.reserve( N );
+    for( unsigned i = 0; i < N; ++i ) indices1.push_back( make_index( rng() ) );
+
+    indices2.reserve( N );
+    for( unsigned i = 0; i < N; ++i ) indices2.push_back( make_index( rng() ) );
+}
+
+static std::uint64_t num_comparisons = 0;
+
+struct counting_equal_to
+{
+    bool operator()( std::string const& x, std::string const& y ) const
+    {
+        ++num_comparisons;
+        return x == y;
+    }
+};
+
+template<class Map> BOOST_NOINLINE void test( char const* label )
+{
+    std::cout << label << ":\n\n";
+
+    Map map;
+    for( unsigned i = 0; i < N; ++i ) map.emplace( indices1[ i ], i );
+
+    for( auto const* indices: { &indices1, &indices2 } )
+    {
+        num_comparisons = 0;
+        std::uint32_t s = 0;
+
+        auto t1 = std::chrono::steady_clock::now();
+
+        for( int j = 0; j < K; ++j )
+        {
+            for( auto const& x: *indices )
+            {
+                auto it = map.find( x );
+                if( it != map.end() ) s += it->second;
+            }
+        }
+
+        auto t2 = std::chrono::steady_clock::now();
+
+        std::cout
+            << ( indices == &indices1? "  Successful lookup:   ": "  Unsuccessful lookup: " )
+            << std::setw( 5 ) << ( t2 - t1 ) / 1ms << " ms, "
+            << std::setprecision( 4 ) << double( num_comparisons ) / ( double( N ) * K ) << " comparisons/lookup (s=" << s << ")\n";
+    }
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    init_indices();
+
+#if defined(BOOST_UNORDERED_ENABLE_16BIT_FINGERPRINTS)
+    std::cout << "16-bit fingerprints\n\n";
+#else
+    std::cout << "8-bit fingerprints\n\n";
+#endif
+
+    test<boost::unordered_flat_map<std::string, std::uint32_t, boost::hash<std::string>, counting_equal_to>>( "boost::unordered_flat_map" );
+    test<boost::unordered_node_map<std::string, std::uint32_t, boost::hash<std::string>, counting_equal_to>>( "boost::unordered_node_map" );
+}
@@ -0,0 +1,96 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Random lookup throughput on a large boost::unordered_flat_map, dominated
+// by TLB misses with regular pages. Build twice, with and without
+// -DBOOST_UNORDERED_ENABLE_HUGE_PAGES, and compare (Linux, transparent huge
+// pages set to "madvise" or "always" in
+// /sys/kernel/mm/transparent_hugepage/enabled).
+
+#define _SILENCE_CXX17_OLD_ALLOCATOR_MEMBERS_DEPRECATION_WARNING
+#define _SILENCE_CXX20_CISO646_REMOVED_WARNING
+
+#include <boost/unordered/unordered_flat_map.hpp>
+#include <boost/core/detail/splitmix64.hpp>
+#include <boost/config.hpp>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+constexpr unsigned N = 50'000'000;
+constexpr unsigned M = 20'000'000;
+constexpr int K = 5;
+
+static std::vector<std::uint64_t> indices1, indices2;
+
+static void init_indices()
+{
+    boost::detail::splitmix64 rng;
+
+    indices1.reserve( N );
+    for( unsigned i = 0; i < N; ++i ) indices1.push_back( rng() );
+
+    indices2.reserve( M );
+    for( unsigned i = 0; i < M; ++i ) indices2.push_back( indices1[ rng() % N ] );
+}
+
+// memory backed by transparent huge pages, as reported by the kernel
+
+static std::string anon_huge_pages()
+{
+    std::ifstream is( "/proc/self/smaps_rollup" );
+    std::string line;
+
+    while( std::getline( is, line ) )
+    {
+        if( line.compare( 0, 14, "AnonHugePages:" ) == 0 ) return line.substr( 14 );
+    }
+
+    return " n/a";
+}
+
+int main()
+{
+#if defined(BOOST_UNORDERED_HUGE_PAGES)
+    std::cout << "boost::unordered_flat_map, huge pages enabled\n\n";
+#else
+    std::cout << "boost::unordered_flat_map, regular pages\n\n";
+#endif
+
+    init_indices();
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    boost::unordered_flat_map<std::uint64_t, std::uint64_t> map;
+    map.reserve( N );
+    for( unsigned i = 0; i < N; ++i ) map.emplace( indices1[ i ], i );
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << "  Insertion:      " << std::setw( 6 ) << ( t2 - t1 ) / 1ms << " ms\n";
+
+    std::uint64_t s = 0;
+
+    for( int k = 0; k < K; ++k )
+    {
+        for( unsigned i = 0; i < M; ++i )
+        {
+            auto it = map.find( indices2[ i ] );
+            if( it != map.end() ) s += it->second;
+        }
+    }
+
+    auto t3 = std::chrono::steady_clock::now();
+
+    std::cout << "  Random lookup:  " << std::setw( 6 ) << ( t3 - t2 ) / 1ms << " ms (s=" << s << ")\n";
+
+    std::cout << "  Bucket array:   " << std::setw( 6 ) << map.bucket_count() * sizeof( std::uint64_t[ 2 ] ) / 1024 / 1024 << " MB\n";
+    std::cout << "  AnonHugePages: " << anon_huge_pages() << "\n";
+}
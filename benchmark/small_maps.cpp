@@ -0,0 +1,84 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Construction, lookup and destruction of many tiny maps (0-8 elements),
+// boost::unordered_flat_map vs. boost::small_unordered_flat_map.
+
+#define _SILENCE_CXX17_OLD_ALLOCATOR_MEMBERS_DEPRECATION_WARNING
+#define _SILENCE_CXX20_CISO646_REMOVED_WARNING
+
+#include <boost/unordered/unordered_flat_map.hpp>
+#include <boost/unordered/small_unordered_flat_map.hpp>
+#include <boost/core/detail/splitmix64.hpp>
+#include <boost/config.hpp>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+constexpr unsigned N = 1'000'000;
+constexpr int K = 10;
+
+static std::vector<std::uint32_t> sizes;
+
+static void init_sizes()
+{
+    boost::detail::splitmix64 rng;
+
+    sizes.reserve( N );
+    for( unsigned i = 0; i < N; ++i ) sizes.push_back( static_cast<std::uint32_t>( rng() % 9 ) );
+}
+
+template<class Map> BOOST_NOINLINE void test( char const* label )
+{
+    std::cout << label << " (sizeof " << sizeof( Map ) << "):\n\n";
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::vector<Map> maps( N );
+    for( unsigned i = 0; i < N; ++i )
+    {
+        for( std::uint32_t j = 0; j < sizes[ i ]; ++j ) maps[ i ].emplace( j * 0x9E3779B9u, j );
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << "  Construction: " << std::setw( 5 ) << ( t2 - t1 ) / 1ms << " ms\n";
+
+    std::uint32_t s = 0;
+
+    for( int k = 0; k < K; ++k )
+    {
+        for( auto const& map: maps )
+        {
+            for( std::uint32_t j = 0; j < 8; ++j )
+            {
+                auto it = map.find( j * 0x9E3779B9u );
+                if( it != map.end() ) s += it->second;
+            }
+        }
+    }
+
+    auto t3 = std::chrono::steady_clock::now();
+
+    std::cout << "  Lookup:       " << std::setw( 5 ) << ( t3 - t2 ) / 1ms << " ms (s=" << s << ")\n";
+
+    maps.clear();
+    maps.shrink_to_fit();
+
+    auto t4 = std::chrono::steady_clock::now();
+
+    std::cout << "  Destruction:  " << std::setw( 5 ) << ( t4 - t3 ) / 1ms << " ms\n\n";
+}
+
+int main()
+{
+    init_sizes();
+
+    test<boost::unordered_flat_map<std::uint32_t, std::uint32_t>>( "boost::unordered_flat_map" );
+    test<boost::small_unordered_flat_map<std::uint32_t, std::uint32_t>>( "boost::small_unordered_flat_map" );
+}
@@ -0,0 +1,120 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Insertion and successful/unsuccessful lookup with large mapped values and
+// with padded std::pair<std::uint64_t, std::uint32_t> elements,
+// boost::unordered_flat_map vs. boost::split_unordered_flat_map.
+
+#define _SILENCE_CXX17_OLD_ALLOCATOR_MEMBERS_DEPRECATION_WARNING
+#define _SILENCE_CXX20_CISO646_REMOVED_WARNING
+
+#include <boost/unordered/unordered_flat_map.hpp>
+#include <boost/unordered/split_unordered_flat_map.hpp>
+#include <boost/core/detail/splitmix64.hpp>
+#include <boost/config.hpp>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+constexpr unsigned N = 2'000'000;
+constexpr int K = 10;
+
+static std::vector<std::uint64_t> indices1, indices2;
+
+static void init_indices()
+{
+    boost::detail::splitmix64 rng;
+
+    indices1.reserve( N );
+    for( unsigned i = 0; i < N; ++i ) indices1.push_back( rng() );
+
+    indices2.reserve( N );
+    for( unsigned i = 0; i < N; ++i ) indices2.push_back( rng() );
+}
+
+template<std::size_t Size> struct payload
+{
+    std::array<std::uint32_t, Size / 4> data;
+
+    payload() = default;
+    explicit payload( std::uint32_t x ) { data.fill( x ); }
+};
+
+inline std::uint32_t first_word( std::uint32_t x ) { return x; }
+
+template<std::size_t Size> inline std::uint32_t first_word( payload<Size> const& x )
+{
+    return x.data[ 0 ];
+}
+
+// bytes_per_bucket: size of the element, or of the key plus the mapped value
+
+template<class Map> BOOST_NOINLINE void test( char const* label, std::size_t bytes_per_bucket )
+{
+    using mapped_type = typename Map::mapped_type;
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    Map map;
+    for( unsigned i = 0; i < N; ++i ) map.emplace( indices1[ i ], mapped_type( i ) );
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::uint32_t s = 0;
+
+    for( int k = 0; k < K; ++k )
+    {
+        for( unsigned i = 0; i < N; ++i )
+        {
+            auto it = map.find( indices1[ i ] );
+            if( it != map.end() ) s += first_word( it->second );
+        }
+    }
+
+    auto t3 = std::chrono::steady_clock::now();
+
+    for( int k = 0; k < K; ++k )
+    {
+        for( unsigned i = 0; i < N; ++i )
+        {
+            auto it = map.find( indices2[ i ] );
+            if( it != map.end() ) s += first_word( it->second );
+        }
+    }
+
+    auto t4 = std::chrono::steady_clock::now();
+
+    std::size_t mem = map.bucket_count() * bytes_per_bucket;
+
+    std::cout << "  " << std::left << std::setw( 28 ) << label << std::right
+        << std::setw( 6 ) << ( t2 - t1 ) / 1ms << " ms insert, "
+        << std::setw( 6 ) << ( t3 - t2 ) / 1ms << " ms hits, "
+        << std::setw( 6 ) << ( t4 - t3 ) / 1ms << " ms misses, "
+        << std::setw( 5 ) << mem / 1024 / 1024 << " MB (s=" << s << ")\n";
+}
+
+template<class T> void test_mapped( char const* label )
+{
+    std::cout << label << ":\n";
+
+    test< boost::unordered_flat_map<std::uint64_t, T> >( "unordered_flat_map", sizeof( std::pair<std::uint64_t const, T> ) );
+    test< boost::split_unordered_flat_map<std::uint64_t, T> >( "split_unordered_flat_map", sizeof( std::uint64_t ) + sizeof( T ) );
+
+    std::cout << "\n";
+}
+
+int main()
+{
+    init_indices();
+
+    test_mapped<std::uint32_t>( "<std::uint64_t, std::uint32_t>" );
+    test_mapped< payload<64> >( "<std::uint64_t, 64-byte payload>" );
+    test_mapped< payload<128> >( "<std::uint64_t, 128-byte payload>" );
+    test_mapped< payload<256> >( "<std::uint64_t, 256-byte payload>" );
+}
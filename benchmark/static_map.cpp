@@ -0,0 +1,134 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Lookup tables of M std::uint64_t keys: successful/unsuccessful lookup and
+// startup (building the table), boost::unordered_flat_map populated at
+// run time vs. a constexpr boost::static_flat_map.
+
+#define _SILENCE_CXX17_OLD_ALLOCATOR_MEMBERS_DEPRECATION_WARNING
+#define _SILENCE_CXX20_CISO646_REMOVED_WARNING
+
+#include <boost/unordered/unordered_flat_map.hpp>
+#include <boost/unordered/static_flat_map.hpp>
+#include <boost/core/detail/splitmix64.hpp>
+#include <boost/config.hpp>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <utility>
+
+using namespace std::chrono_literals;
+
+constexpr unsigned N = 2'000'000;
+constexpr int K = 10;
+
+constexpr std::uint64_t key( std::size_t i )
+{
+    // splitmix64 output for state i
+    std::uint64_t z = ( i + 1 ) * 0x9e3779b97f4a7c15ull;
+    z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ull;
+    z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebull;
+    return z ^ ( z >> 31 );
+}
+
+template<std::size_t... I> constexpr auto make_table( std::index_sequence<I...> )
+{
+    return boost::static_flat_map<std::uint64_t, std::uint32_t, sizeof...( I )>( { { key( I ), static_cast<std::uint32_t>( I ) }... } );
+}
+
+template<std::size_t M> struct tables
+{
+    static constexpr auto static_table = make_table( std::make_index_sequence<M>() );
+};
+
+static std::vector<std::uint64_t> indices1, indices2;
+
+template<std::size_t M> static void init_indices()
+{
+    boost::detail::splitmix64 rng;
+
+    indices1.clear();
+    indices1.reserve( N );
+    for( unsigned i = 0; i < N; ++i ) indices1.push_back( key( rng() % M ) );
+
+    indices2.clear();
+    indices2.reserve( N );
+    for( unsigned i = 0; i < N; ++i ) indices2.push_back( rng() );
+}
+
+template<class Map> BOOST_NOINLINE void test_lookup( char const* label, Map const& map, double startup_us )
+{
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::uint32_t s = 0;
+
+    for( int k = 0; k < K; ++k )
+    {
+        for( unsigned i = 0; i < N; ++i )
+        {
+            auto it = map.find( indices1[ i ] );
+            if( it != map.end() ) s += it->second;
+        }
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    for( int k = 0; k < K; ++k )
+    {
+        for( unsigned i = 0; i < N; ++i )
+        {
+            auto it = map.find( indices2[ i ] );
+            if( it != map.end() ) s += it->second;
+        }
+    }
+
+    auto t3 = std::chrono::steady_clock::now();
+
+    std::cout << "  " << std::left << std::setw( 20 ) << label << std::right
+        << std::setw( 10 ) << std::fixed << std::setprecision( 2 ) << startup_us << " us startup, "
+        << std::setw( 6 ) << ( t2 - t1 ) / 1ms << " ms hits, "
+        << std::setw( 6 ) << ( t3 - t2 ) / 1ms << " ms misses (s=" << s << ")\n";
+}
+
+template<std::size_t M> void test( char const* label )
+{
+    std::cout << label << ":\n";
+
+    init_indices<M>();
+
+    auto const& st = tables<M>::static_table;
+
+    // startup: the static table is constant-initialized, the dynamic one is
+    // built from the same elements (averaged over several builds)
+
+    constexpr int R = 100;
+
+    boost::unordered_flat_map<std::uint64_t, std::uint32_t> map;
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    for( int r = 0; r < R; ++r )
+    {
+        boost::unordered_flat_map<std::uint64_t, std::uint32_t> tmp( st.begin(), st.end() );
+        map.swap( tmp );
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    double startup_us = std::chrono::duration<double, std::micro>( t2 - t1 ).count() / R;
+
+    test_lookup( "unordered_flat_map", map, startup_us );
+    test_lookup( "static_flat_map", st, 0.0 );
+
+    std::cout << "\n";
+}
+
+int main()
+{
+    test<64>( "64 elements" );
+    test<1024>( "1024 elements" );
+    test<8192>( "8192 elements" );
+}
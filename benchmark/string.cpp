@@ -9,6 +9,7 @@
 #include <boost/unordered_map.hpp>
 #include <boost/unordered/unordered_node_map.hpp>
 #include <boost/unordered/unordered_flat_map.hpp>
+#include <boost/unordered/frozen_flat_map.hpp>
 #include <boost/core/detail/splitmix64.hpp>
 #include <boost/config.hpp>
 #ifdef HAVE_ABSEIL
@@ -264,6 +265,42 @@ template<template<class...> class Map> BOOST_NOINLINE void test( char const* lab
     times.push_back( rec );
 }
 
+// read-only lookup: the map is built, frozen and then only looked up;
+// the total includes freezing but not the insertions
+
+template<template<class...> class Map> BOOST_NOINLINE void test_frozen( char const* label )
+{
+    std::cout << label << ":\n\n";
+
+    Map<std::string, std::uint32_t> map;
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    test_insert( map, t1 );
+
+    s_alloc_bytes = 0;
+    s_alloc_count = 0;
+
+    auto t0 = t1;
+
+    auto frozen = boost::freeze( std::move( map ) );
+
+    print_time( t1, "Freeze", 0, frozen.size() );
+
+    std::cout << "\nMemory: " << s_alloc_bytes << " bytes in " << s_alloc_count << " allocations\n\n";
+
+    record rec = { label, 0, s_alloc_bytes, s_alloc_count };
+
+    test_lookup( frozen, t1 );
+    test_lookup( frozen, t1 );
+
+    auto tN = std::chrono::steady_clock::now();
+    std::cout << "Total: " << ( tN - t0 ) / 1ms << " ms\n\n";
+
+    rec.time_ = ( tN - t0 ) / 1ms;
+    times.push_back( rec );
+}
+
 // aliases using the counting allocator
 
 template<class K, class V> using allocator_for = ::allocator< std::pair<K const, V> >;
@@ -373,6 +410,40 @@ template<class K, class V> using ankerl_unordered_dense_map_fnv1a =
 
 #endif
 
+// stored hash values
+
+struct expensive_hash: boost::hash<std::string>
+{
+    using is_expensive = void;
+};
+
+// closed-addressing containers store hash values based on the key type;
+// lookups with std::string are heterogeneous so as not to construct keys
+
+struct stored_hash_string: std::string
+{
+    using std::string::string;
+    stored_hash_string( std::string const& s ): std::string( s ) {}
+};
+
+template<> struct boost::unordered::node_stores_hash<stored_hash_string>: std::true_type
+{
+};
+
+struct stored_hash_string_hash: boost::hash<std::string>
+{
+    using is_transparent = void;
+};
+
+template<class K, class V> using boost_unordered_map_stored_hash =
+    boost::unordered_map<stored_hash_string, V, stored_hash_string_hash, std::equal_to<>, allocator_for<stored_hash_string, V>>;
+
+template<class K, class V> using boost_unordered_node_map_stored_hash =
+    boost::unordered_node_map<K, V, expensive_hash, std::equal_to<K>, allocator_for<K, V>>;
+
+template<class K, class V> using boost_unordered_flat_map_stored_hash =
+    boost::unordered_flat_map<K, V, expensive_hash, std::equal_to<K>, allocator_for<K, V>>;
+
 //
 
 int main()
@@ -383,6 +454,7 @@ int main()
     test<boost_unordered_map>( "boost::unordered_map" );
     test<boost_unordered_node_map>( "boost::unordered_node_map" );
     test<boost_unordered_flat_map>( "boost::unordered_flat_map" );
+    test_frozen<boost_unordered_flat_map>( "boost::frozen_flat_map" );
 
 #ifdef HAVE_ANKERL_UNORDERED_DENSE
 
@@ -401,6 +473,11 @@ int main()
     test<boost_unordered_map_fnv1a>( "boost::unordered_map, FNV-1a" );
     test<boost_unordered_node_map_fnv1a>( "boost::unordered_node_map, FNV-1a" );
     test<boost_unordered_flat_map_fnv1a>( "boost::unordered_flat_map, FNV-1a" );
+    test_frozen<boost_unordered_flat_map_fnv1a>( "boost::frozen_flat_map, FNV-1a" );
+
+    test<boost_unordered_map_stored_hash>( "boost::unordered_map, stored hash" );
+    test<boost_unordered_node_map_stored_hash>( "boost::unordered_node_map, stored hash" );
+    test<boost_unordered_flat_map_stored_hash>( "boost::unordered_flat_map, stored hash" );
 
 #ifdef HAVE_ANKERL_UNORDERED_DENSE
 
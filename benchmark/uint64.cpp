@@ -9,6 +9,7 @@
 #include <boost/unordered_map.hpp>
 #include <boost/unordered/unordered_node_map.hpp>
 #include <boost/unordered/unordered_flat_map.hpp>
+#include <boost/unordered/frozen_flat_map.hpp>
 #include <boost/endian/conversion.hpp>
 #include <boost/core/detail/splitmix64.hpp>
 #include <boost/config.hpp>
@@ -26,6 +27,8 @@
 #include <iostream>
 #include <iomanip>
 #include <chrono>
+#include <type_traits>
+#include <utility>
 
 using namespace std::chrono_literals;
 
@@ -143,6 +146,53 @@ template<class Map> BOOST_NOINLINE void test_lookup( Map& map, std::chrono::stea
     std::cout << std::endl;
 }
 
+// bulk lookup (for containers supporting visit(first, last, f))
+
+template<class Map, class = void> struct has_bulk_lookup: std::false_type
+{
+};
+
+template<class Map> struct has_bulk_lookup<Map, decltype( (void)std::declval<Map const&>().visit(
+    indices1.cbegin(), indices1.cend(), std::declval<void(*)( typename Map::value_type const& )>() ) )>: std::true_type
+{
+};
+
+template<class Map> BOOST_NOINLINE void test_bulk_lookup( Map& map, std::chrono::steady_clock::time_point & t1 )
+{
+    std::uint64_t s;
+
+    auto f = [&]( typename Map::value_type const& x ){ s += x.second; };
+
+    s = 0;
+
+    for( int j = 0; j < K; ++j )
+    {
+        map.visit( indices1.cbegin() + 1, indices1.cend(), f );
+    }
+
+    print_time( t1, "Consecutive bulk lookup",  s, map.size() );
+
+    s = 0;
+
+    for( int j = 0; j < K; ++j )
+    {
+        map.visit( indices2.cbegin() + 1, indices2.cend(), f );
+    }
+
+    print_time( t1, "Random bulk lookup",  s, map.size() );
+
+    s = 0;
+
+    for( int j = 0; j < K; ++j )
+    {
+        map.visit( indices3.cbegin() + 1, indices3.cend(), f );
+    }
+
+    print_time( t1, "Consecutive reversed bulk lookup",  s, map.size() );
+
+    std::cout << std::endl;
+}
+
 template<class Map> BOOST_NOINLINE void test_iteration( Map& map, std::chrono::steady_clock::time_point & t1 )
 {
     auto it = map.begin();
@@ -270,6 +320,16 @@ template<template<class...> class Map> BOOST_NOINLINE void test( char const* lab
     record rec = { label, 0, s_alloc_bytes, s_alloc_count };
 
     test_lookup( map, t1 );
+
+    // bulk lookup times are not included in the total for comparability
+
+    if constexpr( has_bulk_lookup<Map<std::uint64_t, std::uint64_t>>::value )
+    {
+        auto tb = t1;
+        test_bulk_lookup( map, t1 );
+        t0 += t1 - tb;
+    }
+
     test_iteration( map, t1 );
     test_lookup( map, t1 );
     test_erase( map, t1 );
@@ -281,6 +341,42 @@ template<template<class...> class Map> BOOST_NOINLINE void test( char const* lab
     times.push_back( rec );
 }
 
+// read-only lookup: the map is built, frozen and then only looked up;
+// the total includes freezing but not the insertions
+
+template<template<class...> class Map> BOOST_NOINLINE void test_frozen( char const* label )
+{
+    std::cout << label << ":\n\n";
+
+    Map<std::uint64_t, std::uint64_t> map;
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    test_insert( map, t1 );
+
+    s_alloc_bytes = 0;
+    s_alloc_count = 0;
+
+    auto t0 = t1;
+
+    auto frozen = boost::freeze( std::move( map ) );
+
+    print_time( t1, "Freeze", 0, frozen.size() );
+
+    std::cout << "\nMemory: " << s_alloc_bytes << " bytes in " << s_alloc_count << " allocations\n\n";
+
+    record rec = { label, 0, s_alloc_bytes, s_alloc_count };
+
+    test_lookup( frozen, t1 );
+    test_lookup( frozen, t1 );
+
+    auto tN = std::chrono::steady_clock::now();
+    std::cout << "Total: " << ( tN - t0 ) / 1ms << " ms\n\n";
+
+    rec.time_ = ( tN - t0 ) / 1ms;
+    times.push_back( rec );
+}
+
 // aliases using the counting allocator
 
 template<class K, class V> using allocator_for = ::allocator< std::pair<K const, V> >;
@@ -332,6 +428,7 @@ int main()
     test<boost_unordered_map>( "boost::unordered_map" );
     test<boost_unordered_node_map>( "boost::unordered_node_map" );
     test<boost_unordered_flat_map>( "boost::unordered_flat_map" );
+    test_frozen<boost_unordered_flat_map>( "boost::frozen_flat_map" );
 
 #ifdef HAVE_ANKERL_UNORDERED_DENSE
 
@@ -0,0 +1,101 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0.
+// https://www.boost.org/LICENSE_1_0.txt
+
+// Full traversal throughput of large boost::unordered_flat_map and
+// boost::unordered_node_map, iterator loop vs. visit_all. Build with
+// -DBOOST_UNORDERED_VISIT_ALL_PREFETCH_DISTANCE=<n> to try other prefetch
+// distances.
+
+#define _SILENCE_CXX17_OLD_ALLOCATOR_MEMBERS_DEPRECATION_WARNING
+#define _SILENCE_CXX20_CISO646_REMOVED_WARNING
+
+#include <boost/unordered/unordered_flat_map.hpp>
+#include <boost/unordered/unordered_node_map.hpp>
+#include <boost/core/detail/splitmix64.hpp>
+#include <boost/config.hpp>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+constexpr unsigned N = 20'000'000;
+constexpr int K = 10;
+
+static std::vector<std::uint64_t> indices;
+
+static void init_indices()
+{
+    boost::detail::splitmix64 rng;
+
+    indices.reserve( N );
+    for( unsigned i = 0; i < N; ++i ) indices.push_back( rng() );
+}
+
+static void print_time( std::chrono::steady_clock::time_point t1, std::chrono::steady_clock::time_point t2, std::string const& label, std::uint64_t s, std::size_t bytes )
+{
+    auto ms = ( t2 - t1 ) / 1ms;
+    double gbs = ms? double( bytes ) * K / double( ms ) / 1e6: 0.0;
+
+    std::cout << label << ": " << std::setw( 6 ) << ms << " ms, " << std::fixed << std::setprecision( 2 ) << std::setw( 6 ) << gbs << " GB/s (s=" << s << ")\n";
+}
+
+template<class Map> void test( char const* label )
+{
+    std::cout << label << "\n\n";
+
+    Map map;
+
+    // leave about half the elements, as after heavy erasure
+
+    for( unsigned i = 0; i < N; ++i ) map.emplace( indices[ i ], i );
+    for( unsigned i = 0; i < N; i += 2 ) map.erase( indices[ i ] );
+
+    std::size_t bytes = map.size() * sizeof( typename Map::value_type );
+
+    {
+        auto t1 = std::chrono::steady_clock::now();
+
+        std::uint64_t s = 0;
+
+        for( int k = 0; k < K; ++k )
+        {
+            for( auto const& x: map ) s += x.second;
+        }
+
+        auto t2 = std::chrono::steady_clock::now();
+
+        print_time( t1, t2, "  Iterator loop", s, bytes );
+    }
+
+    {
+        auto t1 = std::chrono::steady_clock::now();
+
+        std::uint64_t s = 0;
+
+        for( int k = 0; k < K; ++k )
+        {
+            map.cvisit_all( [&]( typename Map::value_type const& x ) { s += x.second; } );
+        }
+
+        auto t2 = std::chrono::steady_clock::now();
+
+        print_time( t1, t2, "  visit_all    ", s, bytes );
+    }
+
+    std::cout << std::endl;
+}
+
+int main()
+{
+    std::cout << "Prefetch distance: " << BOOST_UNORDERED_VISIT_ALL_PREFETCH_DISTANCE << " groups\n\n";
+
+    init_indices();
+
+    test< boost::unordered_flat_map<std::uint64_t, std::uint64_t> >( "boost::unordered_flat_map" );
+    test< boost::unordered_node_map<std::uint64_t, std::uint64_t> >( "boost::unordered_node_map" );
+}
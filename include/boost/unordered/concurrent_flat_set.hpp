@@ -17,7 +17,8 @@
 #include <boost/unordered/detail/foa/concurrent_table.hpp>
 #include <boost/unordered/detail/foa/flat_set_types.hpp>
 #include <boost/unordered/detail/type_traits.hpp>
-#include <boost/unordered/unordered_flat_set_fwd.hpp>
+#include <boost/unordered/prehashed_key.hpp>
+#include <boost/unordered/unordered_flat_set.hpp>
 
 #include <boost/container_hash/hash.hpp>
 #include <boost/core/allocator_access.hpp>
@@ -70,6 +71,7 @@ namespace boost {
       using pointer = typename boost::allocator_pointer<allocator_type>::type;
       using const_pointer =
         typename boost::allocator_const_pointer<allocator_type>::type;
+      using checkpoint_chunk = typename table_type::checkpoint_chunk;
       static constexpr size_type bulk_visit_size = table_type::bulk_visit_size;
 
       concurrent_flat_set()
@@ -255,6 +257,29 @@ namespace boost {
         return table_.visit(std::forward<K>(k), f);
       }
 
+      template <class K, class F>
+      BOOST_FORCEINLINE size_type visit(prehashed_key<K, hasher> const& k, F f)
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_INVOCABLE(F)
+        return table_.visit_hashed(k.key(), k.hash(), f);
+      }
+
+      template <class K, class F>
+      BOOST_FORCEINLINE size_type visit(
+        prehashed_key<K, hasher> const& k, F f) const
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_CONST_INVOCABLE(F)
+        return table_.visit_hashed(k.key(), k.hash(), f);
+      }
+
+      template <class K, class F>
+      BOOST_FORCEINLINE size_type cvisit(
+        prehashed_key<K, hasher> const& k, F f) const
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_CONST_INVOCABLE(F)
+        return table_.visit_hashed(k.key(), k.hash(), f);
+      }
+
       template<class FwdIterator, class F>
       BOOST_FORCEINLINE
       size_t visit(FwdIterator first, FwdIterator last, F f) const
@@ -364,16 +389,14 @@ namespace boost {
       }
 
       template <class InputIterator>
-      void insert(InputIterator begin, InputIterator end)
+      size_type insert(InputIterator begin, InputIterator end)
       {
-        for (auto pos = begin; pos != end; ++pos) {
-          table_.emplace(*pos);
-        }
+        return table_.insert(begin, end);
       }
 
-      void insert(std::initializer_list<value_type> ilist)
+      size_type insert(std::initializer_list<value_type> ilist)
       {
-        this->insert(ilist.begin(), ilist.end());
+        return this->insert(ilist.begin(), ilist.end());
       }
 
       template <class F>
@@ -401,19 +424,17 @@ namespace boost {
       }
 
       template <class InputIterator, class F>
-      void insert_or_visit(InputIterator first, InputIterator last, F f)
+      size_type insert_or_visit(InputIterator first, InputIterator last, F f)
       {
         BOOST_UNORDERED_STATIC_ASSERT_CONST_INVOCABLE(F)
-        for (; first != last; ++first) {
-          table_.emplace_or_cvisit(*first, f);
-        }
+        return table_.insert_or_cvisit(first, last, f);
       }
 
       template <class F>
-      void insert_or_visit(std::initializer_list<value_type> ilist, F f)
+      size_type insert_or_visit(std::initializer_list<value_type> ilist, F f)
       {
         BOOST_UNORDERED_STATIC_ASSERT_CONST_INVOCABLE(F)
-        this->insert_or_cvisit(ilist.begin(), ilist.end(), f);
+        return this->insert_or_cvisit(ilist.begin(), ilist.end(), f);
       }
 
       template <class F>
@@ -441,19 +462,17 @@ namespace boost {
       }
 
       template <class InputIterator, class F>
-      void insert_or_cvisit(InputIterator first, InputIterator last, F f)
+      size_type insert_or_cvisit(InputIterator first, InputIterator last, F f)
       {
         BOOST_UNORDERED_STATIC_ASSERT_CONST_INVOCABLE(F)
-        for (; first != last; ++first) {
-          table_.emplace_or_cvisit(*first, f);
-        }
+        return table_.insert_or_cvisit(first, last, f);
       }
 
       template <class F>
-      void insert_or_cvisit(std::initializer_list<value_type> ilist, F f)
+      size_type insert_or_cvisit(std::initializer_list<value_type> ilist, F f)
       {
         BOOST_UNORDERED_STATIC_ASSERT_CONST_INVOCABLE(F)
-        this->insert_or_cvisit(ilist.begin(), ilist.end(), f);
+        return this->insert_or_cvisit(ilist.begin(), ilist.end(), f);
       }
 
       template <class... Args> BOOST_FORCEINLINE bool emplace(Args&&... args)
@@ -490,6 +509,12 @@ namespace boost {
         return table_.erase(std::forward<K>(k));
       }
 
+      template <class K>
+      BOOST_FORCEINLINE size_type erase(prehashed_key<K, hasher> const& k)
+      {
+        return table_.erase_hashed(k.key(), k.hash());
+      }
+
       template <class F>
       BOOST_FORCEINLINE size_type erase_if(key_type const& k, F f)
       {
@@ -541,6 +566,28 @@ namespace boost {
         return merge(x);
       }
 
+      unordered_flat_set<Key, Hash, Pred, Allocator> snapshot() const
+      {
+        return unordered_flat_set<Key, Hash, Pred, Allocator>(
+          table_.snapshot());
+      }
+
+      template <class F> void checkpoint(size_type n, F f) const
+      {
+        table_.checkpoint(n, f);
+      }
+
+#if defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
+      template <class ExecPolicy, class F>
+      typename std::enable_if<detail::is_execution_policy<ExecPolicy>::value,
+        void>::type
+      checkpoint(ExecPolicy&& p, size_type n, F f) const
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_EXEC_POLICY(ExecPolicy)
+        table_.checkpoint(p, n, f);
+      }
+#endif
+
       BOOST_FORCEINLINE size_type count(key_type const& k) const
       {
         return table_.count(k);
@@ -567,6 +614,51 @@ namespace boost {
         return table_.contains(k);
       }
 
+      template <class K>
+      BOOST_FORCEINLINE size_type count(prehashed_key<K, hasher> const& k) const
+      {
+        return this->contains(k) ? 1 : 0;
+      }
+
+      template <class K>
+      BOOST_FORCEINLINE bool contains(prehashed_key<K, hasher> const& k) const
+      {
+        return table_.visit_hashed(
+                 k.key(), k.hash(), [](value_type const&) {}) != 0;
+      }
+
+      prehashed_key<key_type, hasher> prehash(key_type const& k) const
+      {
+        return detail::prehashed_key_access::make<hasher>(k, table_.prehash(k));
+      }
+
+      template <class K>
+      typename std::enable_if<
+        detail::are_transparent<K, hasher, key_equal>::value,
+        prehashed_key<K, hasher> >::type
+      prehash(K const& k) const
+      {
+        return detail::prehashed_key_access::make<hasher>(k, table_.prehash(k));
+      }
+
+      // handles refer to the key, so temporaries are rejected
+
+      prehashed_key<key_type, hasher> prehash(key_type&&) const = delete;
+
+      template <class K>
+      typename std::enable_if<!std::is_lvalue_reference<K>::value &&
+                                detail::are_transparent<K, hasher,
+                                  key_equal>::value,
+        prehashed_key<K, hasher> >::type
+      prehash(K&&) const = delete;
+
+      template <class K>
+      BOOST_FORCEINLINE void prefetch(
+        prehashed_key<K, hasher> const& k) const noexcept
+      {
+        table_.prefetch(k.hash());
+      }
+
       /// Hash Policy
       ///
       size_type bucket_count() const noexcept { return table_.capacity(); }
@@ -582,6 +674,39 @@ namespace boost {
       void rehash(size_type n) { table_.rehash(n); }
       void reserve(size_type n) { table_.reserve(n); }
 
+      void rebuild_overflow() { table_.rebuild_overflow(); }
+
+#if defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
+      template <class ExecPolicy>
+      typename std::enable_if<detail::is_execution_policy<ExecPolicy>::value,
+        void>::type
+      rehash(ExecPolicy&& p, size_type n)
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_EXEC_POLICY(ExecPolicy)
+        table_.rehash(p, n);
+      }
+
+      template <class ExecPolicy>
+      typename std::enable_if<detail::is_execution_policy<ExecPolicy>::value,
+        void>::type
+      reserve(ExecPolicy&& p, size_type n)
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_EXEC_POLICY(ExecPolicy)
+        table_.reserve(p, n);
+      }
+#endif
+
+#if defined(BOOST_UNORDERED_ENABLE_STATS)
+      /// Statistics
+      ///
+
+      using stats = typename table_type::stats;
+
+      stats get_stats() const { return table_.get_stats(); }
+
+      void reset_stats() noexcept { table_.reset_stats(); }
+#endif
+
       /// Observers
       ///
       allocator_type get_allocator() const noexcept
@@ -0,0 +1,53 @@
+/* Detection of C++17 parallel algorithms.
+ *
+ * Copyright 2023-2024 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See https://www.boost.org/libs/unordered for library home page.
+ */
+
+#ifndef BOOST_UNORDERED_DETAIL_EXECUTION_POLICY_HPP
+#define BOOST_UNORDERED_DETAIL_EXECUTION_POLICY_HPP
+
+#include <boost/config.hpp>
+#include <type_traits>
+
+#if !defined(BOOST_UNORDERED_DISABLE_PARALLEL_ALGORITHMS)
+#if defined(BOOST_UNORDERED_ENABLE_PARALLEL_ALGORITHMS)|| \
+    !defined(BOOST_NO_CXX17_HDR_EXECUTION)
+#define BOOST_UNORDERED_PARALLEL_ALGORITHMS
+#endif
+#endif
+
+#if defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
+#include <algorithm>
+#include <execution>
+#endif
+
+namespace boost{
+namespace unordered{
+namespace detail{
+
+#if defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
+
+template<typename ExecutionPolicy>
+using is_execution_policy=std::is_execution_policy<
+  typename std::remove_cv<
+    typename std::remove_reference<ExecutionPolicy>::type
+  >::type
+>;
+
+#else
+
+template<typename ExecutionPolicy>
+using is_execution_policy=std::false_type;
+
+#endif
+
+} /* namespace detail */
+} /* namespace unordered */
+} /* namespace boost */
+
+#endif
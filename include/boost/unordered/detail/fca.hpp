@@ -134,8 +134,33 @@ namespace boost {
   namespace unordered {
     namespace detail {
 
-      template <class ValueType, class VoidPtr> struct node
+      // nodes of tables whose key type is marked with
+      // boost::unordered::node_stores_hash keep the hash value of their
+      // element, which is then used on rehashing and to skip calls to the
+      // equality predicate on lookup. This is not decided by the hash
+      // function so that node handles remain interchangeable between
+      // containers with different hash functions
+
+      template <bool StoresHash> struct node_hash_base
       {
+        void set_hash(std::size_t) noexcept {}
+      };
+
+      template <> struct node_hash_base<true>
+      {
+        std::size_t hash_;
+
+        node_hash_base() noexcept : hash_(0) {}
+
+        void set_hash(std::size_t h) noexcept { hash_ = h; }
+        std::size_t get_hash() const noexcept { return hash_; }
+      };
+
+      template <class ValueType, class VoidPtr, bool StoresHash = false>
+      struct node : node_hash_base<StoresHash>
+      {
+        BOOST_STATIC_CONSTANT(bool, stores_hash = StoresHash);
+
         typedef ValueType value_type;
         typedef typename boost::pointer_traits<VoidPtr>::template rebind_to<
           node>::type node_pointer;
@@ -158,6 +183,7 @@ namespace boost {
 
       template <class Node, class VoidPtr> struct bucket
       {
+        typedef Node node_type;
         typedef typename boost::pointer_traits<VoidPtr>::template rebind_to<
           Node>::type node_pointer;
 
@@ -451,12 +477,8 @@ namespace boost {
       template <class Bucket, class Allocator, class SizePolicy>
       class grouped_bucket_array
           : boost::empty_value<typename boost::allocator_rebind<Allocator,
-              node<typename boost::allocator_value_type<Allocator>::type,
-                typename boost::allocator_void_pointer<Allocator>::type> >::
-                type>
+              typename Bucket::node_type>::type>
       {
-        typedef typename boost::allocator_value_type<Allocator>::type
-          allocator_value_type;
         typedef
           typename boost::allocator_void_pointer<Allocator>::type void_pointer;
         typedef typename boost::allocator_difference_type<Allocator>::type
@@ -464,9 +486,9 @@ namespace boost {
 
       public:
         typedef typename boost::allocator_rebind<Allocator,
-          node<allocator_value_type, void_pointer> >::type node_allocator_type;
+          typename Bucket::node_type>::type node_allocator_type;
 
-        typedef node<allocator_value_type, void_pointer> node_type;
+        typedef typename Bucket::node_type node_type;
         typedef typename boost::allocator_pointer<node_allocator_type>::type
           node_pointer;
         typedef SizePolicy size_policy;
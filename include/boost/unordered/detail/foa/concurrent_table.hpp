@@ -12,25 +12,31 @@
 #ifndef BOOST_UNORDERED_DETAIL_FOA_CONCURRENT_TABLE_HPP
 #define BOOST_UNORDERED_DETAIL_FOA_CONCURRENT_TABLE_HPP
 
+#include <algorithm>
 #include <atomic>
 #include <boost/assert.hpp>
 #include <boost/config.hpp>
 #include <boost/core/ignore_unused.hpp>
 #include <boost/core/no_exceptions_support.hpp>
 #include <boost/core/serialization.hpp>
+#include <boost/core/yield_primitives.hpp>
 #include <boost/cstdint.hpp>
 #include <boost/mp11/tuple.hpp>
 #include <boost/throw_exception.hpp>
 #include <boost/unordered/detail/archive_constructed.hpp>
 #include <boost/unordered/detail/bad_archive_exception.hpp>
+#include <boost/unordered/detail/execution_policy.hpp>
 #include <boost/unordered/detail/foa/core.hpp>
 #include <boost/unordered/detail/foa/reentrancy_check.hpp>
 #include <boost/unordered/detail/foa/rw_spinlock.hpp>
 #include <boost/unordered/detail/foa/tuple_rotate_right.hpp>
+#include <boost/unordered/detail/opt_storage.hpp>
 #include <boost/unordered/detail/serialization_version.hpp>
 #include <boost/unordered/detail/static_assert.hpp>
 #include <boost/unordered/detail/type_traits.hpp>
+#include <boost/unordered/detail/untracked_serializable.hpp>
 #include <cstddef>
+#include <cstring>
 #include <functional>
 #include <initializer_list>
 #include <iterator>
@@ -39,39 +45,11 @@
 #include <type_traits>
 #include <tuple>
 #include <utility>
-
-#if !defined(BOOST_UNORDERED_DISABLE_PARALLEL_ALGORITHMS)
-#if defined(BOOST_UNORDERED_ENABLE_PARALLEL_ALGORITHMS)|| \
-    !defined(BOOST_NO_CXX17_HDR_EXECUTION)
-#define BOOST_UNORDERED_PARALLEL_ALGORITHMS
-#endif
-#endif
-
-#if defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
-#include <algorithm>
-#include <execution>
-#endif
+#include <vector>
 
 namespace boost{
 namespace unordered{
 namespace detail{
-
-#if defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
-
-template<typename ExecutionPolicy>
-using is_execution_policy=std::is_execution_policy<
-  typename std::remove_cv<
-    typename std::remove_reference<ExecutionPolicy>::type
-  >::type
->;
-
-#else
-
-template<typename ExecutionPolicy>
-using is_execution_policy=std::false_type;
-
-#endif
-
 namespace foa{
 
 static constexpr std::size_t cacheline_size=64;
@@ -161,6 +139,37 @@ private:
   Mutex &m;
 };
 
+#if defined(BOOST_UNORDERED_ENABLE_OPTIMISTIC_READS)
+/* lock_guard additionally bumping a seqlock-style version number on
+ * acquisition and release: the version is odd while the lock is held.
+ */
+
+template<typename Mutex,typename Version>
+class versioned_lock_guard
+{
+public:
+  versioned_lock_guard(Mutex& m_,Version& v_)noexcept:m(m_),v(v_)
+  {
+    m.lock();
+    v.store(v.load(std::memory_order_relaxed)+1,std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  ~versioned_lock_guard()noexcept
+  {
+    v.store(v.load(std::memory_order_relaxed)+1,std::memory_order_release);
+    m.unlock();
+  }
+
+  /* not used but VS in pre-C++17 mode needs to see it for RVO */
+  versioned_lock_guard(const versioned_lock_guard&);
+
+private:
+  Mutex   &m;
+  Version &v;
+};
+#endif
+
 /* inspired by boost/multi_index/detail/scoped_bilock.hpp */
 
 template<typename Mutex>
@@ -215,27 +224,114 @@ struct atomic_integral
 
 /* Group-level concurrency protection. It provides a rw mutex plus an
  * atomic insertion counter for optimistic insertion (see
- * unprotected_norehash_emplace_or_visit).
+ * unprotected_norehash_emplace_or_visit). When
+ * BOOST_UNORDERED_ENABLE_OPTIMISTIC_READS is defined, exclusive access
+ * also maintains a version number for optimistic lookup (see
+ * unprotected_optimistic_visit).
  */
 
 struct group_access
 {    
   using mutex_type=rw_spinlock;
   using shared_lock_guard=shared_lock<mutex_type>;
-  using exclusive_lock_guard=lock_guard<mutex_type>;
   using insert_counter_type=std::atomic<boost::uint32_t>;
 
+#if defined(BOOST_UNORDERED_ENABLE_OPTIMISTIC_READS)
+  using version_type=std::atomic<boost::uint32_t>;
+  using exclusive_lock_guard=versioned_lock_guard<mutex_type,version_type>;
+
+  shared_lock_guard    shared_access(){return shared_lock_guard{m};}
+  exclusive_lock_guard exclusive_access(){return exclusive_lock_guard{m,ver};}
+  insert_counter_type& insert_counter(){return cnt;}
+  void                 reference(unsigned int){}
+
+  /* Reads made between read_begin and a successful read_validate did not
+   * overlap with any exclusive access. An odd version means the group is
+   * being written to.
+   */
+
+  boost::uint32_t read_begin()const
+  {
+    return ver.load(std::memory_order_acquire);
+  }
+
+  bool read_validate(boost::uint32_t v)const
+  {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return ver.load(std::memory_order_relaxed)==v;
+  }
+
+private:
+  mutex_type          m;
+  insert_counter_type cnt{0};
+  version_type        ver{0};
+#else
+  using exclusive_lock_guard=lock_guard<mutex_type>;
+
   shared_lock_guard    shared_access(){return shared_lock_guard{m};}
   exclusive_lock_guard exclusive_access(){return exclusive_lock_guard{m};}
   insert_counter_type& insert_counter(){return cnt;}
+  void                 reference(unsigned int){}
 
 private:
   mutex_type          m;
   insert_counter_type cnt{0};
+#endif
+};
+
+/* group_access plus CLOCK reference bits for the elements of the group,
+ * used by concurrent caches (see clock_evict). Insertion and successful
+ * lookups set the bit of the element while holding the group lock in
+ * either mode; eviction clears it under exclusive access. Type policies
+ * select this over plain group_access by defining group_access_type.
+ */
+
+struct clock_group_access:group_access
+{
+  void reference(unsigned int n)
+  {
+    /* don't dirty the cache line on repeated hits */
+    auto bit=boost::uint64_t(1)<<n;
+    if(!(refs.load(std::memory_order_relaxed)&bit)){
+      refs.fetch_or(bit,std::memory_order_relaxed);
+    }
+  }
+
+  void unreference(unsigned int n)
+  {
+    auto bit=boost::uint64_t(1)<<n;
+    if(refs.load(std::memory_order_relaxed)&bit){
+      refs.fetch_and(~bit,std::memory_order_relaxed);
+    }
+  }
+
+  bool referenced(unsigned int n)const
+  {
+    return refs.load(std::memory_order_relaxed)&(boost::uint64_t(1)<<n);
+  }
+
+private:
+  /* all set, so that elements moved by a rehash get a second chance */
+  std::atomic<boost::uint64_t> refs{~boost::uint64_t(0)};
+};
+
+template<typename TypePolicy,typename=void>
+struct group_access_of
+{
+  using type=group_access;
+};
+
+template<typename TypePolicy>
+struct group_access_of<
+  TypePolicy,
+  boost::unordered::detail::void_t<typename TypePolicy::group_access_type>
+>
+{
+  using type=typename TypePolicy::group_access_type;
 };
 
-template<std::size_t Size>
-group_access* dummy_group_accesses()
+template<std::size_t Size,typename GroupAccess=group_access>
+GroupAccess* dummy_group_accesses()
 {
   /* Default group_access array to provide to empty containers without
    * incurring dynamic allocation. Mutexes won't actually ever be used,
@@ -243,34 +339,39 @@ group_access* dummy_group_accesses()
    * be incremented (insertions won't succeed as capacity()==0).
    */
 
-  static group_access accesses[Size];
+  static GroupAccess accesses[Size];
 
   return accesses;
 }
 
 /* subclasses table_arrays to add an additional group_access array */
 
-template<typename Value,typename Group,typename SizePolicy,typename Allocator>
-struct concurrent_table_arrays:table_arrays<Value,Group,SizePolicy,Allocator>
+template<
+  typename Value,typename Group,typename SizePolicy,typename Allocator,
+  typename StoresHash=std::false_type,typename GroupAccess=group_access
+>
+struct concurrent_table_arrays:
+  table_arrays<Value,Group,SizePolicy,Allocator,StoresHash>
 {
+  using group_access_type=GroupAccess;
   using group_access_allocator_type=
-    typename boost::allocator_rebind<Allocator,group_access>::type;
+    typename boost::allocator_rebind<Allocator,group_access_type>::type;
   using group_access_pointer=
     typename boost::allocator_pointer<group_access_allocator_type>::type;
 
-  using super=table_arrays<Value,Group,SizePolicy,Allocator>;
+  using super=table_arrays<Value,Group,SizePolicy,Allocator,StoresHash>;
   using allocator_type=typename super::allocator_type;
 
   concurrent_table_arrays(const super& arrays,group_access_pointer pga):
     super{arrays},group_accesses_{pga}{}
 
-  group_access* group_accesses()const noexcept{
+  group_access_type* group_accesses()const noexcept{
     return boost::to_address(group_accesses_);
   }
 
   static concurrent_table_arrays new_(allocator_type al,std::size_t n)
   {
-    super x{super::new_(al,n)};
+    super x{super::new_(al,n,true)};
     BOOST_TRY{
       return new_group_access(group_access_allocator_type(al),x);
     }
@@ -285,7 +386,7 @@ struct concurrent_table_arrays:table_arrays<Value,Group,SizePolicy,Allocator>
     group_access_allocator_type al,concurrent_table_arrays& arrays)
   {
     set_group_access(
-      al,arrays,std::is_same<group_access*,group_access_pointer>{});
+      al,arrays,std::is_same<group_access_type*,group_access_pointer>{});
   }
 
   static void set_group_access(
@@ -294,10 +395,10 @@ struct concurrent_table_arrays:table_arrays<Value,Group,SizePolicy,Allocator>
     std::false_type /* fancy pointers */)
   {
     arrays.group_accesses_=
-        boost::allocator_allocate(al,arrays.groups_size_mask+1);
+      allocate_pages(al,arrays.groups_size_mask+1,true);
 
       for(std::size_t i=0;i<arrays.groups_size_mask+1;++i){
-        ::new (arrays.group_accesses()+i) group_access();
+        ::new (arrays.group_accesses()+i) group_access_type();
       }
   }
 
@@ -308,7 +409,7 @@ struct concurrent_table_arrays:table_arrays<Value,Group,SizePolicy,Allocator>
   {
     if(!arrays.elements()){
       arrays.group_accesses_=
-        dummy_group_accesses<SizePolicy::min_size()>();
+        dummy_group_accesses<SizePolicy::min_size(),group_access_type>();
     } else {
       set_group_access(al,arrays,std::false_type{});
     }
@@ -332,8 +433,7 @@ struct concurrent_table_arrays:table_arrays<Value,Group,SizePolicy,Allocator>
     group_access_allocator_type al,concurrent_table_arrays& arrays)noexcept
   {
     if(arrays.elements()){
-      boost::allocator_deallocate(
-        al,arrays.group_accesses_,arrays.groups_size_mask+1);
+      deallocate_pages(al,arrays.group_accesses_,arrays.groups_size_mask+1);
     }
   }
 
@@ -427,14 +527,86 @@ inline void swap(atomic_size_control& x,atomic_size_control& y)
  *       whole operation (which is checked by comparing with c0), then we're
  *       good to go and complete the insertion, otherwise we roll back and
  *       start over.
+ *
+ * When BOOST_UNORDERED_ENABLE_INCREMENTAL_REHASH is defined and elements are
+ * nothrow move constructible, growth does not stop the world:
+ *
+ *   - The thread finding the table full allocates the new arrays with the
+ *     container-level lock in shared mode, then takes it exclusively just to
+ *     install them and keep the old arrays aside.
+ *   - Lookups search the old arrays before the new ones. Elements only ever
+ *     move from old to new, so a lookup can't miss an element being migrated
+ *     concurrently.
+ *   - Insertions go to the new arrays. Migration of an element increments the
+ *     insertion counter of its initial group in the new arrays, so that
+ *     concurrent insertions of an equivalent element start over.
+ *   - Operations on individual elements migrate one old group each before
+ *     proceeding (see unprotected_rehash_step). Full-table traversals pause migration
+ *     while they run and visit both arrays.
+ *   - Once all groups are migrated, the old arrays are released under a short
+ *     exclusive lock by the next insertion, erasure or lookup. Operations
+ *     taking the container-level lock exclusively (assignment, swap, rehash,
+ *     etc.) first complete any pending migration.
+ *   - If the hash function throws while migrating a group, incremental
+ *     migration stops, and the remaining elements are moved under an
+ *     exclusive lock at the start of a subsequent operation.
+ *
+ * snapshot() copies the table into a non-concurrent table with the
+ * container-level lock in shared mode only, so that lookups, insertions,
+ * updates and erasures proceed during the copy:
+ *
+ *   - Destination arrays of the same size as the current ones are allocated
+ *     and a pointer to the snapshot state is published.
+ *   - Groups are copied one by one under group-level shared access. A thread
+ *     about to modify a group (that is, taking its lock exclusively) first
+ *     checks the published pointer and copies the group itself if not done
+ *     yet: each group is thus copied in the state it had before the first
+ *     modification following publication, which makes the snapshot a
+ *     consistent cut of the table's history.
+ *   - Groups are copied slot by slot to the same positions, so no rehashing
+ *     is involved and the destination is a valid table once all groups are
+ *     copied. Growth and other exclusive operations wait for the snapshot
+ *     to complete, as does the unpublishing of the state, which is the only
+ *     exclusive section of the process.
+ *
+ * checkpoint() serializes the table under the same scheme, but without
+ * making a full copy:
+ *
+ *   - The published state holds a status for each group. A thread about to
+ *     modify a group not yet visited copies its occupied elements aside (the
+ *     group's pre-image) and marks it as captured.
+ *   - The group range is split into chunks, each serialized as a standalone
+ *     container with the same format as save(). As the element count goes
+ *     first, the groups of a chunk are traversed twice under group-level
+ *     shared access: the first pass adds up the pre-image sizes of captured
+ *     groups and the actual sizes of the rest, the second one writes the
+ *     elements, taking them from the pre-image (which is then released) for
+ *     captured groups. Either way, the result is the same consistent cut as
+ *     would be obtained by snapshot().
+ *   - Extra memory is limited to the pre-images of groups modified ahead of
+ *     the serialization cursor. snapshot() and checkpoint() share the
+ *     publication slot and so don't run concurrently.
  */
 
 template<typename,typename,typename,typename>
 class table; /* concurrent/non-concurrent interop */
 
+template<typename GroupAccess>
+struct concurrent_table_arrays_of
+{
+  template<
+    typename Value,typename Group,typename SizePolicy,typename Allocator,
+    typename StoresHash
+  >
+  using type=concurrent_table_arrays<
+    Value,Group,SizePolicy,Allocator,StoresHash,GroupAccess>;
+};
+
 template <typename TypePolicy,typename Hash,typename Pred,typename Allocator>
 using concurrent_table_core_impl=table_core<
-  TypePolicy,group15<atomic_integral>,concurrent_table_arrays,
+  TypePolicy,default_group<atomic_integral>,
+  concurrent_table_arrays_of<
+    typename group_access_of<TypePolicy>::type>::template type,
   atomic_size_control,Hash,Pred,Allocator>;
 
 #include <boost/unordered/detail/foa/ignore_wshadow.hpp>
@@ -516,11 +688,13 @@ public:
     concurrent_table(std::move(x),x.make_empty_arrays())
   {}
 
-  ~concurrent_table()=default;
+  ~concurrent_table(){discard_old_arrays();}
 
   concurrent_table& operator=(const concurrent_table& x)
   {
     auto lck=exclusive_access(*this,x);
+    settle_rehash();
+    x.settle_rehash();
     super::operator=(x);
     return *this;
   }
@@ -529,12 +703,15 @@ public:
     noexcept(std::declval<super&>() = std::declval<super&&>()))
   {
     auto lck=exclusive_access(*this,x);
+    settle_rehash();
+    x.settle_rehash();
     super::operator=(std::move(x));
     return *this;
   }
 
   concurrent_table& operator=(std::initializer_list<value_type> il) {
     auto lck=exclusive_access();
+    discard_old_arrays();
     super::clear();
     super::noshrink_reserve(il.size());
     for (auto const& v : il) {
@@ -567,6 +744,59 @@ public:
     return visit(x,std::forward<F>(f));
   }
 
+  /* Visitation, erasure and insertion with a hash value previously obtained
+   * from prehash (see boost::unordered::prehashed_key).
+   */
+
+  template<typename Key>
+  std::size_t prehash(const Key& x)const
+  {
+    auto lck=shared_access();
+    return this->hash_for(x);
+  }
+
+  /* arrays is rewritten by rehashing under exclusive access, so it can't be
+   * read without locking, not even for a prefetch.
+   */
+
+  BOOST_FORCEINLINE void prefetch(std::size_t hash)const noexcept
+  {
+    auto lck=shared_access();
+    super::prefetch(hash);
+  }
+
+  template<typename Key,typename F>
+  BOOST_FORCEINLINE std::size_t visit_hashed(
+    const Key& x,std::size_t hash,F&& f)
+  {
+    return visit_hashed_impl(group_exclusive{},x,hash,std::forward<F>(f));
+  }
+
+  template<typename Key,typename F>
+  BOOST_FORCEINLINE std::size_t visit_hashed(
+    const Key& x,std::size_t hash,F&& f)const
+  {
+    return visit_hashed_impl(group_shared{},x,hash,std::forward<F>(f));
+  }
+
+  template<typename Key>
+  BOOST_FORCEINLINE std::size_t erase_hashed(const Key& x,std::size_t hash)
+  {
+    finalize_rehash_if_done();
+    auto lck=shared_access();
+    unprotected_rehash_step();
+    return unprotected_erase_if(x,hash,[](const value_type&){return true;});
+  }
+
+  template<typename Key,typename... Args>
+  BOOST_FORCEINLINE bool try_emplace_hashed(
+    std::size_t hash,Key&& x,Args&&... args)
+  {
+    return emplace_or_visit_hashed_impl(
+      group_shared{},hash,[](const value_type&){},
+      try_emplace_args_t{},std::forward<Key>(x),std::forward<Args>(args)...);
+  }
+
   template<typename FwdIterator,typename F>
   BOOST_FORCEINLINE
   std::size_t visit(FwdIterator first,FwdIterator last,F&& f)
@@ -814,6 +1044,48 @@ public:
       group_shared{},std::forward<F>(f),std::move(x));
   }
 
+  /* Range insertion returns the number of elements inserted. Forward ranges
+   * of value_type/init_type and ranges of keys for bulk_try_emplace_* are
+   * processed in batches: see bulk_emplace_or_visit_loop.
+   */
+
+  template<typename InputIterator>
+  std::size_t insert(InputIterator first,InputIterator last)
+  {
+    return range_emplace_or_visit(
+      group_shared{},first,last,[](const value_type&){});
+  }
+
+  template<typename InputIterator,typename F>
+  std::size_t insert_or_visit(InputIterator first,InputIterator last,F&& f)
+  {
+    return range_emplace_or_visit(
+      group_exclusive{},first,last,std::forward<F>(f));
+  }
+
+  template<typename InputIterator,typename F>
+  std::size_t insert_or_cvisit(InputIterator first,InputIterator last,F&& f)
+  {
+    return range_emplace_or_visit(
+      group_shared{},first,last,std::forward<F>(f));
+  }
+
+  template<typename FwdIterator,typename F>
+  std::size_t bulk_try_emplace_or_visit(
+    FwdIterator first,FwdIterator last,F&& f)
+  {
+    return bulk_emplace_or_visit_impl(
+      group_exclusive{},first,last,std::forward<F>(f),try_emplace_args_t{});
+  }
+
+  template<typename FwdIterator,typename F>
+  std::size_t bulk_try_emplace_or_cvisit(
+    FwdIterator first,FwdIterator last,F&& f)
+  {
+    return bulk_emplace_or_visit_impl(
+      group_shared{},first,last,std::forward<F>(f),try_emplace_args_t{});
+  }
+
   template<typename Key>
   BOOST_FORCEINLINE std::size_t erase(const Key& x)
   {
@@ -824,19 +1096,10 @@ public:
   BOOST_FORCEINLINE auto erase_if(const Key& x,F&& f)->typename std::enable_if<
     !is_execution_policy<Key>::value,std::size_t>::type
   {
-    auto        lck=shared_access();
-    auto        hash=this->hash_for(x);
-    std::size_t res=0;
-    unprotected_internal_visit(
-      group_exclusive{},x,this->position_for(hash),hash,
-      [&,this](group_type* pg,unsigned int n,element_type* p)
-      {
-        if(f(cast_for(group_exclusive{},type_policy::value_from(*p)))){
-          super::erase(pg,n,p);
-          res=1;
-        }
-      });
-    return res;
+    finalize_rehash_if_done();
+    auto lck=shared_access();
+    unprotected_rehash_step();
+    return unprotected_erase_if(x,this->hash_for(x),std::forward<F>(f));
   }
 
   template<typename F>
@@ -871,16 +1134,66 @@ public:
   }
 #endif
 
+  /* CLOCK (second chance) eviction for concurrent caches, whose type
+   * policies provide a clock_group_access: groups are swept in circular
+   * order starting at hand, one group lock at a time, until size()<=n.
+   * Referenced elements of a group have their bit cleared and the rest are
+   * erased, so size() can end up below n by less than a group's worth of
+   * elements. Stopping halfway through a group would favor the elements in
+   * its last slots, as insertion reuses the first free slot. After a full
+   * sweep, elements are erased regardless of their bits so that elements
+   * being constantly hit can't stall eviction. With incremental rehashing,
+   * elements not yet migrated are not evicted. Returns the number of
+   * elements erased.
+   */
+
+  std::size_t clock_evict(std::size_t n,std::atomic<std::size_t>& hand)
+  {
+    finalize_rehash_if_done();
+    auto lck=shared_access();
+    unprotected_rehash_step();
+
+    auto        num_groups=this->arrays.groups_size_mask+1;
+    auto        last=this->arrays.groups()+num_groups;
+    std::size_t res=0;
+    for(std::size_t i=0;i<2*num_groups&&this->size_ctrl.size>n;++i){
+      auto pos=hand.fetch_add(1,std::memory_order_relaxed)%num_groups;
+      auto pg=this->arrays.groups()+pos;
+      if(!super::match_really_occupied(pg,last))continue;
+
+      auto  p=this->arrays.elements()+pos*N;
+      auto& ga=this->arrays.group_accesses()[pos];
+      auto  glck=access(group_exclusive{},pos);
+      copy_on_write(group_exclusive{},this->arrays,pos);
+      auto  mask=super::match_really_occupied(pg,last);
+      while(mask){
+        auto m=unchecked_countr_zero(mask);
+        if(i<num_groups&&ga.referenced(m)){
+          ga.unreference(m);
+        }
+        else{
+          super::erase(pg,m,p+m);
+          ++res;
+        }
+        mask&=mask-1;
+      }
+    }
+    return res;
+  }
+
   void swap(concurrent_table& x)
     noexcept(noexcept(std::declval<super&>().swap(std::declval<super&>())))
   {
     auto lck=exclusive_access(*this,x);
+    settle_rehash();
+    x.settle_rehash();
     super::swap(x);
   }
 
   void clear()noexcept
   {
     auto lck=exclusive_access();
+    discard_old_arrays();
     super::clear();
   }
 
@@ -895,6 +1208,8 @@ public:
     boost::ignore_unused<super2>();
 
     auto      lck=exclusive_access(*this,x);
+    settle_rehash();
+    x.settle_rehash();
     size_type s=super::size();
     x.super2::for_all_elements( /* super2::for_all_elements -> unprotected */
       [&,this](group_type* pg,unsigned int n,element_type* p){
@@ -907,6 +1222,96 @@ public:
   template<typename Hash2,typename Pred2>
   void merge(concurrent_table<TypePolicy,Hash2,Pred2,Allocator>&& x){merge(x);}
 
+  /* See snapshot notes above. */
+
+  compatible_nonconcurrent_table snapshot()const
+  {
+    lock_guard<mutex_type>     clck{cow_mutex}; /* one at a time */
+    cow_holder<snapshot_state> sh{*this};
+    {
+      auto lck=shared_access();
+      unprotected_complete_rehash();
+      sh.construct();
+      if(this->arrays.elements()){
+        sh.publish();
+        for(std::size_t pos=0;pos<=this->arrays.groups_size_mask;++pos){
+          auto glck=access(group_shared{},pos);
+          snapshot_group(sh.state(),pos);
+        }
+        sh.state().done.store(true,std::memory_order_relaxed);
+      }
+    }
+    sh.unpublish();
+
+    auto& s=sh.state();
+    s.res.size_ctrl.size=s.size.load(std::memory_order_relaxed);
+    return std::move(s.res);
+  }
+
+  /* See checkpoint notes above. */
+
+  class checkpoint_chunk;
+
+  template<typename F>
+  void checkpoint(std::size_t n,F f)const
+  {
+    checkpoint_impl(n,[&](const checkpoint_chunk* first,std::size_t m){
+      for(std::size_t i=0;i<m;++i)f(i,first[i]);
+    });
+  }
+
+#if defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
+  template<typename ExecutionPolicy,typename F>
+  void checkpoint(ExecutionPolicy&& policy,std::size_t n,F f)const
+  {
+    checkpoint_impl(n,[&](const checkpoint_chunk* first,std::size_t m){
+      std::for_each(
+        std::forward<ExecutionPolicy>(policy),first,first+m,
+        [&](const checkpoint_chunk& c){
+          f(static_cast<std::size_t>(&c-first),c);
+        });
+    });
+  }
+#endif
+
+  /* Serializes as a concurrent_flat_(map|set) holding the elements of a
+   * range of groups: the container's serialization is mimicked by saving
+   * the table part as a nested object named "table".
+   */
+
+  class checkpoint_chunk
+  {
+    struct table_part
+    {
+      template<typename Archive>
+      void serialize(Archive& ar,unsigned int)
+      {
+        x->save_checkpoint_chunk(ar,*c);
+      }
+
+      const concurrent_table* x;
+      const checkpoint_chunk* c;
+    };
+
+    friend class boost::serialization::access;
+    friend class concurrent_table;
+
+    template<typename Archive>
+    void serialize(Archive& ar,unsigned int)
+    {
+      table_part tp{x,this};
+      ar&core::make_nvp("table",tp);
+    }
+
+    checkpoint_chunk(
+      const concurrent_table* x_,std::size_t first_,std::size_t last_):
+      x{x_},first{first_},last{last_}{}
+
+    const concurrent_table* x;
+    std::size_t             first,last;
+    mutable bool            saved=false;
+  };
+
   hasher hash_function()const
   {
     auto lck=shared_access();
@@ -956,15 +1361,70 @@ public:
   void rehash(std::size_t n)
   {
     auto lck=exclusive_access();
+    settle_rehash();
     super::rehash(n);
   }
 
   void reserve(std::size_t n)
   {
     auto lck=exclusive_access();
+    settle_rehash();
     super::reserve(n);
   }
 
+  void rebuild_overflow()
+  {
+    auto lck=exclusive_access();
+    settle_rehash();
+    super::rebuild_overflow();
+  }
+
+#if defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
+  template<typename ExecutionPolicy>
+  void rehash(ExecutionPolicy&& policy,std::size_t n)
+  {
+    auto lck=exclusive_access();
+    settle_rehash();
+    super::parallel_rehash(
+      [&](group_type* first,group_type* last,const auto& f)
+        {std::for_each(policy,first,last,f);},
+      n);
+  }
+
+  template<typename ExecutionPolicy>
+  void reserve(ExecutionPolicy&& policy,std::size_t n)
+  {
+    auto lck=exclusive_access();
+    settle_rehash();
+    super::parallel_reserve(
+      [&](group_type* first,group_type* last,const auto& f)
+        {std::for_each(policy,first,last,f);},
+      n);
+  }
+#endif
+
+#if defined(BOOST_UNORDERED_ENABLE_STATS)
+  using stats=typename super::stats;
+
+  stats get_stats()const
+  {
+    auto lck=shared_access();
+    auto cs=super::cstats; /* only updated under exclusive access */
+    cs.insertion.merge(cstats.insertion.get());
+    cs.successful_lookup.merge(cstats.successful_lookup.get());
+    cs.unsuccessful_lookup.merge(cstats.unsuccessful_lookup.get());
+    cs.rehash.merge(cstats.rehash.get());
+    return super::make_stats(cs);
+  }
+
+  void reset_stats()noexcept
+  {
+    auto lck=exclusive_access();
+    super::cstats.reset();
+    cstats.reset();
+  }
+#endif
+
   template<typename Predicate>
   friend std::size_t erase_if(concurrent_table& x,Predicate&& pr)
   {
@@ -974,6 +1434,8 @@ public:
   friend bool operator==(const concurrent_table& x,const concurrent_table& y)
   {
     auto lck=exclusive_access(x,y);
+    x.settle_rehash();
+    y.settle_rehash();
     return static_cast<const super&>(x)==static_cast<const super&>(y);
   }
 
@@ -996,15 +1458,15 @@ private:
   using group_insert_counter_type=typename group_access::insert_counter_type;
 
   concurrent_table(const concurrent_table& x,exclusive_lock_guard):
-    super{x}{}
+    super{settled(x)}{}
   concurrent_table(concurrent_table&& x,exclusive_lock_guard):
-    super{std::move(x)}{}
+    super{std::move(settled(x))}{}
   concurrent_table(
     const concurrent_table& x,const Allocator& al_,exclusive_lock_guard):
-    super{x,al_}{}
+    super{settled(x),al_}{}
   concurrent_table(
     concurrent_table&& x,const Allocator& al_,exclusive_lock_guard):
-    super{std::move(x),al_}{}
+    super{std::move(settled(x)),al_}{}
 
   inline shared_lock_guard shared_access()const
   {
@@ -1048,39 +1510,365 @@ private:
     return this->arrays.group_accesses()[pos].exclusive_access();
   }
 
+  static inline group_shared_lock_guard access(
+    group_shared,const arrays_type& arrays_,std::size_t pos)
+  {
+    return arrays_.group_accesses()[pos].shared_access();
+  }
+
+  static inline group_exclusive_lock_guard access(
+    group_exclusive,const arrays_type& arrays_,std::size_t pos)
+  {
+    return arrays_.group_accesses()[pos].exclusive_access();
+  }
+
   inline group_insert_counter_type& insert_counter(std::size_t pos)const
   {
     return this->arrays.group_accesses()[pos].insert_counter();
   }
 
-  /* Const casts value_type& according to the level of group access for
-   * safe passing to visitation functions. When type_policy is set-like,
-   * access is always const regardless of group access.
+  /* Snapshot and checkpoint support (see notes above). copy_on_write must be
+   * called right after taking a group lock: with exclusive access, the group
+   * is handed over to the copy-on-write operation in progress, if any, before
+   * being modified.
    */
 
-  static inline const value_type&
-  cast_for(group_shared,value_type& x){return x;}
-
-  static inline typename std::conditional<
-    std::is_same<key_type,value_type>::value,
-    const value_type&,
-    value_type&
-  >::type
-  cast_for(group_exclusive,value_type& x){return x;}
+  struct cow_state
+  {
+    void (*copy_group)(const concurrent_table&,cow_state&,std::size_t);
+  };
 
-  struct erase_on_exit
+  struct snapshot_state:cow_state
   {
-    erase_on_exit(
-      concurrent_table& x_,
-      group_type* pg_,unsigned int pos_,element_type* p_):
-      x(x_),pg(pg_),pos(pos_),p(p_){}
-    ~erase_on_exit(){if(!rollback_)x.super::erase(pg,pos,p);}
+    using copied_allocator_type=
+      typename boost::allocator_rebind<Allocator,unsigned char>::type;
 
-    void rollback(){rollback_=true;}
+    snapshot_state(const concurrent_table& x):
+      cow_state{&copy_group_for_snapshot},
+      res{
+        x.h(),x.pred(),x.al(),
+        x.arrays.groups_size_index,x.super::capacity(),x.size_ctrl.ml},
+      copied(
+        x.arrays.groups_size_mask+1,0,copied_allocator_type(x.al()))
+    {}
 
-    concurrent_table &x;
-    group_type       *pg;
-    unsigned  int     pos;
+    compatible_nonconcurrent_table                   res;
+    std::vector<unsigned char,copied_allocator_type> copied;
+    std::atomic<std::size_t>                         size{0};
+    std::atomic<bool>                                done{false};
+  };
+
+  static void copy_group_for_snapshot(
+    const concurrent_table& x,cow_state& s,std::size_t pos)
+  {
+    x.snapshot_group(static_cast<snapshot_state&>(s),pos);
+  }
+
+  struct checkpoint_group
+  {
+    using element_allocator_type=
+      typename boost::allocator_rebind<Allocator,element_type>::type;
+    using element_pointer=
+      typename boost::allocator_pointer<element_allocator_type>::type;
+
+    using mask_type=decltype(std::declval<const group_type&>().match(0));
+
+    static constexpr unsigned char fresh=0,captured=1,written=2;
+
+    element_pointer elements=element_pointer();
+    mask_type       mask=0;
+    unsigned char   status=fresh;
+  };
+
+  struct checkpoint_state:cow_state
+  {
+    using element_allocator_type=
+      typename checkpoint_group::element_allocator_type;
+    using groups_allocator_type=
+      typename boost::allocator_rebind<Allocator,checkpoint_group>::type;
+
+    checkpoint_state(const concurrent_table& x):
+      cow_state{&copy_group_for_checkpoint},
+      al(x.al()),
+      groups(
+        x.arrays.groups_size_mask+1,checkpoint_group(),
+        groups_allocator_type(x.al()))
+    {}
+
+    ~checkpoint_state()
+    {
+      for(auto& g:groups)release(g);
+    }
+
+    /* Destroys and deallocates the pre-image of a captured group. */
+
+    void release(checkpoint_group& g)
+    {
+      if(g.elements){
+        auto p=boost::to_address(g.elements);
+        for(auto m=g.mask;m;m&=m-1){
+          type_policy::destroy(al,p+unchecked_countr_zero(m));
+        }
+        element_allocator_type eal(al);
+        boost::allocator_deallocate(eal,g.elements,N);
+        g.elements=typename checkpoint_group::element_pointer();
+      }
+    }
+
+    Allocator                                          al;
+    std::vector<checkpoint_group,groups_allocator_type> groups;
+  };
+
+  static void copy_group_for_checkpoint(
+    const concurrent_table& x,cow_state& s,std::size_t pos)
+  {
+    x.checkpoint_capture_group(static_cast<checkpoint_state&>(s),pos);
+  }
+
+  /* Owns the state of a copy-on-write operation, which must outlive its
+   * publication.
+   */
+
+  template<typename State>
+  struct cow_holder
+  {
+    cow_holder(const concurrent_table& x_):x(x_){}
+
+    ~cow_holder()
+    {
+      unpublish();
+      if(constructed)s.t_.~State();
+    }
+
+    void construct()
+    {
+      ::new (s.address()) State(x);
+      constructed=true;
+    }
+
+    State& state(){return s.t_;}
+
+    void publish()
+    {
+      x.cow_.store(s.address(),std::memory_order_release);
+      published=true;
+    }
+
+    void unpublish()
+    {
+      if(published){
+        /* no one else is holding or about to use the state past this point */
+        auto lck=x.exclusive_access();
+        x.cow_.store(nullptr,std::memory_order_relaxed);
+        published=false;
+      }
+    }
+
+    const concurrent_table& x;
+    opt_storage<State>      s;
+    bool                    constructed=false,
+                            published=false;
+  };
+
+  inline void copy_on_write(group_shared,const arrays_type&,std::size_t)const{}
+
+  inline void copy_on_write(
+    group_exclusive,const arrays_type& arrays_,std::size_t pos)const
+  {
+    auto ps=cow_.load(std::memory_order_acquire);
+    if(BOOST_UNLIKELY(ps!=nullptr)){
+      /* no rehashing during copy-on-write, so old arrays can't be involved */
+      BOOST_ASSERT(&arrays_==&this->arrays);
+      boost::ignore_unused(arrays_);
+      ps->copy_group(*this,*ps,pos);
+    }
+  }
+
+  /* Called with group-level access held. Elements are copied to their
+   * positions in the snapshot and metadata copied last: if copying throws,
+   * the elements of the group already copied are destroyed and the group is
+   * left empty in the snapshot.
+   */
+
+  BOOST_NOINLINE void snapshot_group(snapshot_state& s,std::size_t pos)const
+  {
+    if(s.done.load(std::memory_order_relaxed)||s.copied[pos])return;
+
+    auto& res=s.res;
+    auto  last=this->arrays.groups()+this->arrays.groups_size_mask+1;
+    auto  pg=this->arrays.groups()+pos;
+    auto  p=this->arrays.elements()+pos*N;
+    auto  dpg=reinterpret_cast<group_type*>(res.arrays.groups())+pos;
+    auto  dp=res.arrays.elements()+pos*N;
+    auto  mask=this->match_really_occupied(pg,last);
+    std::size_t num_copied=0;
+    BOOST_TRY{
+      for(auto m=mask;m;m&=m-1){
+        auto n=unchecked_countr_zero(m);
+        res.construct_element(dp+n,p[n]);
+        ++num_copied;
+      }
+    }
+    BOOST_CATCH(...){
+      for(auto m=mask;num_copied--;m&=m-1){
+        res.destroy_element(dp+unchecked_countr_zero(m));
+      }
+      BOOST_RETHROW
+    }
+    BOOST_CATCH_END
+
+    *dpg=*pg;
+    if(super::stores_hash){
+      std::memcpy(
+        res.arrays.hashes()+pos*N,this->arrays.hashes()+pos*N,
+        sizeof(std::size_t)*N);
+    }
+    s.copied[pos]=1;
+    s.size.fetch_add(num_copied,std::memory_order_relaxed);
+  }
+
+  /* Called with exclusive group-level access held, right before a group
+   * is modified: if not serialized or captured yet, its occupied elements
+   * are copied to a newly allocated pre-image.
+   */
+
+  BOOST_NOINLINE void checkpoint_capture_group(
+    checkpoint_state& s,std::size_t pos)const
+  {
+    auto& g=s.groups[pos];
+    if(g.status!=checkpoint_group::fresh)return;
+
+    auto last=this->arrays.groups()+this->arrays.groups_size_mask+1;
+    auto pg=this->arrays.groups()+pos;
+    auto p=this->arrays.elements()+pos*N;
+    auto mask=this->match_really_occupied(pg,last);
+    if(mask){
+      typename checkpoint_state::element_allocator_type eal(s.al);
+      auto        pre=boost::allocator_allocate(eal,N);
+      auto        dp=boost::to_address(pre);
+      std::size_t num_copied=0;
+      BOOST_TRY{
+        for(auto m=mask;m;m&=m-1){
+          auto n=unchecked_countr_zero(m);
+          type_policy::construct(s.al,dp+n,p[n]);
+          ++num_copied;
+        }
+      }
+      BOOST_CATCH(...){
+        for(auto m=mask;num_copied--;m&=m-1){
+          type_policy::destroy(s.al,dp+unchecked_countr_zero(m));
+        }
+        boost::allocator_deallocate(eal,pre,N);
+        BOOST_RETHROW
+      }
+      BOOST_CATCH_END
+      g.elements=pre;
+    }
+    g.mask=mask;
+    g.status=checkpoint_group::captured;
+  }
+
+  template<typename F>
+  void checkpoint_impl(std::size_t n,F run)const
+  {
+    using chunk_allocator_type=
+      typename boost::allocator_rebind<Allocator,checkpoint_chunk>::type;
+
+    lock_guard<mutex_type>       clck{cow_mutex}; /* one at a time */
+    cow_holder<checkpoint_state> ch{*this};
+    auto                         lck=shared_access();
+
+    unprotected_complete_rehash();
+    std::size_t num_groups=0;
+    if(this->arrays.elements()){
+      ch.construct();
+      ch.publish();
+      num_groups=this->arrays.groups_size_mask+1;
+    }
+
+    std::vector<checkpoint_chunk,chunk_allocator_type> chunks{
+      chunk_allocator_type(this->al())};
+    chunks.reserve(n);
+    for(std::size_t i=0;i<n;++i){
+      /* spread num_groups%n remaining groups over the first chunks */
+      auto q=num_groups/n,r=num_groups%n;
+      chunks.push_back(checkpoint_chunk{
+        this,i*q+(std::min)(i,r),(i+1)*q+(std::min)(i+1,r)});
+    }
+    run(chunks.data(),n);
+  }
+
+  template<typename Archive>
+  void save_checkpoint_chunk(Archive& ar,const checkpoint_chunk& c)const
+  {
+    /* pre-images are released as they are written */
+    BOOST_ASSERT(!c.saved);
+    c.saved=true;
+
+    auto ps=c.first==c.last?
+      nullptr:
+      static_cast<checkpoint_state*>(cow_.load(std::memory_order_relaxed));
+    auto last=this->arrays.groups()+this->arrays.groups_size_mask+1;
+
+    std::size_t s=0;
+    for(auto pos=c.first;pos<c.last;++pos){
+      auto  lck=access(group_shared{},pos);
+      auto& g=ps->groups[pos];
+      auto  mask=g.status==checkpoint_group::captured?
+        g.mask:this->match_really_occupied(this->arrays.groups()+pos,last);
+      for(;mask;mask&=mask-1)++s;
+    }
+
+    save_header(ar,s);
+    for(auto pos=c.first;pos<c.last;++pos){
+      auto  lck=access(group_shared{},pos);
+      auto& g=ps->groups[pos];
+      if(g.status==checkpoint_group::captured){
+        auto p=boost::to_address(g.elements);
+        for(auto m=g.mask;m;m&=m-1){
+          save_element(ar,p+unchecked_countr_zero(m));
+        }
+        ps->release(g);
+      }
+      else{
+        auto p=this->arrays.elements()+pos*N;
+        for(auto m=this->match_really_occupied(this->arrays.groups()+pos,last);
+            m;m&=m-1){
+          save_element(ar,p+unchecked_countr_zero(m));
+        }
+      }
+      g.status=checkpoint_group::written;
+    }
+  }
+
+  /* Const casts value_type& according to the level of group access for
+   * safe passing to visitation functions. When type_policy is set-like,
+   * access is always const regardless of group access.
+   */
+
+  static inline const value_type&
+  cast_for(group_shared,value_type& x){return x;}
+
+  static inline typename std::conditional<
+    std::is_same<key_type,value_type>::value,
+    const value_type&,
+    value_type&
+  >::type
+  cast_for(group_exclusive,value_type& x){return x;}
+
+  struct erase_on_exit
+  {
+    erase_on_exit(
+      concurrent_table& x_,
+      group_type* pg_,unsigned int pos_,element_type* p_):
+      x(x_),pg(pg_),pos(pos_),p(p_){}
+    ~erase_on_exit(){if(!rollback_)x.super::erase(pg,pos,p);}
+
+    void rollback(){rollback_=true;}
+
+    concurrent_table &x;
+    group_type       *pg;
+    unsigned  int     pos;
     element_type     *p;
     bool              rollback_=false;
   };
@@ -1089,19 +1877,88 @@ private:
   BOOST_FORCEINLINE std::size_t visit_impl(
     GroupAccessMode access_mode,const Key& x,F&& f)const
   {
+    finalize_rehash_if_done();
     auto lck=shared_access();
+    unprotected_rehash_step();
     auto hash=this->hash_for(x);
     return unprotected_visit(
       access_mode,x,this->position_for(hash),hash,std::forward<F>(f));
   }
 
+  template<typename GroupAccessMode,typename Key,typename F>
+  BOOST_FORCEINLINE std::size_t visit_hashed_impl(
+    GroupAccessMode access_mode,const Key& x,std::size_t hash,F&& f)const
+  {
+    finalize_rehash_if_done();
+    auto lck=shared_access();
+    unprotected_rehash_step();
+    return unprotected_visit(
+      access_mode,x,this->position_for(hash),hash,std::forward<F>(f));
+  }
+
+  template<typename Key,typename F>
+  BOOST_FORCEINLINE std::size_t unprotected_erase_if(
+    const Key& x,std::size_t hash,F&& f)
+  {
+    std::size_t res=0;
+    unprotected_internal_visit(
+      group_exclusive{},x,this->position_for(hash),hash,
+      [&,this](group_type* pg,unsigned int n,element_type* p)
+      {
+        if(f(cast_for(group_exclusive{},type_policy::value_from(*p)))){
+          super::erase(pg,n,p);
+          res=1;
+        }
+      });
+    return res;
+  }
+
   template<typename GroupAccessMode,typename FwdIterator,typename F>
   BOOST_FORCEINLINE
   std::size_t bulk_visit_impl(
     GroupAccessMode access_mode,FwdIterator first,FwdIterator last,F&& f)const
   {
+#if defined(BOOST_UNORDERED_RUNTIME_DISPATCH)
+    if(cpu_supports_avx2_bmi()){
+      return avx2_bulk_visit_impl(
+        access_mode,first,last,std::forward<F>(f));
+    }
+#endif
+
+    return bulk_visit_loop(access_mode,first,last,std::forward<F>(f));
+  }
+
+#if defined(BOOST_UNORDERED_RUNTIME_DISPATCH)
+  template<typename GroupAccessMode,typename FwdIterator,typename F>
+  BOOST_UNORDERED_AVX2_DISPATCH_TARGET
+  std::size_t avx2_bulk_visit_impl(
+    GroupAccessMode access_mode,FwdIterator first,FwdIterator last,F&& f)const
+  {
+    return bulk_visit_loop(access_mode,first,last,std::forward<F>(f));
+  }
+#endif
+
+  template<typename GroupAccessMode,typename FwdIterator,typename F>
+  BOOST_FORCEINLINE std::size_t bulk_visit_loop(
+    GroupAccessMode access_mode,FwdIterator first,FwdIterator last,F&& f)const
+  {
+    finalize_rehash_if_done();
     auto        lck=shared_access();
     std::size_t res=0;
+    unprotected_rehash_step();
+
+#if defined(BOOST_UNORDERED_ENABLE_INCREMENTAL_REHASH)
+    if(BOOST_UNLIKELY(old_arrays_in_use())){
+      /* keys can be in either arrays, go one by one */
+      for(;first!=last;++first){
+        auto hash=this->hash_for(*first);
+        res+=unprotected_visit(
+          access_mode,*first,this->position_for(hash),hash,f);
+      }
+      return res;
+    }
+#endif
+
     auto        n=static_cast<std::size_t>(std::distance(first,last));
     while(n){
       auto m=n<2*bulk_visit_size?n:bulk_visit_size;
@@ -1169,12 +2026,120 @@ private:
     GroupAccessMode access_mode,
     const Key& x,std::size_t pos0,std::size_t hash,F&& f)const
   {
+#if defined(BOOST_UNORDERED_ENABLE_OPTIMISTIC_READS)
+    int res=unprotected_optimistic_visit(
+      x,pos0,hash,f,
+      std::integral_constant<
+        bool,
+        optimistic_reads&&std::is_same<GroupAccessMode,group_shared>::value
+      >{});
+    if(BOOST_LIKELY(res>=0))return static_cast<std::size_t>(res);
+#endif
+
     return unprotected_internal_visit(
       access_mode,x,pos0,hash,
       [&](group_type*,unsigned int,element_type* p)
         {f(cast_for(access_mode,type_policy::value_from(*p)));});
   }
 
+#if defined(BOOST_UNORDERED_ENABLE_OPTIMISTIC_READS)
+  /* Seqlock-style lookup for const access: candidate elements are copied
+   * without taking the group lock, and the copy is only compared and passed
+   * to f if the group's version did not change in the meantime. Copying
+   * racy bytes is safe for trivially copyable elements only. Returns -1 on
+   * conflict with a writer, in which case the regular, locked lookup is
+   * used. f is never invoked more than once.
+   */
+
+  static constexpr bool optimistic_reads=
+    is_trivially_copy_constructible<element_type>::value&&
+    std::is_trivially_destructible<element_type>::value;
+
+  template<typename Key,typename F>
+  BOOST_FORCEINLINE int unprotected_optimistic_visit(
+    const Key&,std::size_t,std::size_t,F&,std::false_type)const
+  {
+    return -1;
+  }
+
+  template<typename Key,typename F>
+  BOOST_FORCEINLINE int unprotected_optimistic_visit(
+    const Key& x,std::size_t pos0,std::size_t hash,F& f,std::true_type)const
+  {
+#if defined(BOOST_UNORDERED_ENABLE_INCREMENTAL_REHASH)
+    /* old arrays go first, see incremental rehash notes above */
+    if(BOOST_UNLIKELY(old_arrays_in_use())){
+      int res=unprotected_optimistic_visit(
+        old_arrays,x,this->position_for(hash,old_arrays),hash,f);
+      if(res!=0)return res;
+    }
+#endif
+
+    return unprotected_optimistic_visit(this->arrays,x,pos0,hash,f);
+  }
+
+  template<typename Key,typename F>
+  BOOST_FORCEINLINE int unprotected_optimistic_visit(
+    const arrays_type& arrays_,
+    const Key& x,std::size_t pos0,std::size_t hash,F& f)const
+  {
+    union element_copy
+    {
+      element_copy(){}
+      element_type e;
+    };
+
+    BOOST_UNORDERED_STATS_COUNTER(num_cmps);
+    prober pb(pos0);
+    do{
+      auto pos=pb.get();
+      auto pg=arrays_.groups()+pos;
+      auto mask=pg->match(hash);
+      if(mask){
+        auto  p=arrays_.elements()+pos*N;
+        BOOST_UNORDERED_PREFETCH_ELEMENTS(p,N);
+        auto& ga=arrays_.group_accesses()[pos];
+        auto  v=ga.read_begin();
+        if(BOOST_UNLIKELY(v&1))return -1;
+        do{
+          auto n=unchecked_countr_zero(mask);
+          if(BOOST_LIKELY(pg->is_occupied(n))){
+            element_copy c;
+            std::memcpy( /* see copy_elements_array_from in core.hpp */
+              reinterpret_cast<unsigned char*>(&c.e),
+              reinterpret_cast<const unsigned char*>(p+n),
+              sizeof(element_type));
+            std::size_t stored_hash=hash;
+            if(super::stores_hash){
+              std::memcpy(
+                &stored_hash,arrays_.hashes()+pos*N+n,sizeof(std::size_t));
+            }
+            if(BOOST_UNLIKELY(!ga.read_validate(v)))return -1;
+            BOOST_UNORDERED_INCREMENT_STATS_COUNTER(num_cmps);
+            if(stored_hash==hash&&bool(this->pred()(x,this->key_from(c.e)))){
+              ga.reference(n);
+              f(cast_for(group_shared{},type_policy::value_from(c.e)));
+              BOOST_UNORDERED_ADD_STATS(
+                cstats.successful_lookup,(pb.length(),num_cmps));
+              return 1;
+            }
+          }
+          mask&=mask-1;
+        }while(mask);
+      }
+      if(BOOST_LIKELY(pg->is_not_overflowed(hash))){
+        BOOST_UNORDERED_ADD_STATS(
+          cstats.unsuccessful_lookup,(pb.length(),num_cmps));
+        return 0;
+      }
+    }
+    while(BOOST_LIKELY(pb.next(arrays_.groups_size_mask)));
+    BOOST_UNORDERED_ADD_STATS(
+      cstats.unsuccessful_lookup,(pb.length(),num_cmps));
+    return 0;
+  }
+#endif
+
 #if defined(BOOST_MSVC)
 /* warning: forcing value to bool 'true' or 'false' in bool(pred()...) */
 #pragma warning(push)
@@ -1185,31 +2150,62 @@ private:
   BOOST_FORCEINLINE std::size_t unprotected_internal_visit(
     GroupAccessMode access_mode,
     const Key& x,std::size_t pos0,std::size_t hash,F&& f)const
+  {
+#if defined(BOOST_UNORDERED_ENABLE_INCREMENTAL_REHASH)
+    /* old arrays go first, see incremental rehash notes above */
+    if(BOOST_UNLIKELY(old_arrays_in_use())){
+      if(unprotected_internal_visit(
+        access_mode,old_arrays,x,
+        this->position_for(hash,old_arrays),hash,f))return 1;
+    }
+#endif
+
+    return unprotected_internal_visit(
+      access_mode,this->arrays,x,pos0,hash,std::forward<F>(f));
+  }
+
+  template<typename GroupAccessMode,typename Key,typename F>
+  BOOST_FORCEINLINE std::size_t unprotected_internal_visit(
+    GroupAccessMode access_mode,const arrays_type& arrays_,
+    const Key& x,std::size_t pos0,std::size_t hash,F&& f)const
   {    
+    BOOST_UNORDERED_STATS_COUNTER(num_cmps);
     prober pb(pos0);
     do{
       auto pos=pb.get();
-      auto pg=this->arrays.groups()+pos;
+      auto pg=arrays_.groups()+pos;
       auto mask=pg->match(hash);
       if(mask){
-        auto p=this->arrays.elements()+pos*N;
+        auto p=arrays_.elements()+pos*N;
         BOOST_UNORDERED_PREFETCH_ELEMENTS(p,N);
-        auto lck=access(access_mode,pos);
+        auto lck=access(access_mode,arrays_,pos);
+        copy_on_write(access_mode,arrays_,pos);
         do{
           auto n=unchecked_countr_zero(mask);
-          if(BOOST_LIKELY(
-            pg->is_occupied(n)&&bool(this->pred()(x,this->key_from(p[n]))))){
-            f(pg,n,p+n);
-            return 1;
+          if(BOOST_LIKELY(pg->is_occupied(n))){
+            BOOST_UNORDERED_INCREMENT_STATS_COUNTER(num_cmps);
+            if(BOOST_LIKELY(
+              this->hash_matches(arrays_,p+n,hash)&&
+              bool(this->pred()(x,this->key_from(p[n]))))){
+              arrays_.group_accesses()[pos].reference(n);
+              f(pg,n,p+n);
+              BOOST_UNORDERED_ADD_STATS(
+                cstats.successful_lookup,(pb.length(),num_cmps));
+              return 1;
+            }
           }
           mask&=mask-1;
         }while(mask);
       }
       if(BOOST_LIKELY(pg->is_not_overflowed(hash))){
+        BOOST_UNORDERED_ADD_STATS(
+          cstats.unsuccessful_lookup,(pb.length(),num_cmps));
         return 0;
       }
     }
-    while(BOOST_LIKELY(pb.next(this->arrays.groups_size_mask)));
+    while(BOOST_LIKELY(pb.next(arrays_.groups_size_mask)));
+    BOOST_UNORDERED_ADD_STATS(
+      cstats.unsuccessful_lookup,(pb.length(),num_cmps));
     return 0;
   }
 
@@ -1219,10 +2215,12 @@ private:
   {
     BOOST_ASSERT(m<2*bulk_visit_size);
 
+    using mask_type=decltype(std::declval<const group_type&>().match(0));
+
     std::size_t res=0,
                 hashes[2*bulk_visit_size-1],
                 positions[2*bulk_visit_size-1];
-    int         masks[2*bulk_visit_size-1];
+    mask_type   masks[2*bulk_visit_size-1];
     auto        it=first;
 
     for(auto i=m;i--;++it){
@@ -1248,20 +2246,27 @@ private:
       prober        pb(pos);
       auto          pg=this->arrays.groups()+pos;
       auto          mask=masks[i];
+      BOOST_UNORDERED_STATS_COUNTER(num_cmps);
       element_type *p;
       if(!mask)goto post_mask;
       p=this->arrays.elements()+pos*N;
       for(;;){
         {
           auto lck=access(access_mode,pos);
+          copy_on_write(access_mode,this->arrays,pos);
           do{
             auto n=unchecked_countr_zero(mask);
-            if(BOOST_LIKELY(
-              pg->is_occupied(n)&&
-              bool(this->pred()(*it,this->key_from(p[n]))))){
-              f(cast_for(access_mode,type_policy::value_from(p[n])));
-              ++res;
-              goto next_key;
+            if(BOOST_LIKELY(pg->is_occupied(n))){
+              BOOST_UNORDERED_INCREMENT_STATS_COUNTER(num_cmps);
+              if(BOOST_LIKELY(
+                this->hash_matches(this->arrays,p+n,hashes[i])&&
+                bool(this->pred()(*it,this->key_from(p[n]))))){
+                f(cast_for(access_mode,type_policy::value_from(p[n])));
+                ++res;
+                BOOST_UNORDERED_ADD_STATS(
+                  cstats.successful_lookup,(pb.length(),num_cmps));
+                goto next_key;
+              }
             }
             mask&=mask-1;
           }while(mask);
@@ -1270,6 +2275,8 @@ private:
         do{
           if(BOOST_LIKELY(pg->is_not_overflowed(hashes[i]))||
              BOOST_UNLIKELY(!pb.next(this->arrays.groups_size_mask))){
+            BOOST_UNORDERED_ADD_STATS(
+              cstats.unsuccessful_lookup,(pb.length(),num_cmps));
             goto next_key;
           }
           pos=pb.get();
@@ -1330,6 +2337,7 @@ private:
   BOOST_FORCEINLINE bool construct_and_emplace_or_visit(
     GroupAccessMode access_mode,F&& f,Args&&... args)
   {
+    finalize_rehash_if_done();
     auto lck=shared_access();
 
     alloc_cted_insert_type<type_policy,Allocator,Args...> x(
@@ -1387,6 +2395,7 @@ private:
   BOOST_FORCEINLINE bool emplace_or_visit_impl(
     GroupAccessMode access_mode,F&& f,Args&&... args)
   {
+    finalize_rehash_if_done();
     for(;;){
       {
         auto lck=shared_access();
@@ -1398,29 +2407,189 @@ private:
     }
   }
 
-  template<typename... Args>
-  BOOST_FORCEINLINE bool unprotected_emplace(Args&&... args)
+  template<typename GroupAccessMode,typename F,typename... Args>
+  BOOST_FORCEINLINE bool emplace_or_visit_hashed_impl(
+    GroupAccessMode access_mode,std::size_t hash,F&& f,Args&&... args)
   {
-    const auto &k=this->key_from(std::forward<Args>(args)...);
-    auto        hash=this->hash_for(k);
-    auto        pos0=this->position_for(hash);
+    finalize_rehash_if_done();
+    for(;;){
+      {
+        auto lck=shared_access();
+        int res=unprotected_norehash_emplace_or_visit_hashed(
+          access_mode,hash,std::forward<F>(f),std::forward<Args>(args)...);
+        if(BOOST_LIKELY(res>=0))return res!=0;
+      }
+      rehash_if_full();
+    }
+  }
 
-    if(this->find(k,pos0,hash))return false;
+  template<typename GroupAccessMode,typename InputIterator,typename F>
+  std::size_t range_emplace_or_visit(
+    GroupAccessMode access_mode,InputIterator first,InputIterator last,F&& f)
+  {
+    using reference=typename std::iterator_traits<InputIterator>::reference;
+    using is_value=is_similar_to_any<reference,value_type,init_type>;
 
-    if(BOOST_LIKELY(this->size_ctrl.size<this->size_ctrl.ml)){
-      this->unchecked_emplace_at(pos0,hash,std::forward<Args>(args)...);
-    }
-    else{
-      this->unchecked_emplace_with_rehash(hash,std::forward<Args>(args)...);
-    }
-    return true;
+    return range_emplace_or_visit(
+      access_mode,first,last,std::forward<F>(f),
+      std::integral_constant<
+        bool,is_forward_iterator<InputIterator>::value&&is_value::value>{});
   }
 
-  struct reserve_size
+  template<typename GroupAccessMode,typename InputIterator,typename F>
+  std::size_t range_emplace_or_visit(
+    GroupAccessMode access_mode,InputIterator first,InputIterator last,F&& f,
+    std::false_type /* bulk processing */)
   {
-    reserve_size(concurrent_table& x_):x(x_)
-    {
-      size_=++x.size_ctrl.size;
+    using reference=typename std::iterator_traits<InputIterator>::reference;
+    using is_value=is_similar_to_any<reference,value_type,init_type>;
+
+    std::size_t res=0;
+    for(;first!=last;++first){
+      res+=element_emplace_or_visit(access_mode,f,*first,is_value{});
+    }
+    return res;
+  }
+
+  template<typename GroupAccessMode,typename F,typename Arg>
+  BOOST_FORCEINLINE bool element_emplace_or_visit(
+    GroupAccessMode access_mode,F&& f,Arg&& x,std::true_type /* is_value */)
+  {
+    return emplace_or_visit_impl(
+      access_mode,std::forward<F>(f),std::forward<Arg>(x));
+  }
+
+  template<typename GroupAccessMode,typename F,typename Arg>
+  BOOST_FORCEINLINE bool element_emplace_or_visit(
+    GroupAccessMode access_mode,F&& f,Arg&& x,std::false_type /* is_value */)
+  {
+    return construct_and_emplace_or_visit(
+      access_mode,std::forward<F>(f),std::forward<Arg>(x));
+  }
+
+  template<typename GroupAccessMode,typename FwdIterator,typename F>
+  std::size_t range_emplace_or_visit(
+    GroupAccessMode access_mode,FwdIterator first,FwdIterator last,F&& f,
+    std::true_type /* bulk processing */)
+  {
+    return bulk_emplace_or_visit_impl(
+      access_mode,first,last,std::forward<F>(f));
+  }
+
+  template<
+    typename GroupAccessMode,typename FwdIterator,typename F,
+    typename... Prefix
+  >
+  BOOST_FORCEINLINE std::size_t bulk_emplace_or_visit_impl(
+    GroupAccessMode access_mode,FwdIterator first,FwdIterator last,F&& f,
+    Prefix... prefix)
+  {
+#if defined(BOOST_UNORDERED_RUNTIME_DISPATCH)
+    if(cpu_supports_avx2_bmi()){
+      return avx2_bulk_emplace_or_visit_impl(
+        access_mode,first,last,std::forward<F>(f),prefix...);
+    }
+#endif
+
+    return bulk_emplace_or_visit_loop(
+      access_mode,first,last,std::forward<F>(f),prefix...);
+  }
+
+#if defined(BOOST_UNORDERED_RUNTIME_DISPATCH)
+  template<
+    typename GroupAccessMode,typename FwdIterator,typename F,
+    typename... Prefix
+  >
+  BOOST_UNORDERED_AVX2_DISPATCH_TARGET
+  std::size_t avx2_bulk_emplace_or_visit_impl(
+    GroupAccessMode access_mode,FwdIterator first,FwdIterator last,F&& f,
+    Prefix... prefix)
+  {
+    return bulk_emplace_or_visit_loop(
+      access_mode,first,last,std::forward<F>(f),prefix...);
+  }
+#endif
+
+  /* Elements are processed in chunks of bulk_visit_size (the last one
+   * possibly up to 2*bulk_visit_size-1): hashes for the whole chunk are
+   * calculated and their initial groups prefetched before proceeding to
+   * insertion proper, which is done in range order so that later duplicates
+   * in the same chunk get visited rather than inserted. The table-level
+   * shared lock is held through the entire range and only released when
+   * the table becomes full, in which case we rehash and resume from the
+   * element that failed; hashes are then recalculated, as the hash function
+   * could have been replaced in the meantime.
+   */
+
+  template<
+    typename GroupAccessMode,typename FwdIterator,typename F,
+    typename... Prefix
+  >
+  BOOST_FORCEINLINE std::size_t bulk_emplace_or_visit_loop(
+    GroupAccessMode access_mode,FwdIterator first,FwdIterator last,F&& f,
+    Prefix... prefix)
+  {
+    std::size_t res=0,
+                hashes[2*bulk_visit_size-1],
+                n=static_cast<std::size_t>(std::distance(first,last)),
+                m=0, /* size of current chunk */
+                i=0; /* index of next element to process in chunk */
+
+    finalize_rehash_if_done();
+    for(;;){
+      {
+        auto lck=shared_access();
+        for(;;){
+          if(i==m){
+            n-=m;
+            if(!n)return res;
+            m=n<2*bulk_visit_size?n:bulk_visit_size;
+            i=0;
+          }
+
+          auto it=first;
+          for(auto j=i;j<m;++j,++it){
+            auto hash=hashes[j]=this->hash_for(this->key_from(prefix...,*it));
+            BOOST_UNORDERED_PREFETCH(
+              this->arrays.groups()+this->position_for(hash));
+          }
+
+          for(;i<m;++i,++first){
+            int r=unprotected_norehash_emplace_or_visit_hashed(
+              access_mode,hashes[i],f,prefix...,*first);
+            if(BOOST_UNLIKELY(r<0))goto rehash;
+            res+=static_cast<std::size_t>(r);
+          }
+        }
+      }
+    rehash:
+      rehash_if_full();
+    }
+  }
+
+  template<typename... Args>
+  BOOST_FORCEINLINE bool unprotected_emplace(Args&&... args)
+  {
+    const auto &k=this->key_from(std::forward<Args>(args)...);
+    auto        hash=this->hash_for(k);
+    auto        pos0=this->position_for(hash);
+
+    if(this->find(k,pos0,hash))return false;
+
+    if(BOOST_LIKELY(this->size_ctrl.size<this->size_ctrl.ml)){
+      this->unchecked_emplace_at(pos0,hash,std::forward<Args>(args)...);
+    }
+    else{
+      this->unchecked_emplace_with_rehash(hash,std::forward<Args>(args)...);
+    }
+    return true;
+  }
+
+  struct reserve_size
+  {
+    reserve_size(concurrent_table& x_):x(x_)
+    {
+      size_=++x.size_ctrl.size;
     }
 
     ~reserve_size()
@@ -1461,11 +2630,21 @@ private:
   BOOST_FORCEINLINE int
   unprotected_norehash_emplace_or_visit(
     GroupAccessMode access_mode,F&& f,Args&&... args)
+  {
+    return unprotected_norehash_emplace_or_visit_hashed(
+      access_mode,this->hash_for(this->key_from(std::forward<Args>(args)...)),
+      std::forward<F>(f),std::forward<Args>(args)...);
+  }
+
+  template<typename GroupAccessMode,typename F,typename... Args>
+  BOOST_FORCEINLINE int
+  unprotected_norehash_emplace_or_visit_hashed(
+    GroupAccessMode access_mode,std::size_t hash,F&& f,Args&&... args)
   {
     const auto &k=this->key_from(std::forward<Args>(args)...);
-    auto        hash=this->hash_for(k);
     auto        pos0=this->position_for(hash);
 
+    unprotected_rehash_step();
     for(;;){
     startover:
       boost::uint32_t counter=insert_counter(pos0);
@@ -1478,6 +2657,7 @@ private:
           auto pos=pb.get();
           auto pg=this->arrays.groups()+pos;
           auto lck=access(group_exclusive{},pos);
+          copy_on_write(group_exclusive{},this->arrays,pos);
           auto mask=pg->match_available();
           if(BOOST_LIKELY(mask!=0)){
             auto n=unchecked_countr_zero(mask);
@@ -1488,8 +2668,11 @@ private:
             }
             auto p=this->arrays.elements()+pos*N+n;
             this->construct_element(p,std::forward<Args>(args)...);
+            this->store_hash(this->arrays,p,hash);
+            this->arrays.group_accesses()[pos].reference(n);
             rslot.commit();
             rsize.commit();
+            BOOST_UNORDERED_ADD_STATS(cstats.insertion,(pb.length()));
             return 1;
           }
           pg->mark_overflow(hash);
@@ -1501,12 +2684,349 @@ private:
 
   void rehash_if_full()
   {
+#if defined(BOOST_UNORDERED_ENABLE_INCREMENTAL_REHASH)
+    if(incremental_rehash){
+      start_incremental_rehash();
+      return;
+    }
+#endif
+
     auto lck=exclusive_access();
     if(this->size_ctrl.size==this->size_ctrl.ml){
       this->unchecked_rehash_for_growth();
     }
   }
 
+#if defined(BOOST_UNORDERED_ENABLE_INCREMENTAL_REHASH)
+  /* Elements are moved from the old arrays with the table-level lock in
+   * shared mode, so moving must not throw: otherwise, we resort to regular
+   * rehashing. The hash function may still throw when recomputing hash
+   * values, see unprotected_rehash_step.
+   */
+
+  static constexpr bool incremental_rehash=
+    std::is_nothrow_move_constructible<init_type>::value||
+    !std::is_same<element_type,value_type>::value;
+
+  bool old_arrays_in_use()const
+  {
+    return
+      rehashing.load(std::memory_order_relaxed)&&
+      rehashed_groups.load(std::memory_order_acquire)!=
+        old_arrays.groups_size_mask+1;
+  }
+
+  struct migration_in_flight
+  {
+    migration_in_flight(const concurrent_table& x_):x(x_)
+    {
+      ++x.migrations_in_flight;
+    }
+
+    ~migration_in_flight(){--x.migrations_in_flight;}
+
+    const concurrent_table& x;
+  };
+
+  /* Called with the table-level lock in shared mode and no group locks
+   * held: migrates the next pending group of the old arrays, if any.
+   */
+
+  void unprotected_rehash_step()const
+  {
+    if(BOOST_LIKELY(!rehashing.load(std::memory_order_relaxed)))return;
+
+    migration_in_flight mif{*this};
+    if(traversals.load()||rehash_failed.load(std::memory_order_relaxed))return;
+
+    auto n=old_arrays.groups_size_mask+1;
+    auto pos=rehash_cursor.fetch_add(1,std::memory_order_relaxed);
+    if(pos>=n)return;
+    BOOST_TRY{
+      migrate_group(pos);
+    }
+    BOOST_CATCH(...){
+      /* The group is left partially migrated and won't be counted as done,
+       * so incremental migration stops here: its remaining elements are
+       * still found in the old arrays, and migration is completed with the
+       * table locked exclusively (see finalize_rehash_if_done).
+       */
+      rehash_failed.store(true,std::memory_order_relaxed);
+      BOOST_RETHROW
+    }
+    BOOST_CATCH_END
+    if(rehashed_groups.fetch_add(1,std::memory_order_acq_rel)+1==n){
+      rehash_done.store(true,std::memory_order_release);
+    }
+  }
+
+  /* Called with the table-level lock in shared mode: helps migrate pending
+   * groups until the old arrays are no longer in use.
+   */
+
+  void unprotected_complete_rehash()const
+  {
+    while(old_arrays_in_use()){
+      if(BOOST_UNLIKELY(rehash_failed.load(std::memory_order_relaxed))){
+        if(unprotected_drain_old_arrays())return;
+        boost::core::sp_thread_yield();
+        continue;
+      }
+      auto n=rehashed_groups.load(std::memory_order_relaxed);
+      unprotected_rehash_step();
+      if(rehashed_groups.load(std::memory_order_relaxed)==n){
+        /* paused by a traversal or last groups being migrated elsewhere */
+        boost::core::sp_thread_yield();
+      }
+    }
+  }
+
+  /* Called with the table-level lock in shared mode after migration has
+   * failed: moves all remaining elements of the old arrays to the new ones,
+   * so that the caller can ignore the former, or returns false if paused by
+   * a traversal. Group locks serialize this with migrations in progress.
+   * The old arrays are released later by finalize_rehash_if_done.
+   */
+
+  bool unprotected_drain_old_arrays()const
+  {
+    migration_in_flight mif{*this};
+    if(traversals.load())return false;
+
+    for(std::size_t pos=0;pos<=old_arrays.groups_size_mask;++pos){
+      migrate_group(pos);
+    }
+    return true;
+  }
+
+  /* Called with no locks held by insertion, erasure and lookup operations,
+   * so that the old arrays are released even if the table is not inserted
+   * into after the last group has been migrated.
+   */
+
+  void finalize_rehash_if_done()const
+  {
+    if(BOOST_UNLIKELY(rehash_done.load(std::memory_order_relaxed))&&
+       rehash_done.exchange(false)){
+      auto lck=exclusive_access();
+      settle_rehash();
+    }
+    else if(BOOST_UNLIKELY(rehash_failed.load(std::memory_order_relaxed))){
+      /* stop-the-world fallback: if the hash function throws again, the
+       * operation that called us has completed anyway, so we leave
+       * migration pending for the next one
+       */
+      auto lck=exclusive_access();
+      BOOST_TRY{
+        settle_rehash();
+      }
+      BOOST_CATCH(...){
+      }
+      BOOST_CATCH_END
+    }
+  }
+
+  void migrate_group(std::size_t pos)const
+  {
+    auto pg=old_arrays.groups()+pos;
+    auto last=old_arrays.groups()+old_arrays.groups_size_mask+1;
+    auto p=old_arrays.elements()+pos*N;
+    auto lck=access(group_exclusive{},old_arrays,pos);
+    auto mask=this->match_really_occupied(pg,last);
+    while(mask){
+      auto n=unchecked_countr_zero(mask);
+      migrate_element(pg,n,p+n);
+      mask&=mask-1;
+    }
+  }
+
+  void migrate_element(
+    group_type* pg,unsigned int n,element_type* p)const
+  {
+    /* size is not modified as the element is accounted for already */
+
+    auto self=const_cast<concurrent_table*>(this);
+    auto hash=this->hash_of(old_arrays,p);
+    auto pos0=this->position_for(hash);
+    for(prober pb(pos0);;pb.next(this->arrays.groups_size_mask)){
+      auto pos=pb.get();
+      auto pg2=this->arrays.groups()+pos;
+      auto lck=access(group_exclusive{},pos);
+      auto mask=pg2->match_available();
+      if(BOOST_LIKELY(mask!=0)){
+        auto n2=unchecked_countr_zero(mask);
+        reserve_slot rslot{pg2,n2,hash};
+        ++insert_counter(pos0);
+        auto p2=this->arrays.elements()+pos*N+n2;
+        self->construct_element(p2,type_policy::move(*p));
+        this->store_hash(this->arrays,p2,hash);
+        rslot.commit();
+        BOOST_UNORDERED_ADD_STATS(cstats.insertion,(pb.length()));
+        break;
+      }
+      pg2->mark_overflow(hash);
+    }
+    self->destroy_element(p);
+    pg->reset(n);
+  }
+
+  /* Exclusive access required. */
+
+  void settle_rehash()const
+  {
+    if(!rehashing.load(std::memory_order_relaxed))return;
+
+    if(rehashed_groups.load()!=old_arrays.groups_size_mask+1){
+      for(std::size_t pos=0;pos<=old_arrays.groups_size_mask;++pos){
+        migrate_group(pos);
+      }
+    }
+    release_old_arrays();
+  }
+
+  /* Exclusive access required: used when the remaining old elements are
+   * going to be dropped anyway.
+   */
+
+  void discard_old_arrays()noexcept
+  {
+    if(!rehashing.load(std::memory_order_relaxed))return;
+
+    std::size_t n=0;
+    super::for_all_elements(old_arrays,[&,this](element_type* p){
+      this->destroy_element(p);
+      ++n;
+    });
+    this->size_ctrl.size-=n;
+    release_old_arrays();
+  }
+
+  void release_old_arrays()const
+  {
+    arrays_type::delete_(
+      typename arrays_type::allocator_type(this->al()),old_arrays);
+    rehashing.store(false,std::memory_order_relaxed);
+    rehash_done.store(false,std::memory_order_relaxed);
+    rehash_failed.store(false,std::memory_order_relaxed);
+  }
+
+  template<typename Table>
+  static Table& settled(Table& x)
+  {
+    x.settle_rehash();
+    return x;
+  }
+
+  /* The allocator can only have been replaced in the meantime if it
+   * propagates on assignment or swap.
+   */
+
+  static bool same_allocator(const Allocator& x,const Allocator& y)
+  {
+    using alloc_traits=boost::allocator_traits<Allocator>;
+
+    return same_allocator(x,y,std::integral_constant<bool,
+      alloc_traits::propagate_on_container_copy_assignment::value||
+      alloc_traits::propagate_on_container_move_assignment::value||
+      alloc_traits::propagate_on_container_swap::value>{});
+  }
+
+  static bool same_allocator(const Allocator&,const Allocator&,std::false_type)
+  {
+    return true;
+  }
+
+  static bool same_allocator(
+    const Allocator& x,const Allocator& y,std::true_type)
+  {
+    return x==y;
+  }
+
+  struct growing_guard
+  {
+    ~growing_guard(){x.growing.store(false);}
+
+    concurrent_table& x;
+  };
+
+  /* New arrays are allocated and initialized under shared access, and
+   * installed briefly under exclusive access, provided no one else has
+   * replaced the current arrays in the meantime. Concurrent growers just
+   * wait for the winner to complete.
+   */
+
+  BOOST_NOINLINE void start_incremental_rehash()
+  {
+    if(growing.exchange(true)){
+      while(growing.load())boost::core::sp_thread_yield();
+      return;
+    }
+    growing_guard gg{*this};
+
+    std::size_t gsi=0;
+    bool        full=false;
+    auto        ah=[&,this]()->arrays_holder<arrays_type,Allocator>{
+      auto lck=shared_access();
+      gsi=this->arrays.groups_size_index;
+      full=this->size_ctrl.size==this->size_ctrl.ml;
+      if(!full)return this->make_empty_arrays();
+      return this->make_arrays_for_growth();
+    }();
+    if(!full)return;
+
+    auto lck=exclusive_access();
+    settle_rehash();
+    if(this->size_ctrl.size!=this->size_ctrl.ml||
+       this->arrays.groups_size_index!=gsi||
+       !same_allocator(this->al(),ah.get_allocator())){
+      return; /* ah frees the new arrays */
+    }
+    if(this->rebuild_overflow_for_growth())return;
+
+#if defined(BOOST_UNORDERED_ENABLE_STATS)
+    /* only the time the table is blocked is accounted for */
+    scoped_duration_stats<concurrent_cumulative_stats<1>> sds{cstats.rehash};
+#endif
+
+    old_arrays=this->arrays;
+    this->arrays=ah.release();
+    this->size_ctrl.ml=this->initial_max_load();
+    if(!old_arrays.elements()){
+      release_old_arrays();
+      return;
+    }
+    rehash_cursor.store(0,std::memory_order_relaxed);
+    rehashed_groups.store(0,std::memory_order_relaxed);
+    rehashing.store(true,std::memory_order_relaxed);
+  }
+
+  struct rehash_pause
+  {
+    rehash_pause(const concurrent_table& x_):
+      x(x_),paused{x.rehashing.load(std::memory_order_relaxed)}
+    {
+      if(paused){
+        ++x.traversals;
+        while(x.migrations_in_flight.load())boost::core::sp_thread_yield();
+      }
+    }
+
+    ~rehash_pause(){if(paused)--x.traversals;}
+
+    const concurrent_table& x;
+    bool                    paused;
+  };
+#else
+  void unprotected_rehash_step()const{}
+  void unprotected_complete_rehash()const{}
+  void finalize_rehash_if_done()const{}
+  void settle_rehash()const{}
+  void discard_old_arrays()noexcept{}
+
+  template<typename Table>
+  static Table& settled(Table& x){return x;}
+#endif
+
   template<typename GroupAccessMode,typename F>
   auto for_all_elements(GroupAccessMode access_mode,F f)const
     ->decltype(f(nullptr),void())
@@ -1536,20 +3056,38 @@ private:
   auto for_all_elements_while(GroupAccessMode access_mode,F f)const
     ->decltype(f(nullptr,0,nullptr),bool())
   {
-    auto p=this->arrays.elements();
-    if(p){
-      for(auto pg=this->arrays.groups(),last=pg+this->arrays.groups_size_mask+1;
-          pg!=last;++pg,p+=N){
-        auto lck=access(access_mode,(std::size_t)(pg-this->arrays.groups()));
-        auto mask=this->match_really_occupied(pg,last);
+#if defined(BOOST_UNORDERED_ENABLE_INCREMENTAL_REHASH)
+    rehash_pause pause{*this};
+    if(pause.paused&&
+       !for_all_array_elements_while(access_mode,old_arrays,f))return false;
+#endif
+
+    return for_all_array_elements_while(access_mode,this->arrays,f);
+  }
+
+  /* Groups found empty without locking are skipped: their elements, if any,
+   * were inserted concurrently with the traversal.
+   */
+
+  template<typename GroupAccessMode,typename F>
+  bool for_all_array_elements_while(
+    GroupAccessMode access_mode,const arrays_type& arrays_,F& f)const
+  {
+    auto last=arrays_.groups()+arrays_.groups_size_mask+1;
+    return super::prefetched_for_all_groups_while(
+      arrays_,[&](group_type* pg,decltype(pg->match_occupied()),
+                  element_type* p){
+        auto pos=static_cast<std::size_t>(pg-arrays_.groups());
+        auto lck=access(access_mode,arrays_,pos);
+        copy_on_write(access_mode,arrays_,pos);
+        auto mask=super::match_really_occupied(pg,last);
         while(mask){
           auto n=unchecked_countr_zero(mask);
           if(!f(pg,n,p+n))return false;
           mask&=mask-1;
         }
-      }
-    }
-    return true;
+        return true;
+      });
   }
 
 #if defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
@@ -1568,15 +3106,31 @@ private:
     GroupAccessMode access_mode,ExecutionPolicy&& policy,F f)const
     ->decltype(f(nullptr,0,nullptr),void())
   {
-    if(!this->arrays.elements())return;
-    auto first=this->arrays.groups(),
-         last=first+this->arrays.groups_size_mask+1;
-    std::for_each(std::forward<ExecutionPolicy>(policy),first,last,
-      [&,this](group_type& g){
+#if defined(BOOST_UNORDERED_ENABLE_INCREMENTAL_REHASH)
+    rehash_pause pause{*this};
+    if(pause.paused){
+      for_all_array_elements(access_mode,policy,old_arrays,f);
+    }
+#endif
+
+    for_all_array_elements(access_mode,policy,this->arrays,f);
+  }
+
+  template<typename GroupAccessMode,typename ExecutionPolicy,typename F>
+  void for_all_array_elements(
+    GroupAccessMode access_mode,ExecutionPolicy& policy,
+    const arrays_type& arrays_,F& f)const
+  {
+    if(!arrays_.elements())return;
+    auto first=arrays_.groups(),
+         last=first+arrays_.groups_size_mask+1;
+    std::for_each(policy,first,last,
+      [&](group_type& g){
         auto pos=static_cast<std::size_t>(&g-first);
-        auto p=this->arrays.elements()+pos*N;
-        auto lck=access(access_mode,pos);
-        auto mask=this->match_really_occupied(&g,last);
+        auto p=arrays_.elements()+pos*N;
+        auto lck=access(access_mode,arrays_,pos);
+        copy_on_write(access_mode,arrays_,pos);
+        auto mask=super::match_really_occupied(&g,last);
         while(mask){
           auto n=unchecked_countr_zero(mask);
           f(&g,n,p+n);
@@ -1590,15 +3144,32 @@ private:
   bool for_all_elements_while(
     GroupAccessMode access_mode,ExecutionPolicy&& policy,F f)const
   {
-    if(!this->arrays.elements())return true;
-    auto first=this->arrays.groups(),
-         last=first+this->arrays.groups_size_mask+1;
-    return std::all_of(std::forward<ExecutionPolicy>(policy),first,last,
-      [&,this](group_type& g){
+#if defined(BOOST_UNORDERED_ENABLE_INCREMENTAL_REHASH)
+    rehash_pause pause{*this};
+    if(pause.paused&&
+       !for_all_array_elements_while(access_mode,policy,old_arrays,f)){
+      return false;
+    }
+#endif
+
+    return for_all_array_elements_while(access_mode,policy,this->arrays,f);
+  }
+
+  template<typename GroupAccessMode,typename ExecutionPolicy,typename F>
+  bool for_all_array_elements_while(
+    GroupAccessMode access_mode,ExecutionPolicy& policy,
+    const arrays_type& arrays_,F& f)const
+  {
+    if(!arrays_.elements())return true;
+    auto first=arrays_.groups(),
+         last=first+arrays_.groups_size_mask+1;
+    return std::all_of(policy,first,last,
+      [&](group_type& g){
         auto pos=static_cast<std::size_t>(&g-first);
-        auto p=this->arrays.elements()+pos*N;
-        auto lck=access(access_mode,pos);
-        auto mask=this->match_really_occupied(&g,last);
+        auto p=arrays_.elements()+pos*N;
+        auto lck=access(access_mode,arrays_,pos);
+        copy_on_write(access_mode,arrays_,pos);
+        auto mask=super::match_really_occupied(&g,last);
         while(mask){
           auto n=unchecked_countr_zero(mask);
           if(!f(p+n))return false;
@@ -1619,61 +3190,88 @@ private:
   }
 
   template<typename Archive>
-  void save(Archive& ar,unsigned int version)const
+  void save(Archive& ar,unsigned int)const
   {
-    save(
-      ar,version,
+    auto lck=exclusive_access();
+    settle_rehash();
+
+    save_header(ar,super::size());
+    super::for_all_elements([&,this](element_type* p){save_element(ar,p);});
+  }
+
+  template<typename Archive>
+  void save_header(Archive& ar,std::size_t s)const
+  {
+    save_header(
+      ar,s,
       std::integral_constant<bool,std::is_same<key_type,value_type>::value>{});
   }
 
   template<typename Archive>
-  void save(Archive& ar,unsigned int,std::true_type /* set */)const
+  void save_header(Archive& ar,std::size_t s,std::true_type /* set */)const
   {
-    auto                                    lck=exclusive_access();
-    const std::size_t                       s=super::size();
     const serialization_version<value_type> value_version;
 
     ar<<core::make_nvp("count",s);
     ar<<core::make_nvp("value_version",value_version);
-
-    super::for_all_elements([&,this](element_type* p){
-      auto& x=type_policy::value_from(*p);
-      core::save_construct_data_adl(ar,std::addressof(x),value_version);
-      ar<<serialization::make_nvp("item",x);
-    });
   }
 
   template<typename Archive>
-  void save(Archive& ar,unsigned int,std::false_type /* map */)const
+  void save_header(Archive& ar,std::size_t s,std::false_type /* map */)const
   {
     using raw_key_type=typename std::remove_const<key_type>::type;
     using raw_mapped_type=typename std::remove_const<
       typename TypePolicy::mapped_type>::type;
 
-    auto                                         lck=exclusive_access();
-    const std::size_t                            s=super::size();
     const serialization_version<raw_key_type>    key_version;
     const serialization_version<raw_mapped_type> mapped_version;
 
     ar<<core::make_nvp("count",s);
     ar<<core::make_nvp("key_version",key_version);
     ar<<core::make_nvp("mapped_version",mapped_version);
+  }
 
-    super::for_all_elements([&,this](element_type* p){
-      /* To remain lib-independent from Boost.Serialization and not rely on
-       * the user having included the serialization code for std::pair
-       * (boost/serialization/utility.hpp), we serialize the key and the
-       * mapped value separately.
-       */
+  template<typename Archive>
+  void save_element(Archive& ar,element_type* p)const
+  {
+    save_element(
+      ar,p,
+      std::integral_constant<bool,std::is_same<key_type,value_type>::value>{});
+  }
 
-      auto& x=type_policy::value_from(*p);
-      core::save_construct_data_adl(
-        ar,std::addressof(x.first),key_version);
-      ar<<serialization::make_nvp("key",x.first);
-      core::save_construct_data_adl(
-        ar,std::addressof(x.second),mapped_version);
-      ar<<serialization::make_nvp("mapped",x.second);
-    });
+  template<typename Archive>
+  void save_element(Archive& ar,element_type* p,std::true_type /* set */)const
+  {
+    const serialization_version<value_type> value_version;
+
+    auto& x=type_policy::value_from(*p);
+    core::save_construct_data_adl(ar,std::addressof(x),value_version);
+    ar<<serialization::make_nvp("item",x);
+  }
+
+  template<typename Archive>
+  void save_element(Archive& ar,element_type* p,std::false_type /* map */)const
+  {
+    using raw_key_type=typename std::remove_const<key_type>::type;
+    using raw_mapped_type=typename std::remove_const<
+      typename TypePolicy::mapped_type>::type;
+
+    const serialization_version<raw_key_type>    key_version;
+    const serialization_version<raw_mapped_type> mapped_version;
+
+    /* To remain lib-independent from Boost.Serialization and not rely on
+     * the user having included the serialization code for std::pair
+     * (boost/serialization/utility.hpp), we serialize the key and the
+     * mapped value separately.
+     */
+
+    auto& x=type_policy::value_from(*p);
+    core::save_construct_data_adl(
+      ar,std::addressof(x.first),key_version);
+    ar<<serialization::make_nvp("key",x.first);
+    core::save_construct_data_adl(
+      ar,std::addressof(x.second),mapped_version);
+    ar<<serialization::make_nvp("mapped",x.second);
   }
 
   template<typename Archive>
@@ -1694,9 +3292,18 @@ private:
     ar>>core::make_nvp("count",s);
     ar>>core::make_nvp("value_version",value_version);
 
+    discard_old_arrays();
     super::clear();
     super::reserve(s);
 
+    load_elements(ar,s,value_version,bulk_loadable{});
+  }
+
+  template<typename Archive>
+  void load_elements(
+    Archive& ar,std::size_t s,unsigned int value_version,
+    std::false_type /* element by element */)
+  {
     for(std::size_t n=0;n<s;++n){
       archive_constructed<value_type> value("item",ar,value_version);
       auto&                           x=value.get();
@@ -1725,9 +3332,23 @@ private:
     ar>>core::make_nvp("key_version",key_version);
     ar>>core::make_nvp("mapped_version",mapped_version);
 
+    discard_old_arrays();
     super::clear();
     super::reserve(s);
 
+    load_elements(ar,s,key_version,mapped_version,bulk_loadable{});
+  }
+
+  template<typename Archive>
+  void load_elements(
+    Archive& ar,std::size_t s,
+    unsigned int key_version,unsigned int mapped_version,
+    std::false_type /* element by element */)
+  {
+    using raw_key_type=typename std::remove_const<key_type>::type;
+    using raw_mapped_type=typename std::remove_const<
+      typename TypePolicy::mapped_type>::type;
+
     for(std::size_t n=0;n<s;++n){
       archive_constructed<raw_key_type>    key("key",ar,key_version);
       archive_constructed<raw_mapped_type> mapped("mapped",ar,mapped_version);
@@ -1743,8 +3364,128 @@ private:
     }
   }
 
-  static std::atomic<std::size_t> thread_counter;
-  mutable multimutex_type         mutexes;
+#if defined(BOOST_UNORDERED_ENABLE_PARALLEL_LOAD)&& \
+    defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
+  /* Parallel loading of elements whose types are never tracked by the
+   * archive (see is_untracked_serializable): elements are decoded
+   * bulk_load_size at a time into a buffer of init_type objects, which are
+   * then hashed and moved into the table in parallel through the regular
+   * concurrent insertion algorithm. The archive needs not be notified of the
+   * final addresses. Decoding is inherently sequential; when not
+   * parallelized, buffering is no faster than interleaving decoding with
+   * insertion as load_elements(...,std::false_type) does.
+   */
+
+  static constexpr std::size_t bulk_load_size=4096;
+
+  using bulk_loadable=std::integral_constant<
+    bool,
+    is_untracked_serializable<init_type>::value&&
+    std::is_default_constructible<init_type>::value
+  >;
+
+  template<typename Archive>
+  void load_elements(
+    Archive& ar,std::size_t s,unsigned int,std::true_type /* bulk */)
+  {
+    bulk_load(ar,s);
+  }
+
+  template<typename Archive>
+  void load_elements(
+    Archive& ar,std::size_t s,unsigned int,unsigned int,
+    std::true_type /* bulk */)
+  {
+    bulk_load(ar,s);
+  }
+
+  template<typename Archive>
+  void bulk_load(Archive& ar,std::size_t s)
+  {
+    using init_allocator_type=
+      typename boost::allocator_rebind<Allocator,init_type>::type;
+    using init_vector=std::vector<init_type,init_allocator_type>;
+
+    init_vector buf{init_allocator_type(this->al())};
+    buf.reserve((std::min)(s,bulk_load_size));
+    for(std::size_t n=0;n<s;){
+      auto m=(std::min)(s-n,bulk_load_size);
+      buf.resize(m);
+      for(auto& x:buf)load_init(ar,x);
+      bulk_insert_loaded(buf.data(),m);
+      n+=m;
+    }
+  }
+
+  template<typename Archive>
+  static void load_init(Archive& ar,init_type& x)
+  {
+    load_init(
+      ar,x,
+      std::integral_constant<bool,std::is_same<key_type,value_type>::value>{});
+  }
+
+  template<typename Archive>
+  static void load_init(Archive& ar,init_type& x,std::true_type /* set */)
+  {
+    ar>>core::make_nvp("item",x);
+  }
+
+  template<typename Archive>
+  static void load_init(Archive& ar,init_type& x,std::false_type /* map */)
+  {
+    ar>>core::make_nvp("key",x.first);
+    ar>>core::make_nvp("mapped",x.second);
+  }
+
+  void bulk_insert_loaded(init_type* first,std::size_t m)
+  {
+    /* capacity is reserved and the table is under exclusive access, so
+     * insertion can't fail other than on duplicate elements
+     */
+    std::atomic<bool> ok{true};
+    std::for_each(std::execution::par,first,first+m,[&,this](init_type& x){
+      auto hash=this->hash_for(this->key_from(x));
+      if(unprotected_norehash_emplace_or_visit_hashed(
+        group_shared{},hash,[](const value_type&){},std::move(x))!=1){
+        ok.store(false,std::memory_order_relaxed);
+      }
+    });
+    if(!ok.load())throw_exception(bad_archive_exception());
+  }
+#else
+  using bulk_loadable=std::false_type;
+#endif
+
+  static std::atomic<std::size_t>       thread_counter;
+  mutable multimutex_type               mutexes;
+  mutable mutex_type                    cow_mutex;
+  mutable std::atomic<cow_state*>       cow_{nullptr};
+
+#if defined(BOOST_UNORDERED_ENABLE_STATS)
+  /* Operations run under the table-level lock in shared mode update these
+   * thread-safe stats, which hide those of super (used when exclusive access
+   * is held).
+   */
+
+  using concurrent_cumulative_stats_type=
+    table_core_cumulative_stats<concurrent_cumulative_stats>;
+
+  mutable concurrent_cumulative_stats_type cstats;
+#endif
+
+#if defined(BOOST_UNORDERED_ENABLE_INCREMENTAL_REHASH)
+  mutable arrays_type              old_arrays{
+    typename arrays_type::super{0,0,nullptr,nullptr},nullptr};
+  mutable std::atomic<bool>        rehashing{false},
+                                   rehash_done{false},
+                                   rehash_failed{false},
+                                   growing{false};
+  mutable std::atomic<std::size_t> rehash_cursor{0},
+                                   rehashed_groups{0},
+                                   traversals{0},
+                                   migrations_in_flight{0};
+#endif
 };
 
 template<typename T,typename H,typename P,typename A>
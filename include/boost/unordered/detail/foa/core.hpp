@@ -28,18 +28,29 @@
 #include <boost/unordered/detail/mulx.hpp>
 #include <boost/unordered/detail/static_assert.hpp>
 #include <boost/unordered/detail/type_traits.hpp>
+#include <boost/unordered/detail/foa/element_type.hpp>
+#include <boost/unordered/detail/foa/huge_pages.hpp>
+#include <boost/unordered/detail/foa/rw_spinlock.hpp>
 #include <boost/unordered/hash_traits.hpp>
+#include <atomic>
 #include <climits>
 #include <cmath>
 #include <cstddef>
 #include <cstring>
+#include <exception>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <new>
 #include <tuple>
 #include <type_traits>
 #include <utility>
 
+#if defined(BOOST_UNORDERED_ENABLE_STATS)
+#include <boost/unordered/detail/foa/cumulative_stats.hpp>
+#include <chrono>
+#endif
+
 #if !defined(BOOST_UNORDERED_DISABLE_SSE2)
 #if defined(BOOST_UNORDERED_ENABLE_SSE2)|| \
     defined(__SSE2__)|| \
@@ -55,12 +66,53 @@
 #endif
 #endif
 
+/* Wide metadata groups (group31/group63) change the observable layout of
+ * containers (iteration order, bucket_count), so they are opt-in rather than
+ * automatically enabled by the presence of AVX2/AVX-512 support. The same
+ * applies to 16-bit fingerprint groups (group7), which take precedence over
+ * wide groups.
+ */
+
+#if defined(BOOST_UNORDERED_ENABLE_16BIT_FINGERPRINTS)
+#define BOOST_UNORDERED_16BIT_FINGERPRINTS
+#elif defined(BOOST_UNORDERED_SSE2)&& \
+    !defined(BOOST_UNORDERED_DISABLE_WIDE_GROUPS)
+#if defined(BOOST_UNORDERED_ENABLE_AVX512_GROUPS)&&defined(__AVX512BW__)
+#define BOOST_UNORDERED_AVX512_GROUPS
+#elif (defined(BOOST_UNORDERED_ENABLE_AVX2_GROUPS)|| \
+       defined(BOOST_UNORDERED_ENABLE_AVX512_GROUPS))&& \
+      defined(__AVX2__)
+#define BOOST_UNORDERED_AVX2_GROUPS
+#endif
+#endif
+
+/* Runtime CPU dispatch: when BOOST_UNORDERED_ENABLE_RUNTIME_DISPATCH is
+ * defined and the code is compiled for a baseline x86 target (no AVX2),
+ * bulk operations (rehashing, bulk visitation) are additionally compiled for
+ * AVX2+BMI1/2 and the appropriate version is selected at run time. Selection
+ * is done per bulk operation rather than per probe so that its cost is
+ * amortized and inlining of group operations is not impeded.
+ */
+
+#if defined(BOOST_UNORDERED_ENABLE_RUNTIME_DISPATCH)&& \
+    defined(BOOST_UNORDERED_SSE2)&&!defined(__AVX2__)&& \
+    (defined(BOOST_GCC)||defined(BOOST_CLANG))&& \
+    (defined(__x86_64__)||defined(__i386__))
+#define BOOST_UNORDERED_RUNTIME_DISPATCH
+#define BOOST_UNORDERED_AVX2_DISPATCH_TARGET \
+  __attribute__((target("avx2,bmi,bmi2"),flatten))
+#endif
+
 #if defined(BOOST_UNORDERED_SSE2)
 #include <emmintrin.h>
 #elif defined(BOOST_UNORDERED_LITTLE_ENDIAN_NEON)
 #include <arm_neon.h>
 #endif
 
+#if defined(BOOST_UNORDERED_AVX2_GROUPS)||defined(BOOST_UNORDERED_AVX512_GROUPS)
+#include <immintrin.h>
+#endif
+
 #ifdef __has_builtin
 #define BOOST_UNORDERED_HAS_BUILTIN(x) __has_builtin(x)
 #else
@@ -121,6 +173,30 @@
 #define BOOST_UNORDERED_PREFETCH_ELEMENTS(p,N) BOOST_UNORDERED_PREFETCH(p)
 #endif
 
+/* Distance, in groups, at which full traversals (visit_all and the like)
+ * prefetch ahead of the group being visited: group metadata and element
+ * slots are prefetched twice this distance ahead, and occupied elements (or
+ * their nodes, for node containers) this distance ahead.
+ */
+
+#if !defined(BOOST_UNORDERED_VISIT_ALL_PREFETCH_DISTANCE)
+#define BOOST_UNORDERED_VISIT_ALL_PREFETCH_DISTANCE 4
+#endif
+
+/* Instrumentation for BOOST_UNORDERED_ENABLE_STATS, expanding to nothing
+ * when it's not defined.
+ */
+
+#if defined(BOOST_UNORDERED_ENABLE_STATS)
+#define BOOST_UNORDERED_STATS_COUNTER(name) std::size_t name=0
+#define BOOST_UNORDERED_INCREMENT_STATS_COUNTER(name) ++name
+#define BOOST_UNORDERED_ADD_STATS(stats,args) stats.add args
+#else
+#define BOOST_UNORDERED_STATS_COUNTER(name)
+#define BOOST_UNORDERED_INCREMENT_STATS_COUNTER(name)
+#define BOOST_UNORDERED_ADD_STATS(stats,args) ((void)0)
+#endif
+
 #ifdef __has_feature
 #define BOOST_UNORDERED_HAS_FEATURE(x) __has_feature(x)
 #else
@@ -150,7 +226,8 @@ static constexpr std::size_t default_bucket_count=0;
  * boost::unordered_(flat|node)_(map|set) and boost::concurrent_flat_(map|set),
  * respectively. Its main internal design aspects are:
  * 
- *   - Element slots are logically split into groups of size N=15. The number
+ *   - Element slots are logically split into groups of size N=15 (31 or 63
+ *     when wide groups are enabled, 7 with 16-bit fingerprints). The number
  *     of groups is always a power of two, so the number of allocated slots
        is of the form (N*2^n)-1 (final slot reserved for a sentinel mark).
  *   - Positioning is done at the group level rather than the slot level, that
@@ -158,10 +235,10 @@ static constexpr std::size_t default_bucket_count=0;
  *     insertion is performed on the first available element of that group;
  *     if the group is full (overflow), further groups are tried using
  *     quadratic probing.
- *   - Each group has an associated 16B metadata word holding reduced hash
- *     values and overflow information. Reduced hash values are used to
- *     accelerate lookup within the group by using 128-bit SIMD or 64-bit word
- *     operations.
+ *   - Each group has an associated 16B (32B, 64B) metadata word holding
+ *     reduced hash values and overflow information. Reduced hash values are
+ *     used to accelerate lookup within the group by using 128-bit (256-bit,
+ *     512-bit) SIMD or 64-bit word operations.
  */
 
 /* group15 controls metadata information of a group of N=15 element slots.
@@ -207,6 +284,9 @@ static constexpr std::size_t default_bucket_count=0;
  * constructible, so is group15, in which case it can be initialized via memset
  * etc. Where needed, group15::initialize resets the metadata to the all
  * zeros (default state).
+ *
+ * group31 and group63 (see below) follow the same scheme with 32B and 64B
+ * metadata words, respectively.
  */
 
 #if defined(BOOST_UNORDERED_SSE2)
@@ -222,6 +302,17 @@ struct group15
     alignas(16) unsigned char storage[N+1]={0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0};
   };
 
+  /* Default construction is trivial. static_table builds its groups at
+   * compile time from the metadata bytes in memory order.
+   */
+
+  group15()=default;
+
+  constexpr explicit group15(const unsigned char (&x)[N+1]):
+    m{{x[0]},{x[1]},{x[2]},{x[3]},{x[4]},{x[5]},{x[6]},{x[7]},
+      {x[8]},{x[9]},{x[10]},{x[11]},{x[12]},{x[13]},{x[14]},{x[15]}}
+  {}
+
   inline void initialize()
   {
     _mm_store_si128(
@@ -279,6 +370,11 @@ struct group15
     overflow()|=static_cast<unsigned char>(1<<(hash%8));
   }
 
+  inline void reset_overflow()
+  {
+    overflow()=0;
+  }
+
   static inline bool maybe_caused_overflow(unsigned char* pc)
   {
     std::size_t pos=reinterpret_cast<uintptr_t>(pc)%sizeof(group15);
@@ -425,6 +521,17 @@ struct group15
     alignas(16) unsigned char storage[N+1]={0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0};
   };
 
+  /* Default construction is trivial. static_table builds its groups at
+   * compile time from the metadata bytes in memory order.
+   */
+
+  group15()=default;
+
+  constexpr explicit group15(const unsigned char (&x)[N+1]):
+    m{{x[0]},{x[1]},{x[2]},{x[3]},{x[4]},{x[5]},{x[6]},{x[7]},
+      {x[8]},{x[9]},{x[10]},{x[11]},{x[12]},{x[13]},{x[14]},{x[15]}}
+  {}
+
   inline void initialize()
   {
     vst1q_u8(reinterpret_cast<uint8_t*>(m),vdupq_n_u8(0));
@@ -481,6 +588,11 @@ struct group15
     overflow()|=static_cast<unsigned char>(1<<(hash%8));
   }
 
+  inline void reset_overflow()
+  {
+    overflow()=0;
+  }
+
   static inline bool maybe_caused_overflow(unsigned char* pc)
   {
     std::size_t pos=reinterpret_cast<uintptr_t>(pc)%sizeof(group15);
@@ -621,6 +733,15 @@ struct group15
       {0x0000000000004000ull,0x0000000000000000ull};
   };
 
+  /* Default construction is trivial. static_table builds its groups at
+   * compile time from the two interleaved metadata words.
+   */
+
+  group15()=default;
+
+  constexpr explicit group15(const boost::uint64_t (&x)[2]):m{{x[0]},{x[1]}}
+  {}
+
   inline void initialize(){m[0]=0;m[1]=0;}
 
   inline void set(std::size_t pos,std::size_t hash)
@@ -664,12 +785,18 @@ struct group15
 
   inline bool is_not_overflowed(std::size_t hash)const
   {
-    return !(reinterpret_cast<const boost::uint16_t*>(m)[hash%8] & 0x8000u);
+    return !(m[hash%8/4]&overflow_bit(hash));
   }
 
   inline void mark_overflow(std::size_t hash)
   {
-    reinterpret_cast<boost::uint16_t*>(m)[hash%8]|=0x8000u;
+    m[hash%8/4]|=overflow_bit(hash);
+  }
+
+  inline void reset_overflow()
+  {
+    m[0]&=boost::uint64_t(0x7FFF7FFF7FFF7FFFull);
+    m[1]&=boost::uint64_t(0x7FFF7FFF7FFF7FFFull);
   }
 
   static inline bool maybe_caused_overflow(unsigned char* pc)
@@ -711,6 +838,19 @@ private:
   static constexpr unsigned char available_=0,
                                  sentinel_=1;
 
+  /* bit 15 of the (hash%8)-th 16-bit word of the metadata, accessed through
+   * the 64-bit word containing it rather than by type punning
+   */
+
+  static inline boost::uint64_t overflow_bit(std::size_t hash)
+  {
+#if BOOST_ENDIAN_BIG_BYTE
+    return boost::uint64_t(0x8000u)<<(16*(3-hash%4));
+#else
+    return boost::uint64_t(0x8000u)<<(16*(hash%4));
+#endif
+  }
+
   inline static unsigned char reduced_hash(std::size_t hash)
   {
     static constexpr unsigned char table[]={
@@ -793,168 +933,845 @@ private:
 
 #endif
 
-/* foa::table_core uses a size policy to obtain the permissible sizes of the
- * group array (and, by implication, the element array) and to do the
- * hash->group mapping.
- * 
- *   - size_index(n) returns an unspecified "index" number used in other policy
- *     operations.
- *   - size(size_index_) returns the number of groups for the given index. It
- *     is guaranteed that size(size_index(n)) >= n.
- *   - min_size() is the minimum number of groups permissible, i.e.
- *     size(size_index(0)).
- *   - position(hash,size_index_) maps hash to a position in the range
- *     [0,size(size_index_)).
- * 
- * The reason we're introducing the intermediate index value for calculating
- * sizes and positions is that it allows us to optimize the implementation of
- * position, which is in the hot path of lookup and insertion operations:
- * pow2_size_policy, the actual size policy used by foa::table, returns 2^n
- * (n>0) as permissible sizes and returns the n most significant bits
- * of the hash value as the position in the group array; using a size index
- * defined as i = (bits in std::size_t) - n, we have an unbeatable
- * implementation of position(hash) as hash>>i.
- * There's a twofold reason for choosing the high bits of hash for positioning:
- *   - Multiplication-based mixing tends to yield better entropy in the high
- *     part of its result.
- *   - group15 reduced-hash values take the *low* bits of hash, and we want
- *     these values and positioning to be as uncorrelated as possible.
+/* group31 and group63 are wide variants of (SSE2) group15 with N=31 and N=63
+ * element slots, respectively, using AVX2 256-bit and AVX-512 512-bit SIMD
+ * operations. The metadata word follows the same logical layout as in
+ * group15, with the overflow byte placed at the end:
+ *
+ *   +---+---+-----+---+---+
+ *   |ofw|hN-1| ... |h01|h00|
+ *   +---+---+-----+---+---+
+ *
+ * Slot and overflow semantics are exactly those of group15; match* functions
+ * return 32-bit and 64-bit masks instead of int.
+ * Wider groups reduce the average probe length at high load factors at the
+ * expense of a larger minimum container footprint. They are used when
+ * BOOST_UNORDERED_ENABLE_AVX2_GROUPS or BOOST_UNORDERED_ENABLE_AVX512_GROUPS
+ * are defined and the target supports the corresponding instruction set
+ * (see default_group below).
  */
 
-struct pow2_size_policy
+#if defined(BOOST_UNORDERED_AVX2_GROUPS)||defined(BOOST_UNORDERED_AVX512_GROUPS)
+
+inline unsigned char wide_group_reduced_hash(std::size_t hash)
 {
-  static inline std::size_t size_index(std::size_t n)
+  /* same mapping as group15: 0 and 1 are reserved and hash%8 is kept */
+
+  auto h=narrow_cast<unsigned char>(hash);
+  return h<2?static_cast<unsigned char>(h+8):h;
+}
+
+#endif
+
+#if defined(BOOST_UNORDERED_AVX2_GROUPS)
+
+template<template<typename> class IntegralWrapper>
+struct group31
+{
+  static constexpr std::size_t N=31;
+  static constexpr bool        regular_layout=true;
+
+  struct dummy_group_type
   {
-    // TODO: min size is 2, see if we can bring it down to 1 without loss
-    // of performance
+    alignas(32) unsigned char storage[N+1]=
+      {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0};
+  };
 
-    return sizeof(std::size_t)*CHAR_BIT-
-      (n<=2?1:((std::size_t)(boost::core::bit_width(n-1))));
+  inline void initialize()
+  {
+    _mm256_store_si256(
+      reinterpret_cast<__m256i*>(m),_mm256_setzero_si256());
   }
 
-  static inline std::size_t size(std::size_t size_index_)
+  inline void set(std::size_t pos,std::size_t hash)
   {
-     return std::size_t(1)<<(sizeof(std::size_t)*CHAR_BIT-size_index_);  
+    BOOST_ASSERT(pos<N);
+    at(pos)=reduced_hash(hash);
   }
-    
-  static constexpr std::size_t min_size(){return 2;}
 
-  static inline std::size_t position(std::size_t hash,std::size_t size_index_)
+  inline void set_sentinel()
   {
-    return hash>>size_index_;
+    at(N-1)=sentinel_;
   }
-};
 
-/* size index of a group array for a given *element* capacity */
+  inline bool is_sentinel(std::size_t pos)const
+  {
+    BOOST_ASSERT(pos<N);
+    return at(pos)==sentinel_;
+  }
 
-template<typename Group,typename SizePolicy>
-static inline std::size_t size_index_for(std::size_t n)
-{
-  /* n/N+1 == ceil((n+1)/N) (extra +1 for the sentinel) */
-  return SizePolicy::size_index(n/Group::N+1);
-}
+  static inline bool is_sentinel(unsigned char* pc)noexcept
+  {
+    return *pc==sentinel_;
+  }
 
-/* Quadratic prober over a power-of-two range using triangular numbers.
- * mask in next(mask) must be the range size minus one (and since size is 2^n,
- * mask has exactly its n first bits set to 1).
- */
+  inline void reset(std::size_t pos)
+  {
+    BOOST_ASSERT(pos<N);
+    at(pos)=available_;
+  }
 
-struct pow2_quadratic_prober
-{
-  pow2_quadratic_prober(std::size_t pos_):pos{pos_}{}
+  static inline void reset(unsigned char* pc)
+  {
+    *reinterpret_cast<slot_type*>(pc)=available_;
+  }
 
-  inline std::size_t get()const{return pos;}
+  inline boost::uint32_t match(std::size_t hash)const
+  {
+    return static_cast<boost::uint32_t>(_mm256_movemask_epi8(
+      _mm256_cmpeq_epi8(
+        load_metadata(),_mm256_set1_epi8((char)reduced_hash(hash)))))&
+      0x7FFFFFFFu;
+  }
 
-  /* next returns false when the whole array has been traversed, which ends
-   * probing (in practice, full-table probing will only happen with very small
-   * arrays).
-   */
+  inline bool is_not_overflowed(std::size_t hash)const
+  {
+    static constexpr unsigned char shift[]={1,2,4,8,16,32,64,128};
 
-  inline bool next(std::size_t mask)
+    return !(overflow()&shift[hash%8]);
+  }
+
+  inline void mark_overflow(std::size_t hash)
   {
-    step+=1;
-    pos=(pos+step)&mask;
-    return step<=mask;
+    overflow()|=static_cast<unsigned char>(1<<(hash%8));
   }
 
-private:
-  std::size_t pos,step=0;
-};
+  inline void reset_overflow()
+  {
+    overflow()=0;
+  }
 
-/* Mixing policies: no_mix is the identity function, and mulx_mix
- * uses the mulx function from <boost/unordered/detail/mulx.hpp>.
- *
- * foa::table_core mixes hash results with mulx_mix unless the hash is marked
- * as avalanching, i.e. of good quality
- * (see <boost/unordered/hash_traits.hpp>).
- */
+  static inline bool maybe_caused_overflow(unsigned char* pc)
+  {
+    std::size_t pos=reinterpret_cast<uintptr_t>(pc)%sizeof(group31);
+    group31    *pg=reinterpret_cast<group31*>(pc-pos);
+    return !pg->is_not_overflowed(*pc);
+  }
 
-struct no_mix
-{
-  template<typename Hash,typename T>
-  static inline std::size_t mix(const Hash& h,const T& x)
+  inline boost::uint32_t match_available()const
   {
-    return h(x);
+    return static_cast<boost::uint32_t>(_mm256_movemask_epi8(
+      _mm256_cmpeq_epi8(load_metadata(),_mm256_setzero_si256())))&
+      0x7FFFFFFFu;
   }
-};
 
-struct mulx_mix
-{
-  template<typename Hash,typename T>
-  static inline std::size_t mix(const Hash& h,const T& x)
+  inline bool is_occupied(std::size_t pos)const
   {
-    return mulx(h(x));
+    BOOST_ASSERT(pos<N);
+    return at(pos)!=available_;
   }
-};
 
-/* boost::core::countr_zero has a potentially costly check for
- * the case x==0.
- */
+  static inline bool is_occupied(unsigned char* pc)noexcept
+  {
+    return *reinterpret_cast<slot_type*>(pc)!=available_;
+  }
 
-inline unsigned int unchecked_countr_zero(int x)
-{
-#if defined(BOOST_MSVC)
-  unsigned long r;
-  _BitScanForward(&r,(unsigned long)x);
-  return (unsigned int)r;
-#else
-  BOOST_UNORDERED_ASSUME(x!=0);
-  return (unsigned int)boost::core::countr_zero((unsigned int)x);
-#endif
-}
+  inline boost::uint32_t match_occupied()const
+  {
+    return (~match_available())&0x7FFFFFFFu;
+  }
 
-/* table_arrays controls allocation, initialization and deallocation of
- * paired arrays of groups and element slots. Only one chunk of memory is
- * allocated to place both arrays: this is not done for efficiency reasons,
- * but in order to be able to properly align the group array without storing
- * additional offset information --the alignment required (16B) is usually
- * greater than alignof(std::max_align_t) and thus not guaranteed by
- * allocators.
- */
+private:
+  using slot_type=IntegralWrapper<unsigned char>;
+  BOOST_UNORDERED_STATIC_ASSERT(sizeof(slot_type)==1);
 
-template<typename Group,std::size_t Size>
-Group* dummy_groups()
-{
-  /* Dummy storage initialized as if in an empty container (actually, each
-   * of its groups is initialized like a separate empty container).
-   * We make table_arrays::groups point to this when capacity()==0, so that
-   * we are not allocating any dynamic memory and yet lookup can be implemented
-   * without checking for groups==nullptr. This space won't ever be used for
-   * insertion as the container's capacity is precisely zero.
-   */
+  static constexpr unsigned char available_=0,
+                                 sentinel_=1;
 
-  static constexpr typename Group::dummy_group_type
-  storage[Size]={typename Group::dummy_group_type(),};
+  inline __m256i load_metadata()const
+  {
+#if defined(BOOST_UNORDERED_THREAD_SANITIZER)
+    /* ThreadSanitizer complains on 1-byte atomic writes combined with
+     * 32-byte atomic reads.
+     */
 
-  return reinterpret_cast<Group*>(
-    const_cast<typename Group::dummy_group_type*>(storage));
-}
+    alignas(32) unsigned char tmp[N+1];
+    for(std::size_t i=0;i<N+1;++i)tmp[i]=m[i];
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(tmp));
+#else
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(m));
+#endif
+  }
 
-template<
-  typename Ptr,typename Ptr2,
-  typename std::enable_if<!std::is_same<Ptr,Ptr2>::value>::type* = nullptr
->
-Ptr to_pointer(Ptr2 p)
+  inline static unsigned char reduced_hash(std::size_t hash)
+  {
+    return wide_group_reduced_hash(hash);
+  }
+
+  inline slot_type& at(std::size_t pos)
+  {
+    return m[pos];
+  }
+
+  inline const slot_type& at(std::size_t pos)const
+  {
+    return m[pos];
+  }
+
+  inline slot_type& overflow()
+  {
+    return at(N);
+  }
+
+  inline const slot_type& overflow()const
+  {
+    return at(N);
+  }
+
+  alignas(32) slot_type m[32];
+};
+
+#endif
+
+#if defined(BOOST_UNORDERED_AVX512_GROUPS)
+
+template<template<typename> class IntegralWrapper>
+struct group63
+{
+  static constexpr std::size_t N=63;
+  static constexpr bool        regular_layout=true;
+
+  struct dummy_group_type
+  {
+    alignas(64) unsigned char storage[N+1]=
+      {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+       0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,0};
+  };
+
+  inline void initialize()
+  {
+    _mm512_store_si512(
+      reinterpret_cast<__m512i*>(m),_mm512_setzero_si512());
+  }
+
+  inline void set(std::size_t pos,std::size_t hash)
+  {
+    BOOST_ASSERT(pos<N);
+    at(pos)=reduced_hash(hash);
+  }
+
+  inline void set_sentinel()
+  {
+    at(N-1)=sentinel_;
+  }
+
+  inline bool is_sentinel(std::size_t pos)const
+  {
+    BOOST_ASSERT(pos<N);
+    return at(pos)==sentinel_;
+  }
+
+  static inline bool is_sentinel(unsigned char* pc)noexcept
+  {
+    return *pc==sentinel_;
+  }
+
+  inline void reset(std::size_t pos)
+  {
+    BOOST_ASSERT(pos<N);
+    at(pos)=available_;
+  }
+
+  static inline void reset(unsigned char* pc)
+  {
+    *reinterpret_cast<slot_type*>(pc)=available_;
+  }
+
+  inline boost::uint64_t match(std::size_t hash)const
+  {
+    return static_cast<boost::uint64_t>(_mm512_cmpeq_epi8_mask(
+      load_metadata(),_mm512_set1_epi8((char)reduced_hash(hash))))&
+      0x7FFFFFFFFFFFFFFFull;
+  }
+
+  inline bool is_not_overflowed(std::size_t hash)const
+  {
+    static constexpr unsigned char shift[]={1,2,4,8,16,32,64,128};
+
+    return !(overflow()&shift[hash%8]);
+  }
+
+  inline void mark_overflow(std::size_t hash)
+  {
+    overflow()|=static_cast<unsigned char>(1<<(hash%8));
+  }
+
+  inline void reset_overflow()
+  {
+    overflow()=0;
+  }
+
+  static inline bool maybe_caused_overflow(unsigned char* pc)
+  {
+    std::size_t pos=reinterpret_cast<uintptr_t>(pc)%sizeof(group63);
+    group63    *pg=reinterpret_cast<group63*>(pc-pos);
+    return !pg->is_not_overflowed(*pc);
+  }
+
+  inline boost::uint64_t match_available()const
+  {
+    return static_cast<boost::uint64_t>(_mm512_cmpeq_epi8_mask(
+      load_metadata(),_mm512_setzero_si512()))&0x7FFFFFFFFFFFFFFFull;
+  }
+
+  inline bool is_occupied(std::size_t pos)const
+  {
+    BOOST_ASSERT(pos<N);
+    return at(pos)!=available_;
+  }
+
+  static inline bool is_occupied(unsigned char* pc)noexcept
+  {
+    return *reinterpret_cast<slot_type*>(pc)!=available_;
+  }
+
+  inline boost::uint64_t match_occupied()const
+  {
+    return (~match_available())&0x7FFFFFFFFFFFFFFFull;
+  }
+
+private:
+  using slot_type=IntegralWrapper<unsigned char>;
+  BOOST_UNORDERED_STATIC_ASSERT(sizeof(slot_type)==1);
+
+  static constexpr unsigned char available_=0,
+                                 sentinel_=1;
+
+  inline __m512i load_metadata()const
+  {
+#if defined(BOOST_UNORDERED_THREAD_SANITIZER)
+    /* ThreadSanitizer complains on 1-byte atomic writes combined with
+     * 64-byte atomic reads.
+     */
+
+    alignas(64) unsigned char tmp[N+1];
+    for(std::size_t i=0;i<N+1;++i)tmp[i]=m[i];
+    return _mm512_load_si512(tmp);
+#else
+    return _mm512_load_si512(m);
+#endif
+  }
+
+  inline static unsigned char reduced_hash(std::size_t hash)
+  {
+    return wide_group_reduced_hash(hash);
+  }
+
+  inline slot_type& at(std::size_t pos)
+  {
+    return m[pos];
+  }
+
+  inline const slot_type& at(std::size_t pos)const
+  {
+    return m[pos];
+  }
+
+  inline slot_type& overflow()
+  {
+    return at(N);
+  }
+
+  inline const slot_type& overflow()const
+  {
+    return at(N);
+  }
+
+  alignas(64) slot_type m[64];
+};
+
+#endif
+
+/* group7 trades slots for fingerprint width: its 16B metadata word holds
+ * 16-bit reduced hash values for N=7 element slots plus a 16-bit overflow
+ * word:
+ *
+ *   +---+---+---+---+---+---+---+---+
+ *   |ofw|h06|h05|h04|h03|h02|h01|h00|
+ *   +---+---+---+---+---+---+---+---+
+ *
+ * As in group15, hi is 0 for available slots and 1 for the sentinel, so
+ * occupied slots keep log2(65534)=15.99 bits of the original hash and the
+ * probability of a spurious match (and the ensuing call to Pred) drops from
+ * ~1/127 to ~1/32767 per slot. Overflow is tracked with 16 bits indexed by
+ * hash%16, which reduced hash values preserve. Matching uses SSE2 16-bit
+ * comparisons when available and a plain loop over the slots otherwise.
+ * The price to pay is a shorter group, hence longer probe sequences at high
+ * load factors and a 2B rather than 1B metadata overhead per slot: group7 is
+ * only profitable when element comparison is expensive (long strings,
+ * composite keys) and is used when BOOST_UNORDERED_ENABLE_16BIT_FINGERPRINTS
+ * is defined.
+ * The slot index is encoded in the address of the metadata word as with
+ * interleaved group15, so regular_layout is false.
+ */
+
+#if defined(BOOST_UNORDERED_16BIT_FINGERPRINTS)
+
+template<template<typename> class IntegralWrapper>
+struct group7
+{
+  static constexpr std::size_t N=7;
+  static constexpr bool        regular_layout=false;
+
+  struct dummy_group_type
+  {
+    alignas(16) boost::uint16_t storage[N+1]={0,0,0,0,0,0,1,0};
+  };
+
+  inline void initialize()
+  {
+#if defined(BOOST_UNORDERED_SSE2)
+    _mm_store_si128(
+      reinterpret_cast<__m128i*>(m),_mm_setzero_si128());
+#else
+    for(std::size_t i=0;i<N+1;++i)m[i]=0;
+#endif
+  }
+
+  inline void set(std::size_t pos,std::size_t hash)
+  {
+    BOOST_ASSERT(pos<N);
+    at(pos)=reduced_hash(hash);
+  }
+
+  inline void set_sentinel()
+  {
+    at(N-1)=sentinel_;
+  }
+
+  inline bool is_sentinel(std::size_t pos)const
+  {
+    BOOST_ASSERT(pos<N);
+    return at(pos)==sentinel_;
+  }
+
+  inline void reset(std::size_t pos)
+  {
+    BOOST_ASSERT(pos<N);
+    at(pos)=available_;
+  }
+
+  static inline void reset(unsigned char* pc)
+  {
+    std::size_t pos=reinterpret_cast<uintptr_t>(pc)%sizeof(group7);
+    pc-=pos;
+    reinterpret_cast<group7*>(pc)->reset(pos);
+  }
+
+  inline int match(std::size_t hash)const
+  {
+    return match_impl(reduced_hash(hash));
+  }
+
+  inline bool is_not_overflowed(std::size_t hash)const
+  {
+    return !(overflow()&(1u<<(hash%16)));
+  }
+
+  inline void mark_overflow(std::size_t hash)
+  {
+    overflow()|=static_cast<boost::uint16_t>(1u<<(hash%16));
+  }
+
+  inline void reset_overflow()
+  {
+    overflow()=0;
+  }
+
+  static inline bool maybe_caused_overflow(unsigned char* pc)
+  {
+    std::size_t pos=reinterpret_cast<uintptr_t>(pc)%sizeof(group7);
+    group7     *pg=reinterpret_cast<group7*>(pc-pos);
+    return !pg->is_not_overflowed(pg->at(pos));
+  }
+
+  inline int match_available()const
+  {
+    return match_impl(available_);
+  }
+
+  inline bool is_occupied(std::size_t pos)const
+  {
+    BOOST_ASSERT(pos<N);
+    return at(pos)!=available_;
+  }
+
+  inline int match_occupied()const
+  {
+    return (~match_available())&0x7F;
+  }
+
+private:
+  using slot_type=IntegralWrapper<boost::uint16_t>;
+  BOOST_UNORDERED_STATIC_ASSERT(sizeof(slot_type)==2);
+
+  static constexpr boost::uint16_t available_=0,
+                                   sentinel_=1;
+
+#if defined(BOOST_UNORDERED_SSE2)
+  inline __m128i load_metadata()const
+  {
+#if defined(BOOST_UNORDERED_THREAD_SANITIZER)
+    /* ThreadSanitizer complains on 2-byte atomic writes combined with
+     * 16-byte atomic reads.
+     */
+
+    return _mm_set_epi16(
+      (short)m[7],(short)m[6],(short)m[5],(short)m[4],
+      (short)m[3],(short)m[2],(short)m[1],(short)m[0]);
+#else
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(m));
+#endif
+  }
+
+  inline int match_impl(boost::uint16_t h)const
+  {
+    /* packing the 16-bit comparison results yields one byte per slot */
+
+    return _mm_movemask_epi8(_mm_packs_epi16(
+      _mm_cmpeq_epi16(load_metadata(),_mm_set1_epi16((short)h)),
+      _mm_setzero_si128()))&0x7F;
+  }
+#else
+  inline int match_impl(boost::uint16_t h)const
+  {
+    int mask=0;
+    for(std::size_t i=0;i<N;++i){
+      mask|=int(boost::uint16_t(m[i])==h)<<i;
+    }
+    return mask;
+  }
+#endif
+
+  inline static boost::uint16_t reduced_hash(std::size_t hash)
+  {
+    /* 0 and 1 are reserved and hash%16 is kept */
+
+    auto h=static_cast<boost::uint16_t>(hash);
+    return h<2?static_cast<boost::uint16_t>(h+16):h;
+  }
+
+  inline slot_type& at(std::size_t pos)
+  {
+    return m[pos];
+  }
+
+  inline const slot_type& at(std::size_t pos)const
+  {
+    return m[pos];
+  }
+
+  inline slot_type& overflow()
+  {
+    return at(N);
+  }
+
+  inline const slot_type& overflow()const
+  {
+    return at(N);
+  }
+
+  alignas(16) slot_type m[N+1];
+};
+
+#endif
+
+/* default_group is the metadata group used by foa::table and
+ * foa::concurrent_table.
+ */
+
+#if defined(BOOST_UNORDERED_16BIT_FINGERPRINTS)
+template<template<typename> class IntegralWrapper>
+using default_group=group7<IntegralWrapper>;
+#elif defined(BOOST_UNORDERED_AVX512_GROUPS)
+template<template<typename> class IntegralWrapper>
+using default_group=group63<IntegralWrapper>;
+#elif defined(BOOST_UNORDERED_AVX2_GROUPS)
+template<template<typename> class IntegralWrapper>
+using default_group=group31<IntegralWrapper>;
+#else
+template<template<typename> class IntegralWrapper>
+using default_group=group15<IntegralWrapper>;
+#endif
+
+/* foa::table_core uses a size policy to obtain the permissible sizes of the
+ * group array (and, by implication, the element array) and to do the
+ * hash->group mapping.
+ * 
+ *   - size_index(n) returns an unspecified "index" number used in other policy
+ *     operations.
+ *   - size(size_index_) returns the number of groups for the given index. It
+ *     is guaranteed that size(size_index(n)) >= n.
+ *   - min_size() is the minimum number of groups permissible, i.e.
+ *     size(size_index(0)).
+ *   - position(hash,size_index_) maps hash to a position in the range
+ *     [0,size(size_index_)).
+ * 
+ * The reason we're introducing the intermediate index value for calculating
+ * sizes and positions is that it allows us to optimize the implementation of
+ * position, which is in the hot path of lookup and insertion operations:
+ * pow2_size_policy, the actual size policy used by foa::table, returns 2^n
+ * (n>0) as permissible sizes and returns the n most significant bits
+ * of the hash value as the position in the group array; using a size index
+ * defined as i = (bits in std::size_t) - n, we have an unbeatable
+ * implementation of position(hash) as hash>>i.
+ * There's a twofold reason for choosing the high bits of hash for positioning:
+ *   - Multiplication-based mixing tends to yield better entropy in the high
+ *     part of its result.
+ *   - group15 reduced-hash values take the *low* bits of hash, and we want
+ *     these values and positioning to be as uncorrelated as possible.
+ */
+
+struct pow2_size_policy
+{
+  static inline std::size_t size_index(std::size_t n)
+  {
+    // min size is 2: position(hash) is hash>>size_index, so a single group
+    // would require a full-width shift. Single-group tables are provided by
+    // small_table instead, whose inline group involves no position
+    // calculation at all.
+
+    return sizeof(std::size_t)*CHAR_BIT-
+      (n<=2?1:((std::size_t)(boost::core::bit_width(n-1))));
+  }
+
+  static inline std::size_t size(std::size_t size_index_)
+  {
+     return std::size_t(1)<<(sizeof(std::size_t)*CHAR_BIT-size_index_);  
+  }
+    
+  static constexpr std::size_t min_size(){return 2;}
+
+  static inline std::size_t position(std::size_t hash,std::size_t size_index_)
+  {
+    return hash>>size_index_;
+  }
+};
+
+/* size index of a group array for a given *element* capacity */
+
+template<typename Group,typename SizePolicy>
+static inline std::size_t size_index_for(std::size_t n)
+{
+  /* n/N+1 == ceil((n+1)/N) (extra +1 for the sentinel) */
+  return SizePolicy::size_index(n/Group::N+1);
+}
+
+/* Quadratic prober over a power-of-two range using triangular numbers.
+ * mask in next(mask) must be the range size minus one (and since size is 2^n,
+ * mask has exactly its n first bits set to 1).
+ */
+
+struct pow2_quadratic_prober
+{
+  pow2_quadratic_prober(std::size_t pos_):pos{pos_}{}
+
+  inline std::size_t get()const{return pos;}
+
+  /* next returns false when the whole array has been traversed, which ends
+   * probing (in practice, full-table probing will only happen with very small
+   * arrays).
+   */
+
+  inline bool next(std::size_t mask)
+  {
+    step+=1;
+    pos=(pos+step)&mask;
+    return step<=mask;
+  }
+
+  /* number of groups visited so far, including the current one */
+
+  inline std::size_t length()const{return step+1;}
+
+private:
+  std::size_t pos,step=0;
+};
+
+/* fastrange_size_policy is used instead of pow2_size_policy when
+ * hash_prefers_compact_growth<Hash>::value is true. Permissible sizes are
+ * 2^n, 1.25*2^n and 1.625*2^n (rounded up for the first few sizes), so that
+ * a table grows by a factor of ~1.25 rather than 2 when its maximum load is
+ * exceeded: for very large tables, this reduces both the average amount of
+ * unused capacity and the peak memory during rehashing (old plus new arrays)
+ * from 3x to 2.25x the size of the old arrays, at the expense of more
+ * frequent rehashing.
+ * The size index is the size itself, and position(hash) maps hash to
+ * [0,size) as the high word of hash*size ("fastrange"), which, as with
+ * pow2_size_policy, depends mostly on the high bits of hash.
+ */
+
+struct fastrange_size_policy
+{
+  static inline std::size_t size_index(std::size_t n)
+  {
+    if(n<=8){
+      return n<=2?2:n<=4?n:n<=5?5:n<=7?7:8;
+    }
+
+    /* p < n <= 2p */
+
+    std::size_t p=std::size_t(1)<<(boost::core::bit_width(n-1)-1);
+    return n<=p+p/4?p+p/4:n<=p+p/2+p/8?p+p/2+p/8:2*p;
+  }
+
+  static inline std::size_t size(std::size_t size_index_)
+  {
+    return size_index_;
+  }
+
+  static constexpr std::size_t min_size(){return 2;}
+
+  static inline std::size_t position(std::size_t hash,std::size_t size_index_)
+  {
+    return mulhi(hash,size_index_);
+  }
+};
+
+/* Quadratic prober over an arbitrary range [0,mask]: probing is done as with
+ * pow2_quadratic_prober over the smallest enclosing power-of-two range, and
+ * positions past mask are skipped. As triangular numbers visit all positions
+ * of a power-of-two range, all positions in [0,mask] are eventually visited.
+ * For fastrange_size_policy, at most 3/8 of the enclosing range is skipped.
+ */
+
+struct skipping_quadratic_prober
+{
+  skipping_quadratic_prober(std::size_t pos_):pos{pos_}{}
+
+  inline std::size_t get()const{return pos;}
+
+  inline bool next(std::size_t mask)
+  {
+    std::size_t pow2_mask=
+      (std::numeric_limits<std::size_t>::max)()>>
+      boost::core::countl_zero(mask);
+    do{
+      step+=1;
+      pos=(pos+step)&pow2_mask;
+    }while(pos>mask&&step<=pow2_mask);
+    return step<=pow2_mask;
+  }
+
+  inline std::size_t length()const{return step+1;}
+
+private:
+  std::size_t pos,step=0;
+};
+
+/* Mixing policies: no_mix is the identity function, and mulx_mix
+ * uses the mulx function from <boost/unordered/detail/mulx.hpp>.
+ *
+ * foa::table_core mixes hash results with mulx_mix unless the hash is marked
+ * as avalanching, i.e. of good quality
+ * (see <boost/unordered/hash_traits.hpp>).
+ */
+
+struct no_mix
+{
+  template<typename Hash,typename T>
+  static inline std::size_t mix(const Hash& h,const T& x)
+  {
+    return h(x);
+  }
+};
+
+struct mulx_mix
+{
+  template<typename Hash,typename T>
+  static inline std::size_t mix(const Hash& h,const T& x)
+  {
+    return mulx(h(x));
+  }
+};
+
+/* boost::core::countr_zero has a potentially costly check for
+ * the case x==0.
+ */
+
+inline unsigned int unchecked_countr_zero(int x)
+{
+#if defined(BOOST_MSVC)
+  unsigned long r;
+  _BitScanForward(&r,(unsigned long)x);
+  return (unsigned int)r;
+#else
+  BOOST_UNORDERED_ASSUME(x!=0);
+  return (unsigned int)boost::core::countr_zero((unsigned int)x);
+#endif
+}
+
+#if defined(BOOST_UNORDERED_AVX2_GROUPS)
+inline unsigned int unchecked_countr_zero(boost::uint32_t x)
+{
+  return unchecked_countr_zero((int)x);
+}
+#endif
+
+#if defined(BOOST_UNORDERED_AVX512_GROUPS)
+inline unsigned int unchecked_countr_zero(boost::uint64_t x)
+{
+#if defined(BOOST_MSVC)
+  unsigned long r;
+  _BitScanForward64(&r,x);
+  return (unsigned int)r;
+#else
+  BOOST_UNORDERED_ASSUME(x!=0);
+  return (unsigned int)boost::core::countr_zero(x);
+#endif
+}
+#endif
+
+#if defined(BOOST_UNORDERED_RUNTIME_DISPATCH)
+/* Checked once per program run. */
+
+inline bool cpu_supports_avx2_bmi()
+{
+  static const bool res=[]{
+    __builtin_cpu_init();
+    return
+      __builtin_cpu_supports("avx2")&&
+      __builtin_cpu_supports("bmi")&&
+      __builtin_cpu_supports("bmi2");
+  }();
+  return res;
+}
+#endif
+
+/* table_arrays controls allocation, initialization and deallocation of
+ * paired arrays of groups and element slots. Only one chunk of memory is
+ * allocated to place both arrays: this is not done for efficiency reasons,
+ * but in order to be able to properly align the group array without storing
+ * additional offset information --the alignment required (16B) is usually
+ * greater than alignof(std::max_align_t) and thus not guaranteed by
+ * allocators.
+ * If StoresHash::value is true, a third array with the hash values of the
+ * elements (one per slot) is placed right after the group array.
+ */
+
+template<typename Group,std::size_t Size>
+Group* dummy_groups()
+{
+  /* Dummy storage initialized as if in an empty container (actually, each
+   * of its groups is initialized like a separate empty container).
+   * We make table_arrays::groups point to this when capacity()==0, so that
+   * we are not allocating any dynamic memory and yet lookup can be implemented
+   * without checking for groups==nullptr. This space won't ever be used for
+   * insertion as the container's capacity is precisely zero.
+   */
+
+  static constexpr typename Group::dummy_group_type
+  storage[Size]={typename Group::dummy_group_type(),};
+
+  return reinterpret_cast<Group*>(
+    const_cast<typename Group::dummy_group_type*>(storage));
+}
+
+template<
+  typename Ptr,typename Ptr2,
+  typename std::enable_if<!std::is_same<Ptr,Ptr2>::value>::type* = nullptr
+>
+Ptr to_pointer(Ptr2 p)
 {
   if(!p){return nullptr;}
   return boost::pointer_traits<Ptr>::pointer_to(*p);
@@ -990,13 +1807,18 @@ struct arrays_holder
     return arrays_;
   }
 
+  const Allocator& get_allocator()const{return al_;}
+
 private:
   Arrays    arrays_;
   Allocator al_;
   bool      released_=false;
 };
 
-template<typename Value,typename Group,typename SizePolicy,typename Allocator>
+template<
+  typename Value,typename Group,typename SizePolicy,typename Allocator,
+  typename StoresHash=std::false_type
+>
 struct table_arrays
 {
   using allocator_type=typename boost::allocator_rebind<Allocator,Value>::type;
@@ -1005,6 +1827,7 @@ struct table_arrays
   using group_type=Group;
   static constexpr auto N=group_type::N;
   using size_policy=SizePolicy;
+  static constexpr bool stores_hash=StoresHash::value;
   using value_type_pointer=
     typename boost::allocator_pointer<allocator_type>::type;
   using group_type_pointer=
@@ -1020,22 +1843,34 @@ struct table_arrays
   value_type* elements()const noexcept{return boost::to_address(elements_);}
   group_type* groups()const noexcept{return boost::to_address(groups_);}
 
-  static void set_arrays(table_arrays& arrays,allocator_type al,std::size_t n)
+  /* only valid if stores_hash and elements()!=nullptr */
+
+  std::size_t* hashes()const noexcept
+  {
+    return reinterpret_cast<std::size_t*>(groups()+groups_size_mask+1);
+  }
+
+  static void set_arrays(
+    table_arrays& arrays,allocator_type al,std::size_t n,bool interleave)
   {
     return set_arrays(
-      arrays,al,n,std::is_same<group_type*,group_type_pointer>{});
+      arrays,al,n,interleave,std::is_same<group_type*,group_type_pointer>{});
   }
 
   static void set_arrays(
-    table_arrays& arrays,allocator_type al,std::size_t,
+    table_arrays& arrays,allocator_type al,std::size_t,bool interleave,
     std::false_type /* always allocate */)
   {
-    using storage_traits=boost::allocator_traits<allocator_type>;
     auto groups_size_index=arrays.groups_size_index;
     auto groups_size=size_policy::size(groups_size_index);
 
+    /* page advice (see huge_pages.hpp) must precede the initialization of
+     * groups below
+     */
+
     auto sal=allocator_type(al);
-    arrays.elements_=storage_traits::allocate(sal,buffer_size(groups_size));
+    arrays.elements_=
+      allocate_pages(sal,buffer_size(groups_size),interleave);
     
     /* Align arrays.groups to sizeof(group_type). table_iterator critically
       * depends on such alignment for its increment operation.
@@ -1054,39 +1889,44 @@ struct table_arrays
   }
 
   static void set_arrays(
-    table_arrays& arrays,allocator_type al,std::size_t n,
+    table_arrays& arrays,allocator_type al,std::size_t n,bool interleave,
     std::true_type /* optimize for n==0*/)
   {
     if(!n){
       arrays.groups_=dummy_groups<group_type,size_policy::min_size()>();
     }
     else{
-      set_arrays(arrays,al,n,std::false_type{});
+      set_arrays(arrays,al,n,interleave,std::false_type{});
     }
   }
 
-  static table_arrays new_(allocator_type al,std::size_t n)
+  /* interleave: spread pages across NUMA nodes if enabled (concurrent
+   * containers only)
+   */
+
+  static table_arrays new_(
+    allocator_type al,std::size_t n,bool interleave=false)
   {
     auto         groups_size_index=size_index_for<group_type,size_policy>(n);
     auto         groups_size=size_policy::size(groups_size_index);
     table_arrays arrays{groups_size_index,groups_size-1,nullptr,nullptr};
 
-    set_arrays(arrays,al,n);
+    set_arrays(arrays,al,n,interleave);
     return arrays;
   }
 
   static void delete_(allocator_type al,table_arrays& arrays)noexcept
   {
-    using storage_traits=boost::allocator_traits<allocator_type>;
-
     auto sal=allocator_type(al);
     if(arrays.elements()){
-      storage_traits::deallocate(
+      deallocate_pages(
         sal,arrays.elements_,buffer_size(arrays.groups_size_mask+1));
     }
   }
 
-  /* combined space for elements and groups measured in sizeof(value_type)s */
+  /* combined space for elements, groups and hash values (if stored)
+   * measured in sizeof(value_type)s
+   */
 
   static std::size_t buffer_size(std::size_t groups_size)
   {
@@ -1094,7 +1934,9 @@ struct table_arrays
       /* space for elements (we subtract 1 because of the sentinel) */
       sizeof(value_type)*(groups_size*N-1)+
       /* space for groups + padding for group alignment */
-      sizeof(group_type)*(groups_size+1)-1;
+      sizeof(group_type)*(groups_size+1)-1+
+      /* space for hash values, suitably aligned after the groups */
+      (stores_hash?sizeof(std::size_t)*groups_size*N:0);
 
     /* ceil(buffer_bytes/sizeof(value_type)) */
     return (buffer_bytes+sizeof(value_type)-1)/sizeof(value_type);
@@ -1213,6 +2055,20 @@ struct table_locator
 
 struct try_emplace_args_t{};
 
+/* Whether elements are moved rather than copied into new arrays on rehash
+ * (std::move_if_noexcept semantics). A class template so that the element
+ * type needs only be complete where rehashing is instantiated.
+ */
+
+template<typename TypePolicy>
+struct transfer_by_move:std::integral_constant<
+  bool,
+  std::is_nothrow_move_constructible<typename TypePolicy::init_type>::value||
+  !std::is_same<
+    typename TypePolicy::element_type,typename TypePolicy::value_type>::value||
+  !std::is_copy_constructible<typename TypePolicy::element_type>::value
+>{};
+
 template<typename TypePolicy,typename Allocator,typename... Args>
 class alloc_cted_insert_type
 {
@@ -1270,25 +2126,111 @@ class alloc_cted_or_fwded_key_type<TypePolicy, Allocator, KFwdRef,
   BOOST_UNORDERED_STATIC_ASSERT(std::is_reference<KFwdRef>::value);
   KFwdRef ref;
 
-public:
-  alloc_cted_or_fwded_key_type(const Allocator&, KFwdRef k)
-      : ref(std::forward<KFwdRef>(k))
+public:
+  alloc_cted_or_fwded_key_type(const Allocator&, KFwdRef k)
+      : ref(std::forward<KFwdRef>(k))
+  {
+  }
+
+  KFwdRef move_or_fwd() { return std::forward<KFwdRef>(ref); }
+};
+
+template <typename Container>
+using is_map =
+  std::integral_constant<bool, !std::is_same<typename Container::key_type,
+                                 typename Container::value_type>::value>;
+
+template <typename Container, typename K>
+using is_emplace_kv_able = std::integral_constant<bool,
+  is_map<Container>::value &&
+    (is_similar<K, typename Container::key_type>::value ||
+      is_complete_and_move_constructible<typename Container::key_type>::value)>;
+
+#if defined(BOOST_UNORDERED_ENABLE_STATS)
+/* Statistics reported by table_core::get_stats (see
+ * cumulative_stats.hpp). Probe lengths are measured in groups visited.
+ */
+
+struct table_core_insertion_stats
+{
+  std::size_t            count;
+  sequence_stats_summary probe_length;
+  stats_histogram        probe_length_histogram;
+};
+
+struct table_core_lookup_stats
+{
+  std::size_t            count;
+  sequence_stats_summary probe_length;
+  sequence_stats_summary num_comparisons;
+  stats_histogram        probe_length_histogram;
+};
+
+struct table_core_rehash_stats
+{
+  std::size_t            count;
+  sequence_stats_summary duration; /* seconds */
+};
+
+template<std::size_t N>
+struct table_core_layout_stats
+{
+  std::size_t                   num_groups;
+  std::size_t                   num_overflowed_groups;
+  std::array<std::size_t,N+1>   occupancy_histogram; /* groups with i elements */
+  std::size_t                   max_load;
+  std::size_t                   max_load_drift; /* see recover_slot */
+};
+
+template<std::size_t N>
+struct table_core_stats
+{
+  table_core_insertion_stats insertion;
+  table_core_lookup_stats    successful_lookup,
+                             unsuccessful_lookup;
+  table_core_rehash_stats    rehash;
+  table_core_layout_stats<N> layout;
+};
+
+template<template<std::size_t> class CumulativeStats>
+struct table_core_cumulative_stats
+{
+  void reset()noexcept
+  {
+    insertion.reset();
+    successful_lookup.reset();
+    unsuccessful_lookup.reset();
+    rehash.reset();
+  }
+
+  CumulativeStats<1> insertion; /* probe length */
+  CumulativeStats<2> successful_lookup, /* probe length, num comparisons */
+                     unsuccessful_lookup;
+  CumulativeStats<1> rehash; /* duration */
+};
+
+/* times the enclosing scope */
+
+template<typename CumulativeStats>
+struct scoped_duration_stats
+{
+  scoped_duration_stats(CumulativeStats& s_):
+    s(s_),t0{std::chrono::steady_clock::now()}{}
+
+  scoped_duration_stats(const scoped_duration_stats&)=delete;
+  scoped_duration_stats& operator=(const scoped_duration_stats&)=delete;
+
+  ~scoped_duration_stats()
   {
+    s.add(std::chrono::duration<double>(
+      std::chrono::steady_clock::now()-t0).count());
   }
 
-  KFwdRef move_or_fwd() { return std::forward<KFwdRef>(ref); }
+  CumulativeStats&                      s;
+  std::chrono::steady_clock::time_point t0;
 };
 
-template <typename Container>
-using is_map =
-  std::integral_constant<bool, !std::is_same<typename Container::key_type,
-                                 typename Container::value_type>::value>;
-
-template <typename Container, typename K>
-using is_emplace_kv_able = std::integral_constant<bool,
-  is_map<Container>::value &&
-    (is_similar<K, typename Container::key_type>::value ||
-      is_complete_and_move_constructible<typename Container::key_type>::value)>;
+#endif
 
 /* table_core. The TypePolicy template parameter is used to generate
  * instantiations suitable for either maps or sets, and introduces non-standard
@@ -1331,6 +2273,15 @@ using is_emplace_kv_able = std::integral_constant<bool,
  *     need to be moved, such as during move construction/assignment when
  *     allocators are unequal and there is no propagation. For all other cases,
  *     the element_type itself is moved.
+ *
+ * When hash_is_expensive<Hash>::value is true, the (mixed) hash value of each
+ * element is stored in a parallel array of table_arrays and used instead of
+ * recomputing it on rehashing and as a pre-filter before calling Pred on
+ * lookup (see store_hash, hash_of and hash_matches).
+ *
+ * When hash_prefers_compact_growth<Hash>::value is true, fastrange_size_policy
+ * and skipping_quadratic_prober are used instead of pow2_size_policy and
+ * pow2_quadratic_prober.
  */
 
 #include <boost/unordered/detail/foa/ignore_wshadow.hpp>
@@ -1364,8 +2315,18 @@ public:
   using type_policy=TypePolicy;
   using group_type=Group;
   static constexpr auto N=group_type::N;
-  using size_policy=pow2_size_policy;
-  using prober=pow2_quadratic_prober;
+  static constexpr bool compact_growth=
+    hash_prefers_compact_growth<Hash>::value;
+  using size_policy=typename std::conditional<
+    compact_growth,
+    fastrange_size_policy,
+    pow2_size_policy
+  >::type;
+  using prober=typename std::conditional<
+    compact_growth,
+    skipping_quadratic_prober,
+    pow2_quadratic_prober
+  >::type;
   using mix_policy=typename std::conditional<
     hash_is_avalanching<Hash>::value,
     no_mix,
@@ -1373,7 +2334,10 @@ public:
   >::type;
   using alloc_traits=boost::allocator_traits<Allocator>;
   using element_type=typename type_policy::element_type;
-  using arrays_type=Arrays<element_type,group_type,size_policy,Allocator>;
+  static constexpr bool stores_hash=hash_is_expensive<Hash>::value;
+  using arrays_type=Arrays<
+    element_type,group_type,size_policy,Allocator,
+    std::integral_constant<bool,stores_hash>>;
   using size_ctrl_type=SizeControl;
   static constexpr auto uses_fancy_pointers=!std::is_same<
     typename alloc_traits::pointer,
@@ -1495,6 +2459,11 @@ public:
     return make_arrays(0);
   }
 
+  arrays_holder_type make_arrays_for_growth()const
+  {
+    return {new_arrays_for_growth(),al()};
+  }
+
   table_core& operator=(const table_core& x)
   {
     BOOST_UNORDERED_STATIC_ASSERT_HASH_PRED(Hash, Pred)
@@ -1629,6 +2598,17 @@ public:
     return find(x,position_for(hash),hash);
   }
 
+  /* brings in the metadata and first element slot of the group where
+   * lookup for hash starts
+   */
+
+  BOOST_FORCEINLINE void prefetch(std::size_t hash)const noexcept
+  {
+    auto pos=position_for(hash);
+    BOOST_UNORDERED_PREFETCH(arrays.groups()+pos);
+    if(arrays.elements())BOOST_UNORDERED_PREFETCH(arrays.elements()+pos*N);
+  }
+
 #if defined(BOOST_MSVC)
 /* warning: forcing value to bool 'true' or 'false' in bool(pred()...) */
 #pragma warning(push)
@@ -1639,6 +2619,7 @@ public:
   BOOST_FORCEINLINE locator find(
     const Key& x,std::size_t pos0,std::size_t hash)const
   {    
+    BOOST_UNORDERED_STATS_COUNTER(num_cmps);
     prober pb(pos0);
     do{
       auto pos=pb.get();
@@ -1651,17 +2632,25 @@ public:
         BOOST_UNORDERED_PREFETCH_ELEMENTS(p,N);
         do{
           auto n=unchecked_countr_zero(mask);
-          if(BOOST_LIKELY(bool(pred()(x,key_from(p[n]))))){
+          BOOST_UNORDERED_INCREMENT_STATS_COUNTER(num_cmps);
+          if(BOOST_LIKELY(
+            hash_matches(arrays,p+n,hash)&&bool(pred()(x,key_from(p[n]))))){
+            BOOST_UNORDERED_ADD_STATS(
+              cstats.successful_lookup,(pb.length(),num_cmps));
             return {pg,n,p+n};
           }
           mask&=mask-1;
         }while(mask);
       }
       if(BOOST_LIKELY(pg->is_not_overflowed(hash))){
+        BOOST_UNORDERED_ADD_STATS(
+          cstats.unsuccessful_lookup,(pb.length(),num_cmps));
         return {};
       }
     }
     while(BOOST_LIKELY(pb.next(arrays.groups_size_mask)));
+    BOOST_UNORDERED_ADD_STATS(
+      cstats.unsuccessful_lookup,(pb.length(),num_cmps));
     return {};
   }
 
@@ -1734,10 +2723,7 @@ public:
 
   void rehash(std::size_t n)
   {
-    auto m=size_t(std::ceil(float(size())/mlf));
-    if(m>n)n=m;
-    if(n)n=capacity_for(n); /* exact resulting capacity */
-
+    n=capacity_for_rehash(n);
     if(n!=capacity())unchecked_rehash(n);
   }
 
@@ -1746,6 +2732,172 @@ public:
     rehash(std::size_t(std::ceil(float(n)/mlf)));
   }
 
+  /* Recomputes overflow bits from the current elements' probe sequences
+   * without moving them, and restores max load to its initial value (see
+   * recover_slot). If the hash function throws, all overflow bits are set,
+   * which is correct albeit slow for lookup, and max load is lowered so that
+   * the next insertion triggers growth (see rebuild_overflow_for_growth).
+   */
+
+  void rebuild_overflow()
+  {
+    if(!arrays.elements())return;
+
+    auto pg0=arrays.groups(),last=pg0+arrays.groups_size_mask+1;
+    for(auto pg=pg0;pg!=last;++pg)pg->reset_overflow();
+    BOOST_TRY{
+      for_all_elements([&,this](group_type* pg,unsigned int,element_type* p){
+        auto hash=hash_of(arrays,p);
+        auto pos=static_cast<std::size_t>(pg-pg0);
+        for(prober pb(position_for(hash));pb.get()!=pos;
+            pb.next(arrays.groups_size_mask)){
+          pg0[pb.get()].mark_overflow(hash);
+        }
+      });
+    }
+    BOOST_CATCH(...){
+      for(auto pg=pg0;pg!=last;++pg){
+        for(std::size_t hash=0;hash<16;++hash)pg->mark_overflow(hash);
+      }
+      size_ctrl.ml=size();
+      BOOST_RETHROW
+    }
+    BOOST_CATCH_END
+    size_ctrl.ml=initial_max_load();
+  }
+
+  /* If max load has drifted so much that growing would not increase
+   * capacity, we rebuild overflow metadata in place instead of rehashing to
+   * the same capacity.
+   */
+
+  bool rebuild_overflow_for_growth()
+  {
+    if(capacity_for(size_for_growth())>capacity())return false;
+    rebuild_overflow();
+    return size_ctrl.size<size_ctrl.ml;
+  }
+
+  /* Same as rehash/reserve, with elements transferred in parallel:
+   * for_each_(first,last,f) is expected to invoke f(g) for every group g in
+   * [first,last), possibly concurrently (std::for_each with an execution
+   * policy, typically).
+   */
+
+  template<typename ParallelForEach>
+  void parallel_rehash(ParallelForEach for_each_,std::size_t n)
+  {
+    n=capacity_for_rehash(n);
+    if(n!=capacity())unchecked_parallel_rehash(for_each_,n);
+  }
+
+  template<typename ParallelForEach>
+  void parallel_reserve(ParallelForEach for_each_,std::size_t n)
+  {
+    parallel_rehash(for_each_,std::size_t(std::ceil(float(n)/mlf)));
+  }
+
+  /* Erases the elements satisfying pr(p), with groups processed in parallel
+   * by for_each_ (same signature as in parallel_rehash). Slot recovery only
+   * touches the group being processed, and size and max load adjustments
+   * are accumulated per group and applied at the end. pr is not expected
+   * to throw (std::terminate is called with standard execution policies).
+   */
+
+  template<typename ParallelForEach,typename Predicate>
+  std::size_t parallel_erase_if(ParallelForEach for_each_,Predicate pr)
+  {
+    if(!arrays.elements())return 0;
+
+    std::atomic<std::size_t> num_erased{0},ml_decrease{0};
+
+    auto first=arrays.groups(),last=first+arrays.groups_size_mask+1;
+    for_each_(first,last,[&,this](group_type& g){
+      auto        pg=&g;
+      auto        p=arrays.elements()+static_cast<std::size_t>(pg-first)*N;
+      auto        mask=match_really_occupied(pg,last);
+      std::size_t ne=0,mld=0;
+      while(mask){
+        auto n=unchecked_countr_zero(mask);
+        if(pr(p+n)){
+          auto pc=reinterpret_cast<unsigned char*>(pg)+n;
+          destroy_element(p+n);
+          mld+=group_type::maybe_caused_overflow(pc);
+          group_type::reset(pc);
+          ++ne;
+        }
+        mask&=mask-1;
+      }
+      if(ne){
+        num_erased.fetch_add(ne,std::memory_order_relaxed);
+        ml_decrease.fetch_add(mld,std::memory_order_relaxed);
+      }
+    });
+
+    auto res=num_erased.load(std::memory_order_relaxed);
+    size_ctrl.ml-=ml_decrease.load(std::memory_order_relaxed);
+    size_ctrl.size-=res;
+    return res;
+  }
+
+#if defined(BOOST_UNORDERED_ENABLE_STATS)
+  using stats=table_core_stats<N>;
+  using cumulative_stats_type=table_core_cumulative_stats<cumulative_stats>;
+
+  stats get_stats()const{return make_stats(cstats);}
+
+  void reset_stats()noexcept{cstats.reset();}
+
+  stats make_stats(const cumulative_stats_type& cs)const
+  {
+    auto  insertion=cs.insertion.get_summary(),
+          rehash=cs.rehash.get_summary();
+    auto  successful_lookup=cs.successful_lookup.get_summary(),
+          unsuccessful_lookup=cs.unsuccessful_lookup.get_summary();
+    stats res;
+
+    res.insertion={
+      insertion.count,insertion.sequence_summary[0],insertion.histogram};
+    res.successful_lookup={
+      successful_lookup.count,successful_lookup.sequence_summary[0],
+      successful_lookup.sequence_summary[1],successful_lookup.histogram};
+    res.unsuccessful_lookup={
+      unsuccessful_lookup.count,unsuccessful_lookup.sequence_summary[0],
+      unsuccessful_lookup.sequence_summary[1],unsuccessful_lookup.histogram};
+    res.rehash={rehash.count,rehash.sequence_summary[0]};
+    res.layout=layout_stats();
+    return res;
+  }
+
+  table_core_layout_stats<N> layout_stats()const
+  {
+    table_core_layout_stats<N> res{};
+    res.num_groups=arrays.groups_size_mask+1;
+    res.max_load=size_ctrl.ml;
+    res.max_load_drift=initial_max_load()-res.max_load;
+    if(!arrays.elements()){ /* dummy groups, see dummy_groups */
+      res.occupancy_histogram[0]=res.num_groups;
+      return res;
+    }
+    for(auto pg=arrays.groups(),last=pg+res.num_groups;pg!=last;++pg){
+      std::size_t num_elements=0;
+      for(auto mask=match_really_occupied(pg,last);mask;mask&=mask-1){
+        ++num_elements;
+      }
+      ++res.occupancy_histogram[num_elements];
+
+      /* overflow bits are indexed by hash%8 (hash%16 for group7) */
+      for(std::size_t hash=0;hash<16;++hash){
+        if(!pg->is_not_overflowed(hash)){
+          ++res.num_overflowed_groups;
+          break;
+        }
+      }
+    }
+    return res;
+  }
+#endif
+
   friend bool operator==(const table_core& x,const table_core& y)
   {
     return
@@ -1834,10 +2986,76 @@ public:
     return size_policy::position(hash,arrays_.groups_size_index);
   }
 
-  static inline int match_really_occupied(group_type* pg,group_type* last)
+  static inline void store_hash(
+    const arrays_type& arrays_,const element_type* p,std::size_t hash)
   {
+    if(stores_hash)arrays_.hashes()[p-arrays_.elements()]=hash;
+  }
+
+  inline std::size_t hash_of(
+    const arrays_type& arrays_,const element_type* p)const
+  {
+    if(stores_hash)return arrays_.hashes()[p-arrays_.elements()];
+    else           return hash_for(key_from(*p));
+  }
+
+  /* false only if p's key is known not to have the given hash value */
+
+  static inline bool hash_matches(
+    const arrays_type& arrays_,const element_type* p,std::size_t hash)
+  {
+    return !stores_hash||arrays_.hashes()[p-arrays_.elements()]==hash;
+  }
+
+  static inline auto match_really_occupied(group_type* pg,group_type* last)
+    ->decltype(pg->match_occupied())
+  {
+    using mask_type=decltype(pg->match_occupied());
+
     /* excluding the sentinel */
-    return pg->match_occupied()&~(int(pg==last-1)<<(N-1));
+    return pg->match_occupied()&~(mask_type(pg==last-1)<<(N-1));
+  }
+
+  static inline void prefetch_group(group_type* pg,element_type* p)
+  {
+    BOOST_UNORDERED_PREFETCH(pg);
+    prefetch_slots(p);
+  }
+
+  /* node containers: slots (pointers) are few and read ahead of their nodes */
+
+  template<typename T,typename VoidPtr>
+  static inline void prefetch_slots(foa::element_type<T,VoidPtr>* p)
+  {
+    constexpr int cache_line=64;
+    const char    *p0=reinterpret_cast<const char*>(p),
+                  *p1=p0+sizeof(*p)*N;
+    for(;p0<p1;p0+=cache_line)BOOST_UNORDERED_PREFETCH(p0);
+  }
+
+  /* flat containers: occupied slots are prefetched in prefetch_occupied */
+
+  template<typename T>
+  static inline void prefetch_slots(T*){}
+
+  template<typename T,typename VoidPtr>
+  static inline void prefetch_element(foa::element_type<T,VoidPtr>* p)
+  {
+    BOOST_UNORDERED_PREFETCH(boost::to_address(p->p));
+  }
+
+  template<typename T>
+  static inline void prefetch_element(T* p)
+  {
+    BOOST_UNORDERED_PREFETCH(p);
+  }
+
+  static inline void prefetch_occupied(
+    group_type* pg,group_type* last,element_type* p)
+  {
+    for(auto mask=match_really_occupied(pg,last);mask;mask&=mask-1){
+      prefetch_element(p+unchecked_countr_zero(mask));
+    }
   }
 
   template<typename... Args>
@@ -1852,6 +3070,8 @@ public:
 
   BOOST_NOINLINE void unchecked_rehash_for_growth()
   {
+    if(rebuild_overflow_for_growth())return;
+
     auto new_arrays_=new_arrays_for_growth();
     unchecked_rehash(new_arrays_);
   }
@@ -1860,6 +3080,11 @@ public:
   BOOST_NOINLINE locator
   unchecked_emplace_with_rehash(std::size_t hash,Args&&... args)
   {
+    if(rebuild_overflow_for_growth()){
+      return unchecked_emplace_at(
+        position_for(hash),hash,std::forward<Args>(args)...);
+    }
+
     auto    new_arrays_=new_arrays_for_growth();
     locator it;
     BOOST_TRY{
@@ -1953,15 +3178,76 @@ public:
     return true;
   }
 
+  /* Full traversal engine for visit_all and the like: f(pg,mask,p) is
+   * invoked for each group pg (with elements p) whose mask of occupied slots
+   * is not zero, so that empty groups cost a single SIMD check. Ahead of the
+   * group being visited, metadata and element slots are prefetched, and
+   * then occupied elements (for node containers, the nodes they point to,
+   * which would otherwise incur a dependent cache miss each).
+   */
+
+  static constexpr std::size_t visit_all_prefetch_distance=
+    BOOST_UNORDERED_VISIT_ALL_PREFETCH_DISTANCE;
+
+  template<typename F>
+  static bool prefetched_for_all_groups_while(const arrays_type& arrays_,F f)
+  {
+    constexpr auto d=visit_all_prefetch_distance;
+
+    auto p=arrays_.elements();
+    if(!p)return true;
+
+    auto size=arrays_.groups_size_mask+1;
+    auto first=arrays_.groups(),last=first+size;
+    for(std::size_t i=0;i<size&&i<2*d;++i){
+      prefetch_group(first+i,p+i*N);
+    }
+    for(std::size_t i=0;i<size&&i<d;++i){
+      prefetch_occupied(first+i,last,p+i*N);
+    }
+
+    for(auto pg=first;pg!=last;++pg,p+=N){
+      auto remaining=static_cast<std::size_t>(last-pg);
+      if(remaining>2*d)prefetch_group(pg+2*d,p+2*d*N);
+      if(remaining>d)prefetch_occupied(pg+d,last,p+d*N);
+
+      auto mask=match_really_occupied(pg,last);
+      if(mask&&!f(pg,mask,p))return false;
+    }
+    return true;
+  }
+
+  template<typename F>
+  static bool prefetched_for_all_elements_while(
+    const arrays_type& arrays_,F f)
+  {
+    return prefetched_for_all_groups_while(
+      arrays_,[&](group_type* pg,decltype(pg->match_occupied()) mask,
+                  element_type* p){
+        do{
+          auto n=unchecked_countr_zero(mask);
+          if(!f(pg,n,p+n))return false;
+          mask&=mask-1;
+        }while(mask);
+        return true;
+      });
+  }
+
   arrays_type    arrays;
   size_ctrl_type size_ctrl;
 
+#if defined(BOOST_UNORDERED_ENABLE_STATS)
+  mutable cumulative_stats_type cstats;
+#endif
+
 private:
   template<
     typename,typename,template<typename...> class,
     typename,typename,typename,typename
   >
   friend class table_core;
+  template<typename,typename,typename,typename,typename>
+  friend class split_table;
 
   using hash_base=empty_value<Hash,0>;
   using pred_base=empty_value<Pred,1>;
@@ -1983,6 +3269,11 @@ private:
   }
 
   arrays_type new_arrays_for_growth()const
+  {
+    return new_arrays(size_for_growth());
+  }
+
+  std::size_t size_for_growth()const
   {
     /* Due to the anti-drift mechanism (see recover_slot), the new arrays may
      * be of the same size as the old arrays; in the limit, erasing one
@@ -1994,8 +3285,8 @@ private:
      * probability of an element having caused overflow; P has been measured as
      * ~0.162 under ideal conditions, yielding F ~ 0.0165 ~ 1/61.
      */
-    return new_arrays(std::size_t(
-      std::ceil(static_cast<float>(size()+size()/61+1)/mlf)));
+    return std::size_t(
+      std::ceil(static_cast<float>(size()+size()/61+1)/mlf));
   }
 
   void delete_arrays(arrays_type& arrays_)noexcept
@@ -2049,6 +3340,7 @@ private:
     if(arrays.elements()&&x.arrays.elements()){
       copy_elements_array_from(x);
       copy_groups_array_from(x);
+      copy_hashes_array_from(x);
       size_ctrl.ml=std::size_t(x.size_ctrl.ml);
       size_ctrl.size=std::size_t(x.size_ctrl.size);
     }
@@ -2123,6 +3415,15 @@ private:
     }
   }
 
+  void copy_hashes_array_from(const table_core& x)
+  {
+    if(stores_hash){
+      std::memcpy(
+        arrays.hashes(),x.arrays.hashes(),
+        (arrays.groups_size_mask+1)*N*sizeof(std::size_t));
+    }
+  }
+
   void recover_slot(unsigned char* pc)
   {
     /* If this slot potentially caused overflow, we decrease the maximum load
@@ -2144,6 +3445,14 @@ private:
     return size_policy::size(size_index_for<group_type,size_policy>(n))*N-1;
   }
 
+  std::size_t capacity_for_rehash(std::size_t n)const
+  {
+    auto m=size_t(std::ceil(float(size())/mlf));
+    if(m>n)n=m;
+    if(n)n=capacity_for(n); /* exact resulting capacity */
+    return n;
+  }
+
   BOOST_NOINLINE void unchecked_rehash(std::size_t n)
   {
     auto new_arrays_=new_arrays(n);
@@ -2152,11 +3461,13 @@ private:
 
   BOOST_NOINLINE void unchecked_rehash(arrays_type& new_arrays_)
   {
+#if defined(BOOST_UNORDERED_ENABLE_STATS)
+    scoped_duration_stats<cumulative_stats<1>> sds{cstats.rehash};
+#endif
+
     std::size_t num_destroyed=0;
     BOOST_TRY{
-      for_all_elements([&,this](element_type* p){
-        nosize_transfer_element(p,new_arrays_,num_destroyed);
-      });
+      transfer_elements(new_arrays_,num_destroyed);
     }
     BOOST_CATCH(...){
       if(num_destroyed){
@@ -2187,6 +3498,36 @@ private:
     size_ctrl.ml=initial_max_load();
   }
 
+  void transfer_elements(
+    const arrays_type& new_arrays_,std::size_t& num_destroyed)
+  {
+#if defined(BOOST_UNORDERED_RUNTIME_DISPATCH)
+    if(cpu_supports_avx2_bmi()){
+      avx2_transfer_elements(new_arrays_,num_destroyed);
+      return;
+    }
+#endif
+
+    transfer_elements_loop(new_arrays_,num_destroyed);
+  }
+
+#if defined(BOOST_UNORDERED_RUNTIME_DISPATCH)
+  BOOST_UNORDERED_AVX2_DISPATCH_TARGET
+  void avx2_transfer_elements(
+    const arrays_type& new_arrays_,std::size_t& num_destroyed)
+  {
+    transfer_elements_loop(new_arrays_,num_destroyed);
+  }
+#endif
+
+  BOOST_FORCEINLINE void transfer_elements_loop(
+    const arrays_type& new_arrays_,std::size_t& num_destroyed)
+  {
+    for_all_elements([&,this](element_type* p){
+      nosize_transfer_element(p,new_arrays_,num_destroyed);
+    });
+  }
+
   template<typename Value>
   void unchecked_insert(Value&& x)
   {
@@ -2194,16 +3535,13 @@ private:
     unchecked_emplace_at(position_for(hash),hash,std::forward<Value>(x));
   }
 
+  using transfer_by_move=foa::transfer_by_move<type_policy>;
+
   void nosize_transfer_element(
     element_type* p,const arrays_type& arrays_,std::size_t& num_destroyed)
   {
     nosize_transfer_element(
-      p,hash_for(key_from(*p)),arrays_,num_destroyed,
-      std::integral_constant< /* std::move_if_noexcept semantics */
-        bool,
-        std::is_nothrow_move_constructible<init_type>::value||
-        !std::is_same<element_type,value_type>::value||
-        !std::is_copy_constructible<element_type>::value>{});
+      p,hash_of(arrays,p),arrays_,num_destroyed,transfer_by_move{});
   }
 
   void nosize_transfer_element(
@@ -2242,12 +3580,144 @@ private:
         auto n=unchecked_countr_zero(mask);
         auto p=arrays_.elements()+pos*N+n;
         construct_element(p,std::forward<Args>(args)...);
+        store_hash(arrays_,p,hash);
         pg->set(n,hash);
+        BOOST_UNORDERED_ADD_STATS(cstats.insertion,(pb.length()));
         return {pg,n,p};
       }
       else pg->mark_overflow(hash);
     }
   }
+
+  /* Parallel rehash: source groups are distributed among threads by
+   * for_each_, and slots in the new arrays are claimed under a striped array
+   * of spinlocks indexed by target group. As in unchecked_rehash, elements
+   * are moved if this can't throw (or copy is not available) and copied
+   * otherwise. Exceptions thrown by any thread are captured and rethrown
+   * once all threads are done, after rolling back to the old arrays: in the
+   * move case, elements already transferred are lost (basic guarantee).
+   */
+
+  static constexpr std::size_t parallel_rehash_num_locks=1024;
+
+  template<typename ParallelForEach>
+  BOOST_NOINLINE void unchecked_parallel_rehash(
+    ParallelForEach& for_each_,std::size_t n)
+  {
+    auto new_arrays_=new_arrays(n);
+    if(!size()){
+      unchecked_rehash(new_arrays_);
+      return;
+    }
+
+#if defined(BOOST_UNORDERED_ENABLE_STATS)
+    scoped_duration_stats<cumulative_stats<1>> sds{cstats.rehash};
+#endif
+
+    rw_spinlock              locks[parallel_rehash_num_locks];
+    std::atomic<bool>        failed{false};
+    std::exception_ptr       ep;
+    std::atomic<std::size_t> num_destroyed{0},ml_decrease{0};
+
+    auto first=arrays.groups(),last=first+arrays.groups_size_mask+1;
+    for_each_(first,last,[&,this](group_type& g){
+      if(failed.load(std::memory_order_relaxed))return;
+
+      auto        pg=&g;
+      auto        p=arrays.elements()+static_cast<std::size_t>(pg-first)*N;
+      auto        mask=match_really_occupied(pg,last);
+      std::size_t nd=0,mld=0;
+      BOOST_TRY{
+        while(mask){
+          auto n=unchecked_countr_zero(mask);
+          parallel_transfer_element(
+            locks,pg,n,p+n,new_arrays_,nd,mld,transfer_by_move{});
+          mask&=mask-1;
+        }
+      }
+      BOOST_CATCH(...){
+        if(!failed.exchange(true))ep=std::current_exception();
+      }
+      BOOST_CATCH_END
+      if(nd){
+        num_destroyed+=nd;
+        ml_decrease+=mld;
+      }
+    });
+
+    if(BOOST_UNLIKELY(failed.load())){
+      size_ctrl.size-=num_destroyed.load();
+      size_ctrl.ml-=ml_decrease.load();
+      for_all_elements(new_arrays_,[this](element_type* p){
+        destroy_element(p);
+      });
+      delete_arrays(new_arrays_);
+      std::rethrow_exception(ep);
+    }
+
+    if(!transfer_by_move::value){
+      for_all_elements([this](element_type* p){
+        destroy_element(p);
+      });
+    }
+    delete_arrays(arrays);
+    arrays=new_arrays_;
+    size_ctrl.ml=initial_max_load();
+  }
+
+  void parallel_transfer_element(
+    rw_spinlock* locks,group_type* pg,unsigned int n,element_type* p,
+    const arrays_type& arrays_,std::size_t& num_destroyed,
+    std::size_t& ml_decrease,std::true_type /* ->move */)
+  {
+    auto hash=hash_of(arrays,p);
+    auto pc=reinterpret_cast<unsigned char*>(pg)+n;
+
+    /* the source group is owned by this thread: vacate the slot right away
+     * and destroy p even if an exception is thrown in the middle of move
+     * construction (see nosize_transfer_element).
+     */
+    ++num_destroyed;
+    ml_decrease+=group_type::maybe_caused_overflow(pc);
+    group_type::reset(pc);
+    destroy_element_on_exit d{this,p};
+    (void)d; /* unused var warning */
+    parallel_nosize_unchecked_emplace_at(
+      locks,arrays_,position_for(hash,arrays_),hash,type_policy::move(*p));
+  }
+
+  void parallel_transfer_element(
+    rw_spinlock* locks,group_type*,unsigned int,element_type* p,
+    const arrays_type& arrays_,std::size_t& /*num_destroyed*/,
+    std::size_t& /*ml_decrease*/,std::false_type /* ->copy */)
+  {
+    auto hash=hash_of(arrays,p);
+    parallel_nosize_unchecked_emplace_at(
+      locks,arrays_,position_for(hash,arrays_),hash,
+      const_cast<const element_type&>(*p));
+  }
+
+  template<typename... Args>
+  void parallel_nosize_unchecked_emplace_at(
+    rw_spinlock* locks,const arrays_type& arrays_,
+    std::size_t pos0,std::size_t hash,Args&&... args)
+  {
+    for(prober pb(pos0);;pb.next(arrays_.groups_size_mask)){
+      auto pos=pb.get();
+      auto pg=arrays_.groups()+pos;
+      std::lock_guard<rw_spinlock> lck{locks[pos%parallel_rehash_num_locks]};
+      auto mask=pg->match_available();
+      if(BOOST_LIKELY(mask!=0)){
+        auto n=unchecked_countr_zero(mask);
+        auto p=arrays_.elements()+pos*N+n;
+        construct_element(p,std::forward<Args>(args)...);
+        store_hash(arrays_,p,hash);
+        pg->set(n,hash);
+        return;
+      }
+      else pg->mark_overflow(hash);
+    }
+  }
 };
 
 #if BOOST_WORKAROUND(BOOST_MSVC,<=1900)
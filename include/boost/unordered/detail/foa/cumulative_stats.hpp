@@ -0,0 +1,167 @@
+/* Copyright 2024 Boost.Unordered contributors.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See https://www.boost.org/libs/unordered for library home page.
+ */
+
+#ifndef BOOST_UNORDERED_DETAIL_FOA_CUMULATIVE_STATS_HPP
+#define BOOST_UNORDERED_DETAIL_FOA_CUMULATIVE_STATS_HPP
+
+#include <boost/config.hpp>
+#include <boost/unordered/detail/foa/rw_spinlock.hpp>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <mutex>
+
+namespace boost{
+namespace unordered{
+namespace detail{
+namespace foa{
+
+/* Cumulative one-pass calculation of the average, variance and deviation of
+ * running sequences (Welford's algorithm), plus a histogram of the values
+ * of the first sequence, which is meant to be a small positive integer
+ * (a probe length, typically): the last bucket accounts for all values
+ * not less than stats_histogram_size.
+ */
+
+struct sequence_stats_summary
+{
+  double average;
+  double variance;
+  double deviation;
+};
+
+static constexpr std::size_t stats_histogram_size=16;
+
+using stats_histogram=std::array<std::size_t,stats_histogram_size>;
+
+struct sequence_stats_data
+{
+  double m=0.0;
+  double s=0.0;
+};
+
+template<std::size_t N>
+class cumulative_stats
+{
+public:
+  struct summary
+  {
+    std::size_t                          count;
+    std::array<sequence_stats_summary,N> sequence_summary;
+    stats_histogram                      histogram;
+  };
+
+  void reset()noexcept{*this=cumulative_stats();}
+
+  template<typename... Ts>
+  void add(Ts... xs)noexcept
+  {
+    static_assert(
+      sizeof...(Ts)==N,"A sample must be provided for each sequence.");
+
+    double x[N]={static_cast<double>(xs)...};
+
+    ++n;
+    ++histogram[histogram_index(x[0])];
+    for(std::size_t i=0;i<N;++i){
+      auto m_prior=data[i].m;
+      data[i].m+=(x[i]-data[i].m)/static_cast<double>(n);
+      data[i].s+=(x[i]-m_prior)*(x[i]-data[i].m);
+    }
+  }
+
+  /* Chan et al.'s parallel variant of Welford's algorithm */
+
+  void merge(const cumulative_stats& x)noexcept
+  {
+    if(!x.n)return;
+    if(!n){
+      *this=x;
+      return;
+    }
+
+    auto na=static_cast<double>(n),
+         nb=static_cast<double>(x.n),
+         nt=na+nb;
+    for(std::size_t i=0;i<N;++i){
+      auto delta=x.data[i].m-data[i].m;
+      data[i].m+=delta*nb/nt;
+      data[i].s+=x.data[i].s+delta*delta*na*nb/nt;
+    }
+    for(std::size_t i=0;i<stats_histogram_size;++i){
+      histogram[i]+=x.histogram[i];
+    }
+    n+=x.n;
+  }
+
+  summary get_summary()const noexcept
+  {
+    summary res;
+    res.count=n;
+    for(std::size_t i=0;i<N;++i){
+      double average=data[i].m,
+             variance=n!=0?data[i].s/static_cast<double>(n):0.0,
+             deviation=std::sqrt(variance);
+      res.sequence_summary[i]={average,variance,deviation};
+    }
+    res.histogram=histogram;
+    return res;
+  }
+
+private:
+  static std::size_t histogram_index(double x)noexcept
+  {
+    return
+      x<1.0?0:
+      x>=double(stats_histogram_size)?stats_histogram_size-1:
+      static_cast<std::size_t>(x)-1;
+  }
+
+  std::size_t         n=0;
+  sequence_stats_data data[N];
+  stats_histogram     histogram={};
+};
+
+/* thread-safe version for concurrent tables */
+
+template<std::size_t N>
+class concurrent_cumulative_stats
+{
+public:
+  using summary=typename cumulative_stats<N>::summary;
+
+  void reset()noexcept
+  {
+    std::lock_guard<rw_spinlock> lck{mut};
+    stats.reset();
+  }
+
+  template<typename... Ts>
+  void add(Ts... xs)noexcept
+  {
+    std::lock_guard<rw_spinlock> lck{mut};
+    stats.add(xs...);
+  }
+
+  cumulative_stats<N> get()const noexcept
+  {
+    std::lock_guard<rw_spinlock> lck{mut};
+    return stats;
+  }
+
+private:
+  mutable rw_spinlock mut;
+  cumulative_stats<N> stats;
+};
+
+} /* namespace foa */
+} /* namespace detail */
+} /* namespace unordered */
+} /* namespace boost */
+
+#endif
@@ -0,0 +1,636 @@
+/* Copyright 2024 Boost.Unordered contributors.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See https://www.boost.org/libs/unordered for library home page.
+ */
+
+#ifndef BOOST_UNORDERED_DETAIL_FOA_FROZEN_TABLE_HPP
+#define BOOST_UNORDERED_DETAIL_FOA_FROZEN_TABLE_HPP
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+#include <boost/core/allocator_access.hpp>
+#include <boost/core/empty_value.hpp>
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/core/pointer_traits.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/unordered/detail/foa/core.hpp>
+#include <boost/unordered/detail/mulx.hpp>
+#include <boost/unordered/detail/throw_exception.hpp>
+#include <boost/unordered/hash_traits.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace boost{
+namespace unordered{
+namespace detail{
+namespace foa{
+
+/* Read-only table with a minimal perfect hash function over its elements,
+ * after the PTHash construction (Pibiri and Trani, SIGIR 2021):
+ *
+ *   - Elements are distributed into buckets_size buckets of ~lambda
+ *     elements on average, according to the high bits of their (mixed) hash
+ *     value.
+ *   - Buckets are processed by decreasing size: for each bucket, a "pilot"
+ *     value is searched for such that position(hash,pilot), a remix of the
+ *     hash value with the pilot mapped to [0,table_size), lands every element
+ *     of the bucket on a free position. table_size is slightly larger than
+ *     the number of elements so that the search succeeds fast for the last
+ *     buckets.
+ *   - Positions beyond the number of elements are remapped to the free
+ *     positions below it, so elements are stored in a dense array.
+ *
+ * Lookup computes the position of the key, which takes a load from the
+ * (small) pilot array, and compares the key with the only element that may
+ * be equivalent to it, so there are no probing or overflow checks involved.
+ *
+ * No pilot separates elements with the same hash value: these are rare with
+ * mulx-mixed, 64-bit hash values, and, except for the first of each such
+ * group of elements, they are "spilled" to the end of the element array,
+ * which is then binary searched by hash value on unsuccessful lookups.
+ *
+ * pilots and remapped positions are stored in a single uint32_t array,
+ * as is the hash value of the spilled elements in a std::size_t array.
+ */
+
+struct frozen_arrays_sizes
+{
+  std::size_t size=0;         /* number of elements */
+  std::size_t primary_size=0; /* elements not spilled */
+  std::size_t table_size=0;
+  std::size_t buckets_size=0;
+
+  std::size_t indices_size()const noexcept
+  {
+    return primary_size?buckets_size+table_size-primary_size:0;
+  }
+
+  std::size_t spilled_size()const noexcept{return size-primary_size;}
+};
+
+#include <boost/unordered/detail/foa/ignore_wshadow.hpp>
+
+#if defined(BOOST_MSVC)
+#pragma warning(push)
+#pragma warning(disable:4714) /* marked as __forceinline not inlined */
+#endif
+
+template<typename TypePolicy,typename Hash,typename Pred,typename Allocator>
+class frozen_table:
+  empty_value<Hash,0>,empty_value<Pred,1>,empty_value<Allocator,2>
+{
+  using hash_base=empty_value<Hash,0>;
+  using pred_base=empty_value<Pred,1>;
+  using allocator_base=empty_value<Allocator,2>;
+  using type_policy=TypePolicy;
+  using element_type=typename type_policy::element_type;
+  using alloc_traits=boost::allocator_traits<Allocator>;
+  using element_allocator_type=
+    typename boost::allocator_rebind<Allocator,element_type>::type;
+  using element_pointer=
+    typename boost::allocator_pointer<element_allocator_type>::type;
+  using index_allocator_type=
+    typename boost::allocator_rebind<Allocator,boost::uint32_t>::type;
+  using index_pointer=
+    typename boost::allocator_pointer<index_allocator_type>::type;
+  using hash_allocator_type=
+    typename boost::allocator_rebind<Allocator,std::size_t>::type;
+  using hash_pointer=
+    typename boost::allocator_pointer<hash_allocator_type>::type;
+  using mix_policy=typename std::conditional<
+    hash_is_avalanching<Hash>::value,
+    no_mix,
+    mulx_mix
+  >::type;
+
+  /* average bucket size and (inverse) load factor of the position range */
+
+  static constexpr std::size_t lambda=4;
+  static constexpr std::size_t table_slack=99; /* 1/table_slack extra room */
+
+public:
+  using key_type=typename type_policy::key_type;
+  using value_type=typename type_policy::value_type;
+  using hasher=Hash;
+  using key_equal=Pred;
+  using allocator_type=Allocator;
+  using const_iterator=const value_type*;
+
+  frozen_table(const Hash& h_,const Pred& pred_,const Allocator& al_):
+    hash_base{empty_init,h_},pred_base{empty_init,pred_},
+    allocator_base{empty_init,al_}
+  {}
+
+  /* Builds the table from [first,last), whose elements must have unique keys,
+   * with construct(p,x) placing a copy of (or moving) *it at p.
+   */
+
+  template<typename ForwardIterator,typename Construct>
+  frozen_table(
+    ForwardIterator first,ForwardIterator last,Construct construct,
+    const Hash& h_,const Pred& pred_,const Allocator& al_):
+    frozen_table{h_,pred_,al_}
+  {
+    build(first,last,construct);
+  }
+
+  frozen_table(const frozen_table& x):
+    frozen_table{
+      x,alloc_traits::select_on_container_copy_construction(x.al())}
+  {}
+
+  frozen_table(const frozen_table& x,const Allocator& al_):
+    frozen_table{x.h(),x.pred(),al_}
+  {
+    auto arrays=new_arrays(x.sizes);
+    construct_elements(
+      arrays,x.sizes,[&](std::size_t i){return x.elements()+i;},
+      [](Allocator& al_,element_type* p,const element_type& v){
+        type_policy::construct(al_,p,v);
+      });
+    copy_indices(arrays,x.indices(),x.spilled_hashes(),x.sizes);
+    install(arrays,x.sizes);
+  }
+
+  frozen_table(frozen_table&& x)noexcept:
+    hash_base{empty_init,std::move(x.h())},
+    pred_base{empty_init,std::move(x.pred())},
+    allocator_base{empty_init,std::move(x.al())},
+    sizes{x.sizes},elements_{x.elements_},indices_{x.indices_},
+    spilled_hashes_{x.spilled_hashes_}
+  {
+    x.sizes=frozen_arrays_sizes{};
+    x.elements_=nullptr;
+    x.indices_=nullptr;
+    x.spilled_hashes_=nullptr;
+  }
+
+  ~frozen_table()noexcept
+  {
+    destroy_elements(elements(),sizes.size);
+    delete_arrays(elements_,indices_,spilled_hashes_,sizes);
+  }
+
+  frozen_table& operator=(const frozen_table& x)
+  {
+    if(this!=std::addressof(x)){
+      frozen_table tmp{
+        x,
+        alloc_traits::propagate_on_container_copy_assignment::value?
+          x.al():al()};
+      swap_impl(tmp,std::true_type{});
+    }
+    return *this;
+  }
+
+  frozen_table& operator=(frozen_table&& x)
+    noexcept(
+      alloc_traits::propagate_on_container_move_assignment::value||
+      alloc_traits::is_always_equal::value)
+  {
+    if(this!=std::addressof(x)){
+      if(alloc_traits::propagate_on_container_move_assignment::value||
+         al()==x.al()){
+        frozen_table tmp{std::move(x)};
+        swap_impl(tmp,std::true_type{});
+      }
+      else{
+        frozen_table tmp{x,al()};
+        swap_impl(tmp,std::true_type{});
+      }
+    }
+    return *this;
+  }
+
+  void swap(frozen_table& x)
+    noexcept(
+      alloc_traits::propagate_on_container_swap::value||
+      alloc_traits::is_always_equal::value)
+  {
+    swap_impl(
+      x,
+      std::integral_constant<
+        bool,alloc_traits::propagate_on_container_swap::value>{});
+  }
+
+  allocator_type get_allocator()const noexcept{return al();}
+
+  const_iterator begin()const noexcept{return elements();}
+  const_iterator end()const noexcept{return elements()+sizes.size;}
+
+  bool        empty()const noexcept{return sizes.size==0;}
+  std::size_t size()const noexcept{return sizes.size;}
+
+  /* number of positions (table_size) per element */
+
+  float load_factor()const noexcept
+  {
+    if(sizes.table_size==0)return 0;
+    else return float(sizes.primary_size)/float(sizes.table_size);
+  }
+
+  const Hash& hash_function()const noexcept{return h();}
+  const Pred& key_eq()const noexcept{return pred();}
+
+#if defined(BOOST_MSVC)
+/* warning: forcing value to bool 'true' or 'false' in bool(pred()...) */
+#pragma warning(push)
+#pragma warning(disable:4800)
+#endif
+
+  template<typename Key>
+  BOOST_FORCEINLINE const_iterator find(const Key& x)const
+  {
+    auto hash=mix_policy::mix(h(),x);
+    if(BOOST_LIKELY(sizes.primary_size!=0)){
+      auto p=elements()+position(hash);
+      if(BOOST_LIKELY(bool(pred()(x,type_policy::extract(*p)))))return p;
+    }
+    if(BOOST_UNLIKELY(sizes.size!=sizes.primary_size)){
+      return find_spilled(x,hash);
+    }
+    return end();
+  }
+
+#if defined(BOOST_MSVC)
+#pragma warning(pop) /* C4800 */
+#endif
+
+private:
+  const Hash&      h()const noexcept{return hash_base::get();}
+  Hash&            h()noexcept{return hash_base::get();}
+  const Pred&      pred()const noexcept{return pred_base::get();}
+  Pred&            pred()noexcept{return pred_base::get();}
+  const Allocator& al()const noexcept{return allocator_base::get();}
+  Allocator&       al()noexcept{return allocator_base::get();}
+
+  struct arrays_type
+  {
+    element_pointer elements=nullptr;
+    index_pointer   indices=nullptr;
+    hash_pointer    spilled_hashes=nullptr;
+  };
+
+  template<typename Pointer>
+  static auto raw(Pointer p)noexcept->decltype(boost::to_address(p))
+  {
+    return p?boost::to_address(p):nullptr;
+  }
+
+  element_type*          elements()const noexcept{return raw(elements_);}
+  const boost::uint32_t* indices()const noexcept{return raw(indices_);}
+  const std::size_t*     spilled_hashes()const noexcept
+                           {return raw(spilled_hashes_);}
+
+  static std::size_t pilot_hash(boost::uint32_t pilot)noexcept
+  {
+    return (std::size_t)pilot*(std::size_t)0x9E3779B97F4A7C15ull;
+  }
+
+  /* Hash values not mixed by us are remixed for bucket selection, as a poor
+   * "avalanching" hash function whose values share their high bits would
+   * otherwise pack many elements in a few buckets and make the search for
+   * pilots fail.
+   */
+
+  static constexpr bool remix_buckets=
+    !std::is_same<mix_policy,mulx_mix>::value;
+
+  static BOOST_FORCEINLINE std::size_t bucket(
+    std::size_t hash,std::size_t buckets_size)noexcept
+  {
+    return mulhi(remix_buckets?mulx(hash):hash,buckets_size);
+  }
+
+  static BOOST_FORCEINLINE std::size_t position(
+    std::size_t hash,boost::uint32_t pilot,std::size_t table_size)noexcept
+  {
+    return mulhi(mulx(hash^pilot_hash(pilot)),table_size);
+  }
+
+  BOOST_FORCEINLINE std::size_t position(std::size_t hash)const noexcept
+  {
+    auto pilot=indices()[bucket(hash,sizes.buckets_size)];
+    auto pos=position(hash,pilot,sizes.table_size);
+    if(pos>=sizes.primary_size){
+      pos=indices()[sizes.buckets_size+pos-sizes.primary_size];
+    }
+    return pos;
+  }
+
+  template<typename Key>
+  BOOST_NOINLINE const_iterator find_spilled(
+    const Key& x,std::size_t hash)const
+  {
+    auto first=spilled_hashes(),last=first+sizes.spilled_size();
+    for(auto it=std::lower_bound(first,last,hash);
+        it!=last&&*it==hash;++it){
+      auto p=elements()+sizes.primary_size+(it-first);
+      if(bool(pred()(x,type_policy::extract(*p))))return p;
+    }
+    return end();
+  }
+
+  template<typename ForwardIterator,typename Construct>
+  void build(ForwardIterator first,ForwardIterator last,Construct construct)
+  {
+    using source_pointer=decltype(std::addressof(*first));
+    struct entry
+    {
+      std::size_t    hash;
+      source_pointer px;
+      std::size_t    pos;
+    };
+
+    std::vector<entry> entries;
+    entries.reserve(static_cast<std::size_t>(std::distance(first,last)));
+    for(;first!=last;++first){
+      entries.push_back({
+        mix_policy::mix(h(),type_policy::extract(*first)),
+        std::addressof(*first),0});
+    }
+    if(entries.empty())return;
+
+    /* elements with the hash value of the previous one are spilled */
+
+    std::stable_sort(
+      entries.begin(),entries.end(),
+      [](const entry& x,const entry& y){return x.hash<y.hash;});
+    std::vector<entry> spilled;
+    {
+      std::size_t n=1;
+      for(std::size_t i=1;i<entries.size();++i){
+        if(entries[i].hash==entries[n-1].hash)spilled.push_back(entries[i]);
+        else entries[n++]=entries[i];
+      }
+      entries.resize(n);
+    }
+
+    frozen_arrays_sizes sizes_;
+    sizes_.size=entries.size()+spilled.size();
+    sizes_.primary_size=entries.size();
+    if(sizes_.primary_size>(std::numeric_limits<boost::uint32_t>::max)()){
+      throw_length_error("frozen table size exceeds maximum");
+    }
+    sizes_.table_size=
+      sizes_.primary_size+(sizes_.primary_size+table_slack-1)/table_slack;
+    sizes_.buckets_size=sizes_.primary_size/lambda+1;
+
+    std::vector<boost::uint32_t> pilots;
+    while(!search_pilots(entries,sizes_,pilots)){
+      /* pathological hash values: retry with smaller buckets */
+      sizes_.buckets_size*=2;
+    }
+
+    /* remap positions beyond primary_size to the free ones below */
+
+    std::vector<boost::uint32_t> remap(
+      sizes_.table_size-sizes_.primary_size,0);
+    {
+      std::vector<bool> taken(sizes_.primary_size,false);
+      for(const auto& e:entries){
+        if(e.pos<sizes_.primary_size)taken[e.pos]=true;
+      }
+      std::size_t free_pos=0;
+      for(auto& e:entries){
+        if(e.pos>=sizes_.primary_size){
+          while(taken[free_pos])++free_pos;
+          taken[free_pos]=true;
+          remap[e.pos-sizes_.primary_size]=
+            static_cast<boost::uint32_t>(free_pos);
+          e.pos=free_pos;
+        }
+      }
+    }
+
+    std::vector<source_pointer> sources(sizes_.size);
+    for(const auto& e:entries)sources[e.pos]=e.px;
+    for(std::size_t i=0;i<spilled.size();++i){
+      sources[sizes_.primary_size+i]=spilled[i].px;
+    }
+
+    auto arrays=new_arrays(sizes_);
+    construct_elements(
+      arrays,sizes_,[&](std::size_t i){return sources[i];},construct);
+
+    auto pi=raw(arrays.indices);
+    if(pi){
+      std::copy(pilots.begin(),pilots.end(),pi);
+      std::copy(remap.begin(),remap.end(),pi+pilots.size());
+    }
+    auto ph=raw(arrays.spilled_hashes);
+    for(std::size_t i=0;i<spilled.size();++i)ph[i]=spilled[i].hash;
+
+    install(arrays,sizes_);
+  }
+
+  /* Assigns a position to each entry, or returns false if some bucket takes
+   * too long, which happens only when many elements share the high bits of
+   * their hash values.
+   */
+
+  template<typename Entry>
+  static bool search_pilots(
+    std::vector<Entry>& entries,const frozen_arrays_sizes& sizes_,
+    std::vector<boost::uint32_t>& pilots)
+  {
+    static constexpr boost::uint32_t max_pilot_search=1u<<20;
+
+    std::size_t buckets_size=sizes_.buckets_size;
+
+    /* entries sorted by bucket, buckets sorted by decreasing size */
+
+    std::vector<std::size_t> bucket_first(buckets_size+1,0);
+    for(const auto& e:entries)++bucket_first[bucket(e.hash,buckets_size)+1];
+    for(std::size_t b=0;b<buckets_size;++b){
+      bucket_first[b+1]+=bucket_first[b];
+    }
+    std::vector<Entry*> bucket_entries(entries.size());
+    {
+      auto next=bucket_first;
+      for(auto& e:entries){
+        bucket_entries[next[bucket(e.hash,buckets_size)]++]=&e;
+      }
+    }
+    std::vector<std::size_t> buckets(buckets_size);
+    for(std::size_t b=0;b<buckets_size;++b)buckets[b]=b;
+    std::stable_sort(
+      buckets.begin(),buckets.end(),[&](std::size_t b1,std::size_t b2){
+        return bucket_first[b1+1]-bucket_first[b1]>
+               bucket_first[b2+1]-bucket_first[b2];
+      });
+
+    pilots.assign(buckets_size,0);
+    std::vector<bool>        taken(sizes_.table_size,false);
+    std::vector<std::size_t> pos;
+    for(auto b:buckets){
+      auto first=bucket_entries.begin()+
+                   static_cast<std::ptrdiff_t>(bucket_first[b]),
+           last=bucket_entries.begin()+
+                   static_cast<std::ptrdiff_t>(bucket_first[b+1]);
+      if(first==last)break;
+      for(boost::uint32_t pilot=0;;++pilot){
+        if(pilot==max_pilot_search&&buckets_size<entries.size())return false;
+
+        pos.clear();
+        for(auto it=first;it!=last;++it){
+          auto p=position((*it)->hash,pilot,sizes_.table_size);
+          if(taken[p]||std::find(pos.begin(),pos.end(),p)!=pos.end())break;
+          pos.push_back(p);
+        }
+        if(pos.size()==static_cast<std::size_t>(last-first)){
+          pilots[b]=pilot;
+          for(auto it=first;it!=last;++it){
+            auto p=pos[static_cast<std::size_t>(it-first)];
+            taken[p]=true;
+            (*it)->pos=p;
+          }
+          break;
+        }
+      }
+    }
+    return true;
+  }
+
+  arrays_type new_arrays(const frozen_arrays_sizes& sizes_)
+  {
+    arrays_type arrays;
+    if(sizes_.size==0)return arrays;
+    BOOST_TRY{
+      element_allocator_type eal(al());
+      arrays.elements=boost::allocator_allocate(eal,sizes_.size);
+      if(sizes_.indices_size()){
+        index_allocator_type ial(al());
+        arrays.indices=boost::allocator_allocate(ial,sizes_.indices_size());
+      }
+      if(sizes_.spilled_size()){
+        hash_allocator_type hal(al());
+        arrays.spilled_hashes=
+          boost::allocator_allocate(hal,sizes_.spilled_size());
+      }
+    }
+    BOOST_CATCH(...){
+      delete_arrays(
+        arrays.elements,arrays.indices,arrays.spilled_hashes,sizes_);
+      BOOST_RETHROW
+    }
+    BOOST_CATCH_END
+    return arrays;
+  }
+
+  void delete_arrays(
+    element_pointer elements_p,index_pointer indices_p,
+    hash_pointer spilled_hashes_p,const frozen_arrays_sizes& sizes_)noexcept
+  {
+    if(elements_p){
+      element_allocator_type eal(al());
+      boost::allocator_deallocate(eal,elements_p,sizes_.size);
+    }
+    if(indices_p){
+      index_allocator_type ial(al());
+      boost::allocator_deallocate(ial,indices_p,sizes_.indices_size());
+    }
+    if(spilled_hashes_p){
+      hash_allocator_type hal(al());
+      boost::allocator_deallocate(
+        hal,spilled_hashes_p,sizes_.spilled_size());
+    }
+  }
+
+  /* constructs element i from *source(i), destroying everything on failure */
+
+  template<typename Source,typename Construct>
+  void construct_elements(
+    const arrays_type& arrays,const frozen_arrays_sizes& sizes_,
+    Source source,Construct construct)
+  {
+    auto        p=raw(arrays.elements);
+    std::size_t i=0;
+    BOOST_TRY{
+      for(;i<sizes_.size;++i)construct(al(),p+i,*source(i));
+    }
+    BOOST_CATCH(...){
+      destroy_elements(p,i);
+      delete_arrays(
+        arrays.elements,arrays.indices,arrays.spilled_hashes,sizes_);
+      BOOST_RETHROW
+    }
+    BOOST_CATCH_END
+  }
+
+  void destroy_elements(element_type* p,std::size_t n)noexcept
+  {
+    for(std::size_t i=0;i<n;++i)type_policy::destroy(al(),p+i);
+  }
+
+  void copy_indices(
+    arrays_type& arrays,const boost::uint32_t* pi,const std::size_t* ph,
+    const frozen_arrays_sizes& sizes_)noexcept
+  {
+    if(pi)std::copy(pi,pi+sizes_.indices_size(),raw(arrays.indices));
+    if(ph)std::copy(ph,ph+sizes_.spilled_size(),raw(arrays.spilled_hashes));
+  }
+
+  void install(const arrays_type& arrays,const frozen_arrays_sizes& sizes_)
+    noexcept
+  {
+    BOOST_ASSERT(!elements_);
+    elements_=arrays.elements;
+    indices_=arrays.indices;
+    spilled_hashes_=arrays.spilled_hashes;
+    sizes=sizes_;
+  }
+
+  void swap_impl(frozen_table& x,std::true_type /* swap allocators */)
+  {
+    using std::swap;
+    swap(h(),x.h());
+    swap(pred(),x.pred());
+    swap(al(),x.al());
+    swap_arrays(x);
+  }
+
+  void swap_impl(frozen_table& x,std::false_type /* don't swap allocators */)
+  {
+    BOOST_ASSERT(al()==x.al());
+    using std::swap;
+    swap(h(),x.h());
+    swap(pred(),x.pred());
+    swap_arrays(x);
+  }
+
+  void swap_arrays(frozen_table& x)noexcept
+  {
+    std::swap(sizes,x.sizes);
+    std::swap(elements_,x.elements_);
+    std::swap(indices_,x.indices_);
+    std::swap(spilled_hashes_,x.spilled_hashes_);
+  }
+
+  frozen_arrays_sizes sizes;
+  element_pointer     elements_=nullptr;
+  index_pointer       indices_=nullptr;
+  hash_pointer        spilled_hashes_=nullptr;
+};
+
+#if defined(BOOST_MSVC)
+#pragma warning(pop) /* C4714 */
+#endif
+
+#include <boost/unordered/detail/foa/restore_wshadow.hpp>
+
+} /* namespace foa */
+} /* namespace detail */
+} /* namespace unordered */
+} /* namespace boost */
+
+#endif
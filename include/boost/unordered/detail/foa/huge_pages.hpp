@@ -0,0 +1,208 @@
+/* Copyright 2024 Boost.Unordered contributors.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See https://www.boost.org/libs/unordered for library home page.
+ */
+
+#ifndef BOOST_UNORDERED_DETAIL_FOA_HUGE_PAGES_HPP
+#define BOOST_UNORDERED_DETAIL_FOA_HUGE_PAGES_HPP
+
+#include <boost/config.hpp>
+#include <boost/core/allocator_access.hpp>
+#include <boost/core/pointer_traits.hpp>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+
+/* Opt-in placement of large bucket arrays in memory pages (Linux only):
+ *
+ *   - When BOOST_UNORDERED_ENABLE_HUGE_PAGES is defined, arrays of
+ *     huge_page_size bytes or more are requested to be backed by transparent
+ *     huge pages (madvise(MADV_HUGEPAGE)), which greatly reduces TLB misses on
+ *     random access to multi-GB tables. With std::allocator (and C++17 aligned
+ *     new), these arrays are also aligned to huge_page_size so that no
+ *     partial huge page is wasted at the beginning.
+ *   - When BOOST_UNORDERED_ENABLE_NUMA_INTERLEAVE is defined, large arrays of
+ *     concurrent containers are interleaved across the NUMA nodes the process
+ *     is allowed to allocate memory on (mbind(MPOL_INTERLEAVE)), so that
+ *     threads running on different nodes see uniform access latency and
+ *     memory bandwidth is aggregated across nodes.
+ *
+ * Both are advisory: failures of the underlying system calls (e.g. THP
+ * disabled, a single NUMA node) are silently ignored.
+ */
+
+#if defined(__linux__)
+#if defined(BOOST_UNORDERED_ENABLE_HUGE_PAGES)
+#include <sys/mman.h>
+#if defined(MADV_HUGEPAGE)
+#define BOOST_UNORDERED_HUGE_PAGES
+#endif
+#endif
+
+#if defined(BOOST_UNORDERED_ENABLE_NUMA_INTERLEAVE)
+#include <sys/syscall.h>
+#include <unistd.h>
+#if defined(SYS_mbind)&&defined(SYS_get_mempolicy)
+#define BOOST_UNORDERED_NUMA_INTERLEAVE
+#endif
+#endif
+#endif
+
+namespace boost{
+namespace unordered{
+namespace detail{
+namespace foa{
+
+static constexpr std::size_t huge_page_size=std::size_t(2)*1024*1024;
+
+#if defined(BOOST_UNORDERED_NUMA_INTERLEAVE)
+/* NUMA nodes allowed for the process, as returned by
+ * get_mempolicy(MPOL_F_MEMS_ALLOWED), or an empty set if interleaving is
+ * pointless or not possible.
+ */
+
+struct numa_node_mask
+{
+  static constexpr std::size_t   max_nodes=1024;
+  static constexpr unsigned long bits_per_word=
+    sizeof(unsigned long)*CHAR_BIT;
+
+  numa_node_mask()noexcept
+  {
+    /* values from <linux/mempolicy.h> */
+
+    static constexpr unsigned long mpol_f_mems_allowed=1ul<<2;
+
+    int mode=0;
+    if(::syscall(
+      SYS_get_mempolicy,&mode,words,(unsigned long)max_nodes,
+      (void*)nullptr,mpol_f_mems_allowed)!=0)return;
+
+    std::size_t num_nodes=0;
+    for(auto w:words){
+      for(;w;w&=w-1)++num_nodes;
+    }
+    usable=num_nodes>1;
+  }
+
+  unsigned long words[max_nodes/bits_per_word]={};
+  bool          usable=false;
+};
+
+inline void interleave_pages(void* p,std::size_t n)noexcept
+{
+  static const numa_node_mask mask;
+  static const std::uintptr_t page_size=
+    static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+  static constexpr int        mpol_interleave=3;
+
+  if(!mask.usable)return;
+
+  /* whole pages within [p,p+n) */
+
+  auto first=(reinterpret_cast<std::uintptr_t>(p)+page_size-1)&~(page_size-1),
+       last=(reinterpret_cast<std::uintptr_t>(p)+n)&~(page_size-1);
+  if(first<last){
+    /* the kernel considers maxnode-1 bits of the node mask */
+
+    (void)::syscall(
+      SYS_mbind,reinterpret_cast<void*>(first),(unsigned long)(last-first),
+      mpol_interleave,mask.words,(unsigned long)numa_node_mask::max_nodes+1,
+      0u);
+  }
+}
+#endif
+
+/* Called on newly allocated (and not yet accessed) array memory: interleave
+ * is set for the arrays of concurrent containers.
+ */
+
+inline void prepare_pages(void* p,std::size_t n,bool interleave)noexcept
+{
+#if defined(BOOST_UNORDERED_HUGE_PAGES)
+  if(n>=huge_page_size){
+    /* whole huge pages within [p,p+n) */
+
+    auto first=(reinterpret_cast<std::uintptr_t>(p)+huge_page_size-1)&
+                 ~std::uintptr_t(huge_page_size-1),
+         last=(reinterpret_cast<std::uintptr_t>(p)+n)&
+                 ~std::uintptr_t(huge_page_size-1);
+    if(first<last){
+      (void)::madvise(
+        reinterpret_cast<void*>(first),last-first,MADV_HUGEPAGE);
+    }
+  }
+#endif
+
+#if defined(BOOST_UNORDERED_NUMA_INTERLEAVE)
+  /* not worth two system calls for small arrays */
+
+  if(interleave&&n>=huge_page_size)interleave_pages(p,n);
+#endif
+
+  (void)p;
+  (void)n;
+  (void)interleave;
+}
+
+template<typename Allocator>
+typename boost::allocator_pointer<Allocator>::type
+allocate_pages(Allocator& al,std::size_t n,bool interleave=false)
+{
+  using value_type=typename boost::allocator_value_type<Allocator>::type;
+
+  auto p=boost::allocator_allocate(al,n);
+  prepare_pages(boost::to_address(p),n*sizeof(value_type),interleave);
+  return p;
+}
+
+template<typename Allocator>
+void deallocate_pages(
+  Allocator& al,typename boost::allocator_pointer<Allocator>::type p,
+  std::size_t n)
+{
+  boost::allocator_deallocate(al,p,n);
+}
+
+#if defined(BOOST_UNORDERED_HUGE_PAGES)&&defined(__cpp_aligned_new)
+/* std::allocator: large arrays are obtained from aligned operator new */
+
+template<typename T>
+bool uses_aligned_pages(std::size_t n)
+{
+  return
+    n>=huge_page_size/sizeof(T)&&
+    n<=(std::numeric_limits<std::size_t>::max)()/sizeof(T);
+}
+
+template<typename T>
+T* allocate_pages(std::allocator<T>& al,std::size_t n,bool interleave=false)
+{
+  if(!uses_aligned_pages<T>(n))return al.allocate(n);
+
+  auto p=static_cast<T*>(
+    ::operator new(n*sizeof(T),std::align_val_t(huge_page_size)));
+  prepare_pages(p,n*sizeof(T),interleave);
+  return p;
+}
+
+template<typename T>
+void deallocate_pages(std::allocator<T>& al,T* p,std::size_t n)
+{
+  if(!uses_aligned_pages<T>(n))al.deallocate(p,n);
+  else ::operator delete(p,std::align_val_t(huge_page_size));
+}
+#endif
+
+} /* namespace foa */
+} /* namespace detail */
+} /* namespace unordered */
+} /* namespace boost */
+
+#endif
@@ -0,0 +1,444 @@
+/* Copyright 2024 Boost.Unordered contributors.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See https://www.boost.org/libs/unordered for library home page.
+ */
+
+#ifndef BOOST_UNORDERED_DETAIL_FOA_IMAGE_HPP
+#define BOOST_UNORDERED_DETAIL_FOA_IMAGE_HPP
+
+#include <boost/config.hpp>
+#include <boost/core/empty_value.hpp>
+#include <boost/core/typeinfo.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/unordered/detail/foa/table.hpp>
+#include <boost/unordered/detail/throw_exception.hpp>
+#include <boost/unordered/hash_traits.hpp>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+namespace boost{
+namespace unordered{
+namespace detail{
+namespace foa{
+
+/* Binary image of a flat table. Its layout is:
+ *
+ *   - An image_header.
+ *   - The bytes of the hash function object, if this is trivially copyable
+ *     and non-empty (so that seeded hashers can be checked on load).
+ *   - The group array, aligned to image_alignment.
+ *   - The element array, with unused slots zeroed out.
+ *
+ * Offsets are relative to the start of the image, so it can be mapped at any
+ * address aligned to image_alignment and used in place. The image is not
+ * portable across platforms or builds with different metadata layouts: the
+ * header records everything needed to detect such mismatches on load.
+ */
+
+static constexpr std::size_t     image_alignment=64;
+static constexpr boost::uint32_t image_version=2;
+static constexpr boost::uint32_t image_endianness_mark=0x01020304;
+
+/* metadata layout of default_group in this build */
+
+static constexpr boost::uint32_t image_group_layout=
+#if defined(BOOST_UNORDERED_16BIT_FINGERPRINTS)
+  6; /* group7 */
+#elif defined(BOOST_UNORDERED_AVX512_GROUPS)
+  5; /* group63 */
+#elif defined(BOOST_UNORDERED_AVX2_GROUPS)
+  4; /* group31 */
+#elif defined(BOOST_UNORDERED_SSE2)
+  1; /* group15, SSE2 */
+#elif defined(BOOST_UNORDERED_LITTLE_ENDIAN_NEON)
+  2; /* group15, Neon */
+#else
+  3; /* group15, interleaved */
+#endif
+
+struct image_header
+{
+  char            magic[8];
+  boost::uint32_t version;
+  boost::uint32_t endianness_mark;
+  boost::uint32_t size_t_size;
+  boost::uint32_t group_layout;
+  boost::uint32_t group_size;
+  boost::uint32_t mixed_hash;
+  boost::uint64_t hash_size;
+  boost::uint64_t hash_type_id; /* digest of the name of the hasher type */
+  boost::uint64_t probe_hash;   /* hash of Key(), 0 if not constructible */
+  boost::uint64_t value_size;
+  boost::uint64_t value_alignment;
+  boost::uint64_t groups_size_index;
+  boost::uint64_t groups_size;
+  boost::uint64_t size;
+  boost::uint64_t capacity; /* 0 if saved from an unallocated table */
+  boost::uint64_t hash_offset;
+  boost::uint64_t hash_state_size; /* 0 if the hasher is not recorded */
+  boost::uint64_t groups_offset;
+  boost::uint64_t elements_offset;
+  boost::uint64_t image_size;
+};
+
+static inline const char* image_magic(){return "BUFMIMG";}
+
+static inline std::size_t image_align(std::size_t n,std::size_t alignment)
+{
+  return (n+alignment-1)/alignment*alignment;
+}
+
+#include <boost/unordered/detail/foa/ignore_wshadow.hpp>
+
+/* Read-only table over an image: lookup replicates that of table_core
+ * (minus stats), and iteration reuses table_iterator.
+ */
+
+template<typename TypePolicy,typename Hash,typename Pred>
+class image_table:empty_value<Hash,0>,empty_value<Pred,1>
+{
+  using core=table_core_impl<
+    TypePolicy,Hash,Pred,std::allocator<typename TypePolicy::value_type>>;
+  using group_type=typename core::group_type;
+  static constexpr auto N=core::N;
+  using size_policy=typename core::size_policy;
+  using prober=typename core::prober;
+  using mix_policy=typename core::mix_policy;
+  using element_type=typename core::element_type;
+  using hash_base=empty_value<Hash,0>;
+  using pred_base=empty_value<Pred,1>;
+
+  /* hasher state is recorded when it can be compared bytewise */
+  static constexpr bool records_hash_state=
+    std::is_trivially_copyable<Hash>::value&&!std::is_empty<Hash>::value;
+
+public:
+  using type_policy=TypePolicy;
+  using key_type=typename type_policy::key_type;
+  using value_type=typename type_policy::value_type;
+  using hasher=Hash;
+  using key_equal=Pred;
+  using const_iterator=table_iterator<type_policy,group_type*,true>;
+
+  image_table(
+    const void* data,std::size_t n,const Hash& h_=Hash(),
+    const Pred& pred_=Pred()):
+    hash_base{empty_init,h_},pred_base{empty_init,pred_}
+  {
+    auto base=static_cast<const unsigned char*>(data);
+    image_header hd;
+    if(!base||n<sizeof(hd)){
+      throw_invalid_argument("image is too small");
+    }
+    if(reinterpret_cast<uintptr_t>(base)%image_alignment!=0){
+      throw_invalid_argument("image is not properly aligned");
+    }
+    std::memcpy(&hd,base,sizeof(hd));
+    if(std::memcmp(hd.magic,image_magic(),sizeof(hd.magic))!=0||
+       hd.version!=image_version){
+      throw_invalid_argument("not an unordered_flat_map image");
+    }
+    if(hd.endianness_mark!=image_endianness_mark||
+       hd.size_t_size!=sizeof(std::size_t)||
+       hd.group_layout!=image_group_layout||
+       hd.group_size!=sizeof(group_type)){
+      throw_invalid_argument("image has an incompatible group layout");
+    }
+    if(hd.mixed_hash!=std::is_same<mix_policy,mulx_mix>::value||
+       hd.hash_size!=sizeof(Hash)||
+       hd.hash_type_id!=hash_type_id()||
+       hd.hash_state_size!=(records_hash_state?sizeof(Hash):0)){
+      throw_invalid_argument("image has an incompatible hash function");
+    }
+    if(hd.value_size!=sizeof(element_type)||
+       hd.value_alignment!=alignof(element_type)){
+      throw_invalid_argument("image has an incompatible value type");
+    }
+
+    /* bounds, guarding against overflow on corrupted headers */
+
+    if(hd.image_size>n||
+       hd.groups_size<size_policy::min_size()||
+       hd.groups_size>n||
+       hd.groups_size_index==0||
+       hd.groups_size_index!=size_policy::size_index(
+         static_cast<std::size_t>(hd.groups_size))||
+       hd.groups_size!=size_policy::size(
+         static_cast<std::size_t>(hd.groups_size_index))||
+       hd.groups_offset%image_alignment!=0||
+       hd.elements_offset%alignof(element_type)!=0||
+       hd.groups_offset>n||
+       hd.groups_size>(n-hd.groups_offset)/sizeof(group_type)||
+       hd.elements_offset>n||
+       hd.groups_size>(n-hd.elements_offset)/(N*sizeof(element_type))||
+       hd.hash_offset>n||
+       hd.hash_state_size>n-hd.hash_offset){
+      throw_invalid_argument("image is corrupted");
+    }
+    groups_size_index=static_cast<std::size_t>(hd.groups_size_index);
+    groups_size_mask=static_cast<std::size_t>(hd.groups_size-1);
+    size_=static_cast<std::size_t>(hd.size);
+    capacity_=static_cast<std::size_t>(hd.capacity);
+    groups_=reinterpret_cast<group_type*>(
+      const_cast<unsigned char*>(base+hd.groups_offset));
+    elements_=reinterpret_cast<element_type*>(
+      const_cast<unsigned char*>(base+hd.elements_offset));
+    if((capacity_!=0&&capacity_!=groups_size_mask*N+N-1)||
+       size_>capacity_||!groups_[groups_size_mask].is_sentinel(N-1)){
+      throw_invalid_argument("image is corrupted");
+    }
+
+    if((records_hash_state&&std::memcmp(
+         base+hd.hash_offset,std::addressof(h()),sizeof(Hash))!=0)||
+       hd.probe_hash!=probe_hash(h())){
+      throw_invalid_argument("image was saved with a different hash function");
+    }
+    if(!check_sample()){
+      throw_invalid_argument("image was saved with a different hash function");
+    }
+  }
+
+  template<typename Allocator>
+  static void save(
+    const table<TypePolicy,Hash,Pred,Allocator>& x,std::ostream& os)
+  {
+    const auto& arrays=x.arrays;
+    auto        groups_size=arrays.groups_size_mask+1;
+
+    image_header hd;
+    std::memset(&hd,0,sizeof(hd));
+    std::memcpy(hd.magic,image_magic(),sizeof(hd.magic));
+    hd.version=image_version;
+    hd.endianness_mark=image_endianness_mark;
+    hd.size_t_size=sizeof(std::size_t);
+    hd.group_layout=image_group_layout;
+    hd.group_size=sizeof(group_type);
+    hd.mixed_hash=std::is_same<mix_policy,mulx_mix>::value;
+    hd.hash_size=sizeof(Hash);
+    hd.hash_type_id=hash_type_id();
+    hd.probe_hash=probe_hash(x.hash_function());
+    hd.value_size=sizeof(element_type);
+    hd.value_alignment=alignof(element_type);
+    hd.groups_size_index=arrays.groups_size_index;
+    hd.groups_size=groups_size;
+    hd.size=x.size();
+    hd.capacity=x.capacity();
+    hd.hash_offset=sizeof(hd);
+    hd.hash_state_size=records_hash_state?sizeof(Hash):0;
+    hd.groups_offset=image_align(
+      static_cast<std::size_t>(hd.hash_offset+hd.hash_state_size),
+      image_alignment);
+    hd.elements_offset=image_align(
+      static_cast<std::size_t>(
+        hd.groups_offset+groups_size*sizeof(group_type)),
+      alignof(element_type));
+    hd.image_size=hd.elements_offset+groups_size*N*sizeof(element_type);
+
+    static constexpr char zeros[image_alignment]={};
+
+    os.write(reinterpret_cast<const char*>(&hd),sizeof(hd));
+    if(records_hash_state){
+      Hash h_=x.hash_function();
+      os.write(reinterpret_cast<const char*>(std::addressof(h_)),sizeof(Hash));
+    }
+    os.write(
+      zeros,
+      static_cast<std::streamsize>(
+        hd.groups_offset-hd.hash_offset-hd.hash_state_size));
+    if(arrays.elements()){
+      os.write(
+        reinterpret_cast<const char*>(arrays.groups()),
+        static_cast<std::streamsize>(groups_size*sizeof(group_type)));
+    }
+    else{
+      /* dummy groups have a sentinel each: write the layout of a freshly
+       * allocated array instead
+       */
+
+      group_type g;
+      for(std::size_t pos=0;pos<groups_size;++pos){
+        g.initialize();
+        if(pos==groups_size-1)g.set_sentinel();
+        os.write(reinterpret_cast<const char*>(&g),sizeof(group_type));
+      }
+    }
+    os.write(
+      zeros,
+      static_cast<std::streamsize>(
+        hd.elements_offset-hd.groups_offset-groups_size*sizeof(group_type)));
+
+    /* elements are written a group at a time, with unused slots zeroed out */
+
+    std::vector<unsigned char> buf(N*sizeof(element_type));
+    auto                       pg=arrays.groups(),last=pg+groups_size;
+    auto                       p=arrays.elements();
+    for(;pg!=last;++pg,p+=N){
+      std::memset(buf.data(),0,buf.size());
+      if(p){
+        auto mask=core::match_really_occupied(pg,last);
+        while(mask){
+          auto n=unchecked_countr_zero(mask);
+          std::memcpy(
+            buf.data()+n*sizeof(element_type),p+n,sizeof(element_type));
+          mask&=mask-1;
+        }
+      }
+      os.write(
+        reinterpret_cast<const char*>(buf.data()),
+        static_cast<std::streamsize>(buf.size()));
+    }
+  }
+
+  const_iterator begin()const noexcept
+  {
+    const_iterator it{groups_,0,elements_};
+    if(!(groups_[0].match_occupied()&0x1))++it;
+    return it;
+  }
+
+  const_iterator end()const noexcept{return {};}
+
+  bool        empty()const noexcept{return size_==0;}
+  std::size_t size()const noexcept{return size_;}
+  std::size_t capacity()const noexcept{return capacity_;}
+
+  float load_factor()const noexcept
+  {
+    if(capacity()==0)return 0;
+    else             return float(size())/float(capacity());
+  }
+
+  const Hash& hash_function()const noexcept{return h();}
+  const Pred& key_eq()const noexcept{return pred();}
+
+  template<typename Key>
+  BOOST_FORCEINLINE const_iterator find(const Key& x)const
+  {
+    auto hash=mix_policy::mix(h(),x);
+    return find(x,size_policy::position(hash,groups_size_index),hash);
+  }
+
+private:
+  const Hash& h()const{return hash_base::get();}
+  const Pred& pred()const{return pred_base::get();}
+
+#if defined(BOOST_MSVC)
+/* warning: forcing value to bool 'true' or 'false' in bool(pred()...) */
+#pragma warning(push)
+#pragma warning(disable:4800)
+#endif
+
+  template<typename Key>
+  BOOST_FORCEINLINE const_iterator find(
+    const Key& x,std::size_t pos0,std::size_t hash)const
+  {
+    prober pb(pos0);
+    do{
+      auto pos=pb.get();
+      auto pg=groups_+pos;
+      auto mask=pg->match(hash);
+      if(mask){
+        auto p=elements_+pos*N;
+        BOOST_UNORDERED_PREFETCH_ELEMENTS(p,N);
+        do{
+          auto n=unchecked_countr_zero(mask);
+          if(BOOST_LIKELY(bool(pred()(x,type_policy::extract(p[n]))))){
+            return {pg,n,p+n};
+          }
+          mask&=mask-1;
+        }while(mask);
+      }
+      if(BOOST_LIKELY(pg->is_not_overflowed(hash))){
+        return {};
+      }
+    }
+    while(BOOST_LIKELY(pb.next(groups_size_mask)));
+    return {};
+  }
+
+#if defined(BOOST_MSVC)
+#pragma warning(pop) /* C4800 */
+#endif
+
+  /* Identity of the hash function, so that images with no elements or whose
+   * sample happens to be found anyway are rejected as well: the type of the
+   * hasher, via a digest of its name (stable across runs of a given build),
+   * and the hash value of a fixed probe key, which detects same-type hashers
+   * in a different state that is not recorded bytewise.
+   */
+
+  static boost::uint64_t hash_type_id()
+  {
+    boost::uint64_t res=14695981039346656037ull; /* FNV-1a */
+    for(const char* p=BOOST_CORE_TYPEID(Hash).name();*p;++p){
+      res^=static_cast<unsigned char>(*p);
+      res*=1099511628211ull;
+    }
+    return res;
+  }
+
+  static boost::uint64_t probe_hash(const Hash& h_)
+  {
+    return probe_hash(
+      h_,std::integral_constant<bool,
+        std::is_default_constructible<key_type>::value>{});
+  }
+
+  static boost::uint64_t probe_hash(const Hash& h_,std::true_type)
+  {
+    return static_cast<boost::uint64_t>(h_(key_type()));
+  }
+
+  static boost::uint64_t probe_hash(const Hash&,std::false_type)
+  {
+    return 0;
+  }
+
+  /* Looks up a sample of elements spread across the image and checks they
+   * are found where they are: this catches hash functions that changed
+   * between saving and loading (other than by sizeof or recorded state).
+   */
+
+  bool check_sample()const
+  {
+    static constexpr std::size_t sample_size=16;
+
+    auto last=groups_+groups_size_mask+1;
+    auto step=(groups_size_mask+1)/sample_size;
+    if(step==0)step=1;
+    for(std::size_t pos=0;pos<=groups_size_mask;pos+=step){
+      auto mask=core::match_really_occupied(groups_+pos,last);
+      if(mask){
+        auto n=unchecked_countr_zero(mask);
+        auto p=elements_+pos*N+n;
+        if(find(type_policy::extract(*p))!=const_iterator{groups_+pos,n,p}){
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  std::size_t   groups_size_index;
+  std::size_t   groups_size_mask;
+  std::size_t   size_;
+  std::size_t   capacity_;
+  group_type*   groups_;
+  element_type* elements_;
+};
+
+#include <boost/unordered/detail/foa/restore_wshadow.hpp>
+
+} /* namespace foa */
+} /* namespace detail */
+} /* namespace unordered */
+} /* namespace boost */
+
+#endif
@@ -0,0 +1,631 @@
+/* Copyright 2024 Boost.Unordered contributors.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See https://www.boost.org/libs/unordered for library home page.
+ */
+
+#ifndef BOOST_UNORDERED_DETAIL_FOA_SMALL_TABLE_HPP
+#define BOOST_UNORDERED_DETAIL_FOA_SMALL_TABLE_HPP
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/unordered/detail/foa/table.hpp>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace boost{
+namespace unordered{
+namespace detail{
+namespace foa{
+
+/* Flat table with small buffer optimization: up to N-1 elements (a group's
+ * worth minus the sentinel slot) are stored in the table object itself, along
+ * with their metadata group, and no memory is allocated. When this inline
+ * capacity is exceeded, elements spill to a regular heap-allocated table.
+ *
+ * Inline lookup is a single SIMD match on the inline group, with no position
+ * calculation, probing or overflow bits involved. As the inline group and
+ * element slots are laid out as a one-group bucket array, iterators are those
+ * of table in both modes.
+ *
+ * The mode is implicit: the table is inline iff the heap table has no bucket
+ * array allocated, in which case it holds no elements. Conversely, inline
+ * storage is empty whenever a bucket array is allocated. Going back to inline
+ * mode happens only when the heap table releases its bucket array, i.e. on
+ * rehash(0) with no elements.
+ */
+
+#include <boost/unordered/detail/foa/ignore_wshadow.hpp>
+
+#if defined(BOOST_MSVC)
+#pragma warning(push)
+#pragma warning(disable:4714) /* marked as __forceinline not inlined */
+#endif
+
+template<typename TypePolicy,typename Hash,typename Pred,typename Allocator>
+class small_table
+{
+  using table_type=table<TypePolicy,Hash,Pred,Allocator>;
+  using super=typename table_type::super;
+  using type_policy=typename super::type_policy;
+  using group_type=typename super::group_type;
+  static constexpr std::size_t N=super::N;
+
+public:
+  using key_type=typename table_type::key_type;
+  using init_type=typename table_type::init_type;
+  using value_type=typename table_type::value_type;
+  using element_type=typename table_type::element_type;
+
+private:
+  static constexpr bool has_mutable_iterator=
+    !std::is_same<key_type,value_type>::value;
+
+  using transfer_by_move=
+    std::integral_constant< /* std::move_if_noexcept semantics */
+      bool,
+      std::is_nothrow_move_constructible<init_type>::value||
+      !std::is_same<element_type,value_type>::value||
+      !std::is_copy_constructible<element_type>::value>;
+
+public:
+  using hasher=typename table_type::hasher;
+  using key_equal=typename table_type::key_equal;
+  using allocator_type=typename table_type::allocator_type;
+  using pointer=typename table_type::pointer;
+  using const_pointer=typename table_type::const_pointer;
+  using reference=typename table_type::reference;
+  using const_reference=typename table_type::const_reference;
+  using size_type=typename table_type::size_type;
+  using difference_type=typename table_type::difference_type;
+  using const_iterator=typename table_type::const_iterator;
+  using iterator=typename table_type::iterator;
+  using erase_return_type=typename table_type::erase_return_type;
+
+  static constexpr std::size_t inline_capacity=N-1;
+
+  small_table(
+    std::size_t n=default_bucket_count,const Hash& h_=Hash(),
+    const Pred& pred_=Pred(),const Allocator& al_=Allocator()):
+    table_{n>inline_capacity?n:0,h_,pred_,al_}
+  {
+    initialize_inline();
+  }
+
+  small_table(const small_table& x):table_{x.table_}
+  {
+    initialize_inline();
+    copy_inline_from(x);
+  }
+
+  small_table(small_table&& x)
+    noexcept(
+      std::is_nothrow_move_constructible<table_type>::value&&
+      std::is_nothrow_move_constructible<init_type>::value):
+    table_{std::move(x.table_)}
+  {
+    initialize_inline();
+    move_inline_from(x);
+  }
+
+  small_table(const small_table& x,const Allocator& al_):table_{x.table_,al_}
+  {
+    initialize_inline();
+    copy_inline_from(x);
+  }
+
+  small_table(small_table&& x,const Allocator& al_):
+    table_{std::move(x.table_),al_}
+  {
+    initialize_inline();
+    move_inline_from(x);
+  }
+
+  ~small_table()noexcept
+  {
+    destroy_inline();
+  }
+
+  small_table& operator=(const small_table& x)
+  {
+    if(this!=std::addressof(x)){
+      clear();
+      table_=x.table_;
+      if(x.is_inline()){
+        table_.rehash(0);
+        copy_inline_from(x);
+      }
+    }
+    return *this;
+  }
+
+  small_table& operator=(small_table&& x)
+    noexcept(
+      noexcept(std::declval<table_type&>()=std::declval<table_type&&>())&&
+      std::is_nothrow_move_constructible<init_type>::value)
+  {
+    if(this!=std::addressof(x)){
+      clear();
+      if(x.is_inline()){
+        table_.rehash(0);
+        table_=std::move(x.table_);
+        move_inline_from(x);
+      }
+      else{
+        table_=std::move(x.table_);
+      }
+    }
+    return *this;
+  }
+
+  allocator_type get_allocator()const noexcept{return table_.get_allocator();}
+
+  iterator begin()noexcept
+  {
+    if(!is_inline())return table_.begin();
+
+    iterator it{group(),0,elements()};
+    if(!(group()->match_occupied()&0x1))++it;
+    return it;
+  }
+
+  const_iterator begin()const noexcept
+                   {return const_cast<small_table*>(this)->begin();}
+  iterator       end()noexcept{return {};}
+  const_iterator end()const noexcept{return const_cast<small_table*>(this)->end();}
+  const_iterator cbegin()const noexcept{return begin();}
+  const_iterator cend()const noexcept{return end();}
+
+  bool        empty()const noexcept{return size()==0;}
+  std::size_t size()const noexcept
+                {return is_inline()?inline_size:table_.size();}
+  std::size_t max_size()const noexcept{return table_.max_size();}
+
+  bool is_inline()const noexcept{return table_.capacity()==0;}
+
+  template<typename... Args>
+  BOOST_FORCEINLINE std::pair<iterator,bool> emplace(Args&&... args)
+  {
+    alloc_cted_insert_type<type_policy,Allocator,Args...> x(
+      table_.al(),std::forward<Args>(args)...);
+    return emplace_impl(type_policy::move(x.value()));
+  }
+
+  template <typename T>
+  BOOST_FORCEINLINE typename std::enable_if<
+    detail::is_similar_to_any<T, value_type, init_type>::value,
+    std::pair<iterator, bool> >::type
+  emplace(T&& x)
+  {
+    return emplace_impl(std::forward<T>(x));
+  }
+
+  template <typename K, typename V>
+  BOOST_FORCEINLINE
+    typename std::enable_if<is_emplace_kv_able<table_type, K>::value,
+      std::pair<iterator, bool> >::type
+    emplace(K&& k, V&& v)
+  {
+    alloc_cted_or_fwded_key_type<type_policy, Allocator, K&&> x(
+      table_.al(), std::forward<K>(k));
+    return emplace_impl(
+      try_emplace_args_t{}, x.move_or_fwd(), std::forward<V>(v));
+  }
+
+  template<typename Key,typename... Args>
+  BOOST_FORCEINLINE std::pair<iterator,bool> try_emplace(
+    Key&& x,Args&&... args)
+  {
+    return emplace_impl(
+      try_emplace_args_t{},std::forward<Key>(x),std::forward<Args>(args)...);
+  }
+
+  BOOST_FORCEINLINE std::pair<iterator,bool>
+  insert(const init_type& x){return emplace_impl(x);}
+
+  BOOST_FORCEINLINE std::pair<iterator,bool>
+  insert(init_type&& x){return emplace_impl(std::move(x));}
+
+  /* template<typename=void> tilts call ambiguities in favor of init_type */
+
+  template<typename=void>
+  BOOST_FORCEINLINE std::pair<iterator,bool>
+  insert(const value_type& x){return emplace_impl(x);}
+
+  template<typename=void>
+  BOOST_FORCEINLINE std::pair<iterator,bool>
+  insert(value_type&& x){return emplace_impl(std::move(x));}
+
+  template<typename T=element_type>
+  BOOST_FORCEINLINE
+  typename std::enable_if<
+    !std::is_same<T,value_type>::value,
+    std::pair<iterator,bool>
+  >::type
+  insert(element_type&& x){return emplace_impl(std::move(x));}
+
+  template<
+    bool dependent_value=false,
+    typename std::enable_if<
+      has_mutable_iterator||dependent_value>::type* =nullptr
+  >
+  erase_return_type erase(iterator pos)noexcept
+  {return erase(const_iterator(pos));}
+
+  BOOST_FORCEINLINE
+  erase_return_type erase(const_iterator pos)noexcept
+  {
+    if(is_inline())erase_inline(static_cast<std::size_t>(pos.p()-elements()));
+    else           table_.super::erase(pos.pc(),pos.p());
+    return {pos};
+  }
+
+  template<typename Key>
+  BOOST_FORCEINLINE
+  auto erase(Key&& x) -> typename std::enable_if<
+    !std::is_convertible<Key,iterator>::value&&
+    !std::is_convertible<Key,const_iterator>::value, std::size_t>::type
+  {
+    auto it=find(x);
+    if(it!=end()){
+      erase(it);
+      return 1;
+    }
+    else return 0;
+  }
+
+  /* Inline elements are moved around, so, unlike with table, iterators and
+   * references to them are invalidated.
+   */
+
+  void swap(small_table& x)
+  {
+    if(is_inline()||x.is_inline()){
+      small_table tmp{std::move(x)};
+      x=std::move(*this);
+      *this=std::move(tmp);
+    }
+    else{
+      table_.swap(x.table_);
+    }
+  }
+
+  void clear()noexcept
+  {
+    clear_inline();
+    table_.clear();
+  }
+
+  hasher   hash_function()const{return table_.hash_function();}
+  key_equal key_eq()const{return table_.key_eq();}
+
+  template<typename Key>
+  BOOST_FORCEINLINE iterator find(const Key& x)
+  {
+    if(!is_inline())return table_.find(x);
+    if(!inline_size)return end();
+    return find_inline(x,table_.hash_for(x));
+  }
+
+  template<typename Key>
+  BOOST_FORCEINLINE const_iterator find(const Key& x)const
+  {
+    return const_cast<small_table*>(this)->find(x);
+  }
+
+  std::size_t capacity()const noexcept
+  {
+    return is_inline()?inline_capacity:table_.capacity();
+  }
+
+  float load_factor()const noexcept
+  {
+    return float(size())/float(capacity());
+  }
+
+  float max_load_factor()const noexcept{return mlf;}
+
+  std::size_t max_load()const noexcept
+  {
+    return is_inline()?inline_capacity:table_.max_load();
+  }
+
+  void rehash(std::size_t n)
+  {
+    if(!is_inline())table_.rehash(n);
+    else if(n>inline_capacity)spill(n,[]{});
+  }
+
+  void reserve(std::size_t n)
+  {
+    if(!is_inline())table_.reserve(n);
+    else if(n>inline_capacity)spill(std::size_t(std::ceil(float(n)/mlf)),[]{});
+  }
+
+  template<typename Predicate>
+  friend std::size_t erase_if(small_table& x,Predicate& pr)
+  {
+    using value_reference=typename std::conditional<
+      std::is_same<key_type,value_type>::value,
+      const_reference,
+      reference
+    >::type;
+
+    if(!x.is_inline())return erase_if(x.table_,pr);
+
+    std::size_t s=x.inline_size;
+    for(auto mask=x.match_inline_occupied();mask;mask&=mask-1){
+      auto n=unchecked_countr_zero(mask);
+      if(pr(const_cast<value_reference>(
+        type_policy::value_from(x.elements()[n])))){
+        x.erase_inline(n);
+      }
+    }
+    return std::size_t(s-x.inline_size);
+  }
+
+  friend bool operator==(const small_table& x,const small_table& y)
+  {
+    if(x.size()!=y.size())return false;
+    for(const auto& v:x){
+      auto it=y.find(type_policy::extract(v));
+      if(it==y.end()||!bool(v==*it))return false;
+    }
+    return true;
+  }
+
+  friend bool operator!=(const small_table& x,const small_table& y)
+  {
+    return !(x==y);
+  }
+
+private:
+  struct inline_storage
+  {
+    group_type group;
+    alignas(element_type)
+    unsigned char elements[sizeof(element_type)*inline_capacity];
+  };
+
+  group_type*   group()noexcept{return &storage.group;}
+  const group_type* group()const noexcept{return &storage.group;}
+
+  element_type* elements()noexcept
+  {
+    return reinterpret_cast<element_type*>(storage.elements);
+  }
+
+  const element_type* elements()const noexcept
+  {
+    return reinterpret_cast<const element_type*>(storage.elements);
+  }
+
+  auto match_inline_occupied()const noexcept
+    ->decltype(std::declval<const group_type&>().match_occupied())
+  {
+    using mask_type=decltype(group()->match_occupied());
+
+    /* excluding the sentinel */
+    return group()->match_occupied()&~(mask_type(1)<<(N-1));
+  }
+
+  iterator make_inline_iterator(std::size_t n)noexcept
+  {
+    return {group(),n,elements()+n};
+  }
+
+  void initialize_inline()noexcept
+  {
+    group()->initialize();
+    group()->set_sentinel();
+    inline_size=0;
+  }
+
+  void destroy_inline()noexcept
+  {
+    for(auto mask=match_inline_occupied();mask;mask&=mask-1){
+      table_.destroy_element(elements()+unchecked_countr_zero(mask));
+    }
+  }
+
+  void clear_inline()noexcept
+  {
+    if(inline_size){
+      destroy_inline();
+      initialize_inline();
+    }
+  }
+
+  void erase_inline(std::size_t n)noexcept
+  {
+    table_.destroy_element(elements()+n);
+    group()->reset(n);
+    --inline_size;
+  }
+
+  /* x's inline elements are constructed in the same slots, so metadata is
+   * copied verbatim: hash functions are equivalent, as they've just been
+   * copied or moved over from x along with table_.
+   */
+
+  void copy_inline_from(const small_table& x)
+  {
+    if(!x.inline_size)return;
+    BOOST_ASSERT(is_inline()&&inline_size==0);
+    inline_from(x,[](const element_type& e)->const element_type&{return e;});
+  }
+
+  void move_inline_from(small_table& x)
+  {
+    if(!x.inline_size)return;
+    BOOST_ASSERT(is_inline()&&inline_size==0);
+    inline_from(x,[](element_type& e){return type_policy::move(e);});
+    x.clear_inline();
+  }
+
+  template<typename SmallTable,typename F>
+  void inline_from(SmallTable& x,F f)
+  {
+    using mask_type=decltype(group()->match_occupied());
+
+    auto      mask=x.match_inline_occupied();
+    mask_type constructed=0;
+    BOOST_TRY{
+      for(auto m=mask;m;m&=m-1){
+        auto n=unchecked_countr_zero(m);
+        table_.construct_element(elements()+n,f(x.elements()[n]));
+        constructed|=mask_type(1)<<n;
+      }
+    }
+    BOOST_CATCH(...){
+      for(;constructed;constructed&=constructed-1){
+        table_.destroy_element(elements()+unchecked_countr_zero(constructed));
+      }
+      BOOST_RETHROW
+    }
+    BOOST_CATCH_END
+    *group()=*x.group();
+    inline_size=x.inline_size;
+  }
+
+#if defined(BOOST_MSVC)
+/* warning: forcing value to bool 'true' or 'false' in bool(pred()...) */
+#pragma warning(push)
+#pragma warning(disable:4800)
+#endif
+
+  template<typename Key>
+  BOOST_FORCEINLINE iterator find_inline(const Key& x,std::size_t hash)
+  {
+    auto mask=group()->match(hash);
+    while(mask){
+      auto n=unchecked_countr_zero(mask);
+      if(BOOST_LIKELY(bool(table_.pred()(x,super::key_from(elements()[n]))))){
+        return make_inline_iterator(n);
+      }
+      mask&=mask-1;
+    }
+    return {};
+  }
+
+#if defined(BOOST_MSVC)
+#pragma warning(pop) /* C4800 */
+#endif
+
+  template<typename... Args>
+  BOOST_FORCEINLINE std::pair<iterator,bool> emplace_impl(Args&&... args)
+  {
+    if(!is_inline())return table_.emplace_impl(std::forward<Args>(args)...);
+
+    const auto &k=super::key_from(std::forward<Args>(args)...);
+    auto        hash=table_.hash_for(k);
+    auto        it=find_inline(k,hash);
+
+    if(it!=end()){
+      return {it,false};
+    }
+    if(BOOST_LIKELY(inline_size<inline_capacity)){
+      auto n=unchecked_countr_zero(group()->match_available());
+      table_.construct_element(elements()+n,std::forward<Args>(args)...);
+      group()->set(n,hash);
+      ++inline_size;
+      return {make_inline_iterator(n),true};
+    }
+    else{
+      return {spill_and_emplace(hash,std::forward<Args>(args)...),true};
+    }
+  }
+
+  template<typename... Args>
+  BOOST_NOINLINE iterator spill_and_emplace(std::size_t hash,Args&&... args)
+  {
+    iterator res;
+    spill(
+      std::size_t(std::ceil(float(inline_size+1)/mlf)),
+      [&,this]{
+        res=table_type::make_iterator(table_.unchecked_emplace_at(
+          table_.position_for(hash),hash,std::forward<Args>(args)...));
+      });
+    return res;
+  }
+
+  /* Moves inline elements to a heap bucket array for (at least) n slots,
+   * after calling f, which may insert an additional element. Hash values are
+   * calculated upfront, and f is called before inline elements are touched
+   * (as its arguments may refer to them), so that the operation has no effect
+   * if an exception is thrown, except when transferring elements by throwing
+   * move construction: elements already transferred are then kept and the
+   * rest destroyed, as table does on rehash.
+   */
+
+  template<typename F>
+  void spill(std::size_t n,F f)
+  {
+    std::size_t hashes[inline_capacity];
+    auto        mask=match_inline_occupied();
+    for(auto m=mask;m;m&=m-1){
+      auto i=unchecked_countr_zero(m);
+      hashes[i]=table_.hash_for(super::key_from(elements()[i]));
+    }
+
+    table_.rehash(n);
+    bool transferring=false;
+    BOOST_TRY{
+      f();
+      transferring=true;
+      for(auto m=mask;m;m&=m-1){
+        auto i=unchecked_countr_zero(m);
+        table_.unchecked_emplace_at(
+          table_.position_for(hashes[i]),hashes[i],
+          transfer(elements()[i],transfer_by_move{}));
+      }
+    }
+    BOOST_CATCH(...){
+      if(!transferring||!transfer_by_move::value){
+        table_.clear();
+        table_.rehash(0);
+      }
+      else{
+        clear_inline();
+      }
+      BOOST_RETHROW
+    }
+    BOOST_CATCH_END
+    clear_inline();
+  }
+
+  static auto transfer(element_type& x,std::true_type /* ->move */)
+    ->decltype(type_policy::move(x))
+  {
+    return type_policy::move(x);
+  }
+
+  static const element_type& transfer(
+    element_type& x,std::false_type /* ->copy */)
+  {
+    return x;
+  }
+
+  table_type     table_;
+  inline_storage storage;
+  std::size_t    inline_size;
+};
+
+#if defined(BOOST_MSVC)
+#pragma warning(pop) /* C4714 */
+#endif
+
+#include <boost/unordered/detail/foa/restore_wshadow.hpp>
+
+} /* namespace foa */
+} /* namespace detail */
+} /* namespace unordered */
+} /* namespace boost */
+
+#endif
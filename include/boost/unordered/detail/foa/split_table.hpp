@@ -0,0 +1,946 @@
+/* Copyright 2024 Boost.Unordered contributors.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See https://www.boost.org/libs/unordered for library home page.
+ */
+
+#ifndef BOOST_UNORDERED_DETAIL_FOA_SPLIT_TABLE_HPP
+#define BOOST_UNORDERED_DETAIL_FOA_SPLIT_TABLE_HPP
+
+#include <boost/assert.hpp>
+#include <boost/config.hpp>
+#include <boost/core/allocator_access.hpp>
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/core/pointer_traits.hpp>
+#include <boost/unordered/detail/foa/flat_map_types.hpp>
+#include <boost/unordered/detail/foa/flat_set_types.hpp>
+#include <boost/unordered/detail/foa/table.hpp>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace boost{
+namespace unordered{
+namespace detail{
+namespace foa{
+
+/* Flat map table with split key/mapped storage (structure of arrays): keys
+ * are held in the slot array of a regular table (with flat_set_types as its
+ * type policy), and mapped values in a parallel array with one entry per
+ * slot, so that the mapped value of the key at slot p is at
+ * mapped[p-elements]. Probing and key comparison only touch the (smaller)
+ * key slots, and mapped values are accessed on successful lookup only. This
+ * pays off for large mapped types or when std::pair<const Key,T> has
+ * padding.
+ *
+ * As there is no value_type object stored, iterators return proxy
+ * references std::pair<const Key&,T&>.
+ *
+ * The mapped array is allocated separately with capacity() entries, and is
+ * always rehashed along with the key table, so split_table implements
+ * insertion with growth and rehashing itself on top of the key table's
+ * building blocks.
+ */
+
+template<typename Reference>
+class split_pointer
+{
+public:
+  split_pointer(const Reference& r_):r{r_}{}
+
+  const Reference* operator->()const noexcept{return std::addressof(r);}
+
+private:
+  Reference r;
+};
+
+template<typename KeyIterator,typename T,bool Const>
+class split_iterator
+{
+  using key_type=typename KeyIterator::value_type;
+  using mapped_pointer=
+    typename std::conditional<Const,const T*,T*>::type;
+
+public:
+  using difference_type=std::ptrdiff_t;
+  using value_type=std::pair<const key_type,T>;
+  using reference=std::pair<
+    const key_type&,typename std::conditional<Const,const T&,T&>::type>;
+  using pointer=split_pointer<reference>;
+  using iterator_category=std::forward_iterator_tag;
+
+  split_iterator()=default;
+  template<bool Const2,typename std::enable_if<!Const2>::type* =nullptr>
+  split_iterator(const split_iterator<KeyIterator,T,Const2>& x):
+    it_{x.it_},keys_{x.keys_},mapped_{x.mapped_}{}
+  split_iterator(
+    const_iterator_cast_tag,const split_iterator<KeyIterator,T,true>& x):
+    it_{x.it_},keys_{x.keys_},mapped_{const_cast<T*>(x.mapped_)}{}
+
+  inline reference operator*()const noexcept
+  {
+    auto p=it_.p();
+    return {*p,mapped_[p-keys_]};
+  }
+
+  inline pointer operator->()const noexcept{return **this;}
+  inline split_iterator& operator++()noexcept{++it_;return *this;}
+  inline split_iterator operator++(int)noexcept
+    {auto x=*this;++it_;return x;}
+  friend inline bool operator==(
+    const split_iterator& x,const split_iterator& y)
+    {return x.it_==y.it_;}
+  friend inline bool operator!=(
+    const split_iterator& x,const split_iterator& y)
+    {return !(x==y);}
+
+private:
+  template<typename,typename,bool> friend class split_iterator;
+  template<typename> friend class split_erase_return_type;
+  template<typename,typename,typename,typename,typename>
+  friend class split_table;
+
+  split_iterator(
+    const KeyIterator& it,const key_type* keys,mapped_pointer mapped):
+    it_{it},keys_{keys},mapped_{mapped}{}
+
+  KeyIterator      it_;
+  const key_type  *keys_=nullptr;
+  mapped_pointer   mapped_=nullptr;
+};
+
+/* Returned by split_table::erase([const_]iterator) to avoid iterator
+ * increment if discarded.
+ */
+
+template<typename Iterator>
+class split_erase_return_type;
+
+template<typename KeyIterator,typename T,bool Const>
+class split_erase_return_type<split_iterator<KeyIterator,T,Const>>
+{
+  using iterator=split_iterator<KeyIterator,T,Const>;
+  using const_iterator=split_iterator<KeyIterator,T,true>;
+
+public:
+  /* can't delete it because VS in pre-C++17 mode needs to see it for RVO */
+  split_erase_return_type(const split_erase_return_type&);
+
+  operator iterator()const noexcept
+  {
+    auto it=pos;
+    it.it_.increment(); /* valid even if *it was erased */
+    return iterator(const_iterator_cast_tag{},it);
+  }
+
+  template<
+    bool dependent_value=false,
+    typename std::enable_if<!Const||dependent_value>::type* =nullptr
+  >
+  operator const_iterator()const noexcept{return this->operator iterator();}
+
+private:
+  template<typename,typename,typename,typename,typename>
+  friend class split_table;
+
+  split_erase_return_type(const_iterator pos_):pos{pos_}{}
+  split_erase_return_type& operator=(const split_erase_return_type&)=delete;
+
+  const_iterator pos;
+};
+
+#include <boost/unordered/detail/foa/ignore_wshadow.hpp>
+
+#if defined(BOOST_MSVC)
+#pragma warning(push)
+#pragma warning(disable:4714) /* marked as __forceinline not inlined */
+#endif
+
+/* std::move_if_noexcept semantics for keys and mapped values, as a class
+ * template so that Key and T need only be complete where rehashing is
+ * instantiated.
+ */
+
+template<typename Key,typename T>
+struct split_transfer_by_move:std::integral_constant<
+  bool,
+  (std::is_nothrow_move_constructible<Key>::value&&
+   std::is_nothrow_move_constructible<T>::value)||
+  !std::is_copy_constructible<Key>::value||
+  !std::is_copy_constructible<T>::value
+>{};
+
+template<
+  typename Key,typename T,typename Hash,typename Pred,typename Allocator
+>
+class split_table
+{
+  using map_types=flat_map_types<Key,T>;
+  using key_allocator_type=
+    typename boost::allocator_rebind<Allocator,Key>::type;
+  using mapped_allocator_type=
+    typename boost::allocator_rebind<Allocator,T>::type;
+  using mapped_pointer=
+    typename boost::allocator_pointer<mapped_allocator_type>::type;
+  using alloc_traits=boost::allocator_traits<key_allocator_type>;
+  using key_table_type=
+    table<flat_set_types<Key>,Hash,Pred,key_allocator_type>;
+  using super=typename key_table_type::super;
+  using group_type=typename super::group_type;
+  using arrays_type=typename super::arrays_type;
+  using locator=typename super::locator;
+  using prober=typename super::prober;
+  using element_type=typename super::element_type;
+  using key_iterator=typename key_table_type::const_iterator;
+  static constexpr std::size_t N=super::N;
+
+  using transfer_by_move=split_transfer_by_move<Key,T>;
+
+public:
+  using key_type=Key;
+  using mapped_type=T;
+  using init_type=typename map_types::init_type;
+  using value_type=typename map_types::value_type;
+  using hasher=Hash;
+  using key_equal=Pred;
+  using allocator_type=Allocator;
+  using reference=std::pair<const Key&,T&>;
+  using const_reference=std::pair<const Key&,const T&>;
+  using size_type=std::size_t;
+  using difference_type=std::ptrdiff_t;
+  using iterator=split_iterator<key_iterator,T,false>;
+  using const_iterator=split_iterator<key_iterator,T,true>;
+  using erase_return_type=split_erase_return_type<iterator>;
+
+  split_table(
+    std::size_t n=default_bucket_count,const Hash& h_=Hash(),
+    const Pred& pred_=Pred(),const Allocator& al_=Allocator()):
+    keys_{n,h_,pred_,key_allocator_type(al_)},
+    mapped_{allocate_mapped(keys_.capacity())}
+  {}
+
+  split_table(const split_table& x):
+    split_table{
+      x,
+      allocator_type(
+        alloc_traits::select_on_container_copy_construction(x.keys_.al()))}
+  {}
+
+  split_table(split_table&& x)
+    noexcept(std::is_nothrow_move_constructible<key_table_type>::value):
+    keys_{std::move(x.keys_)},mapped_{x.mapped_}
+  {
+    /* x.keys_ is left with no bucket array */
+    x.mapped_=nullptr;
+  }
+
+  /* the destructor takes care of cleanup if copying throws, as the object
+   * is constructed by the time the delegating constructor's body runs
+   */
+
+  split_table(const split_table& x,const Allocator& al_):
+    split_table{
+      std::size_t(std::ceil(float(x.size())/mlf)),
+      x.keys_.h(),x.keys_.pred(),al_}
+  {
+    x.for_all_elements([this](const element_type* p,const T& m){
+      unchecked_insert(*p,m);
+    });
+  }
+
+  split_table(split_table&& x,const Allocator& al_):
+    split_table{0,x.keys_.h(),x.keys_.pred(),al_}
+  {
+    if(keys_.al()==x.keys_.al()){
+      using std::swap;
+      swap(keys_.arrays,x.keys_.arrays);
+      swap(keys_.size_ctrl,x.keys_.size_ctrl);
+      swap(mapped_,x.mapped_);
+    }
+    else{
+      reserve(x.size());
+      move_elements_from(x);
+    }
+  }
+
+  ~split_table()noexcept
+  {
+    destroy_all_mapped();
+    deallocate_mapped(mapped_,keys_.capacity());
+  }
+
+  split_table& operator=(const split_table& x)
+  {
+    static constexpr auto pocca=
+      alloc_traits::propagate_on_container_copy_assignment::value;
+
+    if(this!=std::addressof(x)){
+      /* as in table_core, Hash and Pred are copied first so that the
+       * container is left intact if this throws
+       */
+      hasher    tmp_h=x.keys_.h();
+      key_equal tmp_p=x.keys_.pred();
+
+      clear();
+
+      using std::swap;
+      swap(keys_.h(),tmp_h);
+      swap(keys_.pred(),tmp_p);
+
+      if_constexpr<pocca>([&,this]{
+        if(keys_.al()!=x.keys_.al()){
+          auto ah=x.keys_.make_empty_arrays();
+          release_arrays();
+          copy_assign_if<pocca>(keys_.al(),x.keys_.al());
+          keys_.arrays=ah.release();
+          keys_.size_ctrl.ml=keys_.initial_max_load();
+        }
+        else copy_assign_if<pocca>(keys_.al(),x.keys_.al());
+      });
+      noshrink_reserve(x.size());
+      BOOST_TRY{
+        x.for_all_elements([this](const element_type* p,const T& m){
+          unchecked_insert(*p,m);
+        });
+      }
+      BOOST_CATCH(...){
+        clear();
+        BOOST_RETHROW
+      }
+      BOOST_CATCH_END
+    }
+    return *this;
+  }
+
+  split_table& operator=(split_table&& x)
+    noexcept(
+      (alloc_traits::propagate_on_container_move_assignment::value||
+      alloc_traits::is_always_equal::value)&&!super::uses_fancy_pointers)
+  {
+    static constexpr auto pocma=
+      alloc_traits::propagate_on_container_move_assignment::value;
+
+    if(this!=std::addressof(x)){
+      using std::swap;
+
+      clear();
+      swap(keys_.h(),x.keys_.h());
+      swap(keys_.pred(),x.keys_.pred());
+
+      if(pocma||keys_.al()==x.keys_.al()){
+        auto ah=x.keys_.make_empty_arrays();
+        release_arrays();
+        move_assign_if<pocma>(keys_.al(),x.keys_.al());
+        keys_.arrays=x.keys_.arrays;
+        keys_.size_ctrl.ml=std::size_t(x.keys_.size_ctrl.ml);
+        keys_.size_ctrl.size=std::size_t(x.keys_.size_ctrl.size);
+        mapped_=x.mapped_;
+        x.keys_.arrays=ah.release();
+        x.keys_.size_ctrl.ml=x.keys_.initial_max_load();
+        x.keys_.size_ctrl.size=0;
+        x.mapped_=nullptr;
+      }
+      else{
+        /* noshrink: favor memory reuse over tightness */
+        noshrink_reserve(x.size());
+        move_elements_from(x);
+      }
+    }
+    return *this;
+  }
+
+  allocator_type get_allocator()const noexcept
+  {
+    return allocator_type(keys_.get_allocator());
+  }
+
+  iterator begin()noexcept{return make_iterator(keys_.begin());}
+  const_iterator begin()const noexcept
+                   {return const_cast<split_table*>(this)->begin();}
+  iterator       end()noexcept{return {};}
+  const_iterator end()const noexcept{return {};}
+  const_iterator cbegin()const noexcept{return begin();}
+  const_iterator cend()const noexcept{return end();}
+
+  bool        empty()const noexcept{return keys_.empty();}
+  std::size_t size()const noexcept{return keys_.size();}
+  std::size_t max_size()const noexcept{return keys_.max_size();}
+
+  template<typename... Args>
+  BOOST_FORCEINLINE std::pair<iterator,bool> emplace(Args&&... args)
+  {
+    alloc_cted_insert_type<map_types,Allocator,Args...> x(
+      get_allocator(),std::forward<Args>(args)...);
+    auto&& v=map_types::move(x.value());
+    return emplace_impl(
+      std::forward<decltype(v.first)>(v.first),
+      std::forward<decltype(v.second)>(v.second));
+  }
+
+  template<typename K,typename... Args>
+  BOOST_FORCEINLINE std::pair<iterator,bool> try_emplace(
+    K&& k,Args&&... args)
+  {
+    return emplace_impl(std::forward<K>(k),std::forward<Args>(args)...);
+  }
+
+  BOOST_FORCEINLINE std::pair<iterator,bool>
+  insert(const init_type& x){return emplace_impl(x.first,x.second);}
+
+  BOOST_FORCEINLINE std::pair<iterator,bool>
+  insert(init_type&& x)
+    {return emplace_impl(std::move(x.first),std::move(x.second));}
+
+  /* template<typename=void> tilts call ambiguities in favor of init_type */
+
+  template<typename=void>
+  BOOST_FORCEINLINE std::pair<iterator,bool>
+  insert(const value_type& x){return emplace_impl(x.first,x.second);}
+
+  template<typename=void>
+  BOOST_FORCEINLINE std::pair<iterator,bool>
+  insert(value_type&& x)
+    {return emplace_impl(std::move(x.first),std::move(x.second));}
+
+  erase_return_type erase(iterator pos)noexcept
+  {return erase(const_iterator(pos));}
+
+  BOOST_FORCEINLINE
+  erase_return_type erase(const_iterator pos)noexcept
+  {
+    auto p=pos.it_.p();
+    destroy_mapped(keys_.arrays,mapped_array(),p);
+    keys_.super::erase(pos.it_.pc(),p);
+    return {pos};
+  }
+
+  template<typename K>
+  BOOST_FORCEINLINE
+  auto erase(K&& x) -> typename std::enable_if<
+    !std::is_convertible<K,iterator>::value&&
+    !std::is_convertible<K,const_iterator>::value, std::size_t>::type
+  {
+    auto it=find(x);
+    if(it!=end()){
+      erase(it);
+      return 1;
+    }
+    else return 0;
+  }
+
+  void swap(split_table& x)
+    noexcept(noexcept(std::declval<key_table_type&>().swap(
+      std::declval<key_table_type&>())))
+  {
+    using std::swap;
+    keys_.swap(x.keys_);
+    swap(mapped_,x.mapped_);
+  }
+
+  void clear()noexcept
+  {
+    destroy_all_mapped();
+    keys_.clear();
+  }
+
+  hasher    hash_function()const{return keys_.hash_function();}
+  key_equal key_eq()const{return keys_.key_eq();}
+
+  template<typename K>
+  BOOST_FORCEINLINE iterator find(const K& x)
+  {
+    auto hash=keys_.hash_for(x);
+    return make_iterator(find(x,keys_.position_for(hash),hash));
+  }
+
+  template<typename K>
+  BOOST_FORCEINLINE const_iterator find(const K& x)const
+  {
+    return const_cast<split_table*>(this)->find(x);
+  }
+
+  std::size_t capacity()const noexcept{return keys_.capacity();}
+  float       load_factor()const noexcept{return keys_.load_factor();}
+  float       max_load_factor()const noexcept{return mlf;}
+  std::size_t max_load()const noexcept{return keys_.max_load();}
+
+  void rehash(std::size_t n)
+  {
+    n=keys_.capacity_for_rehash(n);
+    if(n!=capacity())unchecked_rehash(n);
+  }
+
+  void reserve(std::size_t n)
+  {
+    rehash(std::size_t(std::ceil(float(n)/mlf)));
+  }
+
+  template<typename Predicate>
+  friend std::size_t erase_if(split_table& x,Predicate& pr)
+  {
+    return x.erase_if_impl(pr);
+  }
+
+  friend bool operator==(const split_table& x,const split_table& y)
+  {
+    return x.equal(y);
+  }
+
+  friend bool operator!=(const split_table& x,const split_table& y)
+  {
+    return !(x==y);
+  }
+
+private:
+  template<typename Predicate>
+  std::size_t erase_if_impl(Predicate& pr)
+  {
+    std::size_t s=size();
+    auto        mapped=mapped_array();
+    keys_.for_all_elements(
+      [&,this](group_type* pg,unsigned int n,element_type* p){
+        if(pr(reference{*p,mapped_at(keys_.arrays,mapped,p)})){
+          destroy_mapped(keys_.arrays,mapped,p);
+          keys_.super::erase(pg,n,p);
+        }
+      });
+    return std::size_t(s-size());
+  }
+
+  bool equal(const split_table& y)const
+  {
+    if(size()!=y.size())return false;
+    auto mapped=y.mapped_array();
+    return for_all_elements_while([&](const element_type* p,const T& m){
+      auto loc=y.keys_.super::find(*p);
+      return
+        loc&&
+        bool(*p==*loc.p)&&
+        bool(m==mapped_at(y.keys_.arrays,mapped,loc.p));
+    });
+  }
+
+  struct split_arrays
+  {
+    arrays_type    arrays;
+    mapped_pointer mapped;
+  };
+
+  static std::size_t capacity_of(const arrays_type& arrays_)noexcept
+  {
+    return arrays_.elements()?(arrays_.groups_size_mask+1)*N-1:0;
+  }
+
+  static T& mapped_at(const arrays_type& arrays_,T* mapped,const Key* p)
+  {
+    return mapped[p-arrays_.elements()];
+  }
+
+  T* mapped_array()const noexcept
+  {
+    return mapped_?boost::to_address(mapped_):nullptr;
+  }
+
+  static T* mapped_array(mapped_pointer mapped)noexcept
+  {
+    return mapped?boost::to_address(mapped):nullptr;
+  }
+
+  mapped_allocator_type mapped_al()const
+  {
+    return mapped_allocator_type(keys_.al());
+  }
+
+  mapped_pointer allocate_mapped(std::size_t n)
+  {
+    if(!n)return nullptr;
+    auto al=mapped_al();
+    return boost::allocator_allocate(al,n);
+  }
+
+  void deallocate_mapped(mapped_pointer mapped,std::size_t n)noexcept
+  {
+    if(mapped){
+      auto al=mapped_al();
+      boost::allocator_deallocate(al,mapped,n);
+    }
+  }
+
+  split_arrays new_split_arrays(arrays_type arrays_)
+  {
+    split_arrays res{arrays_,nullptr};
+    BOOST_TRY{
+      res.mapped=allocate_mapped(capacity_of(arrays_));
+    }
+    BOOST_CATCH(...){
+      keys_.delete_arrays(res.arrays);
+      BOOST_RETHROW
+    }
+    BOOST_CATCH_END
+    return res;
+  }
+
+  void delete_split_arrays(split_arrays& sa)noexcept
+  {
+    deallocate_mapped(sa.mapped,capacity_of(sa.arrays));
+    keys_.delete_arrays(sa.arrays);
+  }
+
+  /* precondition: empty() */
+
+  void release_arrays()noexcept
+  {
+    BOOST_ASSERT(empty());
+    deallocate_mapped(mapped_,keys_.capacity());
+    mapped_=nullptr;
+    keys_.delete_arrays(keys_.arrays);
+  }
+
+  void install_split_arrays(split_arrays& sa)noexcept
+  {
+    deallocate_mapped(mapped_,keys_.capacity());
+    keys_.delete_arrays(keys_.arrays);
+    keys_.arrays=sa.arrays;
+    mapped_=sa.mapped;
+    keys_.size_ctrl.ml=keys_.initial_max_load();
+  }
+
+  void noshrink_reserve(std::size_t n)
+  {
+    /* used only on assignment after element clearance */
+    BOOST_ASSERT(empty());
+
+    if(n){
+      n=std::size_t(std::ceil(float(n)/mlf)); /* elements -> slots */
+      n=super::capacity_for(n); /* exact resulting capacity */
+
+      if(n>capacity()){
+        auto sa=new_split_arrays(keys_.new_arrays(n));
+        install_split_arrays(sa);
+      }
+    }
+  }
+
+  iterator make_iterator(const key_iterator& it)const noexcept
+  {
+    return {it,keys_.arrays.elements(),mapped_array()};
+  }
+
+  iterator make_iterator(const locator& l)const noexcept
+  {
+    return make_iterator(key_table_type::make_iterator(l));
+  }
+
+  /* Same as table_core::find, except that the mapped slot of each candidate
+   * is prefetched before key comparison, so that on a hit the cache misses
+   * for the key and for the mapped value overlap rather than follow one
+   * another.
+   */
+
+  template<typename K>
+  BOOST_FORCEINLINE locator find(
+    const K& x,std::size_t pos0,std::size_t hash)const
+  {
+    prober pb(pos0);
+    do{
+      auto pos=pb.get();
+      auto pg=keys_.arrays.groups()+pos;
+      auto mask=pg->match(hash);
+      if(mask){
+        auto elements=keys_.arrays.elements();
+        BOOST_UNORDERED_ASSUME(elements!=nullptr);
+        auto p=elements+pos*N;
+        auto pm=mapped_array()+pos*N;
+        do{
+          auto n=unchecked_countr_zero(mask);
+          BOOST_UNORDERED_PREFETCH(pm+n);
+          if(BOOST_LIKELY(
+            super::hash_matches(keys_.arrays,p+n,hash)&&
+            bool(keys_.pred()(x,p[n])))){
+            return {pg,n,p+n};
+          }
+          mask&=mask-1;
+        }while(mask);
+      }
+      if(BOOST_LIKELY(pg->is_not_overflowed(hash)))return {};
+    }
+    while(BOOST_LIKELY(pb.next(keys_.arrays.groups_size_mask)));
+    return {};
+  }
+
+  /* f(p,m) for each key slot p and its mapped value m */
+
+  template<typename F>
+  void for_all_elements(F f)const
+  {
+    auto mapped=mapped_array();
+    keys_.for_all_elements([&,this](element_type* p){
+      f(p,mapped_at(keys_.arrays,mapped,p));
+    });
+  }
+
+  template<typename F>
+  bool for_all_elements_while(F f)const
+  {
+    auto mapped=mapped_array();
+    return keys_.for_all_elements_while([&,this](element_type* p){
+      return f(p,mapped_at(keys_.arrays,mapped,p));
+    });
+  }
+
+  template<typename... Args>
+  void construct_mapped(T* p,Args&&... args)
+  {
+    auto al=mapped_al();
+    boost::allocator_construct(al,p,std::forward<Args>(args)...);
+  }
+
+  void destroy_mapped(
+    const arrays_type& arrays_,T* mapped,const element_type* p)noexcept
+  {
+    auto al=mapped_al();
+    boost::allocator_destroy(al,std::addressof(mapped_at(arrays_,mapped,p)));
+  }
+
+  void destroy_element(
+    const arrays_type& arrays_,T* mapped,element_type* p)noexcept
+  {
+    destroy_mapped(arrays_,mapped,p);
+    keys_.destroy_element(p);
+  }
+
+  struct destroy_element_on_exit
+  {
+    ~destroy_element_on_exit(){this_->destroy_element(arrays_,mapped,p);}
+    split_table       *this_;
+    const arrays_type &arrays_;
+    T                 *mapped;
+    element_type      *p;
+  };
+
+  void destroy_all_mapped()noexcept
+  {
+    if(!std::is_trivially_destructible<T>::value){
+      auto mapped=mapped_array();
+      keys_.for_all_elements([&,this](element_type* p){
+        destroy_mapped(keys_.arrays,mapped,p);
+      });
+    }
+  }
+
+  void move_elements_from(split_table& x)
+  {
+    struct clear_on_exit
+    {
+      ~clear_on_exit(){x.clear();}
+      split_table& x;
+    } c{x};
+    (void)c; /* unused var warning */
+
+    auto mapped=x.mapped_array();
+    x.keys_.for_all_elements([&,this](element_type* p){
+      unchecked_insert(
+        std::move(*p),std::move(mapped_at(x.keys_.arrays,mapped,p)));
+    });
+  }
+
+  template<typename KeyArg,typename MappedArg>
+  void unchecked_insert(KeyArg&& k,MappedArg&& m)
+  {
+    auto hash=keys_.hash_for(k);
+    nosize_unchecked_emplace_at(
+      keys_.arrays,mapped_array(),keys_.position_for(hash),hash,
+      std::forward<KeyArg>(k),std::forward<MappedArg>(m));
+    ++keys_.size_ctrl.size;
+  }
+
+  template<typename KeyArg,typename... Args>
+  BOOST_FORCEINLINE std::pair<iterator,bool> emplace_impl(
+    KeyArg&& k,Args&&... args)
+  {
+    auto hash=keys_.hash_for(k);
+    auto pos0=keys_.position_for(hash);
+    auto loc=find(k,pos0,hash);
+
+    if(loc){
+      return {make_iterator(loc),false};
+    }
+    if(BOOST_LIKELY(keys_.size_ctrl.size<keys_.size_ctrl.ml)){
+      loc=nosize_unchecked_emplace_at(
+        keys_.arrays,mapped_array(),pos0,hash,
+        std::forward<KeyArg>(k),std::forward<Args>(args)...);
+      ++keys_.size_ctrl.size;
+      return {make_iterator(loc),true};
+    }
+    else{
+      return {
+        make_iterator(unchecked_emplace_with_rehash(
+          hash,std::forward<KeyArg>(k),std::forward<Args>(args)...)),
+        true
+      };
+    }
+  }
+
+  template<typename KeyArg,typename... Args>
+  BOOST_NOINLINE locator unchecked_emplace_with_rehash(
+    std::size_t hash,KeyArg&& k,Args&&... args)
+  {
+    if(keys_.rebuild_overflow_for_growth()){
+      auto loc=nosize_unchecked_emplace_at(
+        keys_.arrays,mapped_array(),keys_.position_for(hash),hash,
+        std::forward<KeyArg>(k),std::forward<Args>(args)...);
+      ++keys_.size_ctrl.size;
+      return loc;
+    }
+
+    auto    sa=new_split_arrays(keys_.new_arrays_for_growth());
+    locator it;
+    BOOST_TRY{
+      /* strong exception guarantee -> try insertion before rehash */
+      it=nosize_unchecked_emplace_at(
+        sa.arrays,mapped_array(sa.mapped),
+        super::position_for(hash,sa.arrays),hash,
+        std::forward<KeyArg>(k),std::forward<Args>(args)...);
+    }
+    BOOST_CATCH(...){
+      delete_split_arrays(sa);
+      BOOST_RETHROW
+    }
+    BOOST_CATCH_END
+
+    /* sa lifetime taken care of by unchecked_rehash */
+    unchecked_rehash(sa);
+    ++keys_.size_ctrl.size;
+    return it;
+  }
+
+  BOOST_NOINLINE void unchecked_rehash(std::size_t n)
+  {
+    auto sa=new_split_arrays(keys_.new_arrays(n));
+    unchecked_rehash(sa);
+  }
+
+  /* same as table_core::unchecked_rehash, with mapped values transferred
+   * along with their keys
+   */
+
+  BOOST_NOINLINE void unchecked_rehash(split_arrays& sa)
+  {
+    std::size_t num_destroyed=0;
+    BOOST_TRY{
+      keys_.for_all_elements([&,this](element_type* p){
+        transfer_element(p,sa,num_destroyed,transfer_by_move{});
+      });
+    }
+    BOOST_CATCH(...){
+      if(num_destroyed){
+        keys_.for_all_elements_while(
+          [&,this](group_type* pg,unsigned int n,element_type*){
+            keys_.recover_slot(pg,n);
+            return --num_destroyed!=0;
+          }
+        );
+      }
+      auto mapped=mapped_array(sa.mapped);
+      super::for_all_elements(sa.arrays,[&,this](element_type* p){
+        destroy_element(sa.arrays,mapped,p);
+      });
+      delete_split_arrays(sa);
+      BOOST_RETHROW
+    }
+    BOOST_CATCH_END
+
+    /* either all moved and destroyed or all copied */
+    BOOST_ASSERT(num_destroyed==size()||num_destroyed==0);
+    if(num_destroyed!=size()){
+      auto mapped=mapped_array();
+      keys_.for_all_elements([&,this](element_type* p){
+        destroy_element(keys_.arrays,mapped,p);
+      });
+    }
+    install_split_arrays(sa);
+  }
+
+  void transfer_element(
+    element_type* p,const split_arrays& sa,std::size_t& num_destroyed,
+    std::true_type /* ->move */)
+  {
+    auto hash=keys_.hash_of(keys_.arrays,p);
+    auto mapped=mapped_array();
+
+    /* Destroy p even if an an exception is thrown in the middle of move
+     * construction, which could leave the source half-moved.
+     */
+    ++num_destroyed;
+    destroy_element_on_exit d{this,keys_.arrays,mapped,p};
+    (void)d; /* unused var warning */
+    nosize_unchecked_emplace_at(
+      sa.arrays,mapped_array(sa.mapped),
+      super::position_for(hash,sa.arrays),hash,
+      std::move(*p),std::move(mapped_at(keys_.arrays,mapped,p)));
+  }
+
+  void transfer_element(
+    element_type* p,const split_arrays& sa,std::size_t& /*num_destroyed*/,
+    std::false_type /* ->copy */)
+  {
+    auto hash=keys_.hash_of(keys_.arrays,p);
+    nosize_unchecked_emplace_at(
+      sa.arrays,mapped_array(sa.mapped),
+      super::position_for(hash,sa.arrays),hash,
+      const_cast<const element_type&>(*p),
+      const_cast<const T&>(mapped_at(keys_.arrays,mapped_array(),p)));
+  }
+
+  template<typename KeyArg,typename... Args>
+  locator nosize_unchecked_emplace_at(
+    const arrays_type& arrays_,T* mapped,std::size_t pos0,std::size_t hash,
+    KeyArg&& k,Args&&... args)
+  {
+    for(prober pb(pos0);;pb.next(arrays_.groups_size_mask)){
+      auto pos=pb.get();
+      auto pg=arrays_.groups()+pos;
+      auto mask=pg->match_available();
+      if(BOOST_LIKELY(mask!=0)){
+        auto n=unchecked_countr_zero(mask);
+        auto p=arrays_.elements()+pos*N+n;
+        keys_.construct_element(p,std::forward<KeyArg>(k));
+        BOOST_TRY{
+          construct_mapped(
+            std::addressof(mapped_at(arrays_,mapped,p)),
+            std::forward<Args>(args)...);
+        }
+        BOOST_CATCH(...){
+          keys_.destroy_element(p);
+          BOOST_RETHROW
+        }
+        BOOST_CATCH_END
+        super::store_hash(arrays_,p,hash);
+        pg->set(n,hash);
+        return {pg,n,p};
+      }
+      else pg->mark_overflow(hash);
+    }
+  }
+
+  key_table_type keys_;
+  mapped_pointer mapped_;
+};
+
+#if defined(BOOST_MSVC)
+#pragma warning(pop) /* C4714 */
+#endif
+
+#include <boost/unordered/detail/foa/restore_wshadow.hpp>
+
+} /* namespace foa */
+} /* namespace detail */
+} /* namespace unordered */
+} /* namespace boost */
+
+#endif
@@ -0,0 +1,383 @@
+/* Copyright 2024 Boost.Unordered contributors.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See https://www.boost.org/libs/unordered for library home page.
+ */
+
+#ifndef BOOST_UNORDERED_DETAIL_FOA_STATIC_TABLE_HPP
+#define BOOST_UNORDERED_DETAIL_FOA_STATIC_TABLE_HPP
+
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/predef/other/endian.h>
+#include <boost/unordered/detail/foa/table.hpp>
+#include <boost/unordered/detail/throw_exception.hpp>
+#include <boost/unordered/hash_traits.hpp>
+#include <climits>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#if defined(BOOST_NO_CXX14_CONSTEXPR)
+#error "static tables require C++14 constexpr support"
+#endif
+
+namespace boost{
+namespace unordered{
+namespace detail{
+namespace foa{
+
+/* constexpr counterparts of mulx and mix_policy: results are the same as
+ * those of their runtime versions, which are still used for lookup as they
+ * may resort to intrinsics.
+ */
+
+constexpr boost::uint64_t static_mulx64(boost::uint64_t x,boost::uint64_t y)
+{
+  boost::uint64_t x1=(boost::uint32_t)x;
+  boost::uint64_t x2=x>>32;
+  boost::uint64_t y1=(boost::uint32_t)y;
+  boost::uint64_t y2=y>>32;
+  boost::uint64_t r3=x2*y2;
+  boost::uint64_t r2a=x1*y2;
+  r3+=r2a>>32;
+  boost::uint64_t r2b=x2*y1;
+  r3+=r2b>>32;
+  boost::uint64_t r1=x1*y1;
+  boost::uint64_t r2=(r1>>32)+(boost::uint32_t)r2a+(boost::uint32_t)r2b;
+  r1=(r2<<32)+(boost::uint32_t)r1;
+  r3+=r2>>32;
+  return r1^r3;
+}
+
+constexpr boost::uint32_t static_mulx32(boost::uint32_t x,boost::uint32_t y)
+{
+  boost::uint64_t r=(boost::uint64_t)x*y;
+  return (boost::uint32_t)r^(boost::uint32_t)(r>>32);
+}
+
+constexpr std::size_t static_mulx(std::size_t x)
+{
+  return sizeof(std::size_t)*CHAR_BIT>=64?
+    (std::size_t)static_mulx64((boost::uint64_t)x,0x9E3779B97F4A7C15ull):
+    (std::size_t)static_mulx32((boost::uint32_t)x,0xE817FB2Du);
+}
+
+template<typename Hash,typename Key>
+constexpr std::size_t static_mix(const Hash& h,const Key& x)
+{
+  return hash_is_avalanching<Hash>::value?h(x):static_mulx(h(x));
+}
+
+/* Metadata of a group15 as laid out in memory by the active implementation
+ * (see group15 in core.hpp), written at compile time and then used to
+ * construct the actual group15 objects.
+ */
+
+constexpr unsigned char static_reduced_hash(std::size_t hash)
+{
+  /* 0 and 1 are reserved for available slots and the sentinel */
+  return (unsigned char)((hash&0xFFu)<2?(hash&0xFFu)+8:hash&0xFFu);
+}
+
+#if defined(BOOST_UNORDERED_SSE2)||defined(BOOST_UNORDERED_LITTLE_ENDIAN_NEON)
+
+struct static_group_storage
+{
+  constexpr void set(std::size_t pos,unsigned char n){m[pos]=n;}
+
+  constexpr void mark_overflow(std::size_t hash)
+  {
+    m[15]=(unsigned char)(m[15]|(1u<<(hash%8)));
+  }
+
+  alignas(16) unsigned char m[16];
+};
+
+#else /* interleaved */
+
+struct static_group_storage
+{
+  constexpr void set(std::size_t pos,unsigned char n)
+  {
+    for(std::size_t k=0;k<4;++k){
+      if((n>>k)&1u)    m[0]|=boost::uint64_t(1)<<(pos+16*k);
+      if((n>>(k+4))&1u)m[1]|=boost::uint64_t(1)<<(pos+16*k);
+    }
+  }
+
+  constexpr void mark_overflow(std::size_t hash)
+  {
+    /* bit 15 of the (hash%8)-th 16-bit word */
+    std::size_t n=hash%8;
+#if BOOST_ENDIAN_BIG_BYTE
+    m[n/4]|=boost::uint64_t(0x8000u)<<(16*(3-n%4));
+#else
+    m[n/4]|=boost::uint64_t(0x8000u)<<(16*(n%4));
+#endif
+  }
+
+  alignas(16) boost::uint64_t m[2];
+};
+
+#endif
+
+constexpr std::size_t static_groups_size(std::size_t n)
+{
+  /* same bucket array as unordered_flat_map::reserve(n) would allocate */
+  std::size_t c=(n*8+6)/7; /* ceil(n/0.875) */
+  std::size_t g=c/15+1;    /* extra +1 for the sentinel */
+  std::size_t s=2;
+  while(s<g)s*=2;
+  return s;
+}
+
+constexpr std::size_t static_size_index(std::size_t groups_size)
+{
+  std::size_t n=0;
+  while((std::size_t(1)<<n)<groups_size)++n;
+  return sizeof(std::size_t)*CHAR_BIT-n;
+}
+
+/* not constexpr, so duplicate keys are a compile-time error when the table
+ * is constant-initialized
+ */
+
+inline void static_table_duplicate_key()
+{
+  throw_invalid_argument("duplicate key in static table");
+}
+
+template<typename Key,typename T>
+struct static_map_types
+{
+  using key_type=Key;
+  using mapped_type=T;
+  using value_type=std::pair<const Key,T>;
+  using element_type=value_type;
+
+  static constexpr const Key& extract(const value_type& x){return x.first;}
+  static const value_type& value_from(const element_type& x){return x;}
+};
+
+template<typename Key>
+struct static_set_types
+{
+  using key_type=Key;
+  using value_type=Key;
+  using element_type=value_type;
+
+  static constexpr const Key& extract(const value_type& x){return x;}
+  static const value_type& value_from(const element_type& x){return x;}
+};
+
+#include <boost/unordered/detail/foa/ignore_wshadow.hpp>
+
+/* Fixed-size, immutable table built at compile time from an array of Size
+ * elements. The bucket array is that of a table_core with the same elements
+ * (group15 metadata followed by element slots, value-initialized when empty),
+ * stored inline, so that a constexpr static_table is placed in read-only
+ * memory with no dynamic initialization. Lookup and iteration use the
+ * runtime machinery of table_core and image_table.
+ */
+
+template<typename TypePolicy,std::size_t Size,typename Hash,typename Pred>
+class static_table
+{
+  using group_type=group15<plain_integral>;
+  static constexpr std::size_t N=group_type::N;
+  using size_policy=pow2_size_policy;
+  using prober=pow2_quadratic_prober;
+  using mix_policy=typename std::conditional<
+    hash_is_avalanching<Hash>::value,
+    no_mix,
+    mulx_mix
+  >::type;
+
+public:
+  using type_policy=TypePolicy;
+  using key_type=typename type_policy::key_type;
+  using value_type=typename type_policy::value_type;
+  using element_type=typename type_policy::element_type;
+  using hasher=Hash;
+  using key_equal=Pred;
+  using const_iterator=table_iterator<type_policy,group_type*,true>;
+
+  static constexpr std::size_t groups_size=static_groups_size(Size);
+  static constexpr std::size_t groups_size_mask=groups_size-1;
+  static constexpr std::size_t groups_size_index=
+    static_size_index(groups_size);
+
+  constexpr static_table(
+    const value_type (&x)[Size],const Hash& h_,const Pred& pred_):
+    static_table(
+      x,make_layout(x,h_,pred_),h_,pred_,
+      std::make_index_sequence<groups_size>{},
+      std::make_index_sequence<groups_size*N>{})
+  {}
+
+  const_iterator begin()const noexcept
+  {
+    const_iterator it{groups(),0,elements_};
+    if(!(groups()[0].match_occupied()&0x1))++it;
+    return it;
+  }
+
+  const_iterator end()const noexcept{return {};}
+
+  static constexpr bool        empty()noexcept{return Size==0;}
+  static constexpr std::size_t size()noexcept{return Size;}
+  static constexpr std::size_t capacity()noexcept{return groups_size*N-1;}
+
+  static constexpr float load_factor()noexcept
+  {
+    return float(size())/float(capacity());
+  }
+
+  constexpr const Hash& hash_function()const noexcept{return h;}
+  constexpr const Pred& key_eq()const noexcept{return pred;}
+
+#if defined(BOOST_MSVC)
+/* warning: forcing value to bool 'true' or 'false' in bool(pred()...) */
+#pragma warning(push)
+#pragma warning(disable:4800)
+#endif
+
+  template<typename Key>
+  BOOST_FORCEINLINE const_iterator find(const Key& x)const
+  {
+    auto   hash=mix_policy::mix(h,x);
+    prober pb(size_policy::position(hash,groups_size_index));
+    do{
+      auto pos=pb.get();
+      auto pg=groups()+pos;
+      auto mask=pg->match(hash);
+      if(mask){
+        auto p=elements_+pos*N;
+        BOOST_UNORDERED_PREFETCH_ELEMENTS(p,N);
+        do{
+          auto n=unchecked_countr_zero(mask);
+          if(BOOST_LIKELY(bool(pred(x,type_policy::extract(p[n]))))){
+            return {pg,n,p+n};
+          }
+          mask&=mask-1;
+        }while(mask);
+      }
+      if(BOOST_LIKELY(pg->is_not_overflowed(hash))){
+        return {};
+      }
+    }
+    while(BOOST_LIKELY(pb.next(groups_size_mask)));
+    return {};
+  }
+
+#if defined(BOOST_MSVC)
+#pragma warning(pop) /* C4800 */
+#endif
+
+private:
+  struct group_array
+  {
+    group_type g[groups_size];
+  };
+
+  struct layout_type
+  {
+    static_group_storage groups[groups_size];
+    std::size_t   slots[groups_size*N]; /* element index+1, 0 if empty */
+    unsigned char hashes[groups_size*N];
+    unsigned char overflow[groups_size];
+  };
+
+  /* Insertion replicates that of table_core on a table with no erasures:
+   * duplicates are looked for first, then the element goes to the first
+   * available slot along the probe sequence, marking overflow on every full
+   * group visited.
+   */
+
+  static constexpr layout_type make_layout(
+    const value_type (&x)[Size],const Hash& h_,const Pred& pred_)
+  {
+    layout_type l{};
+    for(std::size_t i=0;i<Size;++i){
+      const auto&   k=type_policy::extract(x[i]);
+      std::size_t   hash=static_mix(h_,k);
+      unsigned char rh=static_reduced_hash(hash);
+      std::size_t   pos0=hash>>groups_size_index;
+      unsigned      ofw=1u<<(hash%8);
+
+      for(std::size_t pos=pos0,step=0;;){
+        for(std::size_t n=0;n<N;++n){
+          std::size_t s=l.slots[pos*N+n];
+          if(s&&l.hashes[pos*N+n]==rh&&
+             pred_(type_policy::extract(x[s-1]),k)){
+            static_table_duplicate_key();
+          }
+        }
+        if(!(l.overflow[pos]&ofw)||++step>groups_size_mask)break;
+        pos=(pos+step)&groups_size_mask;
+      }
+
+      for(std::size_t pos=pos0,step=0;;){
+        std::size_t n=0;
+        std::size_t last=pos==groups_size_mask?N-1:N; /* sentinel */
+        while(n<last&&l.slots[pos*N+n])++n;
+        if(n<last){
+          l.slots[pos*N+n]=i+1;
+          l.hashes[pos*N+n]=rh;
+          break;
+        }
+        l.overflow[pos]=(unsigned char)(l.overflow[pos]|ofw);
+        pos=(pos+(++step))&groups_size_mask;
+      }
+    }
+
+    for(std::size_t pos=0;pos<groups_size;++pos){
+      for(std::size_t n=0;n<N;++n){
+        if(l.slots[pos*N+n])l.groups[pos].set(n,l.hashes[pos*N+n]);
+      }
+      for(std::size_t b=0;b<8;++b){
+        if(l.overflow[pos]&(1u<<b))l.groups[pos].mark_overflow(b);
+      }
+    }
+    l.groups[groups_size_mask].set(N-1,1); /* sentinel */
+    return l;
+  }
+
+  static constexpr element_type make_element(
+    const value_type (&x)[Size],std::size_t s)
+  {
+    return s?element_type(x[s-1]):element_type();
+  }
+
+  template<std::size_t... Gs,std::size_t... Is>
+  constexpr static_table(
+    const value_type (&x)[Size],const layout_type& l,
+    const Hash& h_,const Pred& pred_,
+    std::index_sequence<Gs...>,std::index_sequence<Is...>):
+    groups_{{group_type(l.groups[Gs].m)...}},
+    elements_{make_element(x,l.slots[Is])...},
+    h(h_),pred(pred_)
+  {}
+
+  group_type* groups()const noexcept
+  {
+    return const_cast<group_type*>(groups_.g);
+  }
+
+  group_array  groups_;
+  element_type elements_[groups_size*N];
+  Hash         h;
+  Pred         pred;
+};
+
+#include <boost/unordered/detail/foa/restore_wshadow.hpp>
+
+} /* namespace foa */
+} /* namespace detail */
+} /* namespace unordered */
+} /* namespace boost */
+
+#endif
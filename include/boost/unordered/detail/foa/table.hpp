@@ -26,6 +26,21 @@
 #include <type_traits>
 #include <utility>
 
+/* Execution policy overloads are opt-in for non-concurrent containers, as
+ * <execution> may bring in additional link dependencies (e.g. TBB in
+ * libstdc++).
+ */
+
+#if defined(BOOST_UNORDERED_ENABLE_PARALLEL_ALGORITHMS)
+#include <boost/unordered/detail/execution_policy.hpp>
+#if defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
+#include <boost/unordered/detail/opt_storage.hpp>
+#include <functional>
+#include <new>
+#include <numeric>
+#endif
+#endif
+
 namespace boost{
 namespace unordered{
 namespace detail{
@@ -59,6 +74,9 @@ struct plain_size_control
 template<typename,typename,typename,typename>
 class table;
 
+template<typename,typename,typename>
+class image_table;
+
 /* table_iterator keeps two pointers:
  * 
  *   - A pointer p to the element slot.
@@ -134,6 +152,13 @@ private:
   template<typename,typename,bool> friend class table_iterator;
   template<typename> friend class table_erase_return_type;
   template<typename,typename,typename,typename> friend class table;
+  template<typename,typename,typename> friend class image_table;
+  template<typename,typename,typename,typename> friend class small_table;
+  template<typename,std::size_t,typename,typename> friend class static_table;
+  template<typename,typename,bool> friend class split_iterator;
+  template<typename> friend class split_erase_return_type;
+  template<typename,typename,typename,typename,typename>
+  friend class split_table;
 
   table_iterator(group_type* pg,std::size_t n,const table_element_type* ptet):
     pc_{to_pointer<char_pointer>(
@@ -168,7 +193,7 @@ private:
     }
 
     for(;;){
-      int mask=reinterpret_cast<group_type*>(pc())->match_occupied();
+      auto mask=reinterpret_cast<group_type*>(pc())->match_occupied();
       if(mask!=0){
         auto n=unchecked_countr_zero(mask);
         if(BOOST_UNLIKELY(reinterpret_cast<group_type*>(pc())->is_sentinel(n))){
@@ -269,6 +294,7 @@ public:
 
 private:
   template<typename,typename,typename,typename> friend class table;
+  template<typename,typename,typename,typename> friend class small_table;
 
   table_erase_return_type(const_iterator pos_):pos{pos_}{}
   table_erase_return_type& operator=(const table_erase_return_type&)=delete;
@@ -307,7 +333,7 @@ class concurrent_table; /* concurrent/non-concurrent interop */
 
 template <typename TypePolicy,typename Hash,typename Pred,typename Allocator>
 using table_core_impl=
-  table_core<TypePolicy,group15<plain_integral>,table_arrays,
+  table_core<TypePolicy,default_group<plain_integral>,table_arrays,
   plain_size_control,Hash,Pred,Allocator>;
 
 #include <boost/unordered/detail/foa/ignore_wshadow.hpp>
@@ -334,6 +360,10 @@ class table:table_core_impl<TypePolicy,Hash,Pred,Allocator>
     typename boost::allocator_pointer<Allocator>::type
   >::template rebind<group_type>;
   friend compatible_concurrent_table;
+  template<typename,typename,typename> friend class image_table;
+  template<typename,typename,typename,typename> friend class small_table;
+  template<typename,typename,typename,typename,typename>
+  friend class split_table;
 
 public:
   using key_type=typename super::key_type;
@@ -535,22 +565,269 @@ public:
     return const_cast<table*>(this)->find(x);
   }
 
+  /* Lookup, erasure and insertion with a hash value previously obtained
+   * from prehash (see boost::unordered::prehashed_key).
+   */
+
+  template<typename Key>
+  std::size_t prehash(const Key& x)const{return this->hash_for(x);}
+
+  using super::prefetch;
+
+  template<typename Key>
+  BOOST_FORCEINLINE iterator find_hashed(const Key& x,std::size_t hash)
+  {
+    return make_iterator(super::find(x,this->position_for(hash),hash));
+  }
+
+  template<typename Key>
+  BOOST_FORCEINLINE const_iterator find_hashed(
+    const Key& x,std::size_t hash)const
+  {
+    return const_cast<table*>(this)->find_hashed(x,hash);
+  }
+
+  template<typename Key>
+  BOOST_FORCEINLINE std::size_t erase_hashed(const Key& x,std::size_t hash)
+  {
+    auto it=find_hashed(x,hash);
+    if(it!=end()){
+      erase(it);
+      return 1;
+    }
+    else return 0;
+  }
+
+  template<typename Key,typename... Args>
+  BOOST_FORCEINLINE std::pair<iterator,bool> try_emplace_hashed(
+    std::size_t hash,Key&& x,Args&&... args)
+  {
+    return emplace_hashed_impl(
+      hash,try_emplace_args_t{},
+      std::forward<Key>(x),std::forward<Args>(args)...);
+  }
+
+  /* Bulk lookup: keys are processed in chunks of bulk_lookup_size, whose
+   * hashes are calculated and associated groups and elements prefetched
+   * before actual matching, so that memory latencies overlap.
+   */
+
+  static constexpr std::size_t bulk_lookup_size=16;
+
+  template<typename FwdIterator,typename OutputIterator>
+  BOOST_FORCEINLINE OutputIterator find(
+    FwdIterator first,FwdIterator last,OutputIterator out)
+  {
+    bulk_find(first,last,[&](const locator& l){*out++=make_iterator(l);});
+    return out;
+  }
+
+  template<typename FwdIterator,typename OutputIterator>
+  BOOST_FORCEINLINE OutputIterator find(
+    FwdIterator first,FwdIterator last,OutputIterator out)const
+  {
+    bulk_find(first,last,[&](const locator& l){
+      *out++=const_iterator(make_iterator(l));
+    });
+    return out;
+  }
+
+  template<typename FwdIterator,typename OutputIterator>
+  BOOST_FORCEINLINE OutputIterator contains(
+    FwdIterator first,FwdIterator last,OutputIterator out)const
+  {
+    bulk_find(first,last,[&](const locator& l){*out++=bool(l);});
+    return out;
+  }
+
+  template<typename FwdIterator,typename F>
+  BOOST_FORCEINLINE std::size_t visit(
+    FwdIterator first,FwdIterator last,F&& f)
+  {
+    std::size_t res=0;
+    bulk_find(first,last,[&](const locator& l){
+      if(l){
+        f(*make_iterator(l));
+        ++res;
+      }
+    });
+    return res;
+  }
+
+  template<typename FwdIterator,typename F>
+  BOOST_FORCEINLINE std::size_t visit(
+    FwdIterator first,FwdIterator last,F&& f)const
+  {
+    std::size_t res=0;
+    bulk_find(first,last,[&](const locator& l){
+      if(l){
+        f(*const_iterator(make_iterator(l)));
+        ++res;
+      }
+    });
+    return res;
+  }
+
+  /* Full traversal with prefetching (see
+   * table_core::prefetched_for_all_groups_while).
+   */
+
+  template<typename F>
+  std::size_t visit_all(F&& f)
+  {
+    return visit_all_impl<value_reference>(f);
+  }
+
+  template<typename F>
+  std::size_t visit_all(F&& f)const
+  {
+    return const_cast<table*>(this)->
+      template visit_all_impl<const_reference>(f);
+  }
+
+  template<typename F>
+  bool visit_while(F&& f)
+  {
+    return visit_while_impl<value_reference>(f);
+  }
+
+  template<typename F>
+  bool visit_while(F&& f)const
+  {
+    return const_cast<table*>(this)->
+      template visit_while_impl<const_reference>(f);
+  }
+
   using super::capacity;
   using super::load_factor;
   using super::max_load_factor;
   using super::max_load;
   using super::rehash;
   using super::reserve;
+  using super::rebuild_overflow;
+
+#if defined(BOOST_UNORDERED_ENABLE_PARALLEL_ALGORITHMS)&&\
+    defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
+  template<typename ExecutionPolicy>
+  void rehash(ExecutionPolicy&& policy,std::size_t n)
+  {
+    super::parallel_rehash(
+      [&](group_type* first,group_type* last,const auto& f)
+        {std::for_each(policy,first,last,f);},
+      n);
+  }
+
+  template<typename ExecutionPolicy>
+  void reserve(ExecutionPolicy&& policy,std::size_t n)
+  {
+    super::parallel_reserve(
+      [&](group_type* first,group_type* last,const auto& f)
+        {std::for_each(policy,first,last,f);},
+      n);
+  }
+
+  /* Parallel traversal: groups are distributed among the execution agents
+   * of policy. No locking is involved, as the table is assumed to be
+   * accessed by the calling thread only.
+   */
+
+  template<typename ExecutionPolicy,typename F>
+  void visit_all(ExecutionPolicy&& policy,F&& f)
+  {
+    parallel_visit_all_impl<value_reference>(policy,f);
+  }
+
+  template<typename ExecutionPolicy,typename F>
+  void visit_all(ExecutionPolicy&& policy,F&& f)const
+  {
+    const_cast<table*>(this)->
+      template parallel_visit_all_impl<const_reference>(policy,f);
+  }
+
+  template<typename ExecutionPolicy,typename F>
+  bool visit_while(ExecutionPolicy&& policy,F&& f)
+  {
+    return parallel_visit_while_impl<value_reference>(policy,f);
+  }
+
+  template<typename ExecutionPolicy,typename F>
+  bool visit_while(ExecutionPolicy&& policy,F&& f)const
+  {
+    return const_cast<table*>(this)->
+      template parallel_visit_while_impl<const_reference>(policy,f);
+  }
+
+  template<typename ExecutionPolicy,typename Predicate>
+  std::size_t erase_if(ExecutionPolicy&& policy,Predicate&& pr)
+  {
+    return super::parallel_erase_if(
+      [&](group_type* first,group_type* last,const auto& f)
+        {std::for_each(policy,first,last,f);},
+      [&](element_type* p){
+        return static_cast<bool>(
+          pr(const_cast<value_reference>(type_policy::value_from(*p))));
+      });
+  }
+
+  template<typename ExecutionPolicy,typename Predicate>
+  std::size_t count_if(ExecutionPolicy&& policy,Predicate&& pr)const
+  {
+    return parallel_transform_reduce_groups(
+      policy,std::size_t(0),std::plus<std::size_t>(),
+      [&](element_type* p,auto mask){
+        std::size_t res=0;
+        while(mask){
+          auto n=unchecked_countr_zero(mask);
+          res+=static_cast<bool>(
+            pr(const_cast<const_reference>(type_policy::value_from(p[n]))));
+          mask&=mask-1;
+        }
+        return res;
+      });
+  }
+
+  /* std::transform_reduce semantics: the result is init and f(v) for all
+   * elements v combined with op in unspecified order and grouping.
+   */
+
+  template<typename ExecutionPolicy,typename T,typename BinaryOp,typename F>
+  T transform_reduce(ExecutionPolicy&& policy,T init,BinaryOp op,F&& f)const
+  {
+    using partial=reduce_partial<T>;
+
+    auto res=parallel_transform_reduce_groups(
+      policy,partial{},
+      [&](partial x,partial y){
+        if(!x.has_value)return y;
+        if(!y.has_value)return x;
+        return partial(op(std::move(x.value()),std::move(y.value())));
+      },
+      [&](element_type* p,auto mask){
+        partial res;
+        while(mask){
+          auto  n=unchecked_countr_zero(mask);
+          auto& v=const_cast<const_reference>(type_policy::value_from(p[n]));
+          if(res.has_value)res=partial(op(std::move(res.value()),f(v)));
+          else             res=partial(T(f(v)));
+          mask&=mask-1;
+        }
+        return res;
+      });
+    if(res.has_value)return op(std::move(init),std::move(res.value()));
+    else             return init;
+  }
+#endif
+
+#if defined(BOOST_UNORDERED_ENABLE_STATS)
+  using stats=typename super::stats;
+
+  using super::get_stats;
+  using super::reset_stats;
+#endif
 
   template<typename Predicate>
   friend std::size_t erase_if(table& x,Predicate& pr)
   {
-    using value_reference=typename std::conditional<
-      std::is_same<key_type,value_type>::value,
-      const_reference,
-      reference
-    >::type;
-
     std::size_t s=x.size();
     x.for_all_elements(
       [&](group_type* pg,unsigned int n,element_type* p){
@@ -569,6 +846,147 @@ public:
   friend bool operator!=(const table& x,const table& y){return !(x==y);}
 
 private:
+  using value_reference=typename std::conditional<
+    std::is_same<key_type,value_type>::value,
+    const_reference,
+    reference
+  >::type;
+
+  template<typename Reference,typename F>
+  std::size_t visit_all_impl(F& f)
+  {
+    std::size_t res=0;
+    super::prefetched_for_all_elements_while(
+      this->arrays,[&](group_type*,unsigned int,element_type* p){
+        f(const_cast<Reference>(type_policy::value_from(*p)));
+        ++res;
+        return true;
+      });
+    return res;
+  }
+
+  template<typename Reference,typename F>
+  bool visit_while_impl(F& f)
+  {
+    return super::prefetched_for_all_elements_while(
+      this->arrays,[&](group_type*,unsigned int,element_type* p){
+        return static_cast<bool>(
+          f(const_cast<Reference>(type_policy::value_from(*p))));
+      });
+  }
+
+#if defined(BOOST_UNORDERED_ENABLE_PARALLEL_ALGORITHMS)&&\
+    defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
+  /* value folded over the elements of a group in transform_reduce: T need
+   * not be default constructible and empty groups produce no value
+   */
+
+  template<typename T>
+  struct reduce_partial
+  {
+    reduce_partial()noexcept{}
+    explicit reduce_partial(T&& x):has_value{true}
+      {::new (s.address()) T(std::move(x));}
+    reduce_partial(const reduce_partial& x):has_value{x.has_value}
+      {if(has_value)::new (s.address()) T(*x.s.address());}
+    reduce_partial(reduce_partial&& x):has_value{x.has_value}
+      {if(has_value)::new (s.address()) T(std::move(*x.s.address()));}
+    ~reduce_partial(){reset();}
+
+    reduce_partial& operator=(reduce_partial&& x)
+    {
+      if(this!=&x){
+        reset();
+        if(x.has_value){
+          ::new (s.address()) T(std::move(*x.s.address()));
+          has_value=true;
+        }
+      }
+      return *this;
+    }
+
+    reduce_partial& operator=(const reduce_partial& x)
+    {
+      if(this!=&x){
+        reset();
+        if(x.has_value){
+          ::new (s.address()) T(*x.s.address());
+          has_value=true;
+        }
+      }
+      return *this;
+    }
+
+    T& value()noexcept{return *s.address();}
+
+    void reset()noexcept
+    {
+      if(has_value){
+        s.address()->~T();
+        has_value=false;
+      }
+    }
+
+    bool           has_value=false;
+    opt_storage<T> s;
+  };
+
+  template<typename Reference,typename ExecutionPolicy,typename F>
+  void parallel_visit_all_impl(ExecutionPolicy& policy,F& f)
+  {
+    if(!this->arrays.elements())return;
+    auto first=this->arrays.groups(),
+         last=first+this->arrays.groups_size_mask+1;
+    std::for_each(policy,first,last,[&,this](group_type& g){
+      auto p=this->arrays.elements()+static_cast<std::size_t>(&g-first)*N;
+      auto mask=super::match_really_occupied(&g,last);
+      while(mask){
+        auto n=unchecked_countr_zero(mask);
+        f(const_cast<Reference>(type_policy::value_from(p[n])));
+        mask&=mask-1;
+      }
+    });
+  }
+
+  template<typename Reference,typename ExecutionPolicy,typename F>
+  bool parallel_visit_while_impl(ExecutionPolicy& policy,F& f)
+  {
+    if(!this->arrays.elements())return true;
+    auto first=this->arrays.groups(),
+         last=first+this->arrays.groups_size_mask+1;
+    return std::all_of(policy,first,last,[&,this](group_type& g){
+      auto p=this->arrays.elements()+static_cast<std::size_t>(&g-first)*N;
+      auto mask=super::match_really_occupied(&g,last);
+      while(mask){
+        auto n=unchecked_countr_zero(mask);
+        if(!f(const_cast<Reference>(type_policy::value_from(p[n])))){
+          return false;
+        }
+        mask&=mask-1;
+      }
+      return true;
+    });
+  }
+
+  /* f(p,mask) -> partial result for the occupied slots in mask of the group
+   * whose first element is at p
+   */
+
+  template<typename ExecutionPolicy,typename T,typename BinaryOp,typename F>
+  T parallel_transform_reduce_groups(
+    ExecutionPolicy& policy,T init,BinaryOp op,F f)const
+  {
+    if(!this->arrays.elements())return init;
+    auto first=this->arrays.groups(),
+         last=first+this->arrays.groups_size_mask+1;
+    return std::transform_reduce(
+      policy,first,last,std::move(init),op,[&,this](group_type& g){
+        auto p=this->arrays.elements()+static_cast<std::size_t>(&g-first)*N;
+        return f(p,super::match_really_occupied(&g,last));
+      });
+  }
+#endif
+
   template<typename ArraysType>
   table(compatible_concurrent_table&& x,arrays_holder<ArraysType,Allocator>&& ah):
     super{
@@ -588,7 +1006,31 @@ private:
 
   template<typename ExclusiveLockGuard>
   table(compatible_concurrent_table&& x,ExclusiveLockGuard):
-    table(std::move(x),x.make_empty_arrays())
+    table(
+      std::move(compatible_concurrent_table::settled(x)),
+      x.make_empty_arrays())
+  {}
+
+  /* Empty table with arrays of the given size index, to be filled group by
+   * group by compatible_concurrent_table::snapshot. n is the capacity of
+   * the source (arrays may not be allocated if zero).
+   */
+
+  table(
+    const Hash& h_,const Pred& pred_,const Allocator& al_,
+    std::size_t groups_size_index,std::size_t n,std::size_t ml):
+    super{
+      Hash(h_),Pred(pred_),Allocator(al_),
+      [&]{
+        using size_policy=typename super::size_policy;
+
+        arrays_type arrays_{
+          groups_size_index,size_policy::size(groups_size_index)-1,
+          nullptr,nullptr};
+        arrays_type::set_arrays(arrays_,al_,n,false);
+        return arrays_;
+      },
+      size_ctrl_type{ml,0}}
   {}
 
   struct erase_on_exit
@@ -608,11 +1050,119 @@ private:
     return {l.pg,l.n,l.p};
   }
 
+  template<typename FwdIterator,typename F>
+  BOOST_FORCEINLINE void bulk_find(
+    FwdIterator first,FwdIterator last,F f)const
+  {
+    auto n=static_cast<std::size_t>(std::distance(first,last));
+    while(n){
+      auto m=n<2*bulk_lookup_size?n:bulk_lookup_size;
+      bulk_find_chunk(first,m,f);
+      n-=m;
+      std::advance(
+        first,
+        static_cast<
+          typename std::iterator_traits<FwdIterator>::difference_type>(m));
+    }
+  }
+
+  template<typename FwdIterator,typename F>
+  BOOST_FORCEINLINE void bulk_find_chunk(
+    FwdIterator first,std::size_t m,F& f)const
+  {
+    BOOST_ASSERT(m<2*bulk_lookup_size);
+
+    using mask_type=decltype(std::declval<const group_type&>().match(0));
+
+    std::size_t hashes[2*bulk_lookup_size-1],
+                positions[2*bulk_lookup_size-1];
+    mask_type   masks[2*bulk_lookup_size-1];
+    auto        it=first;
+
+    for(std::size_t i=0;i<m;++i,++it){
+      auto hash=hashes[i]=this->hash_for(*it);
+      auto pos=positions[i]=this->position_for(hash);
+      BOOST_UNORDERED_PREFETCH(this->arrays.groups()+pos);
+    }
+
+    for(std::size_t i=0;i<m;++i){
+      auto pos=positions[i];
+      auto mask=masks[i]=(this->arrays.groups()+pos)->match(hashes[i]);
+      if(mask){
+        BOOST_UNORDERED_PREFETCH(
+          this->arrays.elements()+pos*N+unchecked_countr_zero(mask));
+      }
+    }
+
+    it=first;
+    for(std::size_t i=0;i<m;++i,++it){
+      f(bulk_find_key(*it,positions[i],hashes[i],masks[i]));
+    }
+  }
+
+#if defined(BOOST_MSVC)
+/* warning: forcing value to bool 'true' or 'false' in bool(pred()...) */
+#pragma warning(push)
+#pragma warning(disable:4800)
+#endif
+
+  /* same as super::find, except that the initial group match is provided */
+
+  template<typename Key,typename Mask>
+  BOOST_FORCEINLINE locator bulk_find_key(
+    const Key& x,std::size_t pos,std::size_t hash,Mask mask)const
+  {
+    BOOST_UNORDERED_STATS_COUNTER(num_cmps);
+    prober pb(pos);
+    auto   pg=this->arrays.groups()+pos;
+    for(;;){
+      if(mask){
+        auto p=this->arrays.elements()+pos*N;
+        do{
+          auto n=unchecked_countr_zero(mask);
+          BOOST_UNORDERED_INCREMENT_STATS_COUNTER(num_cmps);
+          if(BOOST_LIKELY(
+            this->hash_matches(this->arrays,p+n,hash)&&
+            bool(this->pred()(x,this->key_from(p[n]))))){
+            BOOST_UNORDERED_ADD_STATS(
+              this->cstats.successful_lookup,(pb.length(),num_cmps));
+            return {pg,n,p+n};
+          }
+          mask&=mask-1;
+        }while(mask);
+      }
+      if(BOOST_LIKELY(pg->is_not_overflowed(hash))||
+         BOOST_UNLIKELY(!pb.next(this->arrays.groups_size_mask))){
+        BOOST_UNORDERED_ADD_STATS(
+          this->cstats.unsuccessful_lookup,(pb.length(),num_cmps));
+        return {};
+      }
+      pos=pb.get();
+      pg=this->arrays.groups()+pos;
+      mask=pg->match(hash);
+      if(mask){
+        BOOST_UNORDERED_PREFETCH_ELEMENTS(this->arrays.elements()+pos*N,N);
+      }
+    }
+  }
+
+#if defined(BOOST_MSVC)
+#pragma warning(pop) /* C4800 */
+#endif
+
   template<typename... Args>
   BOOST_FORCEINLINE std::pair<iterator,bool> emplace_impl(Args&&... args)
+  {
+    return emplace_hashed_impl(
+      this->hash_for(this->key_from(std::forward<Args>(args)...)),
+      std::forward<Args>(args)...);
+  }
+
+  template<typename... Args>
+  BOOST_FORCEINLINE std::pair<iterator,bool> emplace_hashed_impl(
+    std::size_t hash,Args&&... args)
   {
     const auto &k=this->key_from(std::forward<Args>(args)...);
-    auto        hash=this->hash_for(k);
     auto        pos0=this->position_for(hash);
     auto        loc=super::find(k,pos0,hash);
 
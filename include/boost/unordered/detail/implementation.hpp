@@ -21,6 +21,7 @@
 #include <boost/unordered/detail/serialize_tracked_address.hpp>
 #include <boost/unordered/detail/static_assert.hpp>
 #include <boost/unordered/detail/type_traits.hpp>
+#include <boost/unordered/hash_traits.hpp>
 
 #include <boost/assert.hpp>
 #include <boost/core/allocator_traits.hpp>
@@ -1201,7 +1202,10 @@ namespace boost {
         typedef typename Types::value_allocator value_allocator;
         typedef typename boost::allocator_void_pointer<value_allocator>::type
           void_pointer;
-        typedef node<value_type, void_pointer> node_type;
+        typedef node<value_type, void_pointer,
+          boost::unordered::node_stores_hash<
+            typename std::remove_const<const_key_type>::type>::value>
+          node_type;
 
         typedef boost::unordered::detail::grouped_bucket_array<
           bucket<node_type, void_pointer>, value_allocator, prime_fmod_size<> >
@@ -1492,7 +1496,7 @@ namespace boost {
             std::size_t key_hash = this->hash(k);
 
             bucket_iterator itb = buckets_.at(buckets_.position(key_hash));
-            buckets_.insert_node(itb, b.release());
+            this->insert_node(itb, b.release(), key_hash);
             ++size_;
           }
         }
@@ -1685,8 +1689,75 @@ namespace boost {
           return this->hash_function()(k);
         }
 
+        // Stored hash values (see node_hash_base)
+
+        std::size_t node_hash(node_pointer p) const
+        {
+          return node_hash(
+            p, std::integral_constant<bool, node_type::stores_hash>());
+        }
+
+        std::size_t node_hash(node_pointer p, std::true_type) const
+        {
+          return p->get_hash();
+        }
+
+        std::size_t node_hash(node_pointer p, std::false_type) const
+        {
+          return this->hash(this->get_key(p));
+        }
+
+        static bool node_hash_matches(node_pointer p, std::size_t key_hash)
+        {
+          return node_hash_matches(
+            p, key_hash, std::integral_constant<bool, node_type::stores_hash>());
+        }
+
+        static bool node_hash_matches(
+          node_pointer p, std::size_t key_hash, std::true_type)
+        {
+          return p->get_hash() == key_hash;
+        }
+
+        static bool node_hash_matches(node_pointer, std::size_t, std::false_type)
+        {
+          return true;
+        }
+
+        void insert_node(
+          bucket_iterator itb, node_pointer p, std::size_t key_hash) noexcept
+        {
+          p->set_hash(key_hash);
+          buckets_.insert_node(itb, p);
+        }
+
+        void insert_node_hint(bucket_iterator itb, node_pointer p,
+          node_pointer hint, std::size_t key_hash) noexcept
+        {
+          p->set_hash(key_hash);
+          buckets_.insert_node_hint(itb, p, hint);
+        }
+
         // Find Node
 
+        template <class Key>
+        node_pointer find_node_impl(
+          Key const& x, bucket_iterator itb, std::size_t key_hash) const
+        {
+          node_pointer p = node_pointer();
+          if (itb != buckets_.end()) {
+            key_equal const& pred = this->key_eq();
+            p = itb->next;
+            for (; p; p = p->next) {
+              if (node_hash_matches(p, key_hash) &&
+                  pred(x, extractor::extract(p->value()))) {
+                break;
+              }
+            }
+          }
+          return p;
+        }
+
         template <class Key>
         node_pointer find_node_impl(Key const& x, bucket_iterator itb) const
         {
@@ -1706,7 +1777,8 @@ namespace boost {
         template <class Key> node_pointer find_node(Key const& k) const
         {
           std::size_t const key_hash = this->hash(k);
-          return find_node_impl(k, buckets_.at(buckets_.position(key_hash)));
+          return find_node_impl(
+            k, buckets_.at(buckets_.position(key_hash)), key_hash);
         }
 
         node_pointer find_node(const_key_type& k, bucket_iterator itb) const
@@ -1728,7 +1800,8 @@ namespace boost {
             std::size_t const key_hash = h(k);
             bucket_iterator itb = buckets_.at(buckets_.position(key_hash));
             for (node_pointer p = itb->next; p; p = p->next) {
-              if (BOOST_LIKELY(pred(k, extractor::extract(p->value())))) {
+              if (BOOST_LIKELY(node_hash_matches(p, key_hash) &&
+                               pred(k, extractor::extract(p->value())))) {
                 return iterator(p, itb);
               }
             }
@@ -1772,8 +1845,7 @@ namespace boost {
         void transfer_node(
           node_pointer p, bucket_type&, bucket_array_type& new_buckets)
         {
-          const_key_type& key = extractor::extract(p->value());
-          std::size_t const h = this->hash(key);
+          std::size_t const h = this->node_hash(p);
           bucket_iterator itnewb = new_buckets.at(new_buckets.position(h));
           new_buckets.insert_node(itnewb, p);
         }
@@ -1837,7 +1909,7 @@ namespace boost {
         {
           std::size_t key_hash = this->hash(k);
           bucket_iterator itb = buckets_.at(buckets_.position(key_hash));
-          node_pointer pos = this->find_node_impl(k, itb);
+          node_pointer pos = this->find_node_impl(k, itb, key_hash);
 
           if (pos) {
             return emplace_return(iterator(pos, itb), false);
@@ -1852,7 +1924,7 @@ namespace boost {
             }
 
             node_pointer p = b.release();
-            buckets_.insert_node(itb, p);
+            this->insert_node(itb, p, key_hash);
             ++size_;
 
             return emplace_return(iterator(p, itb), true);
@@ -1874,7 +1946,7 @@ namespace boost {
           std::size_t const key_hash = this->hash(k);
           bucket_iterator itb = buckets_.at(buckets_.position(key_hash));
 
-          node_pointer p = this->find_node_impl(k, itb);
+          node_pointer p = this->find_node_impl(k, itb, key_hash);
           if (p) {
             return iterator(p, itb);
           }
@@ -1885,7 +1957,7 @@ namespace boost {
           }
 
           p = b.release();
-          buckets_.insert_node(itb, p);
+          this->insert_node(itb, p, key_hash);
           ++size_;
           return iterator(p, itb);
         }
@@ -1901,7 +1973,7 @@ namespace boost {
           std::size_t key_hash = this->hash(k);
 
           bucket_iterator itb = buckets_.at(buckets_.position(key_hash));
-          node_pointer pos = this->find_node_impl(k, itb);
+          node_pointer pos = this->find_node_impl(k, itb, key_hash);
 
           if (pos) {
             return emplace_return(iterator(pos, itb), false);
@@ -1912,7 +1984,7 @@ namespace boost {
             }
 
             node_pointer p = b.release();
-            buckets_.insert_node(itb, p);
+            this->insert_node(itb, p, key_hash);
             ++size_;
 
             return emplace_return(iterator(p, itb), true);
@@ -1934,7 +2006,7 @@ namespace boost {
           std::size_t key_hash = this->hash(k);
           bucket_iterator itb = buckets_.at(buckets_.position(key_hash));
 
-          node_pointer pos = this->find_node_impl(k, itb);
+          node_pointer pos = this->find_node_impl(k, itb, key_hash);
 
           if (pos) {
             return emplace_return(iterator(pos, itb), false);
@@ -1953,7 +2025,7 @@ namespace boost {
             }
 
             node_pointer p = tmp.release();
-            buckets_.insert_node(itb, p);
+            this->insert_node(itb, p, key_hash);
 
             ++size_;
             return emplace_return(iterator(p, itb), true);
@@ -1976,7 +2048,7 @@ namespace boost {
           std::size_t key_hash = this->hash(k);
           bucket_iterator itb = buckets_.at(buckets_.position(key_hash));
 
-          node_pointer pos = this->find_node_impl(k, itb);
+          node_pointer pos = this->find_node_impl(k, itb, key_hash);
 
           if (pos) {
             return emplace_return(iterator(pos, itb), false);
@@ -1994,7 +2066,7 @@ namespace boost {
 
           pos = b.release();
 
-          buckets_.insert_node(itb, pos);
+          this->insert_node(itb, pos, key_hash);
           ++size_;
           return emplace_return(iterator(pos, itb), true);
         }
@@ -2016,7 +2088,7 @@ namespace boost {
           std::size_t key_hash = this->hash(k);
           bucket_iterator itb = buckets_.at(buckets_.position(key_hash));
 
-          node_pointer p = this->find_node_impl(k, itb);
+          node_pointer p = this->find_node_impl(k, itb, key_hash);
           if (p) {
             p->value().second = std::forward<M>(obj);
             return emplace_return(iterator(p, itb), false);
@@ -2034,7 +2106,7 @@ namespace boost {
 
           p = b.release();
 
-          buckets_.insert_node(itb, p);
+          this->insert_node(itb, p, key_hash);
           ++size_;
           return emplace_return(iterator(p, itb), true);
         }
@@ -2052,7 +2124,7 @@ namespace boost {
           const_key_type& k = this->get_key(np.ptr_);
           std::size_t const key_hash = this->hash(k);
           bucket_iterator itb = buckets_.at(buckets_.position(key_hash));
-          node_pointer p = this->find_node_impl(k, itb);
+          node_pointer p = this->find_node_impl(k, itb, key_hash);
 
           if (p) {
             iterator pos(p, itb);
@@ -2067,7 +2139,7 @@ namespace boost {
           p = np.ptr_;
           itb = buckets_.at(buckets_.position(key_hash));
 
-          buckets_.insert_node(itb, p);
+          this->insert_node(itb, p, key_hash);
           np.ptr_ = node_pointer();
           ++size_;
 
@@ -2090,7 +2162,7 @@ namespace boost {
 
           std::size_t const key_hash = this->hash(k);
           bucket_iterator itb = buckets_.at(buckets_.position(key_hash));
-          node_pointer p = this->find_node_impl(k, itb);
+          node_pointer p = this->find_node_impl(k, itb, key_hash);
           if (p) {
             return iterator(p, itb);
           }
@@ -2102,7 +2174,7 @@ namespace boost {
             itb = buckets_.at(buckets_.position(key_hash));
           }
 
-          buckets_.insert_node(itb, p);
+          this->insert_node(itb, p, key_hash);
           ++size_;
           np.ptr_ = node_pointer();
           return iterator(p, itb);
@@ -2129,7 +2201,7 @@ namespace boost {
 
             bucket_iterator itb = buckets_.at(buckets_.position(key_hash));
 
-            if (this->find_node_impl(key, itb)) {
+            if (this->find_node_impl(key, itb, key_hash)) {
               ++pos;
               continue;
             }
@@ -2138,7 +2210,7 @@ namespace boost {
             ++pos;
 
             node_pointer p = other.extract_by_iterator_unique(old);
-            buckets_.insert_node(itb, p);
+            this->insert_node(itb, p, key_hash);
             ++size_;
           }
         }
@@ -2163,7 +2235,7 @@ namespace boost {
             std::size_t const h = hf(key);
 
             bucket_iterator itb = buckets_.at(buckets_.position(h));
-            node_pointer it = find_node_impl(key, itb);
+            node_pointer it = find_node_impl(key, itb, h);
             if (it) {
               continue;
             }
@@ -2174,7 +2246,7 @@ namespace boost {
             }
 
             node_pointer nptr = tmp.release();
-            buckets_.insert_node(itb, nptr);
+            this->insert_node(itb, nptr, h);
             ++size_;
           }
         }
@@ -2288,7 +2360,7 @@ namespace boost {
             node_allocator_type alloc = this->node_alloc();
             node_tmp tmp(detail::func::construct_node(alloc, value), alloc);
 
-            buckets_.insert_node(itb, tmp.release());
+            this->insert_node(itb, tmp.release(), key_hash);
             ++size_;
           }
         }
@@ -2311,7 +2383,7 @@ namespace boost {
             node_tmp tmp(
               detail::func::construct_node(alloc, std::move(value)), alloc);
 
-            buckets_.insert_node(itb, tmp.release());
+            this->insert_node(itb, tmp.release(), key_hash);
             ++size_;
           }
         }
@@ -2422,14 +2494,14 @@ namespace boost {
           const_key_type& k = this->get_key(a.node_);
           std::size_t key_hash = this->hash(k);
           bucket_iterator itb = buckets_.at(buckets_.position(key_hash));
-          node_pointer hint = this->find_node_impl(k, itb);
+          node_pointer hint = this->find_node_impl(k, itb, key_hash);
 
           if (size_ + 1 > max_load_) {
             this->reserve(size_ + 1);
             itb = buckets_.at(buckets_.position(key_hash));
           }
           node_pointer p = a.release();
-          buckets_.insert_node_hint(itb, p, hint);
+          this->insert_node_hint(itb, p, hint, key_hash);
           ++size_;
           return iterator(p, itb);
         }
@@ -2449,9 +2521,9 @@ namespace boost {
           if (!usable_hint) {
             key_hash = this->hash(k);
             itb = buckets_.at(buckets_.position(key_hash));
-            p = this->find_node_impl(k, itb);
-          } else if (usable_hint && needs_rehash) {
-            key_hash = this->hash(k);
+            p = this->find_node_impl(k, itb, key_hash);
+          } else if (needs_rehash || node_type::stores_hash) {
+            key_hash = this->node_hash(p);
           }
 
           if (needs_rehash) {
@@ -2460,7 +2532,7 @@ namespace boost {
           }
 
           a.release();
-          buckets_.insert_node_hint(itb, n, p);
+          this->insert_node_hint(itb, n, p, key_hash);
           ++size_;
           return iterator(n, itb);
         }
@@ -2472,9 +2544,9 @@ namespace boost {
           const_key_type& k = this->get_key(a.node_);
           std::size_t key_hash = this->hash(k);
           bucket_iterator itb = buckets_.at(buckets_.position(key_hash));
-          node_pointer hint = this->find_node_impl(k, itb);
+          node_pointer hint = this->find_node_impl(k, itb, key_hash);
           node_pointer p = a.release();
-          buckets_.insert_node_hint(itb, p, hint);
+          this->insert_node_hint(itb, p, hint, key_hash);
           ++size_;
         }
 
@@ -2491,8 +2563,8 @@ namespace boost {
 
             bucket_iterator itb = buckets_.at(buckets_.position(key_hash));
 
-            node_pointer hint = this->find_node_impl(k, itb);
-            buckets_.insert_node_hint(itb, np.ptr_, hint);
+            node_pointer hint = this->find_node_impl(k, itb, key_hash);
+            this->insert_node_hint(itb, np.ptr_, hint, key_hash);
             ++size_;
 
             result = iterator(np.ptr_, itb);
@@ -2520,9 +2592,9 @@ namespace boost {
             if (hint.p && this->key_eq()(k, this->get_key(hint.p))) {
             } else {
               itb = buckets_.at(buckets_.position(key_hash));
-              pos = this->find_node_impl(k, itb);
+              pos = this->find_node_impl(k, itb, key_hash);
             }
-            buckets_.insert_node_hint(itb, np.ptr_, pos);
+            this->insert_node_hint(itb, np.ptr_, pos, key_hash);
             ++size_;
             result = iterator(np.ptr_, itb);
 
@@ -2633,8 +2705,8 @@ namespace boost {
             bucket_iterator itb = buckets_.at(buckets_.position(key_hash));
             node_allocator_type alloc = this->node_alloc();
             node_tmp tmp(detail::func::construct_node(alloc, value), alloc);
-            node_pointer hint = this->find_node_impl(key, itb);
-            buckets_.insert_node_hint(itb, tmp.release(), hint);
+            node_pointer hint = this->find_node_impl(key, itb, key_hash);
+            this->insert_node_hint(itb, tmp.release(), hint, key_hash);
             ++size_;
           }
         }
@@ -2654,11 +2726,11 @@ namespace boost {
 
             bucket_iterator itb = buckets_.at(buckets_.position(key_hash));
 
-            node_pointer hint = this->find_node_impl(key, itb);
+            node_pointer hint = this->find_node_impl(key, itb, key_hash);
             node_tmp tmp(
               detail::func::construct_node(alloc, std::move(value)), alloc);
 
-            buckets_.insert_node_hint(itb, tmp.release(), hint);
+            this->insert_node_hint(itb, tmp.release(), hint, key_hash);
             ++size_;
           }
         }
@@ -35,7 +35,8 @@ namespace boost {
           void_pointer;
 
         typedef boost::unordered::node_handle_map<
-          node<value_type, void_pointer>, K, M, A>
+          node<value_type, void_pointer,
+            boost::unordered::node_stores_hash<K>::value>, K, M, A>
           node_type;
 
         typedef typename table::iterator iterator;
@@ -32,7 +32,8 @@ namespace boost {
           void_pointer;
 
         typedef boost::unordered::node_handle_set<
-          node<value_type, void_pointer>, T, A>
+          node<value_type, void_pointer,
+            boost::unordered::node_stores_hash<T>::value>, T, A>
           node_type;
 
         typedef typename table::c_iterator iterator;
@@ -23,6 +23,18 @@ namespace boost {
         boost::throw_exception(std::out_of_range(message));
       }
 
+      BOOST_NOINLINE BOOST_NORETURN inline void throw_invalid_argument(
+        char const* message)
+      {
+        boost::throw_exception(std::invalid_argument(message));
+      }
+
+      BOOST_NOINLINE BOOST_NORETURN inline void throw_length_error(
+        char const* message)
+      {
+        boost::throw_exception(std::length_error(message));
+      }
+
     } // namespace detail
   } // namespace unordered
 } // namespace boost
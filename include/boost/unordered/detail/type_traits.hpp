@@ -35,6 +35,8 @@
 
 namespace boost {
   namespace unordered {
+    template <class Key, class Hash> class prehashed_key;
+
     namespace detail {
 
       template <class T> struct type_identity
@@ -143,10 +145,25 @@ namespace boost {
       {
       };
 
-      template <class, class Hash, class KeyEqual> struct are_transparent
+      template <class T> struct is_prehashed_key : std::false_type
+      {
+      };
+
+      template <class Key, class Hash>
+      struct is_prehashed_key<boost::unordered::prehashed_key<Key, Hash> >
+          : std::true_type
+      {
+      };
+
+      // prehashed_key handles have overloads of their own and are never
+      // taken as heterogeneous keys
+
+      template <class Key, class Hash, class KeyEqual> struct are_transparent
       {
         static bool const value =
-          is_transparent<Hash>::value && is_transparent<KeyEqual>::value;
+          is_transparent<Hash>::value && is_transparent<KeyEqual>::value &&
+          !is_prehashed_key<typename std::remove_cv<
+            typename std::remove_reference<Key>::type>::type>::value;
       };
 
       template <class Key, class UnorderedMap> struct transparent_non_iterable
@@ -179,6 +196,19 @@ namespace boost {
       {
       };
 
+      template <class Iterator, class = void>
+      struct is_forward_iterator : std::false_type
+      {
+      };
+
+      template <class Iterator>
+      struct is_forward_iterator<Iterator,
+        void_t<typename std::iterator_traits<Iterator>::iterator_category> >
+          : std::is_base_of<std::forward_iterator_tag,
+              typename std::iterator_traits<Iterator>::iterator_category>
+      {
+      };
+
 #if BOOST_UNORDERED_TEMPLATE_DEDUCTION_GUIDES
       // https://eel.is/c++draft/container.requirements#container.alloc.reqmts-34
       // https://eel.is/c++draft/container.requirements#unord.req.general-243
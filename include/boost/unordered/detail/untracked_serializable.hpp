@@ -0,0 +1,50 @@
+/* Copyright 2024 Boost.Unordered contributors.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See https://www.boost.org/libs/unordered for library home page.
+ */
+
+#ifndef BOOST_UNORDERED_DETAIL_UNTRACKED_SERIALIZABLE_HPP
+#define BOOST_UNORDERED_DETAIL_UNTRACKED_SERIALIZABLE_HPP
+
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace boost{
+namespace unordered{
+namespace detail{
+
+/* Types with primitive implementation level in Boost.Serialization, which
+ * are never tracked and have default construction as load_construct_data.
+ * Objects of such types can be loaded into a temporary buffer and moved
+ * elsewhere without the archive being notified via reset_object_address.
+ * The list is conservative and detected without depending on
+ * Boost.Serialization.
+ */
+
+template<typename T>
+struct is_untracked_serializable:std::integral_constant<
+  bool,
+  std::is_arithmetic<T>::value||std::is_enum<T>::value
+>{};
+
+template<>
+struct is_untracked_serializable<std::string>:std::true_type{};
+
+template<>
+struct is_untracked_serializable<std::wstring>:std::true_type{};
+
+template<typename T,typename U>
+struct is_untracked_serializable<std::pair<T,U> >:std::integral_constant<
+  bool,
+  is_untracked_serializable<T>::value&&is_untracked_serializable<U>::value
+>{};
+
+} /* namespace detail */
+} /* namespace unordered */
+} /* namespace boost */
+
+#endif
@@ -0,0 +1,253 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_FROZEN_FLAT_MAP_HPP_INCLUDED
+#define BOOST_UNORDERED_FROZEN_FLAT_MAP_HPP_INCLUDED
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/unordered/detail/foa/flat_map_types.hpp>
+#include <boost/unordered/detail/foa/frozen_table.hpp>
+#include <boost/unordered/detail/throw_exception.hpp>
+#include <boost/unordered/detail/type_traits.hpp>
+#include <boost/unordered/unordered_flat_map.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace boost {
+  namespace unordered {
+
+    template <class Key, class T, class Hash = boost::hash<Key>,
+      class KeyEqual = std::equal_to<Key>,
+      class Allocator = std::allocator<std::pair<const Key, T> > >
+    class frozen_flat_map
+    {
+      using map_types = detail::foa::flat_map_types<Key, T>;
+
+      using table_type =
+        detail::foa::frozen_table<map_types, Hash, KeyEqual, Allocator>;
+
+      table_type table_;
+
+    public:
+      using key_type = Key;
+      using mapped_type = T;
+      using value_type = typename map_types::value_type;
+      using size_type = std::size_t;
+      using difference_type = std::ptrdiff_t;
+      using hasher = typename boost::unordered::detail::type_identity<Hash>::type;
+      using key_equal = typename boost::unordered::detail::type_identity<KeyEqual>::type;
+      using allocator_type = typename boost::unordered::detail::type_identity<Allocator>::type;
+      using reference = value_type const&;
+      using const_reference = value_type const&;
+      using pointer = value_type const*;
+      using const_pointer = value_type const*;
+      using iterator = typename table_type::const_iterator;
+      using const_iterator = typename table_type::const_iterator;
+      using unordered_flat_map_type =
+        unordered_flat_map<Key, T, Hash, KeyEqual, Allocator>;
+
+      frozen_flat_map()
+          : frozen_flat_map(hasher(), key_equal(), allocator_type())
+      {
+      }
+
+      explicit frozen_flat_map(hasher const& h,
+        key_equal const& pred = key_equal(),
+        allocator_type const& a = allocator_type())
+          : table_(h, pred, a)
+      {
+      }
+
+      explicit frozen_flat_map(unordered_flat_map_type const& m)
+          : table_(m.begin(), m.end(),
+              [](allocator_type& al, value_type* p, value_type const& v) {
+                map_types::construct(al, p, v);
+              },
+              m.hash_function(), m.key_eq(), m.get_allocator())
+      {
+      }
+
+      // elements of m are moved from and m is left empty
+
+      explicit frozen_flat_map(unordered_flat_map_type&& m)
+          : table_(m.begin(), m.end(),
+              [](allocator_type& al, value_type* p, value_type& v) {
+                map_types::construct(al, p, map_types::move(v));
+              },
+              m.hash_function(), m.key_eq(), m.get_allocator())
+      {
+        m.clear();
+      }
+
+      frozen_flat_map(frozen_flat_map const& other) = default;
+
+      frozen_flat_map(frozen_flat_map const& other, allocator_type const& a)
+          : table_(other.table_, a)
+      {
+      }
+
+      frozen_flat_map(frozen_flat_map&&) = default;
+
+      ~frozen_flat_map() = default;
+
+      frozen_flat_map& operator=(frozen_flat_map const& other) = default;
+
+      frozen_flat_map& operator=(frozen_flat_map&& other) noexcept(
+        noexcept(std::declval<table_type&>() = std::declval<table_type&&>()))
+      {
+        table_ = std::move(other.table_);
+        return *this;
+      }
+
+      allocator_type get_allocator() const noexcept
+      {
+        return table_.get_allocator();
+      }
+
+      /// Iterators
+      ///
+
+      const_iterator begin() const noexcept { return table_.begin(); }
+      const_iterator end() const noexcept { return table_.end(); }
+      const_iterator cbegin() const noexcept { return table_.begin(); }
+      const_iterator cend() const noexcept { return table_.end(); }
+
+      /// Capacity
+      ///
+
+      BOOST_ATTRIBUTE_NODISCARD bool empty() const noexcept
+      {
+        return table_.empty();
+      }
+
+      size_type size() const noexcept { return table_.size(); }
+
+      /// Modifiers
+      ///
+
+      void swap(frozen_flat_map& rhs) noexcept(
+        noexcept(std::declval<table_type&>().swap(std::declval<table_type&>())))
+      {
+        table_.swap(rhs.table_);
+      }
+
+      /// Lookup
+      ///
+
+      mapped_type const& at(key_type const& key) const
+      {
+        auto pos = table_.find(key);
+        if (pos != table_.end()) {
+          return pos->second;
+        }
+        boost::unordered::detail::throw_out_of_range(
+          "key was not found in frozen_flat_map");
+      }
+
+      template <class K>
+      typename std::enable_if<
+        boost::unordered::detail::are_transparent<K, hasher, key_equal>::value,
+        mapped_type const&>::type
+      at(K const& key) const
+      {
+        auto pos = table_.find(key);
+        if (pos != table_.end()) {
+          return pos->second;
+        }
+        boost::unordered::detail::throw_out_of_range(
+          "key was not found in frozen_flat_map");
+      }
+
+      BOOST_FORCEINLINE size_type count(key_type const& key) const
+      {
+        auto pos = table_.find(key);
+        return pos != table_.end() ? 1 : 0;
+      }
+
+      template <class K>
+      BOOST_FORCEINLINE typename std::enable_if<
+        detail::are_transparent<K, hasher, key_equal>::value, size_type>::type
+      count(K const& key) const
+      {
+        auto pos = table_.find(key);
+        return pos != table_.end() ? 1 : 0;
+      }
+
+      BOOST_FORCEINLINE const_iterator find(key_type const& key) const
+      {
+        return table_.find(key);
+      }
+
+      template <class K>
+      BOOST_FORCEINLINE typename std::enable_if<
+        boost::unordered::detail::are_transparent<K, hasher, key_equal>::value,
+        const_iterator>::type
+      find(K const& key) const
+      {
+        return table_.find(key);
+      }
+
+      BOOST_FORCEINLINE bool contains(key_type const& key) const
+      {
+        return this->find(key) != this->end();
+      }
+
+      template <class K>
+      BOOST_FORCEINLINE typename std::enable_if<
+        boost::unordered::detail::are_transparent<K, hasher, key_equal>::value,
+        bool>::type
+      contains(K const& key) const
+      {
+        return this->find(key) != this->end();
+      }
+
+      /// Hash Policy
+      ///
+
+      float load_factor() const noexcept { return table_.load_factor(); }
+
+      /// Observers
+      ///
+
+      hasher hash_function() const { return table_.hash_function(); }
+
+      key_equal key_eq() const { return table_.key_eq(); }
+    };
+
+    template <class Key, class T, class Hash, class KeyEqual, class Allocator>
+    void swap(frozen_flat_map<Key, T, Hash, KeyEqual, Allocator>& lhs,
+      frozen_flat_map<Key, T, Hash, KeyEqual, Allocator>& rhs)
+      noexcept(noexcept(lhs.swap(rhs)))
+    {
+      lhs.swap(rhs);
+    }
+
+    template <class Key, class T, class Hash, class KeyEqual, class Allocator>
+    frozen_flat_map<Key, T, Hash, KeyEqual, Allocator> freeze(
+      unordered_flat_map<Key, T, Hash, KeyEqual, Allocator> const& m)
+    {
+      return frozen_flat_map<Key, T, Hash, KeyEqual, Allocator>(m);
+    }
+
+    template <class Key, class T, class Hash, class KeyEqual, class Allocator>
+    frozen_flat_map<Key, T, Hash, KeyEqual, Allocator> freeze(
+      unordered_flat_map<Key, T, Hash, KeyEqual, Allocator>&& m)
+    {
+      return frozen_flat_map<Key, T, Hash, KeyEqual, Allocator>(std::move(m));
+    }
+  } // namespace unordered
+
+  using boost::unordered::freeze;
+  using boost::unordered::frozen_flat_map;
+} // namespace boost
+
+#endif
@@ -26,6 +26,22 @@ struct hash_is_avalanching_impl<Hash,
   boost::unordered::detail::void_t<typename Hash::is_avalanching> >:
     std::true_type{};
 
+template<typename Hash,typename=void>
+struct hash_is_expensive_impl: std::false_type{};
+
+template<typename Hash>
+struct hash_is_expensive_impl<Hash,
+  boost::unordered::detail::void_t<typename Hash::is_expensive> >:
+    std::true_type{};
+
+template<typename Hash,typename=void>
+struct hash_prefers_compact_growth_impl: std::false_type{};
+
+template<typename Hash>
+struct hash_prefers_compact_growth_impl<Hash,
+  boost::unordered::detail::void_t<typename Hash::prefers_compact_growth> >:
+    std::true_type{};
+
 } /* namespace detail */
 
 /* Each trait can be partially specialized by users for concrete hash functions
@@ -38,6 +54,28 @@ struct hash_is_avalanching_impl<Hash,
 template<typename Hash>
 struct hash_is_avalanching: detail::hash_is_avalanching_impl<Hash>::type{};
 
+/* hash_is_expensive<Hash>::value is true when the type Hash::is_expensive
+ * is present, false otherwise.
+ */
+template<typename Hash>
+struct hash_is_expensive: detail::hash_is_expensive_impl<Hash>::type{};
+
+/* node_stores_hash<Key>::value is false unless specialized by the user.
+ * Closed-addressing containers with keys of type Key store the hash value
+ * of each element in its node when this trait is true. Unlike the traits
+ * above, this depends on the key rather than on the hash function, as node
+ * handles can be moved between containers with different hash functions.
+ */
+template<typename Key>
+struct node_stores_hash: std::false_type{};
+
+/* hash_prefers_compact_growth<Hash>::value is true when the type
+ * Hash::prefers_compact_growth is present, false otherwise.
+ */
+template<typename Hash>
+struct hash_prefers_compact_growth:
+  detail::hash_prefers_compact_growth_impl<Hash>::type{};
+
 } /* namespace unordered */
 } /* namespace boost */
 
@@ -0,0 +1,74 @@
+/* Key handles with a precomputed hash value.
+ *
+ * Copyright 2024 Boost.Unordered contributors.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See https://www.boost.org/libs/unordered for library home page.
+ */
+
+#ifndef BOOST_UNORDERED_PREHASHED_KEY_HPP
+#define BOOST_UNORDERED_PREHASHED_KEY_HPP
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/unordered/detail/type_traits.hpp>
+#include <cstddef>
+
+namespace boost{
+namespace unordered{
+
+namespace detail{
+struct prehashed_key_access;
+}
+
+/* Reference to a key plus its hash value as calculated by the prehash
+ * member function of an open-addressing container with hash function of
+ * type Hash. Only containers can create handles, so that lookup and
+ * insertion overloads accepting prehashed_key<K,Hash> can use the hash
+ * value as is. The value is independent of the container's capacity, and
+ * so the handle remains usable after rehashing and with any container
+ * whose hash function is of type Hash and equivalent to that of the
+ * container the handle was obtained from.
+ */
+
+template<typename Key,typename Hash>
+class prehashed_key
+{
+public:
+  using key_type=Key;
+  using hasher=Hash;
+
+  const key_type& key()const noexcept{return *px;}
+  std::size_t     hash()const noexcept{return h;}
+
+private:
+  friend struct detail::prehashed_key_access;
+
+  prehashed_key(const key_type& x,std::size_t h_)noexcept:px(&x),h(h_){}
+
+  const key_type* px;
+  std::size_t     h;
+};
+
+namespace detail{
+
+struct prehashed_key_access
+{
+  template<typename Hash,typename Key>
+  static prehashed_key<Key,Hash> make(const Key& x,std::size_t hash)noexcept
+  {
+    return prehashed_key<Key,Hash>(x,hash);
+  }
+};
+
+} /* namespace detail */
+
+} /* namespace unordered */
+} /* namespace boost */
+
+#endif
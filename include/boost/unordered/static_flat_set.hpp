@@ -0,0 +1,160 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_STATIC_FLAT_SET_HPP_INCLUDED
+#define BOOST_UNORDERED_STATIC_FLAT_SET_HPP_INCLUDED
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/unordered/detail/foa/static_table.hpp>
+#include <boost/unordered/detail/type_traits.hpp>
+#include <boost/unordered/static_hash.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+namespace boost {
+  namespace unordered {
+
+    template <class Key, std::size_t N,
+      class Hash = boost::unordered::static_hash<Key>,
+      class KeyEqual = std::equal_to<Key> >
+    class static_flat_set
+    {
+      using set_types = detail::foa::static_set_types<Key>;
+
+      using table_type =
+        detail::foa::static_table<set_types, N, Hash, KeyEqual>;
+
+      table_type table_;
+
+    public:
+      using key_type = Key;
+      using value_type = Key;
+      using size_type = std::size_t;
+      using difference_type = std::ptrdiff_t;
+      using hasher = typename boost::unordered::detail::type_identity<Hash>::type;
+      using key_equal = typename boost::unordered::detail::type_identity<KeyEqual>::type;
+      using reference = value_type const&;
+      using const_reference = value_type const&;
+      using pointer = value_type const*;
+      using const_pointer = value_type const*;
+      using iterator = typename table_type::const_iterator;
+      using const_iterator = typename table_type::const_iterator;
+
+      constexpr static_flat_set(value_type const (&x)[N],
+        hasher const& h = hasher(), key_equal const& pred = key_equal())
+          : table_(x, h, pred)
+      {
+      }
+
+      /// Iterators
+      ///
+
+      const_iterator begin() const noexcept { return table_.begin(); }
+      const_iterator end() const noexcept { return table_.end(); }
+      const_iterator cbegin() const noexcept { return table_.begin(); }
+      const_iterator cend() const noexcept { return table_.end(); }
+
+      /// Capacity
+      ///
+
+      BOOST_ATTRIBUTE_NODISCARD static constexpr bool empty() noexcept
+      {
+        return table_type::empty();
+      }
+
+      static constexpr size_type size() noexcept { return table_type::size(); }
+
+      static constexpr size_type max_size() noexcept
+      {
+        return table_type::size();
+      }
+
+      /// Lookup
+      ///
+
+      BOOST_FORCEINLINE size_type count(key_type const& key) const
+      {
+        auto pos = table_.find(key);
+        return pos != table_.end() ? 1 : 0;
+      }
+
+      template <class K>
+      BOOST_FORCEINLINE typename std::enable_if<
+        detail::are_transparent<K, hasher, key_equal>::value, size_type>::type
+      count(K const& key) const
+      {
+        auto pos = table_.find(key);
+        return pos != table_.end() ? 1 : 0;
+      }
+
+      BOOST_FORCEINLINE const_iterator find(key_type const& key) const
+      {
+        return table_.find(key);
+      }
+
+      template <class K>
+      BOOST_FORCEINLINE typename std::enable_if<
+        boost::unordered::detail::are_transparent<K, hasher, key_equal>::value,
+        const_iterator>::type
+      find(K const& key) const
+      {
+        return table_.find(key);
+      }
+
+      BOOST_FORCEINLINE bool contains(key_type const& key) const
+      {
+        return this->find(key) != this->end();
+      }
+
+      template <class K>
+      BOOST_FORCEINLINE typename std::enable_if<
+        boost::unordered::detail::are_transparent<K, hasher, key_equal>::value,
+        bool>::type
+      contains(K const& key) const
+      {
+        return this->find(key) != this->end();
+      }
+
+      /// Hash Policy
+      ///
+
+      static constexpr size_type bucket_count() noexcept
+      {
+        return table_type::capacity();
+      }
+
+      static constexpr float load_factor() noexcept
+      {
+        return table_type::load_factor();
+      }
+
+      /// Observers
+      ///
+
+      constexpr hasher hash_function() const { return table_.hash_function(); }
+
+      constexpr key_equal key_eq() const { return table_.key_eq(); }
+    };
+
+    template <class Key, class Hash = boost::unordered::static_hash<Key>,
+      class KeyEqual = std::equal_to<Key>, std::size_t N>
+    constexpr static_flat_set<Key, N, Hash, KeyEqual> make_static_flat_set(
+      Key const (&x)[N], Hash const& h = Hash(),
+      KeyEqual const& pred = KeyEqual())
+    {
+      return static_flat_set<Key, N, Hash, KeyEqual>(x, h, pred);
+    }
+  } // namespace unordered
+
+  using boost::unordered::make_static_flat_set;
+  using boost::unordered::static_flat_set;
+} // namespace boost
+
+#endif
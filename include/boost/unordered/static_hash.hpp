@@ -0,0 +1,86 @@
+/* constexpr hash function for static containers.
+ *
+ * Copyright 2024 Boost.Unordered contributors.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See https://www.boost.org/libs/unordered for library home page.
+ */
+
+#ifndef BOOST_UNORDERED_STATIC_HASH_HPP
+#define BOOST_UNORDERED_STATIC_HASH_HPP
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <type_traits>
+
+#if !defined(BOOST_NO_CXX17_HDR_STRING_VIEW)
+#include <string_view>
+#endif
+
+namespace boost{
+namespace unordered{
+
+/* Hash function usable in constant expressions, as required for building
+ * static_flat_map and static_flat_set at compile time (boost::hash is not
+ * constexpr). Supported types are integrals, enums and, in C++17,
+ * std::basic_string_view. Values are not avalanching: containers mix them
+ * as they do with boost::hash.
+ */
+
+template<typename T,typename=void>
+struct static_hash;
+
+template<typename T>
+struct static_hash<
+  T,
+  typename std::enable_if<
+    std::is_integral<T>::value||std::is_enum<T>::value>::type
+>
+{
+  constexpr std::size_t operator()(T x)const noexcept
+  {
+    return fold(static_cast<boost::ulong_long_type>(x));
+  }
+
+private:
+  static constexpr std::size_t fold(boost::ulong_long_type x)noexcept
+  {
+    return sizeof(std::size_t)>=sizeof(boost::ulong_long_type)?
+      static_cast<std::size_t>(x):
+      static_cast<std::size_t>(x^(x>>32));
+  }
+};
+
+#if !defined(BOOST_NO_CXX17_HDR_STRING_VIEW)
+
+/* FNV-1a over the code units */
+
+template<typename Ch,typename Traits>
+struct static_hash<std::basic_string_view<Ch,Traits>>
+{
+  constexpr std::size_t operator()(
+    std::basic_string_view<Ch,Traits> x)const noexcept
+  {
+    boost::uint64_t h=0xCBF29CE484222325ull;
+    for(auto c:x){
+      h^=static_cast<boost::uint64_t>(
+        static_cast<typename std::make_unsigned<Ch>::type>(c));
+      h*=0x100000001B3ull;
+    }
+    return static_cast<std::size_t>(h^(h>>32));
+  }
+};
+
+#endif
+
+} /* namespace unordered */
+} /* namespace boost */
+
+#endif
@@ -11,17 +11,20 @@
 #endif
 
 #include <boost/unordered/concurrent_flat_map_fwd.hpp>
+#include <boost/unordered/detail/concurrent_static_asserts.hpp>
 #include <boost/unordered/detail/foa/flat_map_types.hpp>
 #include <boost/unordered/detail/foa/table.hpp>
 #include <boost/unordered/detail/serialize_container.hpp>
 #include <boost/unordered/detail/throw_exception.hpp>
 #include <boost/unordered/detail/type_traits.hpp>
+#include <boost/unordered/prehashed_key.hpp>
 #include <boost/unordered/unordered_flat_map_fwd.hpp>
 
 #include <boost/core/allocator_access.hpp>
 #include <boost/container_hash/hash.hpp>
 
 #include <initializer_list>
+#include <iosfwd>
 #include <iterator>
 #include <stdexcept>
 #include <type_traits>
@@ -50,6 +53,9 @@ namespace boost {
 
       table_type table_;
 
+      // used by concurrent_flat_map::snapshot
+      explicit unordered_flat_map(table_type&& t) : table_(std::move(t)) {}
+
       template <class K, class V, class H, class KE, class A>
       bool friend operator==(unordered_flat_map<K, V, H, KE, A> const& lhs,
         unordered_flat_map<K, V, H, KE, A> const& rhs);
@@ -58,6 +64,10 @@ namespace boost {
       typename unordered_flat_map<K, V, H, KE, A>::size_type friend erase_if(
         unordered_flat_map<K, V, H, KE, A>& set, Pred pred);
 
+      template <class K, class V, class H, class KE, class A>
+      friend void save_image(
+        unordered_flat_map<K, V, H, KE, A> const& x, std::ostream& os);
+
     public:
       using key_type = Key;
       using mapped_type = T;
@@ -76,6 +86,9 @@ namespace boost {
       using iterator = typename table_type::iterator;
       using const_iterator = typename table_type::const_iterator;
 
+      static constexpr size_type bulk_lookup_size =
+        table_type::bulk_lookup_size;
+
       unordered_flat_map() : unordered_flat_map(0) {}
 
       explicit unordered_flat_map(size_type n, hasher const& h = hasher(),
@@ -364,6 +377,14 @@ namespace boost {
           std::forward<K>(key), std::forward<Args>(args)...);
       }
 
+      template <class K, class... Args>
+      BOOST_FORCEINLINE std::pair<iterator, bool> try_emplace(
+        prehashed_key<K, hasher> const& k, Args&&... args)
+      {
+        return table_.try_emplace_hashed(
+          k.hash(), k.key(), std::forward<Args>(args)...);
+      }
+
       template <class... Args>
       BOOST_FORCEINLINE iterator try_emplace(
         const_iterator, key_type const& key, Args&&... args)
@@ -425,6 +446,12 @@ namespace boost {
         return table_.erase(key);
       }
 
+      template <class K>
+      BOOST_FORCEINLINE size_type erase(prehashed_key<K, hasher> const& k)
+      {
+        return table_.erase_hashed(k.key(), k.hash());
+      }
+
       void swap(unordered_flat_map& rhs) noexcept(
         noexcept(std::declval<table_type&>().swap(std::declval<table_type&>())))
       {
@@ -577,6 +604,236 @@ namespace boost {
         return this->find(key) != this->end();
       }
 
+      template <class K>
+      BOOST_FORCEINLINE size_type count(prehashed_key<K, hasher> const& k) const
+      {
+        auto pos = table_.find_hashed(k.key(), k.hash());
+        return pos != table_.end() ? 1 : 0;
+      }
+
+      template <class K>
+      BOOST_FORCEINLINE iterator find(prehashed_key<K, hasher> const& k)
+      {
+        return table_.find_hashed(k.key(), k.hash());
+      }
+
+      template <class K>
+      BOOST_FORCEINLINE const_iterator find(
+        prehashed_key<K, hasher> const& k) const
+      {
+        return table_.find_hashed(k.key(), k.hash());
+      }
+
+      template <class K>
+      BOOST_FORCEINLINE bool contains(prehashed_key<K, hasher> const& k) const
+      {
+        return this->find(k) != this->end();
+      }
+
+      prehashed_key<key_type, hasher> prehash(key_type const& key) const
+      {
+        return detail::prehashed_key_access::make<hasher>(
+          key, table_.prehash(key));
+      }
+
+      template <class K>
+      typename std::enable_if<
+        boost::unordered::detail::are_transparent<K, hasher, key_equal>::value,
+        prehashed_key<K, hasher> >::type
+      prehash(K const& key) const
+      {
+        return detail::prehashed_key_access::make<hasher>(
+          key, table_.prehash(key));
+      }
+
+      // handles refer to the key, so temporaries are rejected
+
+      prehashed_key<key_type, hasher> prehash(key_type&&) const = delete;
+
+      template <class K>
+      typename std::enable_if<!std::is_lvalue_reference<K>::value &&
+                                boost::unordered::detail::are_transparent<K, hasher,
+                                  key_equal>::value,
+        prehashed_key<K, hasher> >::type
+      prehash(K&&) const = delete;
+
+      template <class K>
+      BOOST_FORCEINLINE void prefetch(
+        prehashed_key<K, hasher> const& k) const noexcept
+      {
+        table_.prefetch(k.hash());
+      }
+
+      template <class FwdIterator, class OutputIterator>
+      BOOST_FORCEINLINE OutputIterator find(
+        FwdIterator first, FwdIterator last, OutputIterator out)
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_BULK_VISIT_ITERATOR(FwdIterator)
+        return table_.find(first, last, out);
+      }
+
+      template <class FwdIterator, class OutputIterator>
+      BOOST_FORCEINLINE OutputIterator find(
+        FwdIterator first, FwdIterator last, OutputIterator out) const
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_BULK_VISIT_ITERATOR(FwdIterator)
+        return table_.find(first, last, out);
+      }
+
+      template <class FwdIterator, class OutputIterator>
+      BOOST_FORCEINLINE OutputIterator contains(
+        FwdIterator first, FwdIterator last, OutputIterator out) const
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_BULK_VISIT_ITERATOR(FwdIterator)
+        return table_.contains(first, last, out);
+      }
+
+      template <class FwdIterator, class F>
+      BOOST_FORCEINLINE size_type visit(
+        FwdIterator first, FwdIterator last, F f)
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_BULK_VISIT_ITERATOR(FwdIterator)
+        BOOST_UNORDERED_STATIC_ASSERT_INVOCABLE(F)
+        return table_.visit(first, last, f);
+      }
+
+      template <class FwdIterator, class F>
+      BOOST_FORCEINLINE size_type visit(
+        FwdIterator first, FwdIterator last, F f) const
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_BULK_VISIT_ITERATOR(FwdIterator)
+        BOOST_UNORDERED_STATIC_ASSERT_CONST_INVOCABLE(F)
+        return table_.visit(first, last, f);
+      }
+
+      template <class F> size_type visit_all(F f)
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_INVOCABLE(F)
+        return table_.visit_all(f);
+      }
+
+      template <class F> size_type visit_all(F f) const
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_CONST_INVOCABLE(F)
+        return table_.visit_all(f);
+      }
+
+      template <class F> size_type cvisit_all(F f) const
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_CONST_INVOCABLE(F)
+        return table_.visit_all(f);
+      }
+
+      template <class F> bool visit_while(F f)
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_INVOCABLE(F)
+        return table_.visit_while(f);
+      }
+
+      template <class F> bool visit_while(F f) const
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_CONST_INVOCABLE(F)
+        return table_.visit_while(f);
+      }
+
+      template <class F> bool cvisit_while(F f) const
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_CONST_INVOCABLE(F)
+        return table_.visit_while(f);
+      }
+
+#if defined(BOOST_UNORDERED_ENABLE_PARALLEL_ALGORITHMS) &&                   \
+  defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
+      template <class ExecPolicy, class F>
+      typename std::enable_if<detail::is_execution_policy<ExecPolicy>::value,
+        void>::type
+      visit_all(ExecPolicy&& p, F f)
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_INVOCABLE(F)
+        BOOST_UNORDERED_STATIC_ASSERT_EXEC_POLICY(ExecPolicy)
+        table_.visit_all(p, f);
+      }
+
+      template <class ExecPolicy, class F>
+      typename std::enable_if<detail::is_execution_policy<ExecPolicy>::value,
+        void>::type
+      visit_all(ExecPolicy&& p, F f) const
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_CONST_INVOCABLE(F)
+        BOOST_UNORDERED_STATIC_ASSERT_EXEC_POLICY(ExecPolicy)
+        table_.visit_all(p, f);
+      }
+
+      template <class ExecPolicy, class F>
+      typename std::enable_if<detail::is_execution_policy<ExecPolicy>::value,
+        void>::type
+      cvisit_all(ExecPolicy&& p, F f) const
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_CONST_INVOCABLE(F)
+        BOOST_UNORDERED_STATIC_ASSERT_EXEC_POLICY(ExecPolicy)
+        table_.visit_all(p, f);
+      }
+
+      template <class ExecPolicy, class F>
+      typename std::enable_if<detail::is_execution_policy<ExecPolicy>::value,
+        bool>::type
+      visit_while(ExecPolicy&& p, F f)
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_INVOCABLE(F)
+        BOOST_UNORDERED_STATIC_ASSERT_EXEC_POLICY(ExecPolicy)
+        return table_.visit_while(p, f);
+      }
+
+      template <class ExecPolicy, class F>
+      typename std::enable_if<detail::is_execution_policy<ExecPolicy>::value,
+        bool>::type
+      visit_while(ExecPolicy&& p, F f) const
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_CONST_INVOCABLE(F)
+        BOOST_UNORDERED_STATIC_ASSERT_EXEC_POLICY(ExecPolicy)
+        return table_.visit_while(p, f);
+      }
+
+      template <class ExecPolicy, class F>
+      typename std::enable_if<detail::is_execution_policy<ExecPolicy>::value,
+        bool>::type
+      cvisit_while(ExecPolicy&& p, F f) const
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_CONST_INVOCABLE(F)
+        BOOST_UNORDERED_STATIC_ASSERT_EXEC_POLICY(ExecPolicy)
+        return table_.visit_while(p, f);
+      }
+
+      template <class ExecPolicy, class F>
+      typename std::enable_if<detail::is_execution_policy<ExecPolicy>::value,
+        size_type>::type
+      erase_if(ExecPolicy&& p, F f)
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_EXEC_POLICY(ExecPolicy)
+        return table_.erase_if(p, f);
+      }
+
+      template <class ExecPolicy, class F>
+      typename std::enable_if<detail::is_execution_policy<ExecPolicy>::value,
+        size_type>::type
+      count_if(ExecPolicy&& p, F f) const
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_CONST_INVOCABLE(F)
+        BOOST_UNORDERED_STATIC_ASSERT_EXEC_POLICY(ExecPolicy)
+        return table_.count_if(p, f);
+      }
+
+      template <class ExecPolicy, class U, class BinaryOp, class F>
+      typename std::enable_if<detail::is_execution_policy<ExecPolicy>::value,
+        U>::type
+      transform_reduce(ExecPolicy&& p, U init, BinaryOp op, F f) const
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_CONST_INVOCABLE(F)
+        BOOST_UNORDERED_STATIC_ASSERT_EXEC_POLICY(ExecPolicy)
+        return table_.transform_reduce(p, std::move(init), op, f);
+      }
+#endif
+
       std::pair<iterator, iterator> equal_range(key_type const& key)
       {
         auto pos = table_.find(key);
@@ -654,6 +911,40 @@ namespace boost {
 
       void reserve(size_type n) { table_.reserve(n); }
 
+      void rebuild_overflow() { table_.rebuild_overflow(); }
+
+#if defined(BOOST_UNORDERED_ENABLE_PARALLEL_ALGORITHMS) &&                   \
+  defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
+      template <class ExecPolicy>
+      typename std::enable_if<detail::is_execution_policy<ExecPolicy>::value,
+        void>::type
+      rehash(ExecPolicy&& p, size_type n)
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_EXEC_POLICY(ExecPolicy)
+        table_.rehash(p, n);
+      }
+
+      template <class ExecPolicy>
+      typename std::enable_if<detail::is_execution_policy<ExecPolicy>::value,
+        void>::type
+      reserve(ExecPolicy&& p, size_type n)
+      {
+        BOOST_UNORDERED_STATIC_ASSERT_EXEC_POLICY(ExecPolicy)
+        table_.reserve(p, n);
+      }
+#endif
+
+#if defined(BOOST_UNORDERED_ENABLE_STATS)
+      /// Statistics
+      ///
+
+      using stats = typename table_type::stats;
+
+      stats get_stats() const { return table_.get_stats(); }
+
+      void reset_stats() noexcept { table_.reset_stats(); }
+#endif
+
       /// Observers
       ///
 
@@ -0,0 +1,187 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_UNORDERED_FLAT_MAP_VIEW_HPP_INCLUDED
+#define BOOST_UNORDERED_UNORDERED_FLAT_MAP_VIEW_HPP_INCLUDED
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/unordered/detail/foa/flat_map_types.hpp>
+#include <boost/unordered/detail/foa/image.hpp>
+#include <boost/unordered/detail/throw_exception.hpp>
+#include <boost/unordered/detail/type_traits.hpp>
+#include <boost/unordered/unordered_flat_map.hpp>
+
+#include <boost/container_hash/hash.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+namespace boost {
+  namespace unordered {
+
+    template <class Key, class T, class Hash = boost::hash<Key>,
+      class KeyEqual = std::equal_to<Key> >
+    class unordered_flat_map_view
+    {
+      static_assert(std::is_trivially_copyable<Key>::value &&
+                      std::is_trivially_copyable<T>::value,
+        "unordered_flat_map_view requires trivially copyable key and mapped "
+        "types");
+
+      using map_types = detail::foa::flat_map_types<Key, T>;
+
+      using table_type = detail::foa::image_table<map_types, Hash, KeyEqual>;
+
+      table_type table_;
+
+    public:
+      using key_type = Key;
+      using mapped_type = T;
+      using value_type = typename map_types::value_type;
+      using size_type = std::size_t;
+      using difference_type = std::ptrdiff_t;
+      using hasher = typename boost::unordered::detail::type_identity<Hash>::type;
+      using key_equal = typename boost::unordered::detail::type_identity<KeyEqual>::type;
+      using reference = value_type const&;
+      using const_reference = value_type const&;
+      using pointer = value_type const*;
+      using const_pointer = value_type const*;
+      using iterator = typename table_type::const_iterator;
+      using const_iterator = typename table_type::const_iterator;
+
+      unordered_flat_map_view(void const* data, size_type n,
+        hasher const& h = hasher(), key_equal const& pred = key_equal())
+          : table_(data, n, h, pred)
+      {
+      }
+
+      /// Iterators
+      ///
+
+      const_iterator begin() const noexcept { return table_.begin(); }
+      const_iterator end() const noexcept { return table_.end(); }
+      const_iterator cbegin() const noexcept { return table_.begin(); }
+      const_iterator cend() const noexcept { return table_.end(); }
+
+      /// Capacity
+      ///
+
+      BOOST_ATTRIBUTE_NODISCARD bool empty() const noexcept
+      {
+        return table_.empty();
+      }
+
+      size_type size() const noexcept { return table_.size(); }
+
+      /// Lookup
+      ///
+
+      mapped_type const& at(key_type const& key) const
+      {
+        auto pos = table_.find(key);
+        if (pos != table_.end()) {
+          return pos->second;
+        }
+        boost::unordered::detail::throw_out_of_range(
+          "key was not found in unordered_flat_map_view");
+      }
+
+      template <class K>
+      typename std::enable_if<
+        boost::unordered::detail::are_transparent<K, hasher, key_equal>::value,
+        mapped_type const&>::type
+      at(K const& key) const
+      {
+        auto pos = table_.find(key);
+        if (pos != table_.end()) {
+          return pos->second;
+        }
+        boost::unordered::detail::throw_out_of_range(
+          "key was not found in unordered_flat_map_view");
+      }
+
+      BOOST_FORCEINLINE size_type count(key_type const& key) const
+      {
+        auto pos = table_.find(key);
+        return pos != table_.end() ? 1 : 0;
+      }
+
+      template <class K>
+      BOOST_FORCEINLINE typename std::enable_if<
+        detail::are_transparent<K, hasher, key_equal>::value, size_type>::type
+      count(K const& key) const
+      {
+        auto pos = table_.find(key);
+        return pos != table_.end() ? 1 : 0;
+      }
+
+      BOOST_FORCEINLINE const_iterator find(key_type const& key) const
+      {
+        return table_.find(key);
+      }
+
+      template <class K>
+      BOOST_FORCEINLINE typename std::enable_if<
+        boost::unordered::detail::are_transparent<K, hasher, key_equal>::value,
+        const_iterator>::type
+      find(K const& key) const
+      {
+        return table_.find(key);
+      }
+
+      BOOST_FORCEINLINE bool contains(key_type const& key) const
+      {
+        return this->find(key) != this->end();
+      }
+
+      template <class K>
+      BOOST_FORCEINLINE typename std::enable_if<
+        boost::unordered::detail::are_transparent<K, hasher, key_equal>::value,
+        bool>::type
+      contains(K const& key) const
+      {
+        return this->find(key) != this->end();
+      }
+
+      /// Hash Policy
+      ///
+
+      size_type bucket_count() const noexcept { return table_.capacity(); }
+
+      float load_factor() const noexcept { return table_.load_factor(); }
+
+      /// Observers
+      ///
+
+      hasher hash_function() const { return table_.hash_function(); }
+
+      key_equal key_eq() const { return table_.key_eq(); }
+    };
+
+    template <class Key, class T, class Hash, class KeyEqual, class Allocator>
+    void save_image(
+      unordered_flat_map<Key, T, Hash, KeyEqual, Allocator> const& x,
+      std::ostream& os)
+    {
+      static_assert(std::is_trivially_copyable<Key>::value &&
+                      std::is_trivially_copyable<T>::value,
+        "save_image requires trivially copyable key and mapped types");
+
+      using map_types = detail::foa::flat_map_types<Key, T>;
+
+      detail::foa::image_table<map_types, Hash, KeyEqual>::save(x.table_, os);
+    }
+  } // namespace unordered
+
+  using boost::unordered::unordered_flat_map_view;
+} // namespace boost
+
+#endif
@@ -0,0 +1,8 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Succeeds only if the CPU running it supports AVX-512BW, so that tests
+// built with BOOST_UNORDERED_ENABLE_AVX512_GROUPS are skipped elsewhere.
+
+int main() { return __builtin_cpu_supports("avx512bw") ? 0 : 1; }
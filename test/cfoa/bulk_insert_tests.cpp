@@ -0,0 +1,174 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "helpers.hpp"
+
+#include <boost/unordered/concurrent_flat_map.hpp>
+#include <boost/unordered/concurrent_flat_set.hpp>
+
+#include <iterator>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace {
+  test::seed_t initialize_seed(718263519);
+
+  template <class X, class G>
+  void bulk_try_emplace(X*, G gen, test::random_generator rg)
+  {
+    auto values = make_random_values(1024 * 16, [&] { return gen(rg); });
+    std::vector<raii> keys;
+    for (auto const& v : values) {
+      keys.push_back(v.first);
+    }
+    auto reference_map =
+      boost::unordered_flat_map<raii, raii>(values.begin(), values.end());
+
+    for (int reserve = 0; reserve < 2; ++reserve) {
+      raii::reset_counts();
+      {
+        X x;
+        if (reserve) {
+          x.reserve(keys.size());
+        }
+
+        std::atomic<std::uint64_t> num_inserts{0}, num_invokes{0};
+        thread_runner(keys, [&x, &num_inserts, &num_invokes](
+                              boost::span<raii> s) {
+          auto half = s.begin() + (std::ptrdiff_t)(s.size() / 2);
+          num_inserts += x.try_emplace_or_visit(s.begin(), half,
+            [&num_invokes](typename X::value_type& v) {
+              (void)v;
+              ++num_invokes;
+            });
+          num_inserts += x.try_emplace_or_cvisit(half, s.end(),
+            [&num_invokes](typename X::value_type const& v) {
+              (void)v;
+              ++num_invokes;
+            });
+        });
+
+        BOOST_TEST_EQ(x.size(), reference_map.size());
+        BOOST_TEST_EQ(num_inserts, x.size());
+        BOOST_TEST_EQ(num_invokes, keys.size() - x.size());
+        BOOST_TEST_EQ(raii::default_constructor, x.size());
+        BOOST_TEST_EQ(raii::copy_constructor, x.size());
+        BOOST_TEST_EQ(raii::copy_assignment, 0u);
+        BOOST_TEST_EQ(raii::move_assignment, 0u);
+        if (reserve) {
+          BOOST_TEST_EQ(raii::move_constructor, 0u);
+        }
+
+        x.visit_all([&](typename X::value_type const& kv) {
+          BOOST_TEST(reference_map.contains(kv.first));
+          BOOST_TEST_EQ(kv.second, raii());
+        });
+      }
+      check_raii_counts();
+    }
+  }
+
+  // single-threaded so that the first occurrence of each key is known to be
+  // the one inserted, including when duplicates fall in the same batch and
+  // when the table needs to be rehashed halfway through a batch
+
+  template <class X> void bulk_insert_order(X*)
+  {
+    std::size_t const n = X::bulk_visit_size;
+    std::size_t const sizes[] = {
+      0, 1, n - 1, n, n + 1, 2 * n - 1, 2 * n, 3 * n + 1, 1000, 5000};
+
+    for (std::size_t size : sizes) {
+      for (std::size_t num_keys : {size / 3 + 1, size + 1}) {
+        std::vector<std::pair<int, int> > values;
+        for (std::size_t i = 0; i < size; ++i) {
+          values.emplace_back((int)(i % num_keys), (int)i);
+        }
+
+        X x;
+        std::size_t const expected_size = size < num_keys ? size : num_keys;
+
+        std::size_t num_invokes = 0;
+        BOOST_TEST_EQ(x.insert_or_visit(values.begin(), values.end(),
+                        [&](typename X::value_type& v) {
+                          ++v.second;
+                          ++num_invokes;
+                        }),
+          expected_size);
+        BOOST_TEST_EQ(x.size(), expected_size);
+        BOOST_TEST_EQ(num_invokes, size - expected_size);
+
+        std::vector<std::size_t> counts(expected_size, 0);
+        for (auto const& v : values) {
+          ++counts[(std::size_t)v.first];
+        }
+        x.cvisit_all([&](typename X::value_type const& v) {
+          auto k = (std::size_t)v.first;
+          BOOST_TEST_EQ((std::size_t)v.second, k + counts[k] - 1);
+        });
+
+        X y;
+        BOOST_TEST_EQ(y.insert(values.begin(), values.end()), expected_size);
+
+        std::vector<int> keys;
+        for (std::size_t i = 0; i < size; ++i) {
+          keys.push_back((int)i);
+        }
+        num_invokes = 0;
+        BOOST_TEST_EQ(y.try_emplace_or_cvisit(keys.begin(), keys.end(),
+                        [&](typename X::value_type const&) { ++num_invokes; }),
+          size - expected_size);
+        BOOST_TEST_EQ(num_invokes, expected_size);
+        BOOST_TEST_EQ(y.size(), size);
+      }
+    }
+  }
+
+  template <class X> void bulk_insert_input_iterator(X*)
+  {
+    std::stringstream ss;
+    for (int i = 0; i < 100; ++i) {
+      ss << (i % 40) << ' ';
+    }
+
+    X x;
+    std::size_t num_invokes = 0;
+    BOOST_TEST_EQ(x.insert_or_cvisit(std::istream_iterator<int>(ss),
+                    std::istream_iterator<int>(),
+                    [&](typename X::value_type const&) { ++num_invokes; }),
+      40u);
+    BOOST_TEST_EQ(x.size(), 40u);
+    BOOST_TEST_EQ(num_invokes, 60u);
+  }
+
+  boost::unordered::concurrent_flat_map<raii, raii>* map;
+  boost::unordered::concurrent_flat_map<int, int>* int_map;
+  boost::unordered::concurrent_flat_set<int>* int_set;
+
+} // namespace
+
+using test::default_generator;
+using test::limited_range;
+using test::sequential;
+
+value_generator<std::pair<raii, raii> > init_type_generator;
+
+// clang-format off
+UNORDERED_TEST(
+  bulk_try_emplace,
+  ((map))
+  ((init_type_generator))
+  ((default_generator)(sequential)(limited_range)))
+
+UNORDERED_TEST(
+  bulk_insert_order,
+  ((int_map)))
+
+UNORDERED_TEST(
+  bulk_insert_input_iterator,
+  ((int_set)))
+// clang-format on
+
+RUN_TESTS()
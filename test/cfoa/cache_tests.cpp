@@ -0,0 +1,160 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "helpers.hpp"
+
+#include <boost/unordered/concurrent_flat_cache.hpp>
+
+#include <atomic>
+#include <vector>
+
+namespace {
+  test::seed_t initialize_seed(83901512);
+
+  using hasher = stateful_hash;
+  using key_equal = stateful_key_equal;
+
+  using cache_type = boost::unordered::concurrent_flat_cache<raii, raii,
+    hasher, key_equal, stateful_allocator<std::pair<raii const, raii> > >;
+
+  cache_type* cache;
+  boost::unordered::concurrent_flat_cache<int, int>* int_cache;
+
+  int key_value(raii const& r) { return r.x_; }
+  int key_value(int x) { return x; }
+
+  template <class X> void size_limit(X*)
+  {
+    raii::reset_counts();
+    {
+      X x(1000, hasher(1), key_equal(2));
+      BOOST_TEST_EQ(x.size_limit(), 1000u);
+      BOOST_TEST(x.empty());
+      BOOST_TEST_EQ(x.hash_function(), hasher(1));
+      BOOST_TEST_EQ(x.key_eq(), key_equal(2));
+
+      for (int i = 0; i < 10000; ++i) {
+        BOOST_TEST(x.emplace(i, i));
+        BOOST_TEST_LE(x.size(), x.size_limit());
+      }
+      // eviction goes one group at a time
+      BOOST_TEST_GT(x.size() + 64, x.size_limit());
+
+      // new elements are not evicted before the next sweep
+      BOOST_TEST(x.contains(9999));
+
+      // existing keys don't cause eviction
+      auto n = x.size();
+      BOOST_TEST_NOT(x.try_emplace(9999, 0));
+      BOOST_TEST_NOT(x.insert_or_assign(9999, 1));
+      BOOST_TEST_EQ(x.size(), n);
+      x.cvisit(9999, [](typename X::value_type const& v) {
+        BOOST_TEST_EQ(v.second, raii(1));
+      });
+
+      x.erase(9999);
+      BOOST_TEST_EQ(x.size(), n - 1);
+      x.clear();
+      BOOST_TEST(x.empty());
+    }
+    check_raii_counts();
+
+    {
+      X x(0);
+      BOOST_TEST(x.insert(std::make_pair(raii(1), raii(1))));
+      BOOST_TEST(x.empty());
+    }
+  }
+
+  // Once the cache is full, keys looked up between insertions get a second
+  // chance and survive, while keys not looked up anymore are evicted.
+
+  template <class X> void second_chance(X*)
+  {
+    using value_type = typename X::value_type;
+
+    int const num_hot = 100;
+    int const num_cold = 50000;
+
+    X x(1000);
+    std::size_t num_misses = 0;
+
+    for (int i = 0; i < num_cold; ++i) {
+      x.try_emplace(num_hot + i, i);
+      for (int j = 0; j < num_hot; ++j) {
+        if (!x.visit(j, [](value_type&) {})) {
+          // all elements are initially referenced, so the first sweep
+          // can evict anything
+          if (i > 10000) {
+            ++num_misses;
+          }
+          x.try_emplace(j, j);
+        }
+      }
+    }
+    BOOST_TEST_EQ(num_misses, 0u);
+
+    std::size_t num_old = 0;
+    x.cvisit_all([&](value_type const& v) {
+      auto k = key_value(v.first);
+      if (k >= num_hot && k < num_hot + num_cold - 10000) {
+        ++num_old;
+      }
+    });
+    BOOST_TEST_EQ(num_old, 0u);
+  }
+
+  template <class X> void concurrent_insertion_and_lookup(X*)
+  {
+    using value_type = typename X::value_type;
+
+    auto values = make_random_values(
+      1024 * 64, [] { return static_cast<int>(rand() % 8192); });
+
+    raii::reset_counts();
+    {
+      X x(1024);
+      std::atomic<std::size_t> num_hits{0}, num_errors{0};
+
+      thread_runner(values, [&](boost::span<int> s) {
+        for (auto i : s) {
+          if (!x.visit(i, [&](value_type& v) {
+                if (v.second != raii(i)) {
+                  ++num_errors;
+                }
+                ++num_hits;
+              })) {
+            x.emplace(i, i);
+          }
+          if (x.size() > x.size_limit() + num_threads) {
+            ++num_errors;
+          }
+        }
+      });
+
+      BOOST_TEST_EQ(num_errors, 0u);
+      BOOST_TEST_GT(num_hits, 0u);
+      BOOST_TEST_LE(x.size(), x.size_limit());
+      BOOST_TEST_EQ(x.visit_all([](value_type&) {}), x.size());
+    }
+    check_raii_counts();
+  }
+
+} // namespace
+
+// clang-format off
+UNORDERED_TEST(
+  size_limit,
+  ((cache)))
+
+UNORDERED_TEST(
+  second_chance,
+  ((cache)(int_cache)))
+
+UNORDERED_TEST(
+  concurrent_insertion_and_lookup,
+  ((cache)))
+// clang-format on
+
+RUN_TESTS()
@@ -84,7 +84,10 @@ namespace {
         value_cardinality<typename X::value_type>::value;
 
       call_impl(values, x);
-      BOOST_TEST_GE(raii::move_constructor, value_type_cardinality * x.size());
+      if (grew_past_initial_capacity(x)) {
+        BOOST_TEST_GE(
+          raii::move_constructor, value_type_cardinality * x.size());
+      }
     }
   } lvalue_emplacer;
 
@@ -197,7 +200,9 @@ namespace {
       BOOST_TEST_EQ(raii::default_constructor, 0u);
 
       BOOST_TEST_EQ(raii::copy_constructor, value_type_cardinality * x.size());
-      BOOST_TEST_GT(raii::move_constructor, 0u);
+      if (grew_past_initial_capacity(x)) {
+        BOOST_TEST_GT(raii::move_constructor, 0u);
+      }
 
       BOOST_TEST_EQ(raii::copy_assignment, 0u);
       BOOST_TEST_EQ(raii::move_assignment, 0u);
@@ -238,7 +243,10 @@ namespace {
 #if defined(BOOST_MSVC)
 #pragma warning(pop) // C4127
 #endif
-      BOOST_TEST_GT(raii::move_constructor, value_type_cardinality * x.size());
+      if (grew_past_initial_capacity(x)) {
+        BOOST_TEST_GT(
+          raii::move_constructor, value_type_cardinality * x.size());
+      }
 
       BOOST_TEST_EQ(raii::copy_assignment, 0u);
       BOOST_TEST_EQ(raii::move_assignment, 0u);
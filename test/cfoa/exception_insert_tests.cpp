@@ -153,7 +153,9 @@ namespace {
 
       BOOST_TEST_EQ(raii::default_constructor, 0u);
       BOOST_TEST_GT(raii::copy_constructor, 0u);
-      BOOST_TEST_GT(raii::move_constructor, 0u);
+      if (grew_past_initial_capacity(x)) {
+        BOOST_TEST_GT(raii::move_constructor, 0u);
+      }
       BOOST_TEST_EQ(raii::move_assignment, 0u);
     }
   } lvalue_insert_or_assign_copy_assign;
@@ -198,7 +200,9 @@ namespace {
 
       BOOST_TEST_EQ(raii::default_constructor, 0u);
       BOOST_TEST_GT(raii::copy_constructor, 0u);
-      BOOST_TEST_GT(raii::move_constructor, x.size()); // rehashing
+      if (grew_past_initial_capacity(x)) {
+        BOOST_TEST_GT(raii::move_constructor, x.size()); // rehashing
+      }
       BOOST_TEST_EQ(raii::move_assignment, 0u);
     }
   } rvalue_insert_or_assign_copy_assign;
@@ -250,7 +254,9 @@ namespace {
       BOOST_TEST_GT(num_inserts, 0u);
       BOOST_TEST_EQ(raii::default_constructor, 0u);
       // don't check move construction count here because of rehashing
-      BOOST_TEST_GT(raii::move_constructor, 0u);
+      if (grew_past_initial_capacity(x)) {
+        BOOST_TEST_GT(raii::move_constructor, 0u);
+      }
       BOOST_TEST_EQ(raii::move_assignment, 0u);
     }
   } lvalue_insert_or_cvisit;
@@ -289,7 +295,9 @@ namespace {
       BOOST_TEST_EQ(raii::default_constructor, 0u);
 
       // don't check move construction count here because of rehashing
-      BOOST_TEST_GT(raii::move_constructor, 0u);
+      if (grew_past_initial_capacity(x)) {
+        BOOST_TEST_GT(raii::move_constructor, 0u);
+      }
       BOOST_TEST_EQ(raii::move_assignment, 0u);
     }
   } lvalue_insert_or_visit;
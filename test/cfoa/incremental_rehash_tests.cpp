@@ -0,0 +1,344 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(BOOST_UNORDERED_ENABLE_INCREMENTAL_REHASH)
+#define BOOST_UNORDERED_ENABLE_INCREMENTAL_REHASH
+#endif
+
+#include "helpers.hpp"
+
+#include <boost/unordered/concurrent_flat_map.hpp>
+#include <boost/unordered/concurrent_flat_set.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+  test::seed_t initialize_seed(40591731);
+
+  // Single-threaded: migration of the old arrays advances one group per
+  // operation, so the table is known to be mid-rehash right after crossing
+  // each max load boundary. Every kind of operation is exercised from that
+  // state.
+
+  template <class X> void mid_rehash_operations(X*)
+  {
+    using value_type = typename X::value_type;
+
+    for (int n : {1, 100, 1000, 10000}) {
+      raii::reset_counts();
+      {
+        X x;
+        std::size_t num_visits = 0;
+        for (int i = 0; i < n; ++i) {
+          auto max_load = x.max_load();
+          BOOST_TEST(x.insert(value_type(raii{i}, raii{i})));
+          BOOST_TEST_EQ(x.size(), static_cast<std::size_t>(i + 1));
+          if (x.max_load() == max_load) {
+            continue;
+          }
+
+          // just grown
+          BOOST_TEST(x.contains(raii{i}));
+          BOOST_TEST(x.contains(raii{i / 2}));
+          BOOST_TEST(!x.contains(raii{-1}));
+          BOOST_TEST_EQ(x.count(raii{0}), 1u);
+          BOOST_TEST(!x.insert(value_type(raii{i / 3}, raii{0})));
+
+          num_visits = 0;
+          x.cvisit_all([&](value_type const& v) {
+            BOOST_TEST_EQ(v.first, v.second);
+            ++num_visits;
+          });
+          BOOST_TEST_EQ(num_visits, x.size());
+
+          X y(x);
+          BOOST_TEST_EQ(y.size(), x.size());
+          BOOST_TEST(y == x);
+
+          BOOST_TEST_EQ(x.erase(raii{i}), 1u);
+          BOOST_TEST(x.insert(value_type(raii{i}, raii{i})));
+        }
+
+        num_visits = 0;
+        BOOST_TEST_EQ(x.size(), static_cast<std::size_t>(n));
+        for (int i = 0; i < n; ++i) {
+          num_visits += x.visit(raii{i}, [&](value_type& v) {
+            BOOST_TEST_EQ(v.first, v.second);
+          });
+        }
+        BOOST_TEST_EQ(num_visits, static_cast<std::size_t>(n));
+      }
+      check_raii_counts();
+    }
+  }
+
+  template <class X> void mid_rehash_teardown(X*)
+  {
+    using value_type = typename X::value_type;
+
+    // destruction, clear, assignment and swap with migration pending
+
+    for (int op = 0; op < 4; ++op) {
+      raii::reset_counts();
+      {
+        X x, y;
+        int i = 0;
+        for (;;) {
+          auto max_load = x.max_load();
+          x.insert(value_type(raii{i}, raii{i}));
+          ++i;
+          if (x.max_load() != max_load && max_load >= 1000) {
+            break;
+          }
+        }
+
+        switch (op) {
+        case 0:
+          break;
+        case 1:
+          x.clear();
+          BOOST_TEST(x.empty());
+          BOOST_TEST(!x.contains(raii{0}));
+          break;
+        case 2:
+          y = x;
+          BOOST_TEST_EQ(y.size(), static_cast<std::size_t>(i));
+          x = std::move(y);
+          BOOST_TEST_EQ(x.size(), static_cast<std::size_t>(i));
+          break;
+        case 3:
+          x.swap(y);
+          BOOST_TEST_EQ(y.size(), static_cast<std::size_t>(i));
+          BOOST_TEST(y.contains(raii{0}));
+          BOOST_TEST(y.contains(raii{i - 1}));
+          break;
+        }
+      }
+      check_raii_counts();
+    }
+  }
+
+  // Readers check that keys known to be in the container are always found
+  // while other threads keep it growing.
+
+  template <class X> void concurrent_growth(X*)
+  {
+    using value_type = typename X::value_type;
+
+    int const num_keys = 200000;
+    int const num_base_keys = 1000;
+
+    std::vector<int> keys;
+    for (int i = num_base_keys; i < num_keys; ++i) {
+      keys.push_back(i);
+    }
+
+    X x;
+    for (int i = 0; i < num_base_keys; ++i) {
+      x.insert(test::make_value<X>(i));
+    }
+
+    std::atomic<std::size_t> num_misses{0}, num_traversal_errors{0};
+
+    thread_runner(keys, [&](boost::span<int> s) {
+      for (auto k : s) {
+        x.insert(test::make_value<X>(k));
+        if (!x.contains(k)) {
+          ++num_misses;
+        }
+        if (x.visit(k % num_base_keys, [](value_type const&) {}) != 1) {
+          ++num_misses;
+        }
+        if (k % 5 == 0) {
+          x.erase(k);
+        }
+        if (k % 10000 == 0) {
+          // every base key is visited exactly once
+          std::size_t n = 0;
+          x.cvisit_all([&](value_type const& v) {
+            if (get_key(v) < num_base_keys) {
+              ++n;
+            }
+          });
+          if (n != static_cast<std::size_t>(num_base_keys)) {
+            ++num_traversal_errors;
+          }
+        }
+      }
+    });
+
+    BOOST_TEST_EQ(num_misses, 0u);
+    BOOST_TEST_EQ(num_traversal_errors, 0u);
+
+    std::size_t expected_size = num_base_keys;
+    for (int k : keys) {
+      if (k % 5 != 0) {
+        ++expected_size;
+      }
+    }
+    BOOST_TEST_EQ(x.size(), expected_size);
+
+    std::size_t n = 0;
+    x.cvisit_all([&](value_type const& v) {
+      BOOST_TEST(get_key(v) < num_base_keys || get_key(v) % 5 != 0);
+      ++n;
+    });
+    BOOST_TEST_EQ(n, expected_size);
+  }
+
+  // The hash function throws while migrating a group: elements left in the
+  // old arrays are still found, and migration completes once hashing stops
+  // throwing, instead of waiting forever for the group to be done.
+
+  std::atomic<int> throwing_key{-1};
+
+  struct throwing_hash
+  {
+    std::size_t operator()(int x) const
+    {
+      if (x == throwing_key.load()) {
+        throw std::runtime_error("hash");
+      }
+      return boost::hash<int>()(x);
+    }
+  };
+
+  UNORDERED_AUTO_TEST (throwing_migration) {
+    using X = boost::unordered::concurrent_flat_map<int, int, throwing_hash>;
+    using value_type = X::value_type;
+
+    X x;
+    int n = 0;
+    for (;;) {
+      auto max_load = x.max_load();
+      x.emplace(n, n);
+      ++n;
+      if (x.max_load() != max_load && max_load >= 1000) {
+        break;
+      }
+    }
+
+    int const k = n / 2;
+    throwing_key.store(k);
+
+    int num_exceptions = 0;
+    for (int i = 0; i < n; ++i) {
+      if (i == k) {
+        continue;
+      }
+      try {
+        BOOST_TEST(x.contains(i));
+      } catch (std::runtime_error const&) {
+        ++num_exceptions;
+      }
+    }
+    BOOST_TEST_EQ(num_exceptions, 1);
+    BOOST_TEST_EQ(x.cvisit_all([](value_type const&) {}),
+      static_cast<std::size_t>(n));
+    BOOST_TEST_THROWS(x.snapshot(), std::runtime_error);
+
+    throwing_key.store(-1);
+
+    BOOST_TEST(x.contains(k));
+    BOOST_TEST_EQ(x.size(), static_cast<std::size_t>(n));
+    BOOST_TEST_EQ(x.snapshot().size(), static_cast<std::size_t>(n));
+    for (int i = 0; i < n; ++i) {
+      BOOST_TEST_EQ(x.visit(i, [&](value_type const& v) {
+        BOOST_TEST_EQ(v.first, v.second);
+      }), 1u);
+    }
+  }
+
+  // Lookups and erasures also finish migration: with no insertions after
+  // growth, the old arrays are still released.
+
+  std::atomic<int> num_live_allocations{0};
+
+  template <class T> struct counting_allocator
+  {
+    using value_type = T;
+
+    counting_allocator() = default;
+
+    template <class U> counting_allocator(counting_allocator<U> const&) {}
+
+    T* allocate(std::size_t n)
+    {
+      ++num_live_allocations;
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t)
+    {
+      --num_live_allocations;
+      ::operator delete(p);
+    }
+
+    bool operator==(counting_allocator const&) const { return true; }
+    bool operator!=(counting_allocator const&) const { return false; }
+  };
+
+  using counting_map = boost::unordered::concurrent_flat_map<int, int,
+    boost::hash<int>, std::equal_to<int>,
+    counting_allocator<std::pair<int const, int> > >;
+
+  template <class F> void release_without_insertions(F f)
+  {
+    counting_map x;
+    int n = 0;
+    int num_allocations = 0;
+    for (;;) {
+      auto max_load = x.max_load();
+      num_allocations = num_live_allocations.load();
+      x.emplace(n, n);
+      ++n;
+      if (x.max_load() != max_load && max_load >= 1000) {
+        break;
+      }
+    }
+    BOOST_TEST_GT(num_live_allocations.load(), num_allocations);
+
+    // one group migrated per operation
+    for (std::size_t i = 0; i <= x.bucket_count(); ++i) {
+      f(x, static_cast<int>(i));
+    }
+    BOOST_TEST_EQ(num_live_allocations.load(), num_allocations);
+  }
+
+  UNORDERED_AUTO_TEST (release_on_lookup) {
+    release_without_insertions([](counting_map const& x, int i) {
+      (void)x.contains(i);
+    });
+    release_without_insertions([](counting_map const& x, int i) {
+      x.cvisit(i, [](counting_map::value_type const&) {});
+    });
+  }
+
+  UNORDERED_AUTO_TEST (release_on_erasure) {
+    release_without_insertions([](counting_map& x, int i) { x.erase(i); });
+  }
+
+  boost::unordered::concurrent_flat_map<raii, raii>* map;
+  boost::unordered::concurrent_flat_map<int, int>* int_map;
+  boost::unordered::concurrent_flat_set<int>* int_set;
+
+} // namespace
+
+// clang-format off
+UNORDERED_TEST(
+  mid_rehash_operations,
+  ((map)))
+
+UNORDERED_TEST(
+  mid_rehash_teardown,
+  ((map)))
+
+UNORDERED_TEST(
+  concurrent_growth,
+  ((int_map)(int_set)))
+// clang-format on
+
+RUN_TESTS()
@@ -180,7 +180,9 @@ namespace {
       BOOST_TEST_EQ(raii::default_constructor, 0u);
       BOOST_TEST_EQ(raii::copy_constructor, 2 * x.size());
       // don't check move construction count here because of rehashing
-      BOOST_TEST_GT(raii::move_constructor, 0u);
+      if (grew_past_initial_capacity(x)) {
+        BOOST_TEST_GT(raii::move_constructor, 0u);
+      }
       BOOST_TEST_EQ(raii::copy_assignment, values.size() - x.size());
       BOOST_TEST_EQ(raii::move_assignment, 0u);
     }
@@ -198,7 +200,10 @@ namespace {
 
       BOOST_TEST_EQ(raii::default_constructor, 0u);
       BOOST_TEST_EQ(raii::copy_constructor, x.size());
-      BOOST_TEST_GT(raii::move_constructor, x.size()); // rehashing
+      BOOST_TEST_GE(raii::move_constructor, x.size());
+      if (grew_past_initial_capacity(x)) {
+        BOOST_TEST_GT(raii::move_constructor, x.size()); // rehashing
+      }
       BOOST_TEST_EQ(raii::copy_assignment, 0u);
       BOOST_TEST_EQ(raii::move_assignment, values.size() - x.size());
     }
@@ -216,7 +221,10 @@ namespace {
 
       BOOST_TEST_EQ(raii::default_constructor, 0u);
       BOOST_TEST_EQ(raii::copy_constructor, x.size());
-      BOOST_TEST_GT(raii::move_constructor, x.size()); // rehashing
+      BOOST_TEST_GE(raii::move_constructor, x.size());
+      if (grew_past_initial_capacity(x)) {
+        BOOST_TEST_GT(raii::move_constructor, x.size()); // rehashing
+      }
       BOOST_TEST_EQ(raii::copy_assignment, values.size() - x.size());
       BOOST_TEST_EQ(raii::move_assignment, 0u);
     }
@@ -260,7 +268,9 @@ namespace {
 
       BOOST_TEST_EQ(raii::default_constructor, x.size());
       BOOST_TEST_EQ(raii::copy_constructor, x.size());
-      BOOST_TEST_GT(raii::move_constructor, x.size()); // rehashing
+      if (grew_past_initial_capacity(x)) {
+        BOOST_TEST_GT(raii::move_constructor, x.size()); // rehashing
+      }
       BOOST_TEST_EQ(raii::copy_assignment, values.size() - x.size());
       BOOST_TEST_EQ(raii::move_assignment, 0u);
     }
@@ -284,7 +294,10 @@ namespace {
 
       BOOST_TEST_EQ(raii::default_constructor, x.size());
       BOOST_TEST_EQ(raii::copy_constructor, 0u);
-      BOOST_TEST_GT(raii::move_constructor, 2 * x.size()); // rehashing
+      BOOST_TEST_GE(raii::move_constructor, x.size());
+      if (grew_past_initial_capacity(x)) {
+        BOOST_TEST_GT(raii::move_constructor, 2 * x.size()); // rehashing
+      }
       BOOST_TEST_EQ(raii::copy_assignment, 0u);
       BOOST_TEST_EQ(raii::move_assignment, values.size() - x.size());
     }
@@ -320,7 +333,9 @@ namespace {
       BOOST_TEST_EQ(
         raii::copy_constructor, value_type_cardinality * x.size());
       // don't check move construction count here because of rehashing
-      BOOST_TEST_GT(raii::move_constructor, 0u);
+      if (grew_past_initial_capacity(x)) {
+        BOOST_TEST_GT(raii::move_constructor, 0u);
+      }
       BOOST_TEST_EQ(raii::move_assignment, 0u);
     }
   } lvalue_insert_or_cvisit;
@@ -361,7 +376,9 @@ namespace {
       BOOST_TEST_EQ(raii::default_constructor, 0u);
       BOOST_TEST_EQ(raii::copy_constructor, value_type_cardinality * x.size());
       // don't check move construction count here because of rehashing
-      BOOST_TEST_GT(raii::move_constructor, 0u);
+      if (grew_past_initial_capacity(x)) {
+        BOOST_TEST_GT(raii::move_constructor, 0u);
+      }
       BOOST_TEST_EQ(raii::move_assignment, 0u);
     }
   } lvalue_insert_or_visit;
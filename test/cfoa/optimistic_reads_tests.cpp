@@ -0,0 +1,179 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(BOOST_UNORDERED_ENABLE_OPTIMISTIC_READS)
+#define BOOST_UNORDERED_ENABLE_OPTIMISTIC_READS
+#endif
+
+#include "helpers.hpp"
+
+#include <boost/unordered/concurrent_flat_map.hpp>
+#include <boost/unordered/concurrent_flat_set.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace {
+  test::seed_t initialize_seed(271828182);
+
+  // trivially copyable mapped type spanning several words, so that torn
+  // reads would be detected as a mismatch among its members
+
+  struct wide_value
+  {
+    std::uint64_t x[8];
+
+    wide_value() = default;
+    explicit wide_value(std::uint64_t n)
+    {
+      for (auto& y : x) {
+        y = n;
+      }
+    }
+
+    bool consistent() const
+    {
+      for (auto y : x) {
+        if (y != x[0]) {
+          return false;
+        }
+      }
+      return true;
+    }
+  };
+
+  template <class X> void lookup_semantics(X*)
+  {
+    using value_type = typename X::value_type;
+
+    raii::reset_counts();
+    {
+      X x;
+      for (int i = 0; i < 1000; ++i) {
+        x.insert(value_type(raii{i}, raii{2 * i}));
+      }
+
+      for (int i = -10; i < 1010; ++i) {
+        bool found = i >= 0 && i < 1000;
+        BOOST_TEST_EQ(x.contains(raii{i}), found);
+        BOOST_TEST_EQ(x.count(raii{i}), found ? 1u : 0u);
+
+        std::size_t num_invokes = 0;
+        BOOST_TEST_EQ(x.cvisit(raii{i},
+                        [&](value_type const& v) {
+                          BOOST_TEST_EQ(v.second, raii{2 * i});
+                          ++num_invokes;
+                        }),
+          found ? 1u : 0u);
+        BOOST_TEST_EQ(num_invokes, found ? 1u : 0u);
+      }
+
+      // non-const visitation still gives access to the element itself
+      x.visit(raii{0}, [](value_type& v) { v.second = raii{-1}; });
+      x.cvisit(raii{0},
+        [](value_type const& v) { BOOST_TEST_EQ(v.second, raii{-1}); });
+    }
+    check_raii_counts();
+  }
+
+  template <class X> void int_lookup_semantics(X*)
+  {
+    X x;
+    for (int i = 0; i < 1000; ++i) {
+      x.insert(test::make_value<X>(i));
+    }
+    for (int i = 0; i < 2000; ++i) {
+      x.erase(i / 2);
+      x.insert(test::make_value<X>(i / 2 + 1000));
+    }
+
+    for (int i = 0; i < 3000; ++i) {
+      bool found = i >= 1000 && i < 2000;
+      BOOST_TEST_EQ(x.contains(i), found);
+      BOOST_TEST_EQ(x.count(i), found ? 1u : 0u);
+      BOOST_TEST_EQ(
+        x.cvisit(i,
+          [&](typename X::value_type const& v) {
+            BOOST_TEST_EQ(get_key(v), i);
+          }),
+        found ? 1u : 0u);
+    }
+  }
+
+  // Writers keep updating, erasing and reinserting elements while readers
+  // check they never observe a partially written value.
+
+  void no_torn_reads()
+  {
+    using map_type = boost::unordered::concurrent_flat_map<int, wide_value>;
+    using value_type = map_type::value_type;
+
+    int const num_keys = 1000;
+
+    map_type x;
+    for (int i = 0; i < num_keys; ++i) {
+      x.emplace(i, wide_value(0));
+    }
+
+    std::vector<int> ops;
+    for (int i = 0; i < 100000; ++i) {
+      ops.push_back(i);
+    }
+
+    std::atomic<std::size_t> num_torn{0}, num_found{0};
+
+    thread_runner(ops, [&](boost::span<int> s) {
+      for (auto i : s) {
+        int k = i % num_keys;
+        switch (i % 4) {
+        case 0:
+          x.visit(k, [](value_type& v) {
+            for (auto& y : v.second.x) {
+              ++y;
+            }
+          });
+          break;
+        case 1:
+          if (x.erase(k)) {
+            x.emplace(k, wide_value(static_cast<std::uint64_t>(i)));
+          }
+          break;
+        default:
+          num_found += x.cvisit(k, [&](value_type const& v) {
+            if (!v.second.consistent()) {
+              ++num_torn;
+            }
+          });
+          break;
+        }
+      }
+    });
+
+    BOOST_TEST_EQ(num_torn, 0u);
+    BOOST_TEST_GT(num_found, 0u);
+    BOOST_TEST_EQ(x.size(), static_cast<std::size_t>(num_keys));
+  }
+
+  boost::unordered::concurrent_flat_map<raii, raii>* map;
+  boost::unordered::concurrent_flat_map<int, int>* int_map;
+  boost::unordered::concurrent_flat_set<int>* int_set;
+
+} // namespace
+
+// clang-format off
+UNORDERED_TEST(
+  lookup_semantics,
+  ((map)))
+
+UNORDERED_TEST(
+  int_lookup_semantics,
+  ((int_map)(int_set)))
+
+UNORDERED_AUTO_TEST (no_torn_reads_) {
+  no_torn_reads();
+}
+// clang-format on
+
+RUN_TESTS()
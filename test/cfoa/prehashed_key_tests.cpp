@@ -0,0 +1,162 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "helpers.hpp"
+
+#include <boost/unordered/concurrent_flat_map.hpp>
+#include <boost/unordered/concurrent_flat_set.hpp>
+#include <boost/unordered/unordered_flat_map.hpp>
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+namespace {
+  test::seed_t initialize_seed(3571924);
+
+  template <class Handle>
+  bool try_emplace(boost::unordered::concurrent_flat_map<int, int>& x,
+    Handle const& h)
+  {
+    return x.try_emplace(h, h.key());
+  }
+
+  template <class Handle>
+  bool try_emplace(boost::unordered::concurrent_flat_set<int>& x,
+    Handle const& h)
+  {
+    return x.insert(h.key());
+  }
+
+  template <class X> void prehashed_operations(X*)
+  {
+    using value_type = typename X::value_type;
+
+    X x;
+    X const& cx = x;
+
+    int k0 = 0;
+    auto h0 = x.prehash(k0);
+    BOOST_TEST_EQ(&h0.key(), &k0);
+    x.prefetch(h0);
+    BOOST_TEST(!x.contains(h0));
+    BOOST_TEST_EQ(x.erase(h0), 0u);
+
+    for (int i = 0; i < 1000; ++i) {
+      auto h = x.prehash(i);
+      x.prefetch(h);
+      BOOST_TEST(try_emplace(x, h));
+      BOOST_TEST(!try_emplace(x, h));
+    }
+    BOOST_TEST_EQ(x.size(), 1000u);
+
+    for (int i = -100; i < 1100; ++i) {
+      auto h = cx.prehash(i);
+      std::size_t expected = i >= 0 && i < 1000 ? 1 : 0;
+      BOOST_TEST_EQ(x.contains(h), expected != 0);
+      BOOST_TEST_EQ(x.count(h), expected);
+      BOOST_TEST_EQ(x.visit(h, [&](value_type const& v) {
+        BOOST_TEST_EQ(get_key(v), i);
+      }), expected);
+      BOOST_TEST_EQ(cx.visit(h, [&](value_type const& v) {
+        BOOST_TEST_EQ(get_key(v), i);
+      }), expected);
+      BOOST_TEST_EQ(x.cvisit(h, [&](value_type const& v) {
+        BOOST_TEST_EQ(get_key(v), i);
+      }), expected);
+    }
+
+    // handles survive rehashing
+
+    auto h1 = x.prehash(k0);
+    x.rehash(10000);
+    BOOST_TEST(x.contains(h1));
+    BOOST_TEST_EQ(x.erase(h1), 1u);
+    BOOST_TEST_EQ(x.erase(h1), 0u);
+    BOOST_TEST_EQ(x.size(), 999u);
+  }
+
+  void handles_from_non_concurrent_containers()
+  {
+    boost::unordered_flat_map<int, int> m;
+    boost::unordered::concurrent_flat_map<int, int> x;
+
+    for (int i = 0; i < 1000; ++i) {
+      auto h = m.prehash(i);
+      BOOST_TEST_EQ(h.hash(), x.prehash(i).hash());
+      BOOST_TEST(x.try_emplace(h, i));
+    }
+    for (int i = 0; i < 1000; ++i) {
+      BOOST_TEST(x.contains(m.prehash(i)));
+    }
+  }
+
+  template <class X> void concurrent_prehashed_operations(X*)
+  {
+    using value_type = typename X::value_type;
+
+    std::vector<int> keys;
+    for (int i = 0; i < 100000; ++i) {
+      keys.push_back(i);
+    }
+    shuffle_values(keys);
+
+    X x;
+    std::atomic<std::size_t> num_inserted{0}, num_misses{0}, num_erased{0};
+
+    thread_runner(keys, [&](boost::span<int> s) {
+      std::vector<decltype(x.prehash(std::declval<int const&>()))> handles;
+      for (auto const& k : s) {
+        handles.push_back(x.prehash(k));
+      }
+
+      for (auto const& h : handles) {
+        x.prefetch(h);
+      }
+      for (auto const& h : handles) {
+        if (try_emplace(x, h)) {
+          ++num_inserted;
+        }
+      }
+      for (auto const& h : handles) {
+        if (x.visit(h, [](value_type const&) {}) != 1) {
+          ++num_misses;
+        }
+      }
+      for (auto const& h : handles) {
+        if (h.key() % 3 == 0) {
+          num_erased += x.erase(h);
+        }
+      }
+    });
+
+    BOOST_TEST_EQ(num_inserted, keys.size());
+    BOOST_TEST_EQ(num_misses, 0u);
+    BOOST_TEST_EQ(num_erased, (keys.size() + 2) / 3);
+    BOOST_TEST_EQ(x.size(), keys.size() - num_erased);
+    for (int k : keys) {
+      BOOST_TEST_EQ(x.contains(x.prehash(k)), k % 3 != 0);
+    }
+  }
+
+  boost::unordered::concurrent_flat_map<int, int>* map;
+  boost::unordered::concurrent_flat_set<int>* set;
+
+} // namespace
+
+// clang-format off
+UNORDERED_TEST(
+  prehashed_operations,
+  ((map)(set)))
+
+UNORDERED_TEST(
+  concurrent_prehashed_operations,
+  ((map)(set)))
+// clang-format on
+
+UNORDERED_AUTO_TEST (prehashed_key_interoperability) {
+  handles_from_non_concurrent_containers();
+}
+
+RUN_TESTS()
@@ -182,6 +182,95 @@ namespace {
 
     check_raii_counts();
   }
+
+  // Concurrent insert/erase churn at steady size while overflow metadata is
+  // rebuilt: the container never needs to grow.
+
+  template <class X, class GF>
+  void rebuild_overflow_with_churn(
+    X*, GF gen_factory, test::random_generator rg)
+  {
+    using allocator_type = typename X::allocator_type;
+
+    auto gen = gen_factory.template get<X>();
+    auto vals1 = make_random_values(1024 * 8, [&] { return gen(rg); });
+
+    auto reference_cont = reference_container<X>();
+    reference_cont.insert(vals1.begin(), vals1.end());
+
+    {
+      raii::reset_counts();
+
+      X x(vals1.begin(), vals1.end(), 0, hasher(1), key_equal(2),
+        allocator_type(3));
+      auto const bucket_count = x.bucket_count();
+      std::atomic<std::size_t> num_churns{0};
+
+      // unique keys, so that reinsertion does not change mapped values
+      std::vector<span_value_type<X> > vals2(
+        reference_cont.begin(), reference_cont.end());
+
+      thread_runner(vals2, [&](boost::span<span_value_type<X> > s) {
+        for (int i = 0; i < 10; ++i) {
+          for (auto const& val : s) {
+            if (x.erase(get_key(val))) {
+              x.insert(val);
+            }
+          }
+          if (++num_churns % 8 == 0) {
+            x.rebuild_overflow();
+          }
+        }
+      });
+
+      BOOST_TEST_EQ(x.bucket_count(), bucket_count);
+      test_matches_reference(x, reference_cont);
+
+      x.rebuild_overflow();
+      BOOST_TEST_EQ(x.bucket_count(), bucket_count);
+      test_matches_reference(x, reference_cont);
+    }
+
+    check_raii_counts();
+  }
+
+#if defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
+  template <class X, class GF>
+  void parallel_rehash(X*, GF gen_factory, test::random_generator rg)
+  {
+    using allocator_type = typename X::allocator_type;
+
+    auto gen = gen_factory.template get<X>();
+    auto vals1 = make_random_values(1024 * 8, [&] { return gen(rg); });
+
+    auto reference_cont = reference_container<X>();
+    reference_cont.insert(vals1.begin(), vals1.end());
+
+    {
+      raii::reset_counts();
+
+      X x(vals1.begin(), vals1.end(), 0, hasher(1), key_equal(2),
+        allocator_type(3));
+      X y(x);
+
+      for (std::size_t n : {0u, 100u, 10000u, 100000u, 0u}) {
+        x.rehash(std::execution::par, n);
+        y.rehash(n);
+        BOOST_TEST_EQ(x.bucket_count(), y.bucket_count());
+        BOOST_TEST_GE(x.bucket_count(), n);
+        BOOST_TEST(x == y);
+        test_matches_reference(x, reference_cont);
+
+        x.reserve(std::execution::par, n);
+        y.reserve(n);
+        BOOST_TEST_EQ(x.bucket_count(), y.bucket_count());
+        test_matches_reference(x, reference_cont);
+      }
+    }
+
+    check_raii_counts();
+  }
+#endif
 } // namespace
 
 // clang-format off
@@ -198,6 +287,20 @@ UNORDERED_TEST(
   ((test_map)(test_set))
   ((value_type_generator_factory))
   ((default_generator)(sequential)(limited_range)))
+
+UNORDERED_TEST(
+  rebuild_overflow_with_churn,
+  ((test_map)(test_set))
+  ((value_type_generator_factory))
+  ((default_generator)(sequential)(limited_range)))
+
+#if defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
+UNORDERED_TEST(
+  parallel_rehash,
+  ((test_map)(test_set))
+  ((value_type_generator_factory))
+  ((default_generator)(sequential)(limited_range)))
+#endif
 // clang-format on
 
 RUN_TESTS()
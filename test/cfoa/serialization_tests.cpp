@@ -10,8 +10,16 @@
 #include <boost/archive/xml_oarchive.hpp>
 #include <boost/archive/xml_iarchive.hpp>
 #include <boost/serialization/nvp.hpp>
+#include <boost/serialization/string.hpp>
 #include <boost/unordered/concurrent_flat_map.hpp>
 #include <boost/unordered/concurrent_flat_set.hpp>
+#include <boost/unordered/unordered_flat_map.hpp>
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace {
 
@@ -59,6 +67,147 @@ namespace {
     }
   }
 
+  template <class Container, typename ArchivePair>
+  void checkpoint_tests(
+    Container*, ArchivePair*, test::random_generator generator)
+  {
+    using output_archive = typename ArchivePair::first_type;
+    using input_archive = typename ArchivePair::second_type;
+    using chunk_type = typename Container::checkpoint_chunk;
+
+    BOOST_LIGHTWEIGHT_TEST_OSTREAM << "checkpoint_tests\n";
+    for (std::size_t n : {0, 100, 1000}) {
+      test::random_values<Container> values(n, generator);
+      Container c(values.begin(), values.end());
+
+      // each chunk is saved as a standalone container
+      for (std::size_t num_chunks : {1, 3, 200}) {
+        std::vector<std::string> chunks(num_chunks);
+        c.checkpoint(num_chunks, [&](std::size_t i, chunk_type const& chunk) {
+          std::ostringstream oss;
+          {
+            output_archive oa(oss);
+            oa << boost::serialization::make_nvp("container", chunk);
+          }
+          chunks[i] = oss.str();
+        });
+
+        Container c2;
+        for (auto const& str : chunks) {
+          Container c3;
+          std::istringstream iss(str);
+          input_archive ia(iss);
+          ia >> boost::serialization::make_nvp("container", c3);
+          auto m = c3.size();
+          BOOST_TEST_EQ(c2.merge(c3), m); // chunks are disjoint
+        }
+        BOOST_TEST(c == c2);
+      }
+
+#if defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
+      std::vector<std::string> chunks(8);
+      c.checkpoint(std::execution::par, chunks.size(),
+        [&](std::size_t i, chunk_type const& chunk) {
+          std::ostringstream oss;
+          {
+            output_archive oa(oss);
+            oa << boost::serialization::make_nvp("container", chunk);
+          }
+          chunks[i] = oss.str();
+        });
+
+      Container c2;
+      for (auto const& str : chunks) {
+        Container c3;
+        std::istringstream iss(str);
+        input_archive ia(iss);
+        ia >> boost::serialization::make_nvp("container", c3);
+        c2.merge(c3);
+      }
+      BOOST_TEST(c == c2);
+#endif
+    }
+  }
+
+  // Containers of untracked element types are loaded in bulk, which must
+  // give the same results as element-by-element loading, duplicates included.
+
+  void make_element(int i, int& x) { x = i; }
+
+  void make_element(int i, std::string& x) { x = std::to_string(i * 7); }
+
+  template <class T, class U> void make_element(int i, std::pair<T, U>& x)
+  {
+    make_element(i, x.first);
+    make_element(-i, x.second);
+  }
+
+  template <class Container, typename ArchivePair>
+  void bulk_load_tests(Container*, ArchivePair*)
+  {
+    using output_archive = typename ArchivePair::first_type;
+    using input_archive = typename ArchivePair::second_type;
+    using init_type = typename Container::init_type;
+
+    BOOST_LIGHTWEIGHT_TEST_OSTREAM << "bulk_load_tests\n";
+    for (int n : {0, 100, 10000}) {
+      Container c;
+      for (int i = 0; i < n; ++i) {
+        init_type x;
+        make_element(i, x);
+        c.insert(x);
+      }
+
+      std::ostringstream oss;
+      {
+        output_archive oa(oss);
+        oa << boost::serialization::make_nvp("container", c);
+      }
+
+      Container c2;
+      c2.insert(init_type{}); // previous contents are discarded
+      std::istringstream iss(oss.str());
+      input_archive ia(iss);
+      ia >> boost::serialization::make_nvp("container", c2);
+      BOOST_TEST(c == c2);
+    }
+  }
+
+  struct half_hash
+  {
+    std::size_t operator()(int x) const { return std::hash<int>()(x / 2); }
+  };
+
+  struct half_equal_to
+  {
+    bool operator()(int x, int y) const { return x / 2 == y / 2; }
+  };
+
+  template <typename ArchivePair> void bulk_load_duplicates_tests(ArchivePair*)
+  {
+    using output_archive = typename ArchivePair::first_type;
+    using input_archive = typename ArchivePair::second_type;
+
+    BOOST_LIGHTWEIGHT_TEST_OSTREAM << "bulk_load_duplicates_tests\n";
+    boost::concurrent_flat_set<int> c;
+    for (int i = 0; i < 10000; ++i) {
+      c.insert(i);
+    }
+
+    std::ostringstream oss;
+    {
+      output_archive oa(oss);
+      oa << boost::serialization::make_nvp("container", c);
+    }
+
+    // keys 2 * i and 2 * i + 1 are equivalent for c2
+    boost::concurrent_flat_set<int, half_hash, half_equal_to> c2;
+    std::istringstream iss(oss.str());
+    input_archive ia(iss);
+    BOOST_TEST_THROWS(ia >> boost::serialization::make_nvp("container", c2),
+      boost::unordered::detail::bad_archive_exception);
+  }
+
   using test::default_generator;
 
   std::pair<
@@ -77,6 +226,92 @@ namespace {
     ((test_flat_map)(test_flat_set))
     ((text_archive)(xml_archive))
     ((default_generator)))
+
+  UNORDERED_TEST(checkpoint_tests,
+    ((test_flat_map)(test_flat_set))
+    ((text_archive)(xml_archive))
+    ((default_generator)))
+
+  boost::concurrent_flat_map<int, int>* int_flat_map;
+  boost::concurrent_flat_map<std::string, std::string>* string_flat_map;
+  boost::concurrent_flat_set<int>* int_flat_set;
+  boost::concurrent_flat_set<std::string>* string_flat_set;
+
+  UNORDERED_TEST(bulk_load_tests,
+    ((int_flat_map)(string_flat_map)(int_flat_set)(string_flat_set))
+    ((text_archive)(xml_archive)))
+
+  UNORDERED_TEST(bulk_load_duplicates_tests,
+    ((text_archive)(xml_archive)))
+}
+
+// A checkpoint taken while a writer sets every key to value r in increasing
+// key order, for r = 1, 2, ..., is a consistent cut of the writer's history:
+// the first keys must be saved with some value r and the rest with r - 1.
+
+UNORDERED_AUTO_TEST (checkpoint_consistent_cut) {
+  using X = boost::concurrent_flat_map<int, int>;
+
+  int const num_keys = 50000;
+
+  X x;
+  for (int i = 0; i < num_keys; ++i) {
+    x.emplace(i, 0);
+  }
+
+  std::atomic<bool> done{false};
+  std::atomic<int> rounds{0};
+
+  std::thread updater([&] {
+    for (int r = 1; !done.load(); ++r) {
+      for (int i = 0; i < num_keys; ++i) {
+        x.visit(i, [&](X::value_type& v) { v.second = r; });
+      }
+      rounds.store(r);
+    }
+  });
+
+  int num_checkpoints = 0, num_errors = 0;
+  while (rounds.load() < 5 || num_checkpoints < 5) {
+    std::vector<std::string> chunks(4);
+    x.checkpoint(chunks.size(), [&](std::size_t i, X::checkpoint_chunk const& c) {
+      std::ostringstream oss;
+      {
+        boost::archive::text_oarchive oa(oss);
+        oa << boost::serialization::make_nvp("container", c);
+      }
+      chunks[i] = oss.str();
+    });
+    ++num_checkpoints;
+
+    boost::unordered_flat_map<int, int> m;
+    for (auto const& str : chunks) {
+      X y;
+      std::istringstream iss(str);
+      boost::archive::text_iarchive ia(iss);
+      ia >> boost::serialization::make_nvp("container", y);
+      y.cvisit_all([&](X::value_type const& v) { m.insert(v); });
+    }
+
+    if (m.size() != static_cast<std::size_t>(num_keys)) {
+      ++num_errors;
+      continue;
+    }
+    int r = m[0];
+    int i = 0;
+    for (; i < num_keys && m[i] == r; ++i) {
+    }
+    for (; i < num_keys && m[i] == r - 1; ++i) {
+    }
+    if (i != num_keys) {
+      ++num_errors;
+    }
+  }
+
+  done.store(true);
+  updater.join();
+
+  BOOST_TEST_EQ(num_errors, 0);
 }
 
 RUN_TESTS()
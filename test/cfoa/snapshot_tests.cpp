@@ -0,0 +1,218 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "helpers.hpp"
+
+#include <boost/unordered/concurrent_flat_map.hpp>
+#include <boost/unordered/concurrent_flat_set.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+  test::seed_t initialize_seed(70412256);
+
+  using test::default_generator;
+  using test::limited_range;
+  using test::sequential;
+
+  using hasher = stateful_hash;
+  using key_equal = stateful_key_equal;
+
+  using map_type = boost::unordered::concurrent_flat_map<raii, raii, hasher,
+    key_equal, stateful_allocator<std::pair<raii const, raii> > >;
+
+  using set_type = boost::unordered::concurrent_flat_set<raii, hasher,
+    key_equal, stateful_allocator<raii> >;
+
+  map_type* map;
+  set_type* set;
+
+  template <class X, class GF>
+  void snapshot_contents(X*, GF gen_factory, test::random_generator rg)
+  {
+    using allocator_type = typename X::allocator_type;
+
+    auto gen = gen_factory.template get<X>();
+    auto values = make_random_values(1024 * 16, [&] { return gen(rg); });
+    auto reference_cont = reference_container<X>(values.begin(), values.end());
+
+    raii::reset_counts();
+    {
+      X x(0, hasher(1), key_equal(2), allocator_type(3));
+
+      auto s = x.snapshot();
+      BOOST_TEST(s.empty());
+      BOOST_TEST_EQ(s.hash_function(), x.hash_function());
+      BOOST_TEST_EQ(s.key_eq(), x.key_eq());
+      BOOST_TEST(s.get_allocator() == x.get_allocator());
+
+      x.insert(values.begin(), values.end());
+      for (std::size_t i = 0; i < values.size(); i += 3) {
+        x.erase(get_key(values[i]));
+      }
+
+      auto y = x.snapshot();
+      BOOST_TEST_EQ(y.size(), x.size());
+      BOOST_TEST_EQ(y.hash_function(), x.hash_function());
+      BOOST_TEST_EQ(y.key_eq(), x.key_eq());
+      BOOST_TEST(y.get_allocator() == x.get_allocator());
+
+      std::size_t num_found = 0;
+      x.cvisit_all([&](typename X::value_type const& v) {
+        auto it = y.find(get_key(v));
+        if (it != y.end() && *it == v) {
+          ++num_found;
+        }
+      });
+      BOOST_TEST_EQ(num_found, x.size());
+
+      // the snapshot is a regular container, independent of x
+      auto n = x.size();
+      x.clear();
+      BOOST_TEST_EQ(y.size(), n);
+      BOOST_TEST_EQ(
+        y.size(), static_cast<std::size_t>(std::distance(y.begin(), y.end())));
+      for (auto const& v : y) {
+        BOOST_TEST(reference_cont.contains(get_key(v)));
+        if (rg == test::sequential) {
+          BOOST_TEST_EQ(v, *reference_cont.find(get_key(v)));
+        }
+      }
+      x.insert(y.begin(), y.end());
+      BOOST_TEST_EQ(x.size(), y.size());
+    }
+    check_raii_counts();
+  }
+
+  // Snapshots concurrent with insertions, erasures and growth: any element in
+  // a snapshot was in the container at some point, and snapshots requested
+  // by different threads at once do not interfere.
+
+  template <class X, class GF>
+  void concurrent_snapshots(X*, GF gen_factory, test::random_generator rg)
+  {
+    auto gen = gen_factory.template get<X>();
+    auto values = make_random_values(1024 * 16, [&] { return gen(rg); });
+    auto reference_cont = reference_container<X>(values.begin(), values.end());
+
+    raii::reset_counts();
+    {
+      X x;
+      std::atomic<std::size_t> num_errors{0};
+
+      using value_type = typename X::value_type;
+
+      thread_runner(values, [&](boost::span<value_type> s) {
+        std::size_t i = 0;
+        for (auto const& v : s) {
+          x.insert(v);
+          if (++i % 1024 == 0) {
+            auto y = x.snapshot();
+            for (auto const& w : y) {
+              if (reference_cont.find(get_key(w)) == reference_cont.end()) {
+                ++num_errors;
+              }
+            }
+          }
+          if (i % 3 == 0) {
+            x.erase(get_key(v));
+          }
+        }
+      });
+
+      BOOST_TEST_EQ(num_errors, 0u);
+      BOOST_TEST_EQ(x.snapshot().size(), x.size());
+    }
+    check_raii_counts();
+  }
+
+} // namespace
+
+// A single writer sets every key to value r in increasing key order, for
+// r = 1, 2, ..., while another one inserts new keys in increasing order.
+// As the snapshot is a consistent cut of each writer's history, the first
+// keys must be seen with some value r and the rest with r - 1, and inserted
+// keys must form a prefix of the insertion sequence.
+
+UNORDERED_AUTO_TEST (consistent_cut) {
+  using X = boost::unordered::concurrent_flat_map<int, int>;
+
+  int const num_updated = 50000;
+  int const num_inserted = 200000;
+
+  X x;
+  x.reserve(static_cast<std::size_t>(num_updated + num_inserted));
+  for (int i = 0; i < num_updated; ++i) {
+    x.emplace(i, 0);
+  }
+
+  std::atomic<bool> done{false};
+  std::atomic<int> rounds{0};
+
+  std::thread updater([&] {
+    for (int r = 1; !done.load(); ++r) {
+      for (int i = 0; i < num_updated; ++i) {
+        x.visit(i, [&](X::value_type& v) { v.second = r; });
+      }
+      rounds.store(r);
+    }
+  });
+
+  std::thread inserter([&] {
+    for (int i = num_updated; i < num_updated + num_inserted; ++i) {
+      x.emplace(i, -1);
+    }
+  });
+
+  int num_snapshots = 0, num_errors = 0;
+  while (rounds.load() < 10 || num_snapshots < 10) {
+    auto s = x.snapshot();
+    ++num_snapshots;
+
+    int r = s.at(0);
+    int i = 0;
+    for (; i < num_updated && s.at(i) == r; ++i) {
+    }
+    for (; i < num_updated && s.at(i) == r - 1; ++i) {
+    }
+    if (i != num_updated) {
+      ++num_errors;
+    }
+
+    auto n = s.size() - static_cast<std::size_t>(num_updated);
+    for (i = num_updated; i < num_updated + static_cast<int>(n); ++i) {
+      if (!s.contains(i)) {
+        ++num_errors;
+        break;
+      }
+    }
+  }
+
+  done.store(true);
+  updater.join();
+  inserter.join();
+
+  BOOST_TEST_EQ(num_errors, 0);
+  BOOST_TEST_EQ(
+    x.size(), static_cast<std::size_t>(num_updated + num_inserted));
+  BOOST_TEST_EQ(x.snapshot().size(), x.size());
+}
+
+// clang-format off
+UNORDERED_TEST(
+  snapshot_contents,
+  ((map)(set))
+  ((value_type_generator_factory))
+  ((default_generator)(sequential)(limited_range)))
+
+UNORDERED_TEST(
+  concurrent_snapshots,
+  ((map)(set))
+  ((value_type_generator_factory))
+  ((default_generator)(limited_range)))
+// clang-format on
+
+RUN_TESTS()
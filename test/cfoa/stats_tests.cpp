@@ -0,0 +1,146 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(BOOST_UNORDERED_ENABLE_STATS)
+#define BOOST_UNORDERED_ENABLE_STATS
+#endif
+
+#include "helpers.hpp"
+
+#include <boost/unordered/concurrent_flat_map.hpp>
+#include <boost/unordered/concurrent_flat_set.hpp>
+
+#include <atomic>
+#include <vector>
+
+namespace {
+  test::seed_t initialize_seed(314159265);
+
+  template <class Stats> std::size_t histogram_sum(Stats const& s)
+  {
+    std::size_t n = 0;
+    for (auto m : s.probe_length_histogram) {
+      n += m;
+    }
+    return n;
+  }
+
+  template <class X> void check_layout(X const& x)
+  {
+    auto layout = x.get_stats().layout;
+
+    std::size_t num_groups = 0, num_elements = 0;
+    for (std::size_t i = 0; i < layout.occupancy_histogram.size(); ++i) {
+      num_groups += layout.occupancy_histogram[i];
+      num_elements += i * layout.occupancy_histogram[i];
+    }
+    BOOST_TEST_EQ(num_groups, layout.num_groups);
+    BOOST_TEST_EQ(num_elements, x.size());
+    BOOST_TEST_LE(layout.num_overflowed_groups, layout.num_groups);
+  }
+
+  template <class X> void stats_tests(X*)
+  {
+    int const num_keys = 10000;
+
+    std::vector<int> keys;
+    for (int i = 0; i < num_keys; ++i) {
+      keys.push_back(i);
+    }
+    shuffle_values(keys);
+
+    // growing from scratch triggers rehashes done under exclusive access
+
+    X x;
+    thread_runner(keys, [&](boost::span<int> s) {
+      for (auto k : s) {
+        x.insert(test::make_value<X>(k));
+      }
+    });
+
+    auto stats = x.get_stats();
+    BOOST_TEST_EQ(x.size(), static_cast<std::size_t>(num_keys));
+    BOOST_TEST_GT(stats.rehash.count, 0u);
+    BOOST_TEST_GT(stats.insertion.count, x.size());
+    BOOST_TEST_EQ(histogram_sum(stats.insertion), stats.insertion.count);
+    // insertions are preceded by a lookup, retried after each rehash
+    BOOST_TEST_GE(
+      stats.unsuccessful_lookup.count, static_cast<std::size_t>(num_keys));
+    check_layout(x);
+
+    X y;
+    y.reserve(num_keys); // counts as a rehash
+    y.reset_stats();
+    thread_runner(keys, [&](boost::span<int> s) {
+      for (auto k : s) {
+        y.insert(test::make_value<X>(k));
+      }
+    });
+    stats = y.get_stats();
+    BOOST_TEST_EQ(stats.rehash.count, 0u);
+    BOOST_TEST_EQ(stats.insertion.count, static_cast<std::size_t>(num_keys));
+
+    // lookups, one at a time and in bulk, half of them successful
+
+    std::vector<int> lookup_keys;
+    for (int i = 0; i < 2 * num_keys; ++i) {
+      lookup_keys.push_back(i);
+    }
+
+    x.reset_stats();
+    std::atomic<std::size_t> num_found{0};
+    thread_runner(lookup_keys, [&](boost::span<int> s) {
+      for (auto k : s) {
+        num_found += x.count(k);
+      }
+      num_found +=
+        x.cvisit(s.begin(), s.end(), [](typename X::value_type const&) {});
+    });
+
+    stats = x.get_stats();
+    BOOST_TEST_EQ(num_found, static_cast<std::size_t>(2 * num_keys));
+    BOOST_TEST_EQ(stats.insertion.count, 0u);
+    BOOST_TEST_EQ(
+      stats.successful_lookup.count, static_cast<std::size_t>(2 * num_keys));
+    BOOST_TEST_EQ(
+      stats.unsuccessful_lookup.count, static_cast<std::size_t>(2 * num_keys));
+    BOOST_TEST_EQ(
+      histogram_sum(stats.successful_lookup), stats.successful_lookup.count);
+    BOOST_TEST_EQ(histogram_sum(stats.unsuccessful_lookup),
+      stats.unsuccessful_lookup.count);
+    BOOST_TEST_GE(stats.successful_lookup.probe_length.average, 1.0);
+    BOOST_TEST_GE(stats.successful_lookup.num_comparisons.average, 1.0);
+
+    // explicit rehash
+
+    x.reset_stats();
+    x.rehash(2 * x.bucket_count());
+    stats = x.get_stats();
+    BOOST_TEST_EQ(stats.rehash.count, 1u);
+    BOOST_TEST_EQ(stats.insertion.count, x.size());
+    check_layout(x);
+
+    x.reset_stats();
+    stats = x.get_stats();
+    BOOST_TEST_EQ(stats.insertion.count, 0u);
+    BOOST_TEST_EQ(stats.successful_lookup.count, 0u);
+    BOOST_TEST_EQ(stats.unsuccessful_lookup.count, 0u);
+    BOOST_TEST_EQ(stats.rehash.count, 0u);
+
+    X empty;
+    check_layout(empty);
+  }
+
+  boost::unordered::concurrent_flat_map<int, int>* map;
+  boost::unordered::concurrent_flat_set<int>* set;
+
+} // namespace
+
+// clang-format off
+UNORDERED_TEST(
+  stats_tests,
+  ((map)(set)))
+// clang-format on
+
+RUN_TESTS()
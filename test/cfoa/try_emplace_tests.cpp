@@ -162,7 +162,9 @@ namespace {
       BOOST_TEST_EQ(raii::default_constructor, x.size());
       BOOST_TEST_EQ(raii::copy_constructor, x.size());
       // don't check move construction count here because of rehashing
-      BOOST_TEST_GT(raii::move_constructor, 0u);
+      if (grew_past_initial_capacity(x)) {
+        BOOST_TEST_GT(raii::move_constructor, 0u);
+      }
       BOOST_TEST_EQ(raii::move_assignment, 0u);
       BOOST_TEST_EQ(raii::copy_assignment, 0u);
     }
@@ -195,7 +197,9 @@ namespace {
       BOOST_TEST_EQ(raii::default_constructor, x.size());
       BOOST_TEST_EQ(raii::copy_constructor, x.size());
       // don't check move construction count here because of rehashing
-      BOOST_TEST_GT(raii::move_constructor, 0u);
+      if (grew_past_initial_capacity(x)) {
+        BOOST_TEST_GT(raii::move_constructor, 0u);
+      }
       BOOST_TEST_EQ(raii::move_assignment, 0u);
       BOOST_TEST_EQ(raii::copy_assignment, 0u);
     }
@@ -229,7 +233,9 @@ namespace {
 
       if (std::is_same<T, typename X::value_type>::value) {
         BOOST_TEST_EQ(raii::copy_constructor, x.size());
-        BOOST_TEST_GE(raii::move_constructor, x.size());
+        if (grew_past_initial_capacity(x)) {
+          BOOST_TEST_GE(raii::move_constructor, x.size()); // rehashing
+        }
       } else {
         BOOST_TEST_EQ(raii::copy_constructor, 0u);
         BOOST_TEST_GE(raii::move_constructor, x.size());
@@ -264,7 +270,9 @@ namespace {
       BOOST_TEST_EQ(raii::default_constructor, x.size());
       if (std::is_same<T, typename X::value_type>::value) {
         BOOST_TEST_EQ(raii::copy_constructor, x.size());
-        BOOST_TEST_GE(raii::move_constructor, x.size());
+        if (grew_past_initial_capacity(x)) {
+          BOOST_TEST_GE(raii::move_constructor, x.size()); // rehashing
+        }
       } else {
         BOOST_TEST_EQ(raii::copy_constructor, 0u);
         BOOST_TEST_GE(raii::move_constructor, x.size());
@@ -7,6 +7,7 @@
 #define BOOST_UNORDERED_TEST_HELPERS_HEADER
 
 #include <iterator>
+#include <utility>
 
 namespace test {
   template <class Container> struct get_key_impl
@@ -35,6 +36,31 @@ namespace test {
     return get_key_impl<Container>::get_key(x);
   }
 
+  // test::make_value
+  //
+  // Makes a value for a container with int-constructible keys (and mapped
+  // values), with the mapped value equal to the key.
+
+  template <class Container> struct make_value_impl
+  {
+    typedef typename Container::key_type key_type;
+
+    static key_type make_value(int x, key_type const*) { return key_type(x); }
+
+    template <class K, class T>
+    static std::pair<K, T> make_value(int x, std::pair<K, T> const*)
+    {
+      return std::pair<K, T>(key_type(x), T(x));
+    }
+  };
+
+  template <class Container>
+  inline typename Container::value_type make_value(int x)
+  {
+    return make_value_impl<Container>::make_value(
+      x, static_cast<typename Container::value_type const*>(0));
+  }
+
   // test::next
   //
   // Increments an iterator by 1 or a given value.
@@ -0,0 +1,144 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(BOOST_UNORDERED_FOA_TESTS)
+#error "bulk_find_tests is currently only supported by open-addressed containers"
+#else
+
+#include "../helpers/unordered.hpp"
+
+#include "../helpers/helpers.hpp"
+#include "../helpers/random_values.hpp"
+#include "../helpers/test.hpp"
+#include "../objects/test.hpp"
+
+#include <vector>
+
+template <class X> void bulk_find_tests(X*, test::random_generator generator)
+{
+  typedef typename X::key_type key_type;
+  typedef typename X::iterator iterator;
+  typedef typename X::const_iterator const_iterator;
+
+  test::reset_sequence();
+
+  test::random_values<X> v(500, generator);
+  X x(v.begin(), v.end());
+  X const& cx = x;
+
+  // keys from v (present) interleaved with keys from v2 (likely absent)
+  test::random_values<X> v2(500, generator);
+  std::vector<key_type> keys;
+  {
+    auto it = v.begin(), it2 = v2.begin();
+    for (; it != v.end() && it2 != v2.end(); ++it, ++it2) {
+      keys.push_back(test::get_key<X>(*it));
+      keys.push_back(test::get_key<X>(*it2));
+    }
+  }
+
+  // chunk boundaries around X::bulk_lookup_size
+  std::size_t const n = X::bulk_lookup_size;
+  std::size_t const sizes[] = {
+    0, 1, n - 1, n, n + 1, 2 * n - 1, 2 * n, 3 * n + 1, keys.size()};
+
+  for (std::size_t size : sizes) {
+    auto first = keys.begin(), last = keys.begin() + (std::ptrdiff_t)size;
+
+    std::vector<iterator> its(size);
+    BOOST_TEST(x.find(first, last, its.begin()) == its.end());
+
+    std::vector<const_iterator> cits;
+    cx.find(first, last, std::back_inserter(cits));
+    BOOST_TEST_EQ(cits.size(), size);
+
+    std::vector<bool> bs;
+    cx.contains(first, last, std::back_inserter(bs));
+    BOOST_TEST_EQ(bs.size(), size);
+
+    std::size_t num_found = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+      BOOST_TEST(its[i] == x.find(keys[i]));
+      BOOST_TEST(cits[i] == cx.find(keys[i]));
+      BOOST_TEST_EQ(bs[i], cx.contains(keys[i]));
+      if (bs[i])
+        ++num_found;
+    }
+
+    std::size_t num_visited = 0;
+    BOOST_TEST_EQ(x.visit(first, last,
+                    [&](typename X::value_type const& val) {
+                      BOOST_TEST(x.find(test::get_key<X>(val)) != x.end());
+                      ++num_visited;
+                    }),
+      num_found);
+    BOOST_TEST_EQ(num_visited, num_found);
+
+    num_visited = 0;
+    BOOST_TEST_EQ(cx.visit(first, last,
+                    [&](typename X::value_type const&) { ++num_visited; }),
+      num_found);
+    BOOST_TEST_EQ(num_visited, num_found);
+  }
+}
+
+template <class X> void bulk_find_empty_tests(X*, test::random_generator)
+{
+  typedef typename X::key_type key_type;
+
+  X x;
+  std::vector<key_type> keys(3 * X::bulk_lookup_size, key_type());
+
+  std::vector<bool> bs;
+  x.contains(keys.begin(), keys.end(), std::back_inserter(bs));
+  BOOST_TEST_EQ(bs.size(), keys.size());
+  for (bool b : bs) {
+    BOOST_TEST(!b);
+  }
+
+  std::vector<typename X::iterator> its;
+  x.find(keys.begin(), keys.end(), std::back_inserter(its));
+  for (auto const& it : its) {
+    BOOST_TEST(it == x.end());
+  }
+}
+
+using test::default_generator;
+using test::generate_collisions;
+using test::limited_range;
+
+boost::unordered_flat_set<int>* int_set_ptr;
+boost::unordered_flat_map<int, int>* int_map_ptr;
+boost::unordered_flat_set<test::object, test::hash, test::equal_to,
+  test::allocator1<test::object> >* test_set_ptr;
+boost::unordered_flat_map<test::object, test::object, test::hash,
+  test::equal_to,
+  test::allocator1<std::pair<test::object const, test::object> > >*
+  test_map_ptr;
+
+boost::unordered_node_set<int>* int_node_set_ptr;
+boost::unordered_node_map<int, int>* int_node_map_ptr;
+boost::unordered_node_set<test::object, test::hash, test::equal_to,
+  test::allocator1<test::object> >* test_node_set_ptr;
+boost::unordered_node_map<test::object, test::object, test::hash,
+  test::equal_to,
+  test::allocator1<std::pair<test::object const, test::object> > >*
+  test_node_map_ptr;
+
+// clang-format off
+UNORDERED_TEST(bulk_find_tests,
+  ((int_set_ptr)(int_map_ptr)(test_set_ptr)(test_map_ptr)
+   (int_node_set_ptr)(int_node_map_ptr)
+   (test_node_set_ptr)(test_node_map_ptr))(
+    (default_generator)(generate_collisions)(limited_range)))
+
+UNORDERED_TEST(bulk_find_empty_tests,
+  ((int_set_ptr)(int_map_ptr)(test_set_ptr)(test_map_ptr)
+   (int_node_set_ptr)(int_node_map_ptr)
+   (test_node_set_ptr)(test_node_map_ptr))(
+    (default_generator)))
+// clang-format on
+#endif
+
+RUN_TESTS()
@@ -0,0 +1,197 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(BOOST_UNORDERED_FOA_TESTS)
+#error "compact_growth_tests is currently only supported by open-addressed containers"
+#else
+
+#include "../helpers/unordered.hpp"
+
+#include "../helpers/helpers.hpp"
+#include "../helpers/test.hpp"
+
+#include <boost/unordered/concurrent_flat_map.hpp>
+#include <boost/unordered/hash_traits.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace {
+  struct compact_hash : boost::hash<int>
+  {
+    using prefers_compact_growth = void;
+  };
+
+  struct compact_expensive_hash : boost::hash<int>
+  {
+    using prefers_compact_growth = void;
+    using is_expensive = void;
+  };
+
+  using boost::unordered::detail::foa::fastrange_size_policy;
+  using boost::unordered::detail::foa::skipping_quadratic_prober;
+} // namespace
+
+UNORDERED_AUTO_TEST (hash_prefers_compact_growth_trait) {
+  using boost::unordered::hash_prefers_compact_growth;
+
+  BOOST_TEST(hash_prefers_compact_growth<compact_hash>::value);
+  BOOST_TEST(hash_prefers_compact_growth<compact_expensive_hash>::value);
+  BOOST_TEST(!hash_prefers_compact_growth<boost::hash<int> >::value);
+}
+
+UNORDERED_AUTO_TEST (fastrange_size_policy_sizes) {
+  using policy = fastrange_size_policy;
+
+  BOOST_TEST_EQ(policy::size(policy::size_index(0)), policy::min_size());
+
+  std::size_t prev = 0;
+  for (std::size_t n = 0; n < 100000; ++n) {
+    std::size_t i = policy::size_index(n);
+    std::size_t s = policy::size(i);
+    BOOST_TEST_GE(s, n);
+    BOOST_TEST_GE(s, policy::min_size());
+    BOOST_TEST_EQ(policy::size_index(s), i);
+    BOOST_TEST_GE(s, prev);
+    if (s != prev) {
+      // growth factor between consecutive permissible sizes
+      if (prev >= 8) {
+        BOOST_TEST_LE(s * 100, prev * 131);
+        BOOST_TEST_GE(s * 100, prev * 120);
+      }
+      prev = s;
+    }
+  }
+
+  std::size_t const big = std::size_t(1) << (sizeof(std::size_t) * 8 - 2);
+  for (std::size_t n : {big - 1, big, big + 1, big + big / 4,
+         big + big / 4 + 1, big + big / 2 + big / 8 + 1}) {
+    std::size_t s = policy::size(policy::size_index(n));
+    BOOST_TEST_GE(s, n);
+    BOOST_TEST_LE(s / 4, n / 3);
+  }
+
+  // position maps the full hash range onto [0,size)
+  for (std::size_t s : {2u, 3u, 5u, 7u, 40u, 52u, 64u, 1000u}) {
+    BOOST_TEST_EQ(policy::position(0, s), 0u);
+    BOOST_TEST_EQ(
+      policy::position((std::numeric_limits<std::size_t>::max)(), s), s - 1);
+    BOOST_TEST_EQ(
+      policy::position(
+        ((std::numeric_limits<std::size_t>::max)() / s + 1) * (s / 2), s),
+      s / 2);
+  }
+}
+
+UNORDERED_AUTO_TEST (skipping_quadratic_prober_coverage) {
+  for (std::size_t size = 2; size < 300; ++size) {
+    std::size_t const mask = size - 1;
+    for (std::size_t pos0 = 0; pos0 < size; pos0 += 1 + size / 8) {
+      std::vector<int> visited(size, 0);
+      skipping_quadratic_prober pb(pos0);
+      do {
+        BOOST_TEST_LE(pb.get(), mask);
+        ++visited[pb.get()];
+      } while (pb.next(mask));
+
+      for (std::size_t pos = 0; pos < size; ++pos) {
+        BOOST_TEST_EQ(visited[pos], 1);
+      }
+    }
+  }
+}
+
+template <class X> void compact_growth_tests(X*)
+{
+  int const n = 100000;
+
+  X x;
+  std::size_t bc = x.bucket_count(), num_rehashes = 0;
+  for (int i = 0; i < n; ++i) {
+    x.insert(test::make_value<X>(i));
+    if (x.bucket_count() != bc) {
+      if (bc >= 1000) {
+        BOOST_TEST_LE(x.bucket_count() * 100, bc * 131);
+      }
+      bc = x.bucket_count();
+      ++num_rehashes;
+    }
+  }
+  BOOST_TEST_EQ(x.size(), static_cast<std::size_t>(n));
+  BOOST_TEST_GE(num_rehashes, 20u);
+  BOOST_TEST_LE(x.load_factor(), x.max_load_factor());
+  // a bucket array of 1.25x-1.3x the size of the previous one
+  BOOST_TEST_GE(x.load_factor() * 1.35f, x.max_load_factor());
+
+  for (int i = 0; i < 2 * n; ++i) {
+    BOOST_TEST_EQ(x.count(i), i < n ? 1u : 0u);
+  }
+
+  for (int i = 0; i < n; i += 2) {
+    x.erase(i);
+  }
+  x.rehash(0);
+  for (int i = 0; i < n; ++i) {
+    BOOST_TEST_EQ(x.count(i), static_cast<std::size_t>(i % 2));
+  }
+
+  X y(x);
+  BOOST_TEST(y == x);
+  y.rehash(3 * y.bucket_count());
+  BOOST_TEST(y == x);
+  y.reserve(0);
+  BOOST_TEST(y == x);
+
+  X z(1000);
+  BOOST_TEST_GE(z.bucket_count(), 1000u);
+  BOOST_TEST_LE(z.bucket_count(), 1300u);
+  z = std::move(y);
+  BOOST_TEST(z == x);
+}
+
+UNORDERED_AUTO_TEST (concurrent_compact_growth_tests) {
+  using concurrent_map = boost::concurrent_flat_map<int, int, compact_hash>;
+  using map = boost::unordered_flat_map<int, int, compact_hash>;
+
+  int const n = 10000;
+
+  concurrent_map x;
+  for (int i = 0; i < n; ++i) {
+    x.emplace(i, i);
+  }
+  x.rehash(x.bucket_count() * 3);
+  for (int i = 0; i < 2 * n; ++i) {
+    BOOST_TEST_EQ(x.contains(i), i < n);
+  }
+
+  map y(std::move(x));
+  BOOST_TEST_EQ(y.size(), static_cast<std::size_t>(n));
+  for (int i = 0; i < n; ++i) {
+    BOOST_TEST_EQ(y.count(i), 1u);
+  }
+
+  concurrent_map z(std::move(y));
+  BOOST_TEST_EQ(z.size(), static_cast<std::size_t>(n));
+  for (int i = 0; i < n; ++i) {
+    BOOST_TEST(z.visit(i, [i](std::pair<int const, int> const& v) {
+      BOOST_TEST_EQ(v.second, i);
+    }));
+  }
+}
+
+static boost::unordered_flat_map<int, int, compact_hash>* test_flat_map;
+static boost::unordered_flat_set<int, compact_hash>* test_flat_set;
+static boost::unordered_node_map<int, int, compact_hash>* test_node_map;
+static boost::unordered_node_set<int, compact_expensive_hash>* test_node_set;
+
+// clang-format off
+UNORDERED_TEST(compact_growth_tests,
+  ((test_flat_map)(test_flat_set)(test_node_map)(test_node_set)))
+// clang-format on
+
+#endif
+
+RUN_TESTS()
@@ -0,0 +1,159 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(BOOST_UNORDERED_FOA_TESTS)
+#error "fingerprint_tests is currently only supported by open-addressed containers"
+#else
+
+#if !defined(BOOST_UNORDERED_ENABLE_16BIT_FINGERPRINTS)
+#define BOOST_UNORDERED_ENABLE_16BIT_FINGERPRINTS
+#endif
+
+#if !defined(BOOST_UNORDERED_ENABLE_STATS)
+#define BOOST_UNORDERED_ENABLE_STATS
+#endif
+
+#include "../helpers/unordered.hpp"
+
+#include "../helpers/test.hpp"
+#include "../objects/test.hpp"
+#include "../helpers/random_values.hpp"
+#include "../helpers/tracker.hpp"
+#include "../helpers/helpers.hpp"
+#include "../helpers/invariants.hpp"
+
+#include <boost/unordered/concurrent_flat_map.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+template <class X> void group7_layout(X*)
+{
+  X x;
+  BOOST_TEST_EQ(x.bucket_count(), 0u);
+
+  test::random_values<X> v(1, test::default_generator);
+  x.insert(*v.begin());
+  BOOST_TEST_EQ(x.bucket_count(), 13u); /* 2 groups of 7 minus sentinel */
+  BOOST_TEST_EQ(x.get_stats().layout.num_groups, 2u);
+  BOOST_TEST_EQ(x.get_stats().layout.occupancy_histogram.size(), 8u);
+}
+
+template <class X>
+void fingerprint_round_trip(X*, test::random_generator generator)
+{
+  test::random_values<X> v(10000, generator);
+
+  X x;
+  for (auto const& val : v) {
+    x.insert(val);
+  }
+
+  test::check_container(x, v);
+  test::check_equivalent_keys(x);
+
+  std::size_t n = 0;
+  for (auto const& val : x) {
+    BOOST_TEST(x.find(test::get_key<X>(val)) != x.end());
+    ++n;
+  }
+  BOOST_TEST_EQ(n, x.size());
+
+  std::vector<typename X::key_type> erased;
+  bool erase = false;
+  for (auto it = x.begin(); it != x.end();) {
+    if (erase) {
+      erased.push_back(test::get_key<X>(*it));
+      it = x.erase(it);
+    } else {
+      ++it;
+    }
+    erase = !erase;
+  }
+  BOOST_TEST_EQ(x.size() + erased.size(), n);
+
+  x.rehash(x.bucket_count() * 2);
+  test::check_equivalent_keys(x);
+
+  for (auto const& k : erased) {
+    BOOST_TEST_EQ(x.count(k), 0u);
+  }
+  n = 0;
+  for (auto const& val : x) {
+    BOOST_TEST(x.find(test::get_key<X>(val)) != x.end());
+    ++n;
+  }
+  BOOST_TEST_EQ(n, x.size());
+
+  x.clear();
+  BOOST_TEST(x.empty());
+  BOOST_TEST(x.begin() == x.end());
+}
+
+UNORDERED_AUTO_TEST (fewer_spurious_comparisons) {
+  // with 16-bit fingerprints, unsuccessful lookups compare keys only once
+  // every ~32K fingerprint matches
+
+  boost::unordered_flat_map<std::string, int> x;
+  for (int i = 0; i < 100000; ++i) {
+    x.emplace(std::to_string(i), i);
+  }
+  x.reset_stats();
+  for (int i = 100000; i < 200000; ++i) {
+    BOOST_TEST(!x.contains(std::to_string(i)));
+  }
+
+  auto stats = x.get_stats();
+  BOOST_TEST_LT(stats.unsuccessful_lookup.num_comparisons.average, 0.01);
+}
+
+UNORDERED_AUTO_TEST (concurrent_interop) {
+  using map = boost::unordered_flat_map<int, int>;
+  using concurrent_map = boost::concurrent_flat_map<int, int>;
+
+  map x;
+  for (int i = 0; i < 1000; ++i) {
+    x.emplace(i, i);
+  }
+
+  concurrent_map y(std::move(x));
+  BOOST_TEST_EQ(y.size(), 1000u);
+  for (int i = 0; i < 2000; ++i) {
+    BOOST_TEST_EQ(y.contains(i), i < 1000);
+  }
+  y.erase_if([](map::value_type const& v) { return v.first % 2 != 0; });
+
+  map z(std::move(y));
+  BOOST_TEST_EQ(z.size(), 500u);
+  for (int i = 0; i < 1000; ++i) {
+    BOOST_TEST_EQ(z.contains(i), i % 2 == 0);
+  }
+}
+
+using test::default_generator;
+using test::generate_collisions;
+using test::limited_range;
+
+static boost::unordered_flat_map<test::object, test::object, test::hash,
+  test::equal_to, test::allocator1<test::object> >* test_flat_map;
+static boost::unordered_flat_set<test::object, test::hash, test::equal_to,
+  test::allocator1<test::object> >* test_flat_set;
+static boost::unordered_node_map<test::object, test::object, test::hash,
+  test::equal_to, test::allocator1<test::object> >* test_node_map;
+static boost::unordered_node_set<test::object, test::hash, test::equal_to,
+  test::allocator1<test::object> >* test_node_set;
+
+// clang-format off
+UNORDERED_TEST(group7_layout,
+  ((test_flat_map)(test_flat_set)(test_node_map)(test_node_set)))
+
+UNORDERED_TEST(fingerprint_round_trip,
+  ((test_flat_map)(test_flat_set)(test_node_map)(test_node_set))
+  ((default_generator)(generate_collisions)(limited_range)))
+// clang-format on
+
+#endif
+
+RUN_TESTS()
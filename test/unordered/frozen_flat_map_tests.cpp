@@ -0,0 +1,204 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(BOOST_UNORDERED_FOA_TESTS)
+#error "frozen_flat_map_tests is currently only supported by open-addressed containers"
+#else
+
+#include "../helpers/unordered.hpp"
+
+#include "../helpers/test.hpp"
+
+#include <boost/unordered/frozen_flat_map.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace {
+  // all keys with the same hash value
+
+  struct constant_hash
+  {
+    std::size_t operator()(int) const { return 42; }
+  };
+
+  // many keys with the same high bits of their hash value
+
+  struct bad_hash
+  {
+    using is_avalanching = void;
+
+    std::size_t operator()(int x) const
+    {
+      return static_cast<std::size_t>(x);
+    }
+  };
+
+  // keys with few distinct hash values
+
+  struct colliding_hash
+  {
+    std::size_t operator()(int x) const
+    {
+      return static_cast<std::size_t>(x % 100);
+    }
+  };
+
+  struct transparent_hash
+  {
+    using is_transparent = void;
+
+    std::size_t operator()(long x) const
+    {
+      return boost::hash<long>()(x);
+    }
+  };
+
+  struct transparent_equal_to
+  {
+    using is_transparent = void;
+
+    bool operator()(long x, long y) const { return x == y; }
+  };
+
+  template <class Map> Map make_map(int n)
+  {
+    Map m;
+    for (int i = 0; i < n; ++i) {
+      m.emplace(i * 7 - 3000, i);
+    }
+    return m;
+  }
+
+  template <class Frozen, class Map>
+  void check_frozen(Frozen const& f, Map const& m)
+  {
+    BOOST_TEST_EQ(f.size(), m.size());
+    BOOST_TEST_EQ(f.empty(), m.empty());
+    BOOST_TEST_EQ(
+      static_cast<std::size_t>(f.end() - f.begin()), f.size());
+
+    std::size_t n = 0;
+    for (auto it = f.cbegin(); it != f.cend(); ++it) {
+      BOOST_TEST(f.find(it->first) == it);
+      BOOST_TEST(m.find(it->first) != m.end());
+      ++n;
+    }
+    BOOST_TEST_EQ(n, m.size());
+
+    for (int i = -4000; i < 4000; ++i) {
+      bool found = m.contains(i);
+      BOOST_TEST_EQ(f.contains(i), found);
+      BOOST_TEST_EQ(f.count(i), found ? 1u : 0u);
+      if (found) {
+        BOOST_TEST_EQ(f.find(i)->first, i);
+        BOOST_TEST_EQ(f.at(i), m.at(i));
+      } else {
+        BOOST_TEST(f.find(i) == f.end());
+        BOOST_TEST_THROWS(f.at(i), std::out_of_range);
+      }
+    }
+  }
+
+  template <class Hash> void test_freeze()
+  {
+    using map_type = boost::unordered_flat_map<int, int, Hash>;
+
+    for (int n : {0, 1, 2, 3, 10, 100, 1000}) {
+      auto m = make_map<map_type>(n);
+
+      auto f = boost::freeze(m);
+      check_frozen(f, m);
+      BOOST_TEST_EQ(m.size(), static_cast<std::size_t>(n));
+      BOOST_TEST_LE(f.load_factor(), 1.0f);
+      if (n >= 100 && !std::is_same<Hash, constant_hash>::value) {
+        BOOST_TEST_GT(f.load_factor(), 0.95f);
+      }
+
+      auto m2 = m;
+      auto f2 = boost::freeze(std::move(m2));
+      check_frozen(f2, m);
+      BOOST_TEST(m2.empty());
+    }
+  }
+} // namespace
+
+UNORDERED_AUTO_TEST (freeze_) {
+  test_freeze<boost::hash<int> >();
+  test_freeze<bad_hash>();
+  test_freeze<colliding_hash>();
+  test_freeze<constant_hash>();
+}
+
+UNORDERED_AUTO_TEST (copy_and_move) {
+  using map_type = boost::unordered_flat_map<int, int>;
+  using frozen_type = boost::frozen_flat_map<int, int>;
+
+  auto m = make_map<map_type>(500);
+  frozen_type f(m);
+
+  frozen_type f2(f);
+  check_frozen(f2, m);
+
+  frozen_type f3(std::move(f2));
+  check_frozen(f3, m);
+  BOOST_TEST(f2.empty());
+  BOOST_TEST(f2.find(0) == f2.end());
+
+  frozen_type f4;
+  BOOST_TEST(f4.empty());
+  BOOST_TEST(!f4.contains(0));
+  f4 = f3;
+  check_frozen(f4, m);
+  f4 = std::move(f3);
+  check_frozen(f4, m);
+
+  frozen_type f5(boost::freeze(make_map<map_type>(10)));
+  swap(f4, f5);
+  BOOST_TEST_EQ(f4.size(), 10u);
+  check_frozen(f5, m);
+}
+
+UNORDERED_AUTO_TEST (transparent_lookup) {
+  boost::unordered_flat_map<long, long, transparent_hash,
+    transparent_equal_to>
+    m;
+  for (long i = 0; i < 100; ++i) {
+    m.emplace(i, i * 10);
+  }
+  auto f = boost::freeze(m);
+
+  for (int i = -10; i < 110; ++i) {
+    BOOST_TEST_EQ(f.contains(i), i >= 0 && i < 100);
+    BOOST_TEST_EQ(f.count(i), i >= 0 && i < 100 ? 1u : 0u);
+    if (f.contains(i)) {
+      BOOST_TEST_EQ(f.at(i), i * 10);
+      BOOST_TEST_EQ(f.find(i)->second, i * 10);
+    }
+  }
+}
+
+UNORDERED_AUTO_TEST (string_keys) {
+  boost::unordered_flat_map<std::string, std::unique_ptr<int> > m;
+  for (int i = 0; i < 1000; ++i) {
+    m.emplace(std::to_string(i), std::unique_ptr<int>(new int(i)));
+  }
+
+  auto f = boost::freeze(std::move(m));
+  BOOST_TEST(m.empty());
+  BOOST_TEST_EQ(f.size(), 1000u);
+  for (int i = 0; i < 1000; ++i) {
+    BOOST_TEST_EQ(*f.at(std::to_string(i)), i);
+  }
+  BOOST_TEST(!f.contains("1000"));
+  BOOST_TEST(!f.contains(""));
+}
+
+#endif
+
+RUN_TESTS()
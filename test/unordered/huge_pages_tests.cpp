@@ -0,0 +1,173 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(BOOST_UNORDERED_FOA_TESTS)
+#error "huge_pages_tests is currently only supported by open-addressed containers"
+#else
+
+#define BOOST_UNORDERED_ENABLE_HUGE_PAGES
+#define BOOST_UNORDERED_ENABLE_NUMA_INTERLEAVE
+
+#include "../helpers/unordered.hpp"
+
+#include "../helpers/helpers.hpp"
+#include "../helpers/test.hpp"
+
+#include <boost/unordered/concurrent_flat_map.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <utility>
+
+namespace {
+  // checks that arrays are deallocated with the same size they were
+  // allocated with
+
+  std::map<void*, std::size_t> allocations;
+
+  template <class T> struct tracking_allocator
+  {
+    using value_type = T;
+
+    tracking_allocator() = default;
+    template <class U> tracking_allocator(tracking_allocator<U> const&) {}
+
+    T* allocate(std::size_t n)
+    {
+      T* p = std::allocator<T>().allocate(n);
+      allocations[p] = n;
+      return p;
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+      auto it = allocations.find(p);
+      BOOST_TEST(it != allocations.end()) && BOOST_TEST_EQ(it->second, n);
+      if (it != allocations.end()) {
+        allocations.erase(it);
+      }
+      std::allocator<T>().deallocate(p, n);
+    }
+
+    bool operator==(tracking_allocator const&) const { return true; }
+    bool operator!=(tracking_allocator const&) const { return false; }
+  };
+
+  using boost::unordered::detail::foa::huge_page_size;
+} // namespace
+
+UNORDERED_AUTO_TEST (allocate_pages_tests) {
+  using boost::unordered::detail::foa::allocate_pages;
+  using boost::unordered::detail::foa::deallocate_pages;
+
+  std::allocator<std::uint64_t> al;
+  for (std::size_t n : {std::size_t(1), std::size_t(1000),
+         huge_page_size / 8 - 1, huge_page_size / 8, 3 * huge_page_size / 8,
+         10 * huge_page_size / 8 + 5}) {
+    std::uint64_t* p = allocate_pages(al, n, true);
+    BOOST_TEST(p != nullptr);
+
+#if defined(BOOST_UNORDERED_HUGE_PAGES) && defined(__cpp_aligned_new)
+    if (n * 8 >= huge_page_size) {
+      BOOST_TEST_EQ(reinterpret_cast<std::uintptr_t>(p) % huge_page_size, 0u);
+    }
+#endif
+
+    for (std::size_t i = 0; i < n; ++i) {
+      p[i] = i;
+    }
+    BOOST_TEST_EQ(p[n - 1], n - 1);
+    deallocate_pages(al, p, n);
+  }
+
+  tracking_allocator<std::uint64_t> tal;
+  std::uint64_t* p = allocate_pages(tal, huge_page_size, false);
+  p[huge_page_size - 1] = 0;
+  deallocate_pages(tal, p, huge_page_size);
+  BOOST_TEST(allocations.empty());
+}
+
+template <class X> void huge_pages_tests(X*)
+{
+  // large enough for the arrays to span several huge pages
+
+  int const n = 300000;
+
+  {
+    X x;
+    for (int i = 0; i < n; ++i) {
+      x.insert(test::make_value<X>(i));
+    }
+    BOOST_TEST_EQ(x.size(), static_cast<std::size_t>(n));
+
+    X y(x);
+    BOOST_TEST(y == x);
+    y.rehash(4 * y.bucket_count());
+    BOOST_TEST(y == x);
+
+    for (int i = 0; i < n; i += 2) {
+      x.erase(i);
+    }
+    x.rehash(0);
+    for (int i = 0; i < 2 * n; ++i) {
+      BOOST_TEST_EQ(x.count(i), (i < n && i % 2) ? 1u : 0u);
+    }
+
+    x.clear();
+    x.rehash(0);
+    BOOST_TEST(x.empty());
+  }
+  BOOST_TEST(allocations.empty());
+}
+
+template <class X> void concurrent_huge_pages_tests(X*)
+{
+  int const n = 300000;
+
+  {
+    X x;
+    for (int i = 0; i < n; ++i) {
+      x.emplace(i, i);
+    }
+    BOOST_TEST_EQ(x.size(), static_cast<std::size_t>(n));
+    x.rehash(4 * x.bucket_count());
+    for (int i = 0; i < 2 * n; ++i) {
+      BOOST_TEST_EQ(x.count(i), i < n ? 1u : 0u);
+    }
+
+    X y(x);
+    BOOST_TEST(y == x);
+    x.erase_if([](typename X::value_type const& v) { return v.first % 2; });
+    BOOST_TEST_EQ(x.size(), static_cast<std::size_t>(n / 2));
+    x.visit_all([](typename X::value_type const& v) {
+      BOOST_TEST_EQ(v.first % 2, 0);
+    });
+  }
+  BOOST_TEST(allocations.empty());
+}
+
+static boost::unordered_flat_map<int, int>* test_flat_map;
+static boost::unordered_flat_map<int, int, boost::hash<int>,
+  std::equal_to<int>, tracking_allocator<std::pair<int const, int> > >*
+  test_tracking_flat_map;
+static boost::unordered_node_set<int, boost::hash<int>, std::equal_to<int>,
+  tracking_allocator<int> >* test_tracking_node_set;
+static boost::concurrent_flat_map<int, int>* test_concurrent_map;
+static boost::concurrent_flat_map<int, int, boost::hash<int>,
+  std::equal_to<int>, tracking_allocator<std::pair<int const, int> > >*
+  test_tracking_concurrent_map;
+
+// clang-format off
+UNORDERED_TEST(huge_pages_tests,
+  ((test_flat_map)(test_tracking_flat_map)(test_tracking_node_set)))
+
+UNORDERED_TEST(concurrent_huge_pages_tests,
+  ((test_concurrent_map)(test_tracking_concurrent_map)))
+// clang-format on
+
+#endif
+
+RUN_TESTS()
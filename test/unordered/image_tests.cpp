@@ -0,0 +1,347 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(BOOST_UNORDERED_FOA_TESTS)
+#error "image_tests is currently only supported by open-addressed containers"
+#else
+
+#include "../helpers/unordered.hpp"
+
+#include "../helpers/test.hpp"
+
+#include <boost/unordered/unordered_flat_map_view.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+  // storage aligned as required by images, with an optional offset to test
+  // misaligned and relocated images
+
+  struct aligned_buffer
+  {
+    aligned_buffer(std::string const& s, std::size_t offset = 0)
+        : storage(new unsigned char[s.size() + offset + 64]), size(s.size())
+    {
+      void* p = storage.get();
+      std::size_t space = s.size() + offset + 64;
+      if (!std::align(64, s.size() + offset, p, space)) {
+        throw std::runtime_error("aligned_buffer: not enough space");
+      }
+      data = static_cast<unsigned char*>(p) + offset;
+      std::memcpy(data, s.data(), s.size());
+    }
+
+    std::unique_ptr<unsigned char[]> storage;
+    unsigned char* data;
+    std::size_t size;
+  };
+
+  template <class X> std::string image_of(X const& x)
+  {
+    std::ostringstream os;
+    boost::unordered::save_image(x, os);
+    BOOST_TEST(os.good());
+    return os.str();
+  }
+
+  struct seeded_hash
+  {
+    std::size_t seed;
+
+    std::size_t operator()(int x) const
+    {
+      return boost::hash<int>()(x) ^ seed;
+    }
+  };
+
+  struct other_hash
+  {
+    std::size_t operator()(int x) const
+    {
+      return boost::hash<int>()(x) * 3 + 1;
+    }
+  };
+
+  // state not recorded in the image, as it is not trivially copyable
+
+  struct salted_hash
+  {
+    std::string salt;
+
+    std::size_t operator()(int x) const
+    {
+      std::size_t seed = boost::hash<std::string>()(salt);
+      boost::hash_combine(seed, x);
+      return seed;
+    }
+  };
+
+  struct compact_hash : boost::hash<int>
+  {
+    using prefers_compact_growth = void;
+  };
+
+  struct point
+  {
+    int x, y;
+
+    friend bool operator==(point const& p1, point const& p2)
+    {
+      return p1.x == p2.x && p1.y == p2.y;
+    }
+
+    friend std::size_t hash_value(point const& p)
+    {
+      std::size_t seed = 0;
+      boost::hash_combine(seed, p.x);
+      boost::hash_combine(seed, p.y);
+      return seed;
+    }
+  };
+
+  struct transparent_hash
+  {
+    using is_transparent = void;
+
+    std::size_t operator()(int x) const { return boost::hash<int>()(x); }
+    std::size_t operator()(long long x) const
+    {
+      return boost::hash<int>()(static_cast<int>(x));
+    }
+  };
+
+  struct transparent_equal_to
+  {
+    using is_transparent = void;
+
+    template <class T, class U> bool operator()(T const& x, U const& y) const
+    {
+      return x == y;
+    }
+  };
+} // namespace
+
+template <class X, class View> void check_view(X const& x, View const& v)
+{
+  BOOST_TEST_EQ(v.size(), x.size());
+  BOOST_TEST_EQ(v.empty(), x.empty());
+  BOOST_TEST_EQ(v.bucket_count(), x.bucket_count());
+
+  std::size_t n = 0;
+  for (auto const& kv : v) {
+    auto it = x.find(kv.first);
+    BOOST_TEST(it != x.end());
+    if (it != x.end()) {
+      BOOST_TEST(it->second == kv.second);
+    }
+    ++n;
+  }
+  BOOST_TEST_EQ(n, x.size());
+
+  for (auto const& kv : x) {
+    auto it = v.find(kv.first);
+    BOOST_TEST(it != v.end());
+    if (it != v.end()) {
+      BOOST_TEST(it->second == kv.second);
+    }
+    BOOST_TEST(v.contains(kv.first));
+    BOOST_TEST_EQ(v.count(kv.first), 1u);
+    BOOST_TEST(v.at(kv.first) == kv.second);
+  }
+}
+
+UNORDERED_AUTO_TEST (image_round_trip) {
+  for (int size : {0, 1, 10, 1000, 100000}) {
+    boost::unordered_flat_map<int, int> x;
+    for (int i = 0; i < size; ++i) {
+      x.emplace(i * 7, i);
+    }
+    for (int i = 0; i < size; i += 3) {
+      x.erase(i * 7);
+    }
+
+    std::string image = image_of(x);
+    aligned_buffer buf(image);
+    boost::unordered_flat_map_view<int, int> v(buf.data, buf.size);
+    check_view(x, v);
+
+    for (int i = 0; i < size; ++i) {
+      BOOST_TEST_EQ(v.contains(i * 7 + 1), false);
+      BOOST_TEST_EQ(v.contains(i * 7), (i % 3 != 0));
+    }
+    BOOST_TEST_THROWS(v.at(-1), std::out_of_range);
+
+    // relocatable
+    aligned_buffer buf2(image, 128);
+    boost::unordered_flat_map_view<int, int> v2(buf2.data, buf2.size);
+    check_view(x, v2);
+  }
+}
+
+UNORDERED_AUTO_TEST (image_user_defined_types) {
+  boost::unordered_flat_map<point, double> x;
+  for (int i = 0; i < 1000; ++i) {
+    x.emplace(point{i, -i}, i / 2.0);
+  }
+
+  aligned_buffer buf(image_of(x));
+  boost::unordered_flat_map_view<point, double> v(buf.data, buf.size);
+  check_view(x, v);
+  BOOST_TEST(!v.contains(point{1, 1}));
+
+  // seeded hasher state is checked on load
+
+  boost::unordered_flat_map<int, int, seeded_hash> y(0, seeded_hash{42});
+  for (int i = 0; i < 1000; ++i) {
+    y.emplace(i, i);
+  }
+
+  aligned_buffer buf2(image_of(y));
+  boost::unordered_flat_map_view<int, int, seeded_hash> v2(
+    buf2.data, buf2.size, seeded_hash{42});
+  check_view(y, v2);
+  BOOST_TEST_EQ(v2.hash_function().seed, 42u);
+
+  BOOST_TEST_THROWS(
+    (boost::unordered_flat_map_view<int, int, seeded_hash>(
+      buf2.data, buf2.size, seeded_hash{43})),
+    std::invalid_argument);
+}
+
+UNORDERED_AUTO_TEST (image_heterogeneous_lookup) {
+  boost::unordered_flat_map<int, int, transparent_hash, transparent_equal_to>
+    x;
+  for (int i = 0; i < 100; ++i) {
+    x.emplace(i, -i);
+  }
+
+  aligned_buffer buf(image_of(x));
+  boost::unordered_flat_map_view<int, int, transparent_hash,
+    transparent_equal_to>
+    v(buf.data, buf.size);
+  check_view(x, v);
+
+  BOOST_TEST(v.contains(10LL));
+  BOOST_TEST(!v.contains(100LL));
+  BOOST_TEST_EQ(v.count(10LL), 1u);
+  BOOST_TEST_EQ(v.at(10LL), -10);
+  BOOST_TEST(v.find(10LL) == v.find(10));
+}
+
+UNORDERED_AUTO_TEST (image_compact_growth) {
+  for (int size : {0, 10, 1000, 100000}) {
+    boost::unordered_flat_map<int, int, compact_hash> x;
+    for (int i = 0; i < size; ++i) {
+      x.emplace(i, -i);
+    }
+
+    std::string image = image_of(x);
+    aligned_buffer buf(image);
+    boost::unordered_flat_map_view<int, int, compact_hash> v(
+      buf.data, buf.size);
+    check_view(x, v);
+    BOOST_TEST(!v.contains(size));
+  }
+}
+
+UNORDERED_AUTO_TEST (image_validation) {
+  boost::unordered_flat_map<int, int> x;
+  for (int i = 0; i < 1000; ++i) {
+    x.emplace(i, i);
+  }
+  std::string image = image_of(x);
+
+  using view = boost::unordered_flat_map_view<int, int>;
+
+  {
+    aligned_buffer buf(image);
+    BOOST_TEST_THROWS(view(buf.data, 0), std::invalid_argument);
+    BOOST_TEST_THROWS(view(buf.data, buf.size - 1), std::invalid_argument);
+    BOOST_TEST_THROWS(view(nullptr, buf.size), std::invalid_argument);
+  }
+
+  {
+    aligned_buffer buf(image, 8);
+    BOOST_TEST_THROWS(view(buf.data, buf.size), std::invalid_argument);
+  }
+
+  {
+    aligned_buffer buf(image);
+    buf.data[0] ^= 1; // magic
+    BOOST_TEST_THROWS(view(buf.data, buf.size), std::invalid_argument);
+  }
+
+  {
+    aligned_buffer buf(image);
+    buf.data[20] ^= 1; // group layout
+    BOOST_TEST_THROWS(view(buf.data, buf.size), std::invalid_argument);
+  }
+
+  {
+    // group array without sentinel
+    aligned_buffer buf(image);
+    std::memset(buf.data + 64, 0, buf.size - 64);
+    BOOST_TEST_THROWS(view(buf.data, buf.size), std::invalid_argument);
+  }
+
+  // mismatched value type
+  BOOST_TEST_THROWS(
+    (boost::unordered_flat_map_view<int, long long>(
+      aligned_buffer(image).data, image.size())),
+    std::invalid_argument);
+
+  // different hash function with no recorded state
+  BOOST_TEST_THROWS(
+    (boost::unordered_flat_map_view<int, int, other_hash>(
+      aligned_buffer(image).data, image.size())),
+    std::invalid_argument);
+}
+
+UNORDERED_AUTO_TEST (image_hash_function_mismatch) {
+  // no elements to look up: the hash function is told apart by its type
+
+  {
+    boost::unordered_flat_map<int, int> x;
+    std::string image = image_of(x);
+    aligned_buffer buf(image);
+
+    boost::unordered_flat_map_view<int, int> v(buf.data, buf.size);
+    BOOST_TEST(v.empty());
+    BOOST_TEST_THROWS(
+      (boost::unordered_flat_map_view<int, int, other_hash>(
+        buf.data, buf.size)),
+      std::invalid_argument);
+    BOOST_TEST_THROWS(
+      (boost::unordered_flat_map_view<int, int, compact_hash>(
+        buf.data, buf.size)),
+      std::invalid_argument);
+  }
+
+  // same type, different state not recorded in the image
+
+  using view = boost::unordered_flat_map_view<int, int, salted_hash>;
+
+  for (int n : {0, 1000}) {
+    boost::unordered_flat_map<int, int, salted_hash> x(0, salted_hash{"a"});
+    for (int i = 0; i < n; ++i) {
+      x.emplace(i, i);
+    }
+    std::string image = image_of(x);
+    aligned_buffer buf(image);
+
+    view v(buf.data, buf.size, salted_hash{"a"});
+    check_view(x, v);
+    BOOST_TEST_THROWS(
+      view(buf.data, buf.size, salted_hash{"b"}), std::invalid_argument);
+  }
+}
+
+#endif
+
+RUN_TESTS()
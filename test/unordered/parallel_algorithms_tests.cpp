@@ -0,0 +1,195 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(BOOST_UNORDERED_FOA_TESTS)
+#error "parallel_algorithms_tests is currently only supported by open-addressed containers"
+#else
+
+#if !defined(BOOST_UNORDERED_ENABLE_PARALLEL_ALGORITHMS)
+#define BOOST_UNORDERED_ENABLE_PARALLEL_ALGORITHMS
+#endif
+
+#include "../helpers/unordered.hpp"
+
+#include "../helpers/helpers.hpp"
+#include "../helpers/test.hpp"
+
+#if defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
+
+#include <atomic>
+#include <cstddef>
+#include <execution>
+#include <utility>
+#include <vector>
+
+// Plain types are used since test/objects keep track of their operations in
+// non-thread-safe global counters.
+
+namespace {
+  template <class X> void fill(X& x, int n)
+  {
+    for (int i = 0; i < n; ++i) {
+      x.insert(test::make_value<X>(i));
+    }
+  }
+
+  std::execution::sequenced_policy const& get_policy(
+    std::execution::sequenced_policy const*)
+  {
+    return std::execution::seq;
+  }
+
+  std::execution::parallel_policy const& get_policy(
+    std::execution::parallel_policy const*)
+  {
+    return std::execution::par;
+  }
+
+  // not default constructible
+  struct sum_type
+  {
+    long long n;
+
+    explicit sum_type(long long n_) : n(n_) {}
+  };
+} // namespace
+
+template <class X, class ExecPolicy>
+void parallel_visitation_tests(X*, ExecPolicy const* p)
+{
+  auto const& policy = get_policy(p);
+  using value_type = typename X::value_type;
+
+  for (int n : {0, 1, 10, 100, 20000}) {
+    X x;
+    X const& cx = x;
+    fill(x, n);
+
+    std::vector<std::atomic<int> > visited(static_cast<std::size_t>(n));
+    auto visit = [&](value_type const& v) {
+      ++visited[static_cast<std::size_t>(test::get_key<X>(v))];
+    };
+    x.visit_all(policy, visit);
+    cx.visit_all(policy, visit);
+    cx.cvisit_all(policy, visit);
+    for (auto const& c : visited) {
+      BOOST_TEST_EQ(c.load(), 3);
+    }
+
+    std::atomic<std::size_t> m{0};
+    BOOST_TEST(cx.visit_while(policy, [&](value_type const&) {
+      ++m;
+      return true;
+    }));
+    BOOST_TEST_EQ(m.load(), x.size());
+    BOOST_TEST_EQ(cx.cvisit_while(policy,
+                    [&](value_type const& v) {
+                      return test::get_key<X>(v) != n / 2;
+                    }),
+      n == 0);
+
+    BOOST_TEST_EQ(cx.count_if(policy,
+                    [](value_type const& v) {
+                      return test::get_key<X>(v) % 3 == 0;
+                    }),
+      static_cast<std::size_t>((n + 2) / 3));
+
+    long long expected = static_cast<long long>(n) * (n - 1) / 2;
+    BOOST_TEST_EQ(cx.transform_reduce(policy, 0LL, std::plus<long long>(),
+                    [](value_type const& v) { return test::get_key<X>(v); }),
+      expected);
+    BOOST_TEST_EQ(cx.transform_reduce(policy, sum_type(1),
+                      [](sum_type a, sum_type b) { return sum_type(a.n + b.n); },
+                      [](value_type const& v) {
+                        return sum_type(test::get_key<X>(v));
+                      })
+                    .n,
+      expected + 1);
+  }
+}
+
+template <class X, class ExecPolicy>
+void parallel_mutable_visitation_tests(X*, ExecPolicy const* p)
+{
+  auto const& policy = get_policy(p);
+  using value_type = typename X::value_type;
+
+  X x;
+  fill(x, 10000);
+
+  x.visit_all(policy, [](value_type& v) { v.second = v.first + 1; });
+  for (int i = 0; i < 10000; ++i) {
+    BOOST_TEST_EQ(x[i], i + 1);
+  }
+  BOOST_TEST(x.visit_while(policy, [](value_type& v) {
+    v.second = -v.second;
+    return true;
+  }));
+  for (int i = 0; i < 10000; ++i) {
+    BOOST_TEST_EQ(x[i], -(i + 1));
+  }
+}
+
+template <class X, class ExecPolicy>
+void parallel_erase_if_tests(X*, ExecPolicy const* p)
+{
+  auto const& policy = get_policy(p);
+  using value_type = typename X::value_type;
+
+  for (int n : {0, 1, 100, 20000}) {
+    X x, y;
+    fill(x, n);
+    fill(y, n);
+
+    for (int d : {7, 2, 1}) {
+      auto pred = [=](value_type const& v) {
+        return test::get_key<X>(v) % d == 0;
+      };
+
+      BOOST_TEST_EQ(x.erase_if(policy, pred), erase_if(y, pred));
+      BOOST_TEST_EQ(x.size(), y.size());
+      BOOST_TEST_EQ(x.max_load(), y.max_load());
+      BOOST_TEST(x == y);
+
+      std::size_t m = 0;
+      for (auto const& v : x) {
+        BOOST_TEST(test::get_key<X>(v) % d != 0);
+        BOOST_TEST(x.find(test::get_key<X>(v)) != x.end());
+        ++m;
+      }
+      BOOST_TEST_EQ(m, x.size());
+    }
+    BOOST_TEST(x.empty());
+
+    // table is still usable
+    fill(x, n);
+    BOOST_TEST_EQ(x.size(), static_cast<std::size_t>(n));
+  }
+}
+
+static boost::unordered_flat_map<int, int>* test_flat_map;
+static boost::unordered_flat_set<int>* test_flat_set;
+static boost::unordered_node_map<int, int>* test_node_map;
+static boost::unordered_node_set<int>* test_node_set;
+
+static std::execution::sequenced_policy const* seq_policy;
+static std::execution::parallel_policy const* par_policy;
+
+// clang-format off
+UNORDERED_TEST(parallel_visitation_tests,
+  ((test_flat_map)(test_flat_set)(test_node_map)(test_node_set))(
+    (seq_policy)(par_policy)))
+
+UNORDERED_TEST(parallel_mutable_visitation_tests,
+  ((test_flat_map)(test_node_map))((seq_policy)(par_policy)))
+
+UNORDERED_TEST(parallel_erase_if_tests,
+  ((test_flat_map)(test_flat_set)(test_node_map)(test_node_set))(
+    (seq_policy)(par_policy)))
+// clang-format on
+
+#endif
+#endif
+
+RUN_TESTS()
@@ -0,0 +1,175 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(BOOST_UNORDERED_FOA_TESTS)
+#error "parallel_rehash_tests is currently only supported by open-addressed containers"
+#else
+
+#if !defined(BOOST_UNORDERED_ENABLE_PARALLEL_ALGORITHMS)
+#define BOOST_UNORDERED_ENABLE_PARALLEL_ALGORITHMS
+#endif
+
+#include "../helpers/unordered.hpp"
+
+#include "../helpers/helpers.hpp"
+#include "../helpers/random_values.hpp"
+#include "../helpers/test.hpp"
+#include "../objects/test.hpp"
+
+#if defined(BOOST_UNORDERED_PARALLEL_ALGORITHMS)
+
+#include <atomic>
+#include <execution>
+#include <stdexcept>
+#include <string>
+
+// Allocators and element types from test/objects keep track of their
+// operations in non-thread-safe global counters, so these tests use plain
+// types instead.
+
+template <class X>
+void check_same_contents(
+  X const& x, X const& y, test::random_values<X> const& v)
+{
+  BOOST_TEST_EQ(x.size(), y.size());
+  BOOST_TEST(x == y);
+  for (auto const& val : v) {
+    BOOST_TEST(x.find(test::get_key<X>(val)) != x.end());
+  }
+
+  std::size_t n = 0;
+  for (auto it = x.begin(); it != x.end(); ++it) {
+    ++n;
+  }
+  BOOST_TEST_EQ(n, x.size());
+}
+
+template <class X>
+void parallel_rehash_tests(X*, test::random_generator generator)
+{
+  for (std::size_t size : {0u, 1u, 100u, 5000u}) {
+    test::random_values<X> v(size, generator);
+    X x(v.begin(), v.end());
+    X y(v.begin(), v.end());
+
+    for (std::size_t n : {0u, 10u, 1000u, 100000u, 0u}) {
+      x.rehash(std::execution::par, n);
+      y.rehash(n);
+      BOOST_TEST_EQ(x.bucket_count(), y.bucket_count());
+      BOOST_TEST_GE(x.bucket_count(), n);
+      check_same_contents(x, y, v);
+
+      x.reserve(std::execution::par, n);
+      y.reserve(n);
+      BOOST_TEST_EQ(x.bucket_count(), y.bucket_count());
+      check_same_contents(x, y, v);
+    }
+
+    // sequenced policy is allowed too
+    x.rehash(std::execution::seq, 2 * x.bucket_count());
+    y.rehash(2 * y.bucket_count());
+    BOOST_TEST_EQ(x.bucket_count(), y.bucket_count());
+    check_same_contents(x, y, v);
+  }
+}
+
+// hash function throwing after a given number of invocations
+
+struct throwing_hash
+{
+  static std::atomic<int> countdown;
+
+  std::size_t operator()(int x) const
+  {
+    if (--countdown == 0) {
+      throw std::runtime_error("throwing_hash");
+    }
+    return boost::hash<int>()(x);
+  }
+};
+
+std::atomic<int> throwing_hash::countdown{-1};
+
+// value type transferred by copy during rehashing
+
+struct copied_value
+{
+  int n;
+
+  copied_value(int n_) : n(n_) {}
+  copied_value(copied_value const&) = default;
+  copied_value(copied_value&& x) noexcept(false) : n(x.n) {}
+  copied_value& operator=(copied_value const&) = default;
+
+  friend bool operator==(copied_value const& x, int y) { return x.n == y; }
+  friend bool operator==(int x, copied_value const& y) { return x == y.n; }
+};
+
+template <class X> void parallel_rehash_exception_tests(X*)
+{
+  X x;
+  for (int i = 0; i < 10000; ++i) {
+    x.emplace(i, i);
+  }
+  auto bucket_count = x.bucket_count();
+  bool copied = !std::is_nothrow_move_constructible<
+    typename X::init_type>::value;
+
+  throwing_hash::countdown = 5000;
+  BOOST_TEST_THROWS(
+    x.rehash(std::execution::par, 4 * bucket_count), std::runtime_error);
+  throwing_hash::countdown = -1;
+
+  // basic guarantee: some elements may be gone, remaining ones are intact;
+  // nothing is lost when transferring by copy
+  BOOST_TEST_EQ(x.bucket_count(), bucket_count);
+  BOOST_TEST_LE(x.size(), 10000u);
+  if (copied) {
+    BOOST_TEST_EQ(x.size(), 10000u);
+  }
+  std::size_t n = 0;
+  for (auto const& kv : x) {
+    BOOST_TEST(kv.first == kv.second);
+    BOOST_TEST(x.find(kv.first) != x.end());
+    ++n;
+  }
+  BOOST_TEST_EQ(n, x.size());
+
+  for (int i = 0; i < 10000; ++i) {
+    x.emplace(i, i);
+  }
+  BOOST_TEST_EQ(x.size(), 10000u);
+}
+
+using test::default_generator;
+using test::generate_collisions;
+using test::limited_range;
+
+boost::unordered_flat_set<int>* int_set_ptr;
+boost::unordered_flat_map<int, int>* int_map_ptr;
+boost::unordered_flat_map<std::string, std::string>* string_map_ptr;
+
+boost::unordered_node_set<int>* int_node_set_ptr;
+boost::unordered_node_map<int, int>* int_node_map_ptr;
+boost::unordered_node_set<std::string>* string_node_set_ptr;
+
+boost::unordered_flat_map<int, int, throwing_hash>* throwing_map_ptr;
+boost::unordered_flat_map<int, copied_value, throwing_hash>*
+  throwing_copied_map_ptr;
+boost::unordered_node_map<int, int, throwing_hash>* throwing_node_map_ptr;
+
+// clang-format off
+UNORDERED_TEST(parallel_rehash_tests,
+  ((int_set_ptr)(int_map_ptr)(string_map_ptr)
+   (int_node_set_ptr)(int_node_map_ptr)(string_node_set_ptr))(
+    (default_generator)(generate_collisions)(limited_range)))
+
+UNORDERED_TEST(parallel_rehash_exception_tests,
+  ((throwing_map_ptr)(throwing_copied_map_ptr)(throwing_node_map_ptr)))
+// clang-format on
+
+#endif
+#endif
+
+RUN_TESTS()
@@ -0,0 +1,251 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(BOOST_UNORDERED_FOA_TESTS)
+#error "prehashed_key_tests is currently only supported by open-addressed containers"
+#else
+
+#include "../helpers/unordered.hpp"
+
+#include "../helpers/helpers.hpp"
+#include "../helpers/test.hpp"
+
+#include <boost/unordered/prehashed_key.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+  struct other_hash
+  {
+    std::size_t operator()(int x) const
+    {
+      return static_cast<std::size_t>(x) * 3u;
+    }
+  };
+
+  // heterogeneous lookup of int keys by long values
+
+  struct transparent_hash
+  {
+    using is_transparent = void;
+
+    std::size_t operator()(long x) const { return boost::hash<long>()(x); }
+  };
+
+  struct transparent_equal_to
+  {
+    using is_transparent = void;
+
+    bool operator()(long x, long y) const { return x == y; }
+  };
+
+  template <class X, class Handle, class = void>
+  struct accepts_handle : std::false_type
+  {
+  };
+
+  template <class X, class Handle>
+  struct accepts_handle<X, Handle,
+    decltype((void)std::declval<X const&>().find(
+      std::declval<Handle const&>()))>
+      : std::true_type
+  {
+  };
+
+  // handles refer to their key, so prehash rejects temporaries
+
+  template <class X, class Arg, class = void>
+  struct accepts_prehash : std::false_type
+  {
+  };
+
+  template <class X, class Arg>
+  struct accepts_prehash<X, Arg,
+    decltype((void)std::declval<X const&>().prehash(std::declval<Arg>()))>
+      : std::true_type
+  {
+  };
+
+  template <class X> void fill(X& x, int first, int last)
+  {
+    for (int i = first; i < last; ++i) {
+      x.insert(test::make_value<X>(i));
+    }
+  }
+
+  template <class X, class Handle>
+  std::pair<typename X::iterator, bool> try_emplace(X& x, Handle const& h)
+  {
+    return x.insert(h.key());
+  }
+
+  template <class K, class V, class H, class P, class A, class Handle>
+  std::pair<typename boost::unordered_flat_map<K, V, H, P, A>::iterator, bool>
+  try_emplace(boost::unordered_flat_map<K, V, H, P, A>& x, Handle const& h)
+  {
+    return x.try_emplace(h, h.key());
+  }
+
+  template <class K, class V, class H, class P, class A, class Handle>
+  std::pair<typename boost::unordered_node_map<K, V, H, P, A>::iterator, bool>
+  try_emplace(boost::unordered_node_map<K, V, H, P, A>& x, Handle const& h)
+  {
+    return x.try_emplace(h, h.key());
+  }
+} // namespace
+
+template <class X> void prehashed_lookup(X*)
+{
+  using key_type = typename X::key_type;
+  using hasher = typename X::hasher;
+  using handle_type = boost::unordered::prehashed_key<key_type, hasher>;
+
+  BOOST_STATIC_ASSERT(accepts_handle<X, handle_type>::value);
+  BOOST_STATIC_ASSERT(!accepts_handle<X,
+    boost::unordered::prehashed_key<key_type, other_hash> >::value);
+  BOOST_STATIC_ASSERT((accepts_prehash<X, key_type&>::value));
+  BOOST_STATIC_ASSERT((accepts_prehash<X, key_type const&>::value));
+  BOOST_STATIC_ASSERT((!accepts_prehash<X, key_type>::value));
+
+  X x;
+  X const& cx = x;
+
+  // empty container
+  key_type k0 = 0;
+  handle_type h0 = x.prehash(k0);
+  BOOST_TEST_EQ(&h0.key(), &k0);
+  key_type k1 = 0;
+  BOOST_TEST_EQ(h0.hash(), x.prehash(k1).hash());
+  x.prefetch(h0);
+  BOOST_TEST(x.find(h0) == x.end());
+  BOOST_TEST(!x.contains(h0));
+  BOOST_TEST_EQ(x.erase(h0), 0u);
+
+  fill(x, 0, 1000);
+  for (int i = -100; i < 1100; ++i) {
+    key_type k = i;
+    auto h = cx.prehash(k);
+    cx.prefetch(h);
+    BOOST_TEST(x.find(h) == x.find(k));
+    BOOST_TEST(cx.find(h) == cx.find(k));
+    BOOST_TEST_EQ(x.contains(h), i >= 0 && i < 1000);
+    BOOST_TEST_EQ(x.count(h), x.count(k));
+    if (x.contains(h)) {
+      BOOST_TEST_EQ(test::get_key<X>(*x.find(h)), i);
+    }
+  }
+
+  // handles survive rehashing and are usable with other containers
+  // with equal hash functions
+
+  std::vector<key_type> keys;
+  for (int i = 0; i < 2000; ++i) {
+    keys.push_back(i);
+  }
+  std::vector<handle_type> handles;
+  for (auto const& k : keys) {
+    handles.push_back(x.prehash(k));
+  }
+
+  X y;
+  for (auto const& h : handles) {
+    y.prefetch(h);
+    auto r = try_emplace(y, h);
+    BOOST_TEST(r.second);
+    BOOST_TEST_EQ(test::get_key<X>(*r.first), h.key());
+    BOOST_TEST(!try_emplace(y, h).second);
+  }
+  BOOST_TEST_EQ(y.size(), handles.size());
+
+  x.rehash(10000);
+  for (auto const& h : handles) {
+    BOOST_TEST_EQ(x.contains(h), h.key() < 1000);
+    BOOST_TEST(y.contains(h));
+  }
+
+  for (std::size_t i = 0; i < handles.size(); i += 2) {
+    BOOST_TEST_EQ(y.erase(handles[i]), 1u);
+    BOOST_TEST_EQ(y.erase(handles[i]), 0u);
+  }
+  BOOST_TEST_EQ(y.size(), handles.size() / 2);
+  for (std::size_t i = 0; i < handles.size(); ++i) {
+    BOOST_TEST_EQ(y.contains(keys[i]), i % 2 != 0);
+  }
+}
+
+template <class X> void prehashed_heterogeneous_lookup(X*)
+{
+  using hasher = typename X::hasher;
+
+  BOOST_STATIC_ASSERT((accepts_prehash<X, long&>::value));
+  BOOST_STATIC_ASSERT((!accepts_prehash<X, long>::value));
+
+  X x;
+  fill(x, 0, 100);
+
+  // mutable handles must not be picked up by transparent overloads
+
+  for (long i = 0; i < 200; ++i) {
+    boost::unordered::prehashed_key<long, hasher> h = x.prehash(i);
+    int j = static_cast<int>(i);
+    BOOST_TEST_EQ(h.hash(), x.prehash(j).hash());
+    x.prefetch(h);
+    BOOST_TEST(x.find(h) == x.find(i));
+    BOOST_TEST_EQ(x.contains(h), i < 100);
+    BOOST_TEST_EQ(x.count(h), i < 100 ? 1u : 0u);
+  }
+  for (long i = 0; i < 200; i += 2) {
+    auto h = x.prehash(i);
+    BOOST_TEST_EQ(x.erase(h), i < 100 ? 1u : 0u);
+  }
+  BOOST_TEST_EQ(x.size(), 50u);
+}
+
+template <class X> void prehashed_heterogeneous_try_emplace(X*)
+{
+  X x;
+  for (long i = 0; i < 100; ++i) {
+    auto h = x.prehash(i);
+    BOOST_TEST(x.try_emplace(h, static_cast<int>(i)).second);
+    BOOST_TEST(!x.try_emplace(h, 0).second);
+  }
+  BOOST_TEST_EQ(x.size(), 100u);
+  for (int i = 0; i < 100; ++i) {
+    BOOST_TEST_EQ(x[i], i);
+  }
+}
+
+static boost::unordered_flat_map<int, int>* test_flat_map;
+static boost::unordered_flat_set<int>* test_flat_set;
+static boost::unordered_node_map<int, int>* test_node_map;
+static boost::unordered_node_set<int>* test_node_set;
+
+static boost::unordered_flat_map<int, int, transparent_hash,
+  transparent_equal_to>* test_transparent_flat_map;
+static boost::unordered_flat_set<int, transparent_hash, transparent_equal_to>*
+  test_transparent_flat_set;
+static boost::unordered_node_map<int, int, transparent_hash,
+  transparent_equal_to>* test_transparent_node_map;
+static boost::unordered_node_set<int, transparent_hash, transparent_equal_to>*
+  test_transparent_node_set;
+
+// clang-format off
+UNORDERED_TEST(prehashed_lookup,
+  ((test_flat_map)(test_flat_set)(test_node_map)(test_node_set)))
+
+UNORDERED_TEST(prehashed_heterogeneous_lookup,
+  ((test_transparent_flat_map)(test_transparent_flat_set)
+   (test_transparent_node_map)(test_transparent_node_set)))
+
+UNORDERED_TEST(prehashed_heterogeneous_try_emplace,
+  ((test_transparent_flat_map)(test_transparent_node_map)))
+// clang-format on
+
+#endif
+
+RUN_TESTS()
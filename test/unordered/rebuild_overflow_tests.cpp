@@ -0,0 +1,200 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(BOOST_UNORDERED_FOA_TESTS)
+#error "rebuild_overflow_tests is currently only supported by open-addressed containers"
+#else
+
+#if !defined(BOOST_UNORDERED_ENABLE_STATS)
+#define BOOST_UNORDERED_ENABLE_STATS
+#endif
+
+#include "../helpers/unordered.hpp"
+
+#include "../helpers/helpers.hpp"
+#include "../helpers/random_values.hpp"
+#include "../helpers/test.hpp"
+#include "../objects/test.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+// Erases and reinserts elements at constant size until max load has drifted
+// down to the container size.
+
+template <class X>
+void churn(X& x, test::random_values<X> const& v, std::size_t num_steps)
+{
+  auto it = v.begin();
+  for (std::size_t i = 0; i < num_steps; ++i) {
+    if (it == v.end()) {
+      it = v.begin();
+    }
+    auto const& k = test::get_key<X>(*it);
+    if (x.erase(k)) {
+      x.insert(*it);
+    }
+    ++it;
+  }
+}
+
+template <class X>
+void check_contents(X const& x, X const& y, test::random_values<X> const& v,
+  test::random_values<X> const& absent)
+{
+  std::size_t n = 0;
+  for (auto const& val : x) {
+    BOOST_TEST(x.find(test::get_key<X>(val)) != x.end());
+    ++n;
+  }
+  BOOST_TEST_EQ(n, x.size());
+  for (auto const& val : v) {
+    BOOST_TEST(x.contains(test::get_key<X>(val)));
+  }
+  for (auto const& val : absent) {
+    BOOST_TEST_EQ(
+      x.count(test::get_key<X>(val)), y.count(test::get_key<X>(val)));
+  }
+}
+
+template <class X>
+void rebuild_overflow_tests(X*, test::random_generator generator)
+{
+  for (std::size_t size : {0u, 1u, 10u, 1000u}) {
+    test::random_values<X> v(size, generator), absent(100, generator);
+
+    X x(v.begin(), v.end());
+    x.rebuild_overflow();
+    BOOST_TEST_EQ(x.get_stats().layout.max_load_drift, 0u);
+
+    churn(x, v, 20 * size);
+    auto bucket_count = x.bucket_count();
+    X y(x);
+
+    std::vector<typename X::value_type const*> ptrs;
+    for (auto const& val : x) {
+      ptrs.push_back(&val);
+    }
+
+    x.rebuild_overflow();
+    BOOST_TEST_EQ(x.bucket_count(), bucket_count);
+    BOOST_TEST_EQ(x.get_stats().layout.max_load_drift, 0u);
+    BOOST_TEST_GE(x.max_load(), y.max_load());
+    BOOST_TEST(x == y);
+    check_contents(x, y, v, absent);
+
+    // elements are not moved
+    std::size_t i = 0;
+    for (auto const& val : x) {
+      BOOST_TEST_EQ(&val, ptrs[i++]);
+    }
+
+    // idempotent
+    auto num_overflowed_groups = x.get_stats().layout.num_overflowed_groups;
+    x.rebuild_overflow();
+    BOOST_TEST_EQ(
+      x.get_stats().layout.num_overflowed_groups, num_overflowed_groups);
+    BOOST_TEST(x == y);
+  }
+}
+
+// Insert/erase churn at a steady size fixes drift in place rather than
+// rehashing to the same (or lower) capacity.
+
+template <class X>
+void churn_without_rehash_tests(X*, test::random_generator generator)
+{
+  test::random_values<X> v(1000, generator), absent(100, generator);
+
+  X x(v.begin(), v.end());
+  auto bucket_count = x.bucket_count();
+  x.reset_stats();
+
+  churn(x, v, 100000);
+  BOOST_TEST_EQ(x.bucket_count(), bucket_count);
+  BOOST_TEST_EQ(x.get_stats().rehash.count, 0u);
+  check_contents(x, X(v.begin(), v.end()), v, absent);
+}
+
+// hash function throwing after a given number of invocations
+
+struct throwing_hash
+{
+  static int countdown;
+
+  std::size_t operator()(int x) const
+  {
+    if (--countdown == 0) {
+      throw std::runtime_error("throwing_hash");
+    }
+    return boost::hash<int>()(x);
+  }
+};
+
+int throwing_hash::countdown = -1;
+
+template <class X> void rebuild_overflow_exception_tests(X*)
+{
+  X x;
+  for (int i = 0; i < 1000; ++i) {
+    x.emplace(i, i);
+  }
+  for (int i = 0; i < 10000; ++i) {
+    x.erase(i % 1000);
+    x.emplace(i % 1000, i % 1000);
+  }
+  auto bucket_count = x.bucket_count();
+
+  throwing_hash::countdown = 500;
+  BOOST_TEST_THROWS(x.rebuild_overflow(), std::runtime_error);
+  throwing_hash::countdown = -1;
+
+  // all elements still reachable, next insertion fixes overflow
+  BOOST_TEST_EQ(x.size(), 1000u);
+  BOOST_TEST_EQ(x.bucket_count(), bucket_count);
+  BOOST_TEST_EQ(x.max_load(), x.size());
+  for (int i = 0; i < 2000; ++i) {
+    BOOST_TEST_EQ(x.contains(i), i < 1000);
+  }
+
+  x.emplace(1000, 1000);
+  BOOST_TEST_GT(x.max_load(), x.size());
+  BOOST_TEST_EQ(x.get_stats().layout.max_load_drift, 0u);
+  for (int i = 0; i < 2000; ++i) {
+    BOOST_TEST_EQ(x.contains(i), i <= 1000);
+  }
+}
+
+using test::default_generator;
+using test::generate_collisions;
+using test::limited_range;
+
+boost::unordered_flat_set<test::object, test::hash, test::equal_to,
+  test::allocator1<test::object> >* test_set;
+boost::unordered_flat_map<test::object, test::object, test::hash,
+  test::equal_to, test::allocator1<test::object> >* test_map;
+boost::unordered_node_set<test::object, test::hash, test::equal_to,
+  test::allocator1<test::object> >* test_node_set;
+boost::unordered_node_map<test::object, test::object, test::hash,
+  test::equal_to, test::allocator1<test::object> >* test_node_map;
+
+boost::unordered_flat_map<int, int, throwing_hash>* throwing_map;
+boost::unordered_node_map<int, int, throwing_hash>* throwing_node_map;
+
+// clang-format off
+UNORDERED_TEST(rebuild_overflow_tests,
+  ((test_set)(test_map)(test_node_set)(test_node_map))(
+    (default_generator)(generate_collisions)(limited_range)))
+
+UNORDERED_TEST(churn_without_rehash_tests,
+  ((test_set)(test_map)(test_node_set)(test_node_map))(
+    (default_generator)(limited_range)))
+
+UNORDERED_TEST(rebuild_overflow_exception_tests,
+  ((throwing_map)(throwing_node_map)))
+// clang-format on
+
+#endif
+
+RUN_TESTS()
@@ -415,7 +415,10 @@ namespace rehash_tests {
 
     typedef typename X::size_type size_type;
 
-    size_type bucket_count = 100;
+    // open-addressing tables of up to two metadata groups can be fully
+    // loaded and so be grown by rehash(0): start larger than that for the
+    // widest groups (63 slots)
+    size_type bucket_count = 1000;
     X x(bucket_count);
 
     size_type num_elems = x.bucket_count() - 1;
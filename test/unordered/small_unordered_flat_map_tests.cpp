@@ -0,0 +1,324 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(BOOST_UNORDERED_FOA_TESTS)
+#error "small_unordered_flat_map_tests is currently only supported by open-addressed containers"
+#else
+
+#include "../helpers/unordered.hpp"
+
+#include "../helpers/test.hpp"
+
+#include <boost/unordered/small_unordered_flat_map.hpp>
+#include <boost/core/detail/splitmix64.hpp>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+  std::size_t num_allocations = 0;
+
+  template <class T> struct counting_allocator
+  {
+    using value_type = T;
+
+    counting_allocator() = default;
+    template <class U> counting_allocator(counting_allocator<U> const&) {}
+
+    T* allocate(std::size_t n)
+    {
+      ++num_allocations;
+      return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+      std::allocator<T>().deallocate(p, n);
+    }
+
+    bool operator==(counting_allocator const&) const { return true; }
+    bool operator!=(counting_allocator const&) const { return false; }
+  };
+
+  bool throw_on_zero = false;
+
+  struct throwing_hash
+  {
+    std::size_t operator()(int x) const
+    {
+      if (throw_on_zero && x == 0) {
+        throw std::runtime_error("hash");
+      }
+      return boost::hash<int>()(x);
+    }
+  };
+
+  using map_type = boost::small_unordered_flat_map<int, std::string,
+    boost::hash<int>, std::equal_to<int>,
+    counting_allocator<std::pair<int const, std::string> > >;
+
+  std::size_t const inline_capacity = map_type::inline_capacity;
+
+  template <class Map> void fill(Map& x, int first, int last)
+  {
+    for (int i = first; i < last; ++i) {
+      x.emplace(i, std::to_string(i));
+    }
+  }
+
+  template <class Map> void check_range(Map const& x, int first, int last)
+  {
+    BOOST_TEST_EQ(x.size(), static_cast<std::size_t>(last - first));
+    for (int i = first - 10; i < last + 10; ++i) {
+      auto it = x.find(i);
+      if (i >= first && i < last) {
+        BOOST_TEST(it != x.end()) && BOOST_TEST_EQ(it->second, std::to_string(i));
+      } else {
+        BOOST_TEST(it == x.end());
+      }
+    }
+
+    std::size_t n = 0;
+    for (auto const& v : x) {
+      BOOST_TEST_EQ(v.second, std::to_string(v.first));
+      ++n;
+    }
+    BOOST_TEST_EQ(n, x.size());
+  }
+} // namespace
+
+UNORDERED_AUTO_TEST (inline_storage) {
+  BOOST_TEST_GT(inline_capacity, 0u);
+
+  num_allocations = 0;
+  {
+    map_type x;
+    BOOST_TEST(x.is_inline());
+    BOOST_TEST(x.empty());
+    BOOST_TEST(x.begin() == x.end());
+    BOOST_TEST_EQ(x.bucket_count(), inline_capacity);
+    BOOST_TEST(x.find(0) == x.end());
+
+    fill(x, 0, static_cast<int>(inline_capacity));
+    BOOST_TEST(x.is_inline());
+    check_range(x, 0, static_cast<int>(inline_capacity));
+    BOOST_TEST(!x.emplace(0, "").second);
+
+    x.erase(0);
+    x.erase(x.find(1));
+    check_range(x, 2, static_cast<int>(inline_capacity));
+    fill(x, static_cast<int>(inline_capacity),
+      static_cast<int>(inline_capacity) + 2);
+    BOOST_TEST(x.is_inline());
+    check_range(x, 2, static_cast<int>(inline_capacity) + 2);
+
+    x.clear();
+    BOOST_TEST(x.empty());
+    BOOST_TEST(x.begin() == x.end());
+  }
+  BOOST_TEST_EQ(num_allocations, 0u);
+}
+
+UNORDERED_AUTO_TEST (spill_to_heap) {
+  int const n = static_cast<int>(inline_capacity);
+
+  num_allocations = 0;
+  map_type x;
+  fill(x, 0, n);
+  BOOST_TEST(x.is_inline());
+
+  x.emplace(n, std::to_string(n));
+  BOOST_TEST(!x.is_inline());
+  BOOST_TEST_GT(num_allocations, 0u);
+  BOOST_TEST_GT(x.bucket_count(), inline_capacity);
+  check_range(x, 0, n + 1);
+
+  fill(x, n + 1, 1000);
+  check_range(x, 0, 1000);
+
+  // back to inline storage only once the bucket array is released
+  x.clear();
+  BOOST_TEST(!x.is_inline());
+  x.rehash(0);
+  BOOST_TEST(x.is_inline());
+  fill(x, 0, n);
+  check_range(x, 0, n);
+
+  // reserve and large bucket counts go directly to the heap
+  x.reserve(inline_capacity);
+  BOOST_TEST(x.is_inline());
+  x.reserve(inline_capacity + 1);
+  BOOST_TEST(!x.is_inline());
+  check_range(x, 0, n);
+
+  map_type y(100);
+  BOOST_TEST(!y.is_inline());
+  map_type z(inline_capacity);
+  BOOST_TEST(z.is_inline());
+}
+
+UNORDERED_AUTO_TEST (spill_with_aliased_argument) {
+  // the new element is constructed before inline elements are moved out
+  int const n = static_cast<int>(inline_capacity);
+
+  map_type x;
+  fill(x, 0, n);
+  x.try_emplace(n, x.find(0)->second);
+  BOOST_TEST(!x.is_inline());
+  BOOST_TEST_EQ(x.size(), inline_capacity + 1);
+  BOOST_TEST_EQ(x[n], std::string("0"));
+  x.erase(n);
+  check_range(x, 0, n);
+}
+
+UNORDERED_AUTO_TEST (spill_exception_safety) {
+  using throwing_map =
+    boost::small_unordered_flat_map<int, std::string, throwing_hash>;
+
+  int const n = static_cast<int>(throwing_map::inline_capacity);
+
+  throwing_map x;
+  fill(x, 0, n);
+
+  // hashing of inline elements throws while spilling
+  throw_on_zero = true;
+  BOOST_TEST_THROWS(x.emplace(n, ""), std::runtime_error);
+  BOOST_TEST_THROWS(x.reserve(1000), std::runtime_error);
+  throw_on_zero = false;
+
+  BOOST_TEST(x.is_inline());
+  check_range(x, 0, n);
+}
+
+UNORDERED_AUTO_TEST (copy_move_swap) {
+  int const n = static_cast<int>(inline_capacity);
+
+  map_type inl, heap;
+  fill(inl, 0, n);
+  fill(heap, 0, 100);
+
+  map_type x(inl);
+  BOOST_TEST(x.is_inline());
+  BOOST_TEST(x == inl);
+  check_range(x, 0, n);
+
+  map_type y(heap);
+  BOOST_TEST(y == heap);
+  BOOST_TEST(x != y);
+
+  map_type z(std::move(x));
+  BOOST_TEST(z.is_inline());
+  BOOST_TEST(z == inl);
+  BOOST_TEST(x.empty());
+
+  x = heap;
+  BOOST_TEST(x == heap);
+  x = inl;
+  BOOST_TEST(x.is_inline());
+  BOOST_TEST(x == inl);
+  x = std::move(y);
+  BOOST_TEST(x == heap);
+  BOOST_TEST(y.empty());
+  x = std::move(z);
+  BOOST_TEST(x.is_inline());
+  BOOST_TEST(x == inl);
+  BOOST_TEST(z.empty());
+
+  x.swap(y);
+  BOOST_TEST(x.empty());
+  BOOST_TEST(y == inl);
+  y.swap(heap);
+  BOOST_TEST(y.size() == 100u);
+  BOOST_TEST(heap.is_inline());
+  check_range(heap, 0, n);
+  swap(y, heap);
+  check_range(y, 0, n);
+  check_range(heap, 0, 100);
+
+  map_type w{{1, "1"}, {2, "2"}, {3, "3"}};
+  BOOST_TEST(w.is_inline());
+  check_range(w, 1, 4);
+  w = {{4, "4"}};
+  check_range(w, 4, 5);
+}
+
+UNORDERED_AUTO_TEST (erase_if_tests) {
+  int const n = static_cast<int>(inline_capacity);
+
+  map_type x;
+  fill(x, 0, n);
+  BOOST_TEST_EQ(
+    erase_if(x, [](map_type::value_type const& v) { return v.first % 2; }),
+    inline_capacity / 2);
+  for (int i = 0; i < n; ++i) {
+    BOOST_TEST_EQ(x.contains(i), i % 2 == 0);
+  }
+
+  fill(x, 0, 100);
+  BOOST_TEST(!x.is_inline());
+  BOOST_TEST_EQ(
+    erase_if(x, [](map_type::value_type const& v) { return v.first % 2; }),
+    50u);
+  for (int i = 0; i < 100; ++i) {
+    BOOST_TEST_EQ(x.contains(i), i % 2 == 0);
+  }
+}
+
+UNORDERED_AUTO_TEST (random_operations) {
+  // compared against std::map over key ranges around the inline capacity
+
+  boost::detail::splitmix64 rng;
+
+  for (std::size_t range : {inline_capacity / 2, inline_capacity,
+         inline_capacity + 1, 4 * inline_capacity}) {
+    map_type x;
+    std::map<int, std::string> m;
+
+    for (int i = 0; i < 10000; ++i) {
+      int k = static_cast<int>(rng() % range);
+      switch (rng() % 5) {
+      case 0:
+      case 1:
+        BOOST_TEST_EQ(x.emplace(k, std::to_string(i)).second,
+          m.emplace(k, std::to_string(i)).second);
+        break;
+      case 2:
+        BOOST_TEST_EQ(x.erase(k), m.erase(k));
+        break;
+      case 3:
+        x[k] = std::to_string(i);
+        m[k] = std::to_string(i);
+        break;
+      default:
+        if (rng() % 100 == 0) {
+          x.clear();
+          m.clear();
+          if (rng() % 2) {
+            x.rehash(0);
+            BOOST_TEST(x.is_inline());
+          }
+        }
+        break;
+      }
+
+      BOOST_TEST_EQ(x.size(), m.size());
+    }
+
+    std::size_t n = 0;
+    for (auto const& v : x) {
+      auto it = m.find(v.first);
+      BOOST_TEST(it != m.end()) && BOOST_TEST_EQ(it->second, v.second);
+      ++n;
+    }
+    BOOST_TEST_EQ(n, m.size());
+  }
+}
+
+#endif
+
+RUN_TESTS()
@@ -0,0 +1,367 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(BOOST_UNORDERED_FOA_TESTS)
+#error "split_unordered_flat_map_tests is currently only supported by open-addressed containers"
+#else
+
+#include "../helpers/unordered.hpp"
+
+#include "../helpers/test.hpp"
+
+#include <boost/unordered/split_unordered_flat_map.hpp>
+#include <boost/core/detail/splitmix64.hpp>
+
+#include <array>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+  // stateful allocator: instances with different ids don't compare equal
+
+  template <class T> struct id_allocator
+  {
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::false_type;
+
+    int id = 0;
+
+    id_allocator() = default;
+    explicit id_allocator(int id_) : id(id_) {}
+    template <class U> id_allocator(id_allocator<U> const& x) : id(x.id) {}
+
+    T* allocate(std::size_t n) { return std::allocator<T>().allocate(n); }
+
+    void deallocate(T* p, std::size_t n)
+    {
+      std::allocator<T>().deallocate(p, n);
+    }
+
+    bool operator==(id_allocator const& x) const { return id == x.id; }
+    bool operator!=(id_allocator const& x) const { return id != x.id; }
+  };
+
+  using map_type = boost::split_unordered_flat_map<int, std::string,
+    boost::hash<int>, std::equal_to<int>,
+    id_allocator<std::pair<int const, std::string> > >;
+
+  // mapped type with a throwing copy constructor and no noexcept move,
+  // so that rehashing copies elements
+
+  int copies_until_throw = -1;
+
+  struct throwing_value
+  {
+    int x = 0;
+
+    throwing_value() = default;
+    explicit throwing_value(int x_) : x(x_) {}
+    throwing_value(throwing_value const& v) : x(v.x)
+    {
+      if (copies_until_throw >= 0 && copies_until_throw-- == 0) {
+        throw std::runtime_error("copy");
+      }
+    }
+    throwing_value(throwing_value&& v) : throwing_value(v) {}
+    throwing_value& operator=(throwing_value const&) = default;
+
+    bool operator==(throwing_value const& v) const { return x == v.x; }
+  };
+
+  template <class Map> void fill(Map& x, int first, int last)
+  {
+    for (int i = first; i < last; ++i) {
+      x.emplace(i, std::to_string(i));
+    }
+  }
+
+  template <class Map> void check_range(Map const& x, int first, int last)
+  {
+    BOOST_TEST_EQ(x.size(), static_cast<std::size_t>(last - first));
+    for (int i = first - 10; i < last + 10; ++i) {
+      auto it = x.find(i);
+      if (i >= first && i < last) {
+        BOOST_TEST(it != x.end()) &&
+          BOOST_TEST_EQ(it->second, std::to_string(i));
+      } else {
+        BOOST_TEST(it == x.end());
+      }
+    }
+
+    std::size_t n = 0;
+    for (auto v : x) {
+      BOOST_TEST_EQ(v.second, std::to_string(v.first));
+      ++n;
+    }
+    BOOST_TEST_EQ(n, x.size());
+  }
+} // namespace
+
+UNORDERED_AUTO_TEST (proxy_references) {
+  map_type x;
+  BOOST_TEST(x.empty());
+  BOOST_TEST(x.begin() == x.end());
+  BOOST_TEST(x.find(0) == x.end());
+
+  auto r = x.emplace(1, "one");
+  BOOST_TEST(r.second);
+  BOOST_TEST_EQ(r.first->first, 1);
+  BOOST_TEST_EQ((*r.first).second, std::string("one"));
+
+  // references point into the container
+  map_type::reference ref = *r.first;
+  ref.second = "uno";
+  BOOST_TEST_EQ(x.at(1), std::string("uno"));
+  r.first->second += "!";
+  BOOST_TEST_EQ(x[1], std::string("uno!"));
+
+  map_type::const_iterator cit = r.first;
+  map_type::const_reference cref = *cit;
+  BOOST_TEST_EQ(&cref.second, &x[1]);
+  BOOST_TEST(cit == x.cbegin());
+  BOOST_TEST(++cit == x.cend());
+
+  BOOST_TEST(!x.emplace(1, "").second);
+  BOOST_TEST(!x.try_emplace(1, "").second);
+  BOOST_TEST(!x.insert_or_assign(1, "ein").second);
+  BOOST_TEST_EQ(x[1], std::string("ein"));
+  BOOST_TEST(x.insert(std::make_pair(2, std::string("two"))).second);
+  BOOST_TEST(x.emplace(std::piecewise_construct, std::make_tuple(3),
+                std::make_tuple(3, 'x'))
+               .second);
+  BOOST_TEST_EQ(x[3], std::string("xxx"));
+  BOOST_TEST_EQ(x.count(2), 1u);
+  BOOST_TEST(x.contains(3));
+  BOOST_TEST_THROWS(x.at(4), std::out_of_range);
+
+  auto er = x.equal_range(2);
+  BOOST_TEST(er.first != er.second);
+  BOOST_TEST_EQ(er.first->second, std::string("two"));
+}
+
+UNORDERED_AUTO_TEST (growth_and_erasure) {
+  map_type x;
+  fill(x, 0, 10000);
+  check_range(x, 0, 10000);
+  BOOST_TEST_LE(x.size(), x.max_load());
+
+  for (int i = 0; i < 5000; ++i) {
+    BOOST_TEST_EQ(x.erase(i), 1u);
+  }
+  BOOST_TEST_EQ(x.erase(0), 0u);
+  check_range(x, 5000, 10000);
+
+  auto it = x.erase(x.begin(), x.find(x.begin()->first));
+  BOOST_TEST(it == x.begin());
+  while (x.size() > 100) {
+    x.erase(x.begin());
+  }
+  BOOST_TEST_EQ(x.size(), 100u);
+
+  x.clear();
+  fill(x, 0, 1000);
+  x.rehash(0);
+  check_range(x, 0, 1000);
+  x.reserve(100000);
+  BOOST_TEST_GE(x.bucket_count(), 100000u);
+  check_range(x, 0, 1000);
+
+  x.clear();
+  x.rehash(0);
+  BOOST_TEST_EQ(x.bucket_count(), 0u);
+  fill(x, 0, 10);
+  check_range(x, 0, 10);
+}
+
+UNORDERED_AUTO_TEST (large_mapped_values) {
+  using big = std::array<unsigned char, 200>;
+
+  boost::split_unordered_flat_map<std::size_t, big> x;
+  for (std::size_t i = 0; i < 3000; ++i) {
+    big b;
+    b.fill(static_cast<unsigned char>(i));
+    x.emplace(i, b);
+  }
+  BOOST_TEST_EQ(x.size(), 3000u);
+  for (std::size_t i = 0; i < 3000; ++i) {
+    auto it = x.find(i);
+    BOOST_TEST(it != x.end()) &&
+      BOOST_TEST_EQ(it->second[199], static_cast<unsigned char>(i));
+  }
+}
+
+UNORDERED_AUTO_TEST (copy_move_swap) {
+  map_type a, b;
+  fill(a, 0, 100);
+  fill(b, 50, 60);
+
+  map_type x(a);
+  BOOST_TEST(x == a);
+  BOOST_TEST(x != b);
+  x.begin()->second = "";
+  BOOST_TEST(x != a);
+
+  map_type y(std::move(x));
+  BOOST_TEST(x.empty());
+  BOOST_TEST_EQ(y.size(), 100u);
+
+  x = b;
+  check_range(x, 50, 60);
+  x = a;
+  check_range(x, 0, 100);
+  x = std::move(y);
+  BOOST_TEST_EQ(x.size(), 100u);
+  BOOST_TEST(y.empty());
+
+  x.swap(b);
+  check_range(x, 50, 60);
+  swap(x, a);
+  check_range(x, 0, 100);
+  check_range(a, 50, 60);
+
+  map_type w{{1, "1"}, {2, "2"}, {3, "3"}};
+  check_range(w, 1, 4);
+  w = {{4, "4"}};
+  check_range(w, 4, 5);
+
+  map_type z(w.begin(), w.end());
+  BOOST_TEST(z == w);
+}
+
+UNORDERED_AUTO_TEST (unequal_allocators) {
+  using allocator_type = map_type::allocator_type;
+
+  map_type x(allocator_type(1));
+  fill(x, 0, 1000);
+
+  // move with unequal allocators moves elements one by one
+
+  map_type y(std::move(x), allocator_type(2));
+  BOOST_TEST_EQ(y.get_allocator().id, 2);
+  BOOST_TEST(x.empty());
+  check_range(y, 0, 1000);
+
+  map_type z(allocator_type(3));
+  fill(z, 0, 10);
+  z = std::move(y);
+  BOOST_TEST_EQ(z.get_allocator().id, 3);
+  BOOST_TEST(y.empty());
+  check_range(z, 0, 1000);
+
+  map_type w(z, allocator_type(4));
+  BOOST_TEST_EQ(w.get_allocator().id, 4);
+  BOOST_TEST(w == z);
+}
+
+UNORDERED_AUTO_TEST (exception_safety) {
+  using throwing_map = boost::split_unordered_flat_map<int, throwing_value>;
+
+  throwing_map x;
+  for (int i = 0; i < 100; ++i) {
+    x.emplace(i, throwing_value(i));
+  }
+
+  // copying of a mapped value throws midway through rehashing
+
+  for (int k : {0, 1, 50, 99}) {
+    copies_until_throw = k;
+    BOOST_TEST_THROWS(x.rehash(1000), std::runtime_error);
+    copies_until_throw = -1;
+
+    BOOST_TEST_EQ(x.size(), 100u);
+    for (int i = 0; i < 100; ++i) {
+      auto it = x.find(i);
+      BOOST_TEST(it != x.end()) && BOOST_TEST_EQ(it->second.x, i);
+    }
+  }
+
+  // and on insertion with growth: the container is left unchanged
+
+  while (x.size() < x.max_load()) {
+    int i = static_cast<int>(x.size());
+    x.emplace(i, throwing_value(i));
+  }
+  std::size_t const n = x.size();
+  throwing_value v(-1);
+  for (int k : {0, 1, 10}) {
+    copies_until_throw = k;
+    BOOST_TEST_THROWS(x.emplace(-1, v), std::runtime_error);
+    copies_until_throw = -1;
+    BOOST_TEST_EQ(x.size(), n);
+    BOOST_TEST(!x.contains(-1));
+  }
+  x.emplace(-1, v);
+  BOOST_TEST_EQ(x.size(), n + 1);
+}
+
+UNORDERED_AUTO_TEST (erase_if_tests) {
+  map_type x;
+  fill(x, 0, 100);
+  BOOST_TEST_EQ(
+    erase_if(x, [](map_type::const_reference v) { return v.first % 2; }),
+    50u);
+  for (int i = 0; i < 100; ++i) {
+    BOOST_TEST_EQ(x.contains(i), i % 2 == 0);
+  }
+
+  BOOST_TEST_EQ(erase_if(x,
+                  [](map_type::reference v) {
+                    return v.second == std::to_string(v.first);
+                  }),
+    50u);
+  BOOST_TEST(x.empty());
+}
+
+UNORDERED_AUTO_TEST (random_operations) {
+  // compared against std::map
+
+  boost::detail::splitmix64 rng;
+
+  for (std::size_t range : {10u, 100u, 10000u}) {
+    map_type x;
+    std::map<int, std::string> m;
+
+    for (int i = 0; i < 20000; ++i) {
+      int k = static_cast<int>(rng() % range);
+      switch (rng() % 5) {
+      case 0:
+      case 1:
+        BOOST_TEST_EQ(x.emplace(k, std::to_string(i)).second,
+          m.emplace(k, std::to_string(i)).second);
+        break;
+      case 2:
+        BOOST_TEST_EQ(x.erase(k), m.erase(k));
+        break;
+      case 3:
+        x[k] = std::to_string(i);
+        m[k] = std::to_string(i);
+        break;
+      default:
+        if (rng() % 1000 == 0) {
+          x.clear();
+          m.clear();
+        }
+        break;
+      }
+
+      BOOST_TEST_EQ(x.size(), m.size());
+    }
+
+    std::size_t n = 0;
+    for (auto v : x) {
+      auto it = m.find(v.first);
+      BOOST_TEST(it != m.end()) && BOOST_TEST_EQ(it->second, v.second);
+      ++n;
+    }
+    BOOST_TEST_EQ(n, m.size());
+  }
+}
+
+#endif
+
+RUN_TESTS()
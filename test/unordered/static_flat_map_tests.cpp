@@ -0,0 +1,246 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(BOOST_UNORDERED_FOA_TESTS)
+#error "static_flat_map_tests is currently only supported by open-addressed containers"
+#else
+
+#include <boost/config.hpp>
+#include <boost/config/pragma_message.hpp>
+
+#if defined(BOOST_NO_CXX14_CONSTEXPR)
+
+BOOST_PRAGMA_MESSAGE("Test skipped because C++14 constexpr is not available.")
+
+#include "../helpers/test.hpp"
+
+#else
+
+#include "../helpers/unordered.hpp"
+
+#include "../helpers/helpers.hpp"
+#include "../helpers/test.hpp"
+
+#include <boost/unordered/static_flat_map.hpp>
+#include <boost/unordered/static_flat_set.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if !defined(BOOST_NO_CXX17_HDR_STRING_VIEW)
+#include <string_view>
+#endif
+
+namespace {
+  template <class Hash, std::size_t... Is>
+  constexpr boost::static_flat_map<int, int, sizeof...(Is), Hash> make_map(
+    std::index_sequence<Is...>)
+  {
+    return boost::static_flat_map<int, int, sizeof...(Is), Hash>(
+      {{static_cast<int>(Is) * 7 - 3000, static_cast<int>(Is)}...});
+  }
+
+  template <class Hash, std::size_t... Is>
+  constexpr boost::static_flat_set<int, sizeof...(Is), Hash> make_set(
+    std::index_sequence<Is...>)
+  {
+    return boost::static_flat_set<int, sizeof...(Is), Hash>(
+      {static_cast<int>(Is) * 7 - 3000 ...});
+  }
+
+  // many collisions, so that groups overflow
+
+  struct bad_hash
+  {
+    constexpr std::size_t operator()(int x) const
+    {
+      return static_cast<std::size_t>(x % 4);
+    }
+  };
+
+  struct avalanching_hash
+  {
+    using is_avalanching = void;
+
+    constexpr std::size_t operator()(int x) const
+    {
+      return static_cast<std::size_t>(x) * 0x9E3779B9u;
+    }
+  };
+
+  struct transparent_hash
+  {
+    using is_transparent = void;
+
+    constexpr std::size_t operator()(long x) const
+    {
+      return static_cast<std::size_t>(x);
+    }
+  };
+
+  struct transparent_equal_to
+  {
+    using is_transparent = void;
+
+    constexpr bool operator()(long x, long y) const { return x == y; }
+  };
+
+  using default_hash = boost::unordered::static_hash<int>;
+
+  constexpr auto static_map =
+    make_map<default_hash>(std::make_index_sequence<1000>());
+  constexpr auto static_set =
+    make_set<default_hash>(std::make_index_sequence<1000>());
+
+  constexpr auto bad_hash_map =
+    make_map<bad_hash>(std::make_index_sequence<1000>());
+  constexpr auto bad_hash_set =
+    make_set<bad_hash>(std::make_index_sequence<1000>());
+
+  constexpr auto avalanching_hash_map =
+    make_map<avalanching_hash>(std::make_index_sequence<1000>());
+  constexpr auto avalanching_hash_set =
+    make_set<avalanching_hash>(std::make_index_sequence<1000>());
+} // namespace
+
+// static containers must lay out their elements exactly as
+// unordered_flat_map does after reserving for the same elements, unless
+// the latter uses wide or 16-bit fingerprint groups
+
+template <class X> void static_layout(X const& x)
+{
+  using namespace boost::unordered::detail::foa;
+
+  if (!std::is_same<default_group<plain_integral>,
+        group15<plain_integral> >::value) {
+    return;
+  }
+
+  boost::unordered_flat_map<int, int, typename X::hasher> m;
+  m.reserve(x.size());
+  for (int i = 0; i < static_cast<int>(x.size()); ++i) {
+    m.emplace(i * 7 - 3000, i);
+  }
+
+  BOOST_TEST_EQ(x.bucket_count(), m.bucket_count());
+  BOOST_TEST_EQ(x.load_factor(), m.load_factor());
+
+  std::vector<int> v1, v2;
+  for (auto const& e : m) {
+    v1.push_back(e.first);
+  }
+  for (auto const& e : x) {
+    v2.push_back(test::get_key<X>(e));
+  }
+  BOOST_TEST(v1 == v2);
+}
+
+template <class X> void static_lookup(X const& x)
+{
+  BOOST_TEST(!x.empty());
+  BOOST_TEST_EQ(x.size(), 1000u);
+  BOOST_TEST_EQ(x.max_size(), x.size());
+
+  std::size_t n = 0;
+  for (auto it = x.cbegin(); it != x.cend(); ++it) {
+    BOOST_TEST(x.find(test::get_key<X>(*it)) == it);
+    ++n;
+  }
+  BOOST_TEST_EQ(n, x.size());
+
+  for (int i = -4000; i < 5000; ++i) {
+    bool found = i >= -3000 && i < 4000 && (i + 3000) % 7 == 0;
+    BOOST_TEST_EQ(x.contains(i), found);
+    BOOST_TEST_EQ(x.count(i), found ? 1u : 0u);
+    if (found) {
+      BOOST_TEST_EQ(test::get_key<X>(*x.find(i)), i);
+    } else {
+      BOOST_TEST(x.find(i) == x.end());
+    }
+  }
+}
+
+UNORDERED_AUTO_TEST (static_containers) {
+  static_layout(static_map);
+  static_lookup(static_map);
+  static_lookup(static_set);
+
+  for (int i = 0; i < 1000; ++i) {
+    BOOST_TEST_EQ(static_map.at(i * 7 - 3000), i);
+  }
+  BOOST_TEST_THROWS(static_map.at(1), std::out_of_range);
+
+  BOOST_STATIC_ASSERT(static_map.size() == 1000);
+  BOOST_STATIC_ASSERT(static_set.bucket_count() == static_map.bucket_count());
+}
+
+UNORDERED_AUTO_TEST (static_containers_with_custom_hash) {
+  static_layout(bad_hash_map);
+  static_lookup(bad_hash_map);
+  static_lookup(bad_hash_set);
+
+  static_layout(avalanching_hash_map);
+  static_lookup(avalanching_hash_map);
+  static_lookup(avalanching_hash_set);
+}
+
+UNORDERED_AUTO_TEST (runtime_construction) {
+  using map_type = boost::static_flat_map<int, int, 3>;
+  using set_type = boost::static_flat_set<int, 3>;
+
+  int n = 10;
+  map_type m({{n, 1}, {n + 1, 2}, {n + 2, 3}});
+  BOOST_TEST_EQ(m.at(11), 2);
+  BOOST_TEST(!m.contains(13));
+
+  BOOST_TEST_THROWS(map_type({{n, 1}, {n + 1, 2}, {n, 3}}),
+    std::invalid_argument);
+  BOOST_TEST_THROWS(set_type({n, n, n}), std::invalid_argument);
+}
+
+UNORDERED_AUTO_TEST (transparent_lookup) {
+  constexpr auto m =
+    boost::make_static_flat_map<int, int, transparent_hash,
+      transparent_equal_to>({{1, 10}, {2, 20}, {3, 30}});
+  constexpr auto s =
+    boost::make_static_flat_set<int, transparent_hash, transparent_equal_to>(
+      {1, 2, 3});
+
+  for (long i = 0; i < 5; ++i) {
+    BOOST_TEST_EQ(m.contains(i), i >= 1 && i <= 3);
+    BOOST_TEST_EQ(s.count(i), i >= 1 && i <= 3 ? 1u : 0u);
+    if (m.contains(i)) {
+      BOOST_TEST_EQ(m.at(i), i * 10);
+      BOOST_TEST_EQ(*s.find(i), i);
+    }
+  }
+}
+
+#if !defined(BOOST_NO_CXX17_HDR_STRING_VIEW)
+
+UNORDERED_AUTO_TEST (string_view_keys) {
+  constexpr auto m = boost::make_static_flat_map<std::string_view, int>(
+    {{"zero", 0}, {"one", 1}, {"two", 2}, {"three", 3}, {"four", 4},
+      {"", -1}});
+
+  BOOST_TEST_EQ(m.size(), 6u);
+  BOOST_TEST_EQ(m.at("zero"), 0);
+  BOOST_TEST_EQ(m.at("three"), 3);
+  BOOST_TEST_EQ(m.at(""), -1);
+  BOOST_TEST(!m.contains("five"));
+  BOOST_TEST(!m.contains("thre"));
+
+  boost::unordered::static_hash<std::string_view> h;
+  BOOST_TEST_EQ(m.hash_function()("one"), h("one"));
+}
+
+#endif
+
+#endif
+#endif
+
+RUN_TESTS()
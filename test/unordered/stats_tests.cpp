@@ -0,0 +1,165 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(BOOST_UNORDERED_FOA_TESTS)
+#error "stats_tests is currently only supported by open-addressed containers"
+#else
+
+#if !defined(BOOST_UNORDERED_ENABLE_STATS)
+#define BOOST_UNORDERED_ENABLE_STATS
+#endif
+
+#include "../helpers/unordered.hpp"
+
+#include "../helpers/helpers.hpp"
+#include "../helpers/random_values.hpp"
+#include "../helpers/test.hpp"
+#include "../objects/test.hpp"
+
+#include <vector>
+
+template <class Stats> std::size_t histogram_sum(Stats const& s)
+{
+  std::size_t n = 0;
+  for (auto m : s.probe_length_histogram) {
+    n += m;
+  }
+  return n;
+}
+
+template <class X> void check_layout(X const& x)
+{
+  auto layout = x.get_stats().layout;
+
+  std::size_t num_groups = 0, num_elements = 0;
+  for (std::size_t i = 0; i < layout.occupancy_histogram.size(); ++i) {
+    num_groups += layout.occupancy_histogram[i];
+    num_elements += i * layout.occupancy_histogram[i];
+  }
+  BOOST_TEST_EQ(num_groups, layout.num_groups);
+  BOOST_TEST_EQ(num_elements, x.size());
+  BOOST_TEST_LE(layout.num_overflowed_groups, layout.num_groups);
+  BOOST_TEST_EQ(layout.max_load, x.max_load());
+}
+
+template <class X> void stats_tests(X*, test::random_generator generator)
+{
+  test::random_values<X> v(1000, generator), v2(1000, generator);
+
+  X x;
+  x.reserve(v.size());
+  x.reset_stats();
+  x.insert(v.begin(), v.end());
+
+  auto stats = x.get_stats();
+  BOOST_TEST_EQ(stats.insertion.count, x.size());
+  BOOST_TEST_EQ(histogram_sum(stats.insertion), stats.insertion.count);
+  BOOST_TEST_GE(stats.insertion.probe_length.average, 1.0);
+  BOOST_TEST_EQ(stats.rehash.count, 0u);
+  BOOST_TEST_EQ(stats.layout.max_load_drift, 0u);
+  check_layout(x);
+
+  // successful lookups
+
+  x.reset_stats();
+  for (auto const& val : x) {
+    BOOST_TEST(x.find(test::get_key<X>(val)) != x.end());
+  }
+  stats = x.get_stats();
+  BOOST_TEST_EQ(stats.insertion.count, 0u);
+  BOOST_TEST_EQ(stats.successful_lookup.count, x.size());
+  BOOST_TEST_EQ(stats.unsuccessful_lookup.count, 0u);
+  BOOST_TEST_EQ(
+    histogram_sum(stats.successful_lookup), stats.successful_lookup.count);
+  BOOST_TEST_GE(stats.successful_lookup.probe_length.average, 1.0);
+  BOOST_TEST_GE(stats.successful_lookup.num_comparisons.average, 1.0);
+
+  // mixed lookups, one at a time and in bulk
+
+  std::vector<typename X::key_type> keys;
+  for (auto const& val : v2) {
+    keys.push_back(test::get_key<X>(val));
+  }
+
+  x.reset_stats();
+  std::size_t num_found = 0;
+  for (auto const& k : keys) {
+    if (x.find(k) != x.end()) {
+      ++num_found;
+    }
+  }
+  std::vector<bool> found;
+  x.contains(keys.begin(), keys.end(), std::back_inserter(found));
+
+  stats = x.get_stats();
+  BOOST_TEST_EQ(stats.successful_lookup.count, 2 * num_found);
+  BOOST_TEST_EQ(
+    stats.unsuccessful_lookup.count, 2 * (keys.size() - num_found));
+  BOOST_TEST_EQ(
+    histogram_sum(stats.unsuccessful_lookup), stats.unsuccessful_lookup.count);
+  if (stats.unsuccessful_lookup.count) {
+    BOOST_TEST_GE(stats.unsuccessful_lookup.probe_length.average, 1.0);
+  }
+
+  // rehashing transfers every element
+
+  x.reset_stats();
+  x.rehash(2 * x.bucket_count());
+  stats = x.get_stats();
+  BOOST_TEST_EQ(stats.rehash.count, 1u);
+  BOOST_TEST_GE(stats.rehash.duration.average, 0.0);
+  BOOST_TEST_EQ(stats.insertion.count, x.size());
+  check_layout(x);
+
+  // erasures may reduce max load
+
+  std::size_t n = 0;
+  for (auto it = x.begin(); it != x.end();) {
+    if (n++ % 2) {
+      it = x.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  stats = x.get_stats();
+  BOOST_TEST_LE(stats.layout.max_load, x.max_load());
+  BOOST_TEST_EQ(
+    stats.layout.max_load + stats.layout.max_load_drift,
+    X(x.bucket_count()).max_load());
+  check_layout(x);
+
+  x.reset_stats();
+  stats = x.get_stats();
+  BOOST_TEST_EQ(stats.insertion.count, 0u);
+  BOOST_TEST_EQ(stats.successful_lookup.count, 0u);
+  BOOST_TEST_EQ(stats.unsuccessful_lookup.count, 0u);
+  BOOST_TEST_EQ(stats.rehash.count, 0u);
+  BOOST_TEST_EQ(histogram_sum(stats.insertion), 0u);
+
+  X empty;
+  check_layout(empty);
+}
+
+using test::default_generator;
+using test::generate_collisions;
+using test::limited_range;
+
+boost::unordered_flat_set<test::object, test::hash, test::equal_to,
+  test::allocator1<test::object> >* test_set;
+boost::unordered_flat_map<test::object, test::object, test::hash,
+  test::equal_to, test::allocator1<test::object> >* test_map;
+boost::unordered_node_set<test::object, test::hash, test::equal_to,
+  test::allocator1<test::object> >* test_node_set;
+boost::unordered_node_map<test::object, test::object, test::hash,
+  test::equal_to, test::allocator1<test::object> >* test_node_map;
+
+// clang-format off
+UNORDERED_TEST(stats_tests,
+  ((test_set)(test_map)(test_node_set)(test_node_map))(
+    (default_generator)(generate_collisions)(limited_range)))
+// clang-format on
+
+#endif
+
+RUN_TESTS()
@@ -0,0 +1,285 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "../helpers/unordered.hpp"
+
+#include "../helpers/helpers.hpp"
+#include "../helpers/test.hpp"
+
+#ifdef BOOST_UNORDERED_FOA_TESTS
+#include <boost/unordered/concurrent_flat_map.hpp>
+#endif
+
+#include <boost/unordered/hash_traits.hpp>
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// closed-addressing containers store hash values in nodes depending on the
+// key type
+
+namespace boost {
+  namespace unordered {
+    template <> struct node_stores_hash<int> : std::true_type
+    {
+    };
+  } // namespace unordered
+} // namespace boost
+
+namespace {
+  std::size_t hash_calls = 0;
+  std::size_t equal_to_calls = 0;
+
+  // injective, so that the stored hash alone tells different keys apart
+
+  struct expensive_hash
+  {
+    using is_expensive = void;
+
+    std::size_t operator()(int x) const
+    {
+      ++hash_calls;
+      return static_cast<std::size_t>(x) * static_cast<std::size_t>(0x9E3779B1u);
+    }
+  };
+
+  struct counting_equal_to
+  {
+    bool operator()(int x, int y) const
+    {
+      ++equal_to_calls;
+      return x == y;
+    }
+  };
+
+  struct cheap_hash
+  {
+    std::size_t operator()(int x) const
+    {
+      return static_cast<std::size_t>(x);
+    }
+  };
+} // namespace
+
+UNORDERED_AUTO_TEST (hash_is_expensive_trait) {
+  using boost::unordered::hash_is_expensive;
+
+  BOOST_TEST(hash_is_expensive<expensive_hash>::value);
+  BOOST_TEST(!hash_is_expensive<cheap_hash>::value);
+  BOOST_TEST(!hash_is_expensive<boost::hash<int> >::value);
+
+  using boost::unordered::node_stores_hash;
+
+  BOOST_TEST(node_stores_hash<int>::value);
+  BOOST_TEST(!node_stores_hash<long>::value);
+}
+
+template <class X> void check_contents(X const& x, int n, std::size_t copies)
+{
+  for (int i = 0; i < n; ++i) {
+    BOOST_TEST_EQ(x.count(i), copies);
+  }
+
+  equal_to_calls = 0;
+  for (int i = n; i < 2 * n; ++i) {
+    BOOST_TEST(x.find(i) == x.end());
+  }
+  BOOST_TEST_EQ(equal_to_calls, 0u);
+}
+
+template <class X> void stored_hash_tests(X*)
+{
+  int const n = 1000;
+
+  X x;
+  for (int i = 0; i < n; ++i) {
+    x.insert(test::make_value<X>(i));
+    x.insert(x.find(i), test::make_value<X>(i));
+  }
+
+  // 2 for equivalent-key containers
+  std::size_t const copies = x.count(0);
+  BOOST_TEST_EQ(x.size(), copies * n);
+  check_contents(x, n, copies);
+
+  // rehashing uses the stored hash values
+
+  hash_calls = 0;
+  x.rehash(x.bucket_count() * 4);
+  BOOST_TEST_EQ(hash_calls, 0u);
+  check_contents(x, n, copies);
+
+  X y(x);
+  BOOST_TEST(y == x);
+  check_contents(y, n, copies);
+
+  for (int i = 0; i < n; i += 2) {
+    x.erase(i);
+  }
+  hash_calls = 0;
+  x.rehash(0);
+  BOOST_TEST_EQ(hash_calls, 0u);
+  for (int i = 0; i < n; ++i) {
+    BOOST_TEST_EQ(x.count(i), i % 2 ? copies : 0u);
+  }
+
+  X z;
+  z.insert(test::make_value<X>(0));
+  std::size_t const m = x.size();
+  z.merge(x);
+  BOOST_TEST_EQ(z.size() + x.size(), m + 1);
+  for (int i = 1; i < n; i += 2) {
+    BOOST_TEST_EQ(z.count(i) + x.count(i), copies);
+  }
+}
+
+template <class X> void stored_hash_node_handle_tests(X*)
+{
+  int const n = 1000;
+
+  X x;
+  for (int i = 0; i < n; ++i) {
+    x.insert(test::make_value<X>(i));
+  }
+
+  X y;
+  for (int i = 0; i < n; i += 2) {
+    y.insert(x.extract(i));
+  }
+
+  hash_calls = 0;
+  y.rehash(y.bucket_count() * 4);
+  BOOST_TEST_EQ(hash_calls, 0u);
+  check_contents(y, 0, 1);
+  for (int i = 0; i < n; ++i) {
+    BOOST_TEST_EQ(x.count(i) + y.count(i), 1u);
+    BOOST_TEST_EQ(y.count(i), i % 2 ? 0u : 1u);
+  }
+}
+
+// node handles can be moved between containers differing only in whether
+// their hash function is expensive
+
+template <class X, class Y> void different_hash_node_handle_tests(X*, Y*)
+{
+  BOOST_STATIC_ASSERT(
+    (std::is_same<typename X::node_type, typename Y::node_type>::value));
+
+  int const n = 1000;
+
+  X x;
+  for (int i = 0; i < n; ++i) {
+    x.insert(test::make_value<X>(i));
+  }
+
+  Y y;
+  for (int i = 0; i < n; i += 2) {
+    typename X::node_type nh = x.extract(i);
+    typename Y::node_type nh2 = std::move(nh);
+    BOOST_TEST(y.insert(std::move(nh2)).inserted);
+  }
+  BOOST_TEST_EQ(x.size() + y.size(), static_cast<std::size_t>(n));
+
+  y.rehash(y.bucket_count() * 4);
+  for (int i = 0; i < n; ++i) {
+    BOOST_TEST_EQ(x.count(i) + y.count(i), 1u);
+    BOOST_TEST_EQ(y.count(i), i % 2 ? 0u : 1u);
+  }
+
+  for (int i = 0; i < n; i += 2) {
+    x.insert(y.extract(i));
+  }
+  BOOST_TEST(y.empty());
+  x.rehash(x.bucket_count() * 4);
+  for (int i = 0; i < n; ++i) {
+    BOOST_TEST_EQ(x.count(i), 1u);
+  }
+}
+
+#ifdef BOOST_UNORDERED_FOA_TESTS
+static boost::unordered_flat_map<int, int, expensive_hash, counting_equal_to>*
+  test_flat_map;
+static boost::unordered_flat_set<int, expensive_hash, counting_equal_to>*
+  test_flat_set;
+static boost::unordered_node_map<int, int, expensive_hash, counting_equal_to>*
+  test_node_map;
+static boost::unordered_node_set<int, expensive_hash, counting_equal_to>*
+  test_node_set;
+
+UNORDERED_TEST(stored_hash_tests,
+  ((test_flat_map)(test_flat_set)(test_node_map)(test_node_set)))
+
+UNORDERED_TEST(
+  stored_hash_node_handle_tests, ((test_node_map)(test_node_set)))
+
+UNORDERED_AUTO_TEST (different_hash_node_handles) {
+  different_hash_node_handle_tests(
+    static_cast<boost::unordered_node_map<int, int, expensive_hash>*>(nullptr),
+    static_cast<boost::unordered_node_map<int, int, cheap_hash>*>(nullptr));
+  different_hash_node_handle_tests(
+    static_cast<boost::unordered_node_set<int, expensive_hash>*>(nullptr),
+    static_cast<boost::unordered_node_set<int, cheap_hash>*>(nullptr));
+}
+
+UNORDERED_AUTO_TEST (concurrent_stored_hash_tests) {
+  using concurrent_map = boost::concurrent_flat_map<int, int, expensive_hash,
+    counting_equal_to>;
+  using map = boost::unordered_flat_map<int, int, expensive_hash,
+    counting_equal_to>;
+
+  int const n = 1000;
+
+  concurrent_map x;
+  for (int i = 0; i < n; ++i) {
+    x.emplace(i, i);
+  }
+
+  hash_calls = 0;
+  x.rehash(x.bucket_count() * 4);
+  BOOST_TEST_EQ(hash_calls, 0u);
+
+  equal_to_calls = 0;
+  for (int i = n; i < 2 * n; ++i) {
+    BOOST_TEST(!x.contains(i));
+  }
+  BOOST_TEST_EQ(equal_to_calls, 0u);
+
+  map y(std::move(x));
+  check_contents(y, n, 1);
+
+  concurrent_map z(std::move(y));
+  BOOST_TEST_EQ(z.size(), static_cast<std::size_t>(n));
+  for (int i = 0; i < n; ++i) {
+    BOOST_TEST(z.visit(i, [i](std::pair<int const, int> const& v) {
+      BOOST_TEST_EQ(v.second, i);
+    }));
+  }
+}
+#else
+static boost::unordered_map<int, int, expensive_hash, counting_equal_to>*
+  test_map;
+static boost::unordered_multimap<int, int, expensive_hash, counting_equal_to>*
+  test_multimap;
+static boost::unordered_set<int, expensive_hash, counting_equal_to>* test_set;
+static boost::unordered_multiset<int, expensive_hash, counting_equal_to>*
+  test_multiset;
+
+UNORDERED_TEST(stored_hash_tests,
+  ((test_map)(test_multimap)(test_set)(test_multiset)))
+
+UNORDERED_TEST(stored_hash_node_handle_tests,
+  ((test_map)(test_multimap)(test_set)(test_multiset)))
+
+UNORDERED_AUTO_TEST (different_hash_node_handles) {
+  different_hash_node_handle_tests(
+    static_cast<boost::unordered_map<int, int, expensive_hash>*>(nullptr),
+    static_cast<boost::unordered_map<int, int, cheap_hash>*>(nullptr));
+  different_hash_node_handle_tests(
+    static_cast<boost::unordered_set<int, expensive_hash>*>(nullptr),
+    static_cast<boost::unordered_set<int, cheap_hash>*>(nullptr));
+}
+#endif
+
+RUN_TESTS()
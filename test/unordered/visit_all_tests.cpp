@@ -0,0 +1,132 @@
+// Copyright 2024 Boost.Unordered contributors.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(BOOST_UNORDERED_FOA_TESTS)
+#error "visit_all_tests is currently only supported by open-addressed containers"
+#else
+
+#include "../helpers/unordered.hpp"
+
+#include "../helpers/helpers.hpp"
+#include "../helpers/test.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace {
+  template <class X>
+  using visitor = std::function<void(typename X::value_type const&)>;
+
+  // checks that each element of x is visited exactly once by
+  // visit(f), which returns the number of elements visited
+
+  template <class X, class Visit>
+  void check_visit_all(X const& x, int n, Visit visit)
+  {
+    std::vector<int> visited(static_cast<std::size_t>(n), 0);
+    std::size_t res = visit([&](typename X::value_type const& v) {
+      int k = test::get_key<X>(v);
+      BOOST_TEST(k >= 0 && k < n) && ++visited[static_cast<std::size_t>(k)];
+    });
+    BOOST_TEST_EQ(res, x.size());
+    for (int i = 0; i < n; ++i) {
+      BOOST_TEST_EQ(visited[static_cast<std::size_t>(i)], x.count(i) ? 1 : 0);
+    }
+  }
+} // namespace
+
+template <class X> void visit_all_tests(X*)
+{
+  // empty, within a few groups, and large enough to span many prefetch
+  // distances; erasures leave fully empty groups behind
+
+  for (int n : {0, 1, 10, 100, 10000}) {
+    X x;
+    X const& cx = x;
+
+    check_visit_all(x, n, [&](visitor<X> f) { return x.visit_all(f); });
+    for (int i = 0; i < n; ++i) {
+      x.insert(test::make_value<X>(i));
+    }
+
+    for (int step : {1, 2, 7, 100}) {
+      for (int i = 0; i < n; i += step) {
+        if (i % 100 != 50) {
+          x.erase(i);
+        }
+      }
+
+      check_visit_all(x, n, [&](visitor<X> f) { return x.visit_all(f); });
+      check_visit_all(x, n, [&](visitor<X> f) { return cx.visit_all(f); });
+      check_visit_all(x, n, [&](visitor<X> f) { return cx.cvisit_all(f); });
+
+      std::size_t m = 0;
+      BOOST_TEST(cx.visit_while([&](typename X::value_type const&) {
+        ++m;
+        return true;
+      }));
+      BOOST_TEST_EQ(m, x.size());
+
+      if (!x.empty()) {
+        m = 0;
+        BOOST_TEST(!cx.cvisit_while([&](typename X::value_type const&) {
+          return ++m < (x.size() + 1) / 2;
+        }));
+        BOOST_TEST_EQ(m, (x.size() + 1) / 2);
+      }
+
+      for (int i = 0; i < n; i += step) {
+        x.insert(test::make_value<X>(i));
+      }
+    }
+  }
+}
+
+template <class X> void visit_all_mutable_tests(X*)
+{
+  int const n = 5000;
+
+  X x;
+  for (int i = 0; i < n; ++i) {
+    x.emplace(i, 0);
+  }
+
+  BOOST_TEST_EQ(
+    x.visit_all([](typename X::value_type& v) { v.second = v.first + 1; }),
+    x.size());
+  for (int i = 0; i < n; ++i) {
+    BOOST_TEST_EQ(x[i], i + 1);
+  }
+
+  int sum = 0;
+  BOOST_TEST(!x.visit_while([&](typename X::value_type& v) {
+    v.second = 0;
+    return ++sum < 100;
+  }));
+  BOOST_TEST_EQ(sum, 100);
+  std::size_t zeros = 0;
+  for (auto const& v : x) {
+    zeros += v.second == 0;
+  }
+  BOOST_TEST_EQ(zeros, 100u);
+}
+
+static boost::unordered_flat_map<int, int>* test_flat_map;
+static boost::unordered_flat_set<int>* test_flat_set;
+static boost::unordered_node_map<int, int>* test_node_map;
+static boost::unordered_node_set<int>* test_node_set;
+
+// clang-format off
+UNORDERED_TEST(visit_all_tests,
+  ((test_flat_map)(test_flat_set)(test_node_map)(test_node_set)))
+
+UNORDERED_TEST(visit_all_mutable_tests,
+  ((test_flat_map)(test_node_map)))
+// clang-format on
+
+#endif
+
+RUN_TESTS()